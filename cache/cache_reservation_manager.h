@@ -13,13 +13,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "cache/cache_entry_roles.h"
+#include "cache/cache_key.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
-#include "table/block_based/block_based_table_reader.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -188,4 +189,80 @@ class CacheReservationHandle {
   std::size_t incremental_memory_used_;
   std::shared_ptr<CacheReservationManager> cache_res_mgr_;
 };
+
+// A thread-safe way of reserving cache space for memory of role R that is
+// allocated and freed from many threads, e.g. by the table readers of a
+// column family. Unlike CacheReservationManager::MakeCacheReservation(), a
+// reservation that cannot be fully made is given up rather than kept.
+//
+// REQUIRES: CacheReservationManager::UpdateCacheReservation<R>() is
+//           explicitly instantiated in cache_reservation_manager.cc
+template <CacheEntryRole R>
+class ConcurrentCacheReservationManager
+    : public std::enable_shared_from_this<
+          ConcurrentCacheReservationManager<R>> {
+ public:
+  // Releases its reservation on destruction
+  class Handle {
+   public:
+    Handle(std::size_t memory_used,
+           std::shared_ptr<ConcurrentCacheReservationManager> mgr)
+        : memory_used_(memory_used), mgr_(std::move(mgr)) {}
+    ~Handle() { mgr_->Release(memory_used_); }
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+   private:
+    std::size_t memory_used_;
+    std::shared_ptr<ConcurrentCacheReservationManager> mgr_;
+  };
+
+  explicit ConcurrentCacheReservationManager(std::shared_ptr<Cache> cache)
+      : cache_res_mgr_(new CacheReservationManager(std::move(cache))) {}
+
+  // Reserves cache space for another `memory_used` bytes. On success, the
+  // reservation lasts as long as *handle; otherwise *handle is reset and
+  // nothing stays reserved.
+  // REQUIRES: handle != nullptr
+  // REQUIRES: this object is managed by std::shared_ptr
+  Status MakeCacheReservation(std::size_t memory_used,
+                              std::unique_ptr<Handle>* handle) {
+    assert(handle != nullptr);
+    handle->reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t prev_memory_used = cache_res_mgr_->GetTotalMemoryUsed();
+    Status s = cache_res_mgr_->template UpdateCacheReservation<R>(
+        prev_memory_used + memory_used);
+    if (!s.ok()) {
+      cache_res_mgr_->template UpdateCacheReservation<R>(prev_memory_used)
+          .PermitUncheckedError();
+      return s;
+    }
+    handle->reset(new Handle(memory_used, this->shared_from_this()));
+    return s;
+  }
+
+  std::size_t GetTotalMemoryUsed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_res_mgr_->GetTotalMemoryUsed();
+  }
+
+  std::size_t GetTotalReservedCacheSize() {
+    return cache_res_mgr_->GetTotalReservedCacheSize();
+  }
+
+ private:
+  void Release(std::size_t memory_used) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(cache_res_mgr_->GetTotalMemoryUsed() >= memory_used);
+    cache_res_mgr_
+        ->template UpdateCacheReservation<R>(
+            cache_res_mgr_->GetTotalMemoryUsed() - memory_used)
+        .PermitUncheckedError();
+  }
+
+  std::mutex mutex_;
+  std::unique_ptr<CacheReservationManager> cache_res_mgr_;
+};
 }  // namespace ROCKSDB_NAMESPACE
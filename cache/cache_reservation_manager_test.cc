@@ -11,9 +11,11 @@
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include "cache/cache_entry_roles.h"
 #include "rocksdb/cache.h"
+#include "port/port.h"
 #include "rocksdb/slice.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "test_util/testharness.h"
@@ -498,6 +500,48 @@ TEST(CacheReservationHandleTest, HandleTest) {
   EXPECT_EQ(mem_used, 0);
   EXPECT_EQ(cache->GetPinnedUsage(), mem_used);
 }
+
+TEST(ConcurrentCacheReservationManagerTest, GiveUpOnFullCache) {
+  constexpr std::size_t kSizeDummyEntry =
+      CacheReservationManager::GetDummyEntrySize();
+  LRUCacheOptions lo;
+  lo.capacity = 4 * kSizeDummyEntry;
+  lo.num_shard_bits = 0;  // 2^0 shard
+  lo.strict_capacity_limit = true;
+  std::shared_ptr<Cache> cache = NewLRUCache(lo);
+  using Manager = ConcurrentCacheReservationManager<CacheEntryRole::kMisc>;
+  std::shared_ptr<Manager> mgr = std::make_shared<Manager>(cache);
+
+  std::unique_ptr<Manager::Handle> handle_1;
+  ASSERT_OK(mgr->MakeCacheReservation(2 * kSizeDummyEntry, &handle_1));
+  ASSERT_NE(handle_1, nullptr);
+  EXPECT_EQ(mgr->GetTotalMemoryUsed(), 2 * kSizeDummyEntry);
+
+  std::unique_ptr<Manager::Handle> handle_2;
+  Status s = mgr->MakeCacheReservation(3 * kSizeDummyEntry, &handle_2);
+  EXPECT_TRUE(s.IsIncomplete());
+  EXPECT_EQ(handle_2, nullptr);
+  // Nothing is left reserved for the failed reservation
+  EXPECT_EQ(mgr->GetTotalMemoryUsed(), 2 * kSizeDummyEntry);
+  EXPECT_EQ(mgr->GetTotalReservedCacheSize(), 2 * kSizeDummyEntry);
+
+  // Reservations from many threads add up and are fully released
+  std::vector<std::unique_ptr<Manager::Handle>> handles(8);
+  std::vector<port::Thread> threads;
+  for (auto& handle : handles) {
+    threads.emplace_back([&]() {
+      ASSERT_OK(mgr->MakeCacheReservation(kSizeDummyEntry / 8, &handle));
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(mgr->GetTotalMemoryUsed(), 3 * kSizeDummyEntry);
+  handles.clear();
+  handle_1.reset();
+  EXPECT_EQ(mgr->GetTotalMemoryUsed(), 0);
+  EXPECT_EQ(mgr->GetTotalReservedCacheSize(), 0);
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -375,6 +375,20 @@ TEST_P(CacheTest, EvictionPolicy) {
   ASSERT_EQ(-1, Lookup(200));
 }
 
+TEST_P(CacheTest, ProbeKeepsEvictionOrder) {
+  Insert(100, 101);
+  ASSERT_TRUE(cache_->Probe(EncodeKey(100)));
+  ASSERT_FALSE(cache_->Probe(EncodeKey(200)));
+
+  // Unlike a looked up entry, a probed one is evicted in turn
+  for (int i = 0; i < kCacheSize * 2; i++) {
+    Insert(1000 + i, 2000 + i);
+    cache_->Probe(EncodeKey(100));
+  }
+  ASSERT_FALSE(cache_->Probe(EncodeKey(100)));
+  ASSERT_EQ(-1, Lookup(100));
+}
+
 TEST_P(CacheTest, ExternalRefPinsEntries) {
   Insert(100, 101);
   Cache::Handle* h = cache_->Lookup(EncodeKey(100));
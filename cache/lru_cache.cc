@@ -583,6 +583,11 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   return InsertItem(e, handle, /* free_handle_on_fail */ true);
 }
 
+bool LRUCacheShard::Probe(const Slice& key, uint32_t hash) {
+  MutexLock l(&mutex_);
+  return table_.Lookup(key, hash) != nullptr;
+}
+
 void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
@@ -335,6 +335,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   virtual bool Release(Cache::Handle* handle,
                        bool force_erase = false) override;
   virtual void Erase(const Slice& key, uint32_t hash) override;
+  // Does not move the entry in the LRU list nor mark it as hit
+  virtual bool Probe(const Slice& key, uint32_t hash) override;
 
   // Although in some platforms the update of size_t is atomic, to make sure
   // GetUsage() and GetPinnedUsage() work correctly under any platform, we'll
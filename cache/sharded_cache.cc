@@ -79,6 +79,11 @@ Cache::Handle* ShardedCache::Lookup(const Slice& key, Statistics* /*stats*/) {
   return GetShard(Shard(hash))->Lookup(key, hash);
 }
 
+bool ShardedCache::Probe(const Slice& key) {
+  uint32_t hash = HashSlice(key);
+  return GetShard(Shard(hash))->Probe(key, hash);
+}
+
 Cache::Handle* ShardedCache::Lookup(const Slice& key,
                                     const CacheItemHelper* helper,
                                     const CreateCallback& create_cb,
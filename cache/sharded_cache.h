@@ -43,6 +43,15 @@ class CacheShard {
   virtual bool Ref(Cache::Handle* handle) = 0;
   virtual bool Release(Cache::Handle* handle, bool force_erase) = 0;
   virtual void Erase(const Slice& key, uint32_t hash) = 0;
+  // See Cache::Probe()
+  virtual bool Probe(const Slice& key, uint32_t hash) {
+    Cache::Handle* handle = Lookup(key, hash);
+    if (handle == nullptr) {
+      return false;
+    }
+    Release(handle, /*force_erase=*/false);
+    return true;
+  }
   virtual void SetCapacity(size_t capacity) = 0;
   virtual void SetStrictCapacityLimit(bool strict_capacity_limit) = 0;
   virtual size_t GetUsage() const = 0;
@@ -90,6 +99,7 @@ class ShardedCache : public Cache {
                         Handle** handle = nullptr,
                         Priority priority = Priority::LOW) override;
   virtual Handle* Lookup(const Slice& key, Statistics* stats) override;
+  virtual bool Probe(const Slice& key) override;
   virtual Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
                          const CreateCallback& create_cb, Priority priority,
                          bool wait, Statistics* stats = nullptr) override;
@@ -31,4 +31,17 @@ Status BlobFetcher::FetchBlob(const Slice& user_key,
                            blob_value, bytes_read);
 }
 
+void BlobFetcher::FetchBlobs(
+    uint64_t blob_file_number,
+    const autovector<std::reference_wrapper<const Slice>>& user_keys,
+    const autovector<std::reference_wrapper<const BlobIndex>>& blob_indexes,
+    autovector<Status*>& statuses, autovector<PinnableSlice*>& blob_values,
+    uint64_t* bytes_read) const {
+  assert(version_);
+
+  version_->MultiGetBlobFromFile(read_options_, blob_file_number, user_keys,
+                                 blob_indexes, statuses, blob_values,
+                                 bytes_read);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <functional>
+
 #include "rocksdb/options.h"
 #include "rocksdb/status.h"
+#include "util/autovector.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -30,6 +33,15 @@ class BlobFetcher {
                    FilePrefetchBuffer* prefetch_buffer,
                    PinnableSlice* blob_value, uint64_t* bytes_read) const;
 
+  // Fetches several blobs of the same blob file at once. The blob references
+  // must be sorted by offset.
+  void FetchBlobs(
+      uint64_t blob_file_number,
+      const autovector<std::reference_wrapper<const Slice>>& user_keys,
+      const autovector<std::reference_wrapper<const BlobIndex>>& blob_indexes,
+      autovector<Status*>& statuses, autovector<PinnableSlice*>& blob_values,
+      uint64_t* bytes_read) const;
+
  private:
   const Version* version_;
   ReadOptions read_options_;
@@ -0,0 +1,196 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_garbage_collection_batcher.h"
+
+#include <functional>
+
+#include "db/dbformat.h"
+#include "db/range_del_aggregator.h"
+#include "test_util/sync_point.h"
+#include "util/autovector.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+BlobGarbageCollectionBatcher::~BlobGarbageCollectionBatcher() {
+  ReleaseBlobs();
+}
+
+Status BlobGarbageCollectionBatcher::FetchBlob(const Slice& ikey,
+                                               const Slice& user_key,
+                                               const BlobIndex& blob_index,
+                                               PinnableSlice* blob_value,
+                                               uint64_t* bytes_read) {
+  assert(blob_value);
+  assert(bytes_read);
+
+  Status s;
+  if (!TakeBlob(user_key, blob_index, blob_value, &s)) {
+    // Only read the next batch if the entry has not been looked at yet, so
+    // that blobs missed by the lookahead cost a single read each.
+    const bool read_batch =
+        entries_.empty() && input_->Valid() && input_->key() == ikey;
+    if (read_batch) {
+      ReadBatch();
+    }
+    if (!read_batch || !TakeBlob(user_key, blob_index, blob_value, &s)) {
+      // Not batched by the lookahead, e.g. because a compaction filter changed
+      // the blob reference, or an older version of the key is kept for a
+      // snapshot
+      return blob_fetcher_->FetchBlob(user_key, blob_index,
+                                      /* prefetch_buffer */ nullptr,
+                                      blob_value, bytes_read);
+    }
+  }
+
+  *bytes_read = unreported_bytes_read_;
+  unreported_bytes_read_ = 0;
+
+  return s;
+}
+
+bool BlobGarbageCollectionBatcher::TakeBlob(const Slice& user_key,
+                                            const BlobIndex& blob_index,
+                                            PinnableSlice* blob_value,
+                                            Status* s) {
+  const auto it = blobs_.find(
+      std::make_pair(blob_index.file_number(), blob_index.offset()));
+  if (it == blobs_.end()) {
+    return false;
+  }
+
+  Blob& blob = it->second;
+  if (Slice(blob.user_key) != user_key ||
+      blob.blob_index.size() != blob_index.size() ||
+      blob.blob_index.compression() != blob_index.compression()) {
+    return false;
+  }
+
+  *s = std::move(blob.status);
+  if (s->ok()) {
+    *blob_value = std::move(blob.value);
+  }
+  blobs_.erase(it);
+
+  return true;
+}
+
+void BlobGarbageCollectionBatcher::ReadBatch() {
+  assert(entries_.empty());
+
+  ReleaseBlobs();
+
+  uint64_t batch_bytes = 0;
+  while (input_->Valid() && batch_bytes < batch_size_ &&
+         entries_bytes_ < batch_size_) {
+    Slice user_key;
+    BlobIndex blob_index;
+    if (ShouldBatch(&user_key, &blob_index)) {
+      Blob& blob = blobs_[std::make_pair(blob_index.file_number(),
+                                         blob_index.offset())];
+      blob.user_key.assign(user_key.data(), user_key.size());
+      blob.blob_index = blob_index;
+      batch_bytes += blob_index.size();
+    }
+
+    const Slice key = input_->key();
+    const Slice value = input_->value();
+    entries_.emplace_back();
+    entries_.back().key.assign(key.data(), key.size());
+    entries_.back().value.assign(value.data(), value.size());
+    entries_bytes_ += key.size() + value.size();
+
+    input_->Next();
+  }
+
+  if (range_del_agg_) {
+    // The lookahead moved the aggregator ahead of the compaction
+    range_del_agg_->InvalidateRangeDelMapPositions();
+  }
+
+  // blobs_ is sorted by file number and offset, so the blobs of each file
+  // are read sequentially
+  auto it = blobs_.begin();
+  while (it != blobs_.end()) {
+    const uint64_t blob_file_number = it->first.first;
+
+    autovector<std::reference_wrapper<const Slice>> user_keys;
+    autovector<Slice> user_key_slices;
+    autovector<std::reference_wrapper<const BlobIndex>> blob_indexes;
+    autovector<Status*> statuses;
+    autovector<PinnableSlice*> values;
+    for (; it != blobs_.end() && it->first.first == blob_file_number; ++it) {
+      Blob& blob = it->second;
+      user_key_slices.emplace_back(blob.user_key);
+      blob_indexes.emplace_back(std::cref(blob.blob_index));
+      statuses.push_back(&blob.status);
+      values.push_back(&blob.value);
+    }
+    for (const Slice& user_key : user_key_slices) {
+      user_keys.emplace_back(std::cref(user_key));
+    }
+
+    TEST_SYNC_POINT_CALLBACK("BlobGarbageCollectionBatcher::ReadBatch",
+                             &blob_indexes);
+
+    uint64_t bytes_read = 0;
+    blob_fetcher_->FetchBlobs(blob_file_number, user_keys, blob_indexes,
+                              statuses, values, &bytes_read);
+    unreported_bytes_read_ += bytes_read;
+  }
+}
+
+bool BlobGarbageCollectionBatcher::ShouldBatch(Slice* user_key,
+                                               BlobIndex* blob_index) {
+  assert(user_key);
+  assert(blob_index);
+
+  ParsedInternalKey parsed_key;
+  const Status pik_status =
+      ParseInternalKey(input_->key(), &parsed_key, false /* log_err_key */);
+  if (!pik_status.ok()) {
+    // Errors are reported by the compaction when it gets there
+    return false;
+  }
+
+  // Older versions of a user key are dropped unless a snapshot needs them
+  if (has_last_user_key_ &&
+      user_comparator_->Equal(parsed_key.user_key, last_user_key_)) {
+    return false;
+  }
+  last_user_key_.assign(parsed_key.user_key.data(),
+                        parsed_key.user_key.size());
+  has_last_user_key_ = true;
+
+  if (parsed_key.type != kTypeBlobIndex) {
+    return false;
+  }
+
+  if (!blob_index->DecodeFrom(input_->value()).ok() ||
+      blob_index->IsInlined() || blob_index->HasTTL() ||
+      blob_index->file_number() >= cutoff_file_number_) {
+    return false;
+  }
+
+  if (range_del_agg_ &&
+      range_del_agg_->ShouldDelete(
+          parsed_key, RangeDelPositioningMode::kForwardTraversal)) {
+    return false;
+  }
+
+  *user_key = parsed_key.user_key;
+
+  return true;
+}
+
+void BlobGarbageCollectionBatcher::ReleaseBlobs() {
+  for (auto& entry : blobs_) {
+    // The remaining blobs are not needed by the compaction
+    entry.second.status.PermitUncheckedError();
+  }
+  blobs_.clear();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
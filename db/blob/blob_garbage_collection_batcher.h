@@ -0,0 +1,178 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "db/blob/blob_fetcher.h"
+#include "db/blob/blob_index.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class CompactionRangeDelAggregator;
+
+// An internal iterator that passes the compaction input through, and reads
+// the blobs relocated by blob garbage collection in batches rather than one at
+// a time. When the compaction asks for a blob that is not in the current
+// batch, the batcher reads ahead in the input for the blob references to
+// relocate, buffering the entries it passes over, and reads the blobs of each
+// blob file in ascending order of offset with a single MultiRead. Only the
+// newest entry of each user key that is not covered by a range tombstone is
+// considered, since the others are usually dropped by the compaction.
+// Designed to be accessed by a single thread only, like the (sub)compaction it
+// serves; only forward iteration is supported.
+class BlobGarbageCollectionBatcher : public InternalIterator {
+ public:
+  // Blobs in files numbered cutoff_file_number or higher are not relocated.
+  // range_del_agg, if not null, is the aggregator of the compaction, which
+  // holds the range tombstones of the input files opened so far.
+  BlobGarbageCollectionBatcher(InternalIterator* input,
+                               const Comparator* user_comparator,
+                               CompactionRangeDelAggregator* range_del_agg,
+                               std::unique_ptr<BlobFetcher>&& blob_fetcher,
+                               uint64_t cutoff_file_number,
+                               uint64_t batch_size)
+      : input_(input),
+        user_comparator_(user_comparator),
+        range_del_agg_(range_del_agg),
+        blob_fetcher_(std::move(blob_fetcher)),
+        cutoff_file_number_(cutoff_file_number),
+        batch_size_(batch_size) {
+    assert(input_);
+    assert(user_comparator_);
+    assert(blob_fetcher_);
+    assert(batch_size_ > 0);
+  }
+
+  ~BlobGarbageCollectionBatcher() override;
+
+  bool Valid() const override {
+    return !entries_.empty() || input_->Valid();
+  }
+
+  void SeekToFirst() override {
+    ClearEntries();
+    input_->SeekToFirst();
+  }
+
+  void Seek(const Slice& target) override {
+    ClearEntries();
+    input_->Seek(target);
+  }
+
+  void Next() override {
+    assert(Valid());
+
+    if (entries_.empty()) {
+      input_->Next();
+      return;
+    }
+
+    const Entry& entry = entries_.front();
+    entries_bytes_ -= entry.key.size() + entry.value.size();
+    entries_.pop_front();
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return entries_.empty() ? input_->key() : Slice(entries_.front().key);
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return entries_.empty() ? input_->value() : Slice(entries_.front().value);
+  }
+
+  // Errors of the input are reported once the entries read ahead of them
+  // have been consumed.
+  Status status() const override {
+    return entries_.empty() ? input_->status() : Status::OK();
+  }
+
+  // Unused InternalIterator methods
+  void SeekToLast() override { assert(false); }
+  void SeekForPrev(const Slice& /* target */) override { assert(false); }
+  void Prev() override { assert(false); }
+
+  // Fetches the blob referenced by the current entry, whose internal key is
+  // ikey. The blob is taken from the current batch if it is there; otherwise,
+  // the next batch is read starting at the current entry, unless the entry
+  // has already been looked at by the previous one. bytes_read is the number
+  // of bytes read from blob files by this call, which might be more or less
+  // than the size of the blob.
+  Status FetchBlob(const Slice& ikey, const Slice& user_key,
+                   const BlobIndex& blob_index, PinnableSlice* blob_value,
+                   uint64_t* bytes_read);
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string value;
+  };
+
+  struct Blob {
+    std::string user_key;
+    BlobIndex blob_index;
+    Status status;
+    PinnableSlice value;
+  };
+
+  void ClearEntries() {
+    entries_.clear();
+    entries_bytes_ = 0;
+    last_user_key_.clear();
+    has_last_user_key_ = false;
+  }
+
+  // Looks up the blob referenced by blob_index in the current batch, and
+  // moves it to *blob_value if found.
+  bool TakeBlob(const Slice& user_key, const BlobIndex& blob_index,
+                PinnableSlice* blob_value, Status* s);
+
+  // Reads ahead from the current entry, which must not be buffered yet,
+  // until batch_size bytes of blobs are collected or batch_size bytes of
+  // entries are buffered, then reads the blobs collected.
+  void ReadBatch();
+
+  // Returns whether the blob referenced by the current entry of the input
+  // should be part of the batch, and if so, the entry's user key and blob
+  // reference. Called on every entry read ahead, in order.
+  bool ShouldBatch(Slice* user_key, BlobIndex* blob_index);
+
+  // Drops the blobs of the current batch the compaction did not take
+  void ReleaseBlobs();
+
+  InternalIterator* input_;
+  const Comparator* user_comparator_;
+  CompactionRangeDelAggregator* range_del_agg_;
+  std::unique_ptr<BlobFetcher> blob_fetcher_;
+  uint64_t cutoff_file_number_;
+  uint64_t batch_size_;
+  // The entries read ahead of the input, starting with the current one. When
+  // empty, the current entry is that of the input.
+  std::deque<Entry> entries_;
+  uint64_t entries_bytes_ = 0;
+  // The user key of the last entry read ahead
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
+  // The blobs of the current batch, keyed by blob file number and offset
+  std::map<std::pair<uint64_t, uint64_t>, Blob> blobs_;
+  // The bytes read for the current batch that have not been reported yet
+  uint64_t unreported_bytes_read_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
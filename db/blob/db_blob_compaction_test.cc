@@ -708,6 +708,145 @@ TEST_F(DBBlobCompactionTest, CompactionReadaheadMerge) {
   Close();
 }
 
+TEST_F(DBBlobCompactionTest, CompactionBatchedGarbageCollection) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.blob_garbage_collection_batch_size = 100;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  constexpr int kNumKeys = 20;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "old_value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), "new_value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+
+  size_t num_single_reads = 0;
+  size_t num_batches = 0;
+  size_t num_batched_blobs = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::GetBlob:ReadFromFile",
+      [&num_single_reads](void* /* arg */) { ++num_single_reads; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobGarbageCollectionBatcher::ReadBatch", [&](void* arg) {
+        const auto* const blob_indexes =
+            static_cast<autovector<std::reference_wrapper<const BlobIndex>>*>(
+                arg);
+        ASSERT_FALSE(blob_indexes->empty());
+        for (size_t i = 1; i < blob_indexes->size(); ++i) {
+          ASSERT_EQ((*blob_indexes)[i - 1].get().file_number(),
+                    (*blob_indexes)[i].get().file_number());
+          ASSERT_LT((*blob_indexes)[i - 1].get().offset(),
+                    (*blob_indexes)[i].get().offset());
+        }
+        ++num_batches;
+        num_batched_blobs += blob_indexes->size();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), begin, end));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(num_single_reads, 0);
+  ASSERT_GT(num_batches, 1);
+  ASSERT_LT(num_batches, num_batched_blobs);
+
+#ifndef ROCKSDB_LITE
+  const auto& compaction_stats = GetCompactionStats();
+  ASSERT_GE(compaction_stats.size(), 2);
+  ASSERT_GT(compaction_stats[1].bytes_read_blob, 0);
+#endif  // ROCKSDB_LITE
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(Get(Key(i)),
+              (i % 2 == 0 ? "new_value" : "old_value") + ToString(i));
+  }
+
+  Close();
+}
+
+TEST_F(DBBlobCompactionTest, CompactionBatchedGarbageCollectionSkipsGarbage) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.blob_garbage_collection_batch_size = 1 << 20;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  constexpr int kNumKeys = 30;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "old_value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+
+  // Overwrite the even keys and delete the middle third of the keys, so that
+  // the lookahead passes over both older versions and deleted keys
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), "new_value" + ToString(i)));
+  }
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(kNumKeys / 3), Key(2 * kNumKeys / 3)));
+  ASSERT_OK(Flush());
+
+  size_t num_single_reads = 0;
+  size_t num_batches = 0;
+  size_t num_batched_blobs = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::GetBlob:ReadFromFile",
+      [&num_single_reads](void* /* arg */) { ++num_single_reads; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobGarbageCollectionBatcher::ReadBatch", [&](void* arg) {
+        const auto* const blob_indexes =
+            static_cast<autovector<std::reference_wrapper<const BlobIndex>>*>(
+                arg);
+        ++num_batches;
+        num_batched_blobs += blob_indexes->size();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), begin, end));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // A single lookahead covers the whole input, and reads the blobs of each of
+  // the two blob files
+  ASSERT_EQ(num_single_reads, 0);
+  ASSERT_EQ(num_batches, 2);
+  ASSERT_EQ(num_batched_blobs, kNumKeys - kNumKeys / 3);
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    if (i >= kNumKeys / 3 && i < 2 * kNumKeys / 3) {
+      ASSERT_EQ(Get(Key(i)), "NOT_FOUND");
+    } else {
+      ASSERT_EQ(Get(Key(i)),
+                (i % 2 == 0 ? "new_value" : "old_value") + ToString(i));
+    }
+  }
+
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
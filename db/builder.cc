@@ -198,17 +198,14 @@ Status BuildTable(
         /*manual_compaction_canceled=*/nullptr, db_options.info_log,
         full_history_ts_low);
 
-    c_iter.SeekToFirst();
-    for (; c_iter.Valid(); c_iter.Next()) {
-      const Slice& key = c_iter.key();
-      const Slice& value = c_iter.value();
-      const ParsedInternalKey& ikey = c_iter.ikey();
+    auto add_to_table = [&](const Slice& key, const Slice& value,
+                            const ParsedInternalKey& ikey) {
       // Generate a rolling 64-bit hash of the key and values
       // Note :
       // Here "key" integrates 'sequence_number'+'kType'+'user key'.
-      s = output_validator.Add(key, value);
-      if (!s.ok()) {
-        break;
+      Status status = output_validator.Add(key, value);
+      if (!status.ok()) {
+        return status;
       }
       builder->Add(key, value);
       meta->UpdateBoundaries(key, value, ikey.sequence, ikey.type);
@@ -219,11 +216,76 @@ Status BuildTable(
         ThreadStatusUtil::SetThreadOperationProperty(
             ThreadStatus::FLUSH_BYTES_WRITTEN, IOSTATS(bytes_written));
       }
+      return status;
+    };
+
+    // Without snapshots, range deletions, compaction filter, blob files or
+    // user timestamps, CompactionIterator only keeps the newest entry of
+    // each user key as long as the entries are puts and deletes. Such
+    // entries are added straight from the input, sparing the key copies and
+    // bookkeeping of CompactionIterator. The first user key starting with
+    // any other entry type hands the rest of the input over to it.
+    const Comparator* ucmp = tboptions.internal_comparator.user_comparator();
+    uint64_t num_direct_input_entries = 0;
+    uint64_t direct_input_raw_key_bytes = 0;
+    uint64_t direct_input_raw_value_bytes = 0;
+    if (snapshots.empty() && snapshot_checker == nullptr &&
+        compaction_filter == nullptr && blob_file_builder == nullptr &&
+        range_del_agg->IsEmpty() && ucmp->timestamp_size() == 0) {
+      // Only copied if the input does not pin its keys
+      std::string last_user_key_buf;
+      Slice last_user_key;
+      bool has_last_user_key = false;
+      for (; iter->Valid(); iter->Next()) {
+        const Slice key = iter->key();
+        ParsedInternalKey ikey;
+        if (!ParseInternalKey(key, &ikey, ioptions.allow_data_in_errors)
+                 .ok()) {
+          // Left to CompactionIterator to report
+          break;
+        }
+        if (!has_last_user_key || !ucmp->Equal(ikey.user_key, last_user_key)) {
+          if (ikey.type != kTypeValue && ikey.type != kTypeDeletion) {
+            break;
+          }
+          s = add_to_table(key, iter->value(), ikey);
+          if (!s.ok()) {
+            break;
+          }
+          if (iter->IsKeyPinned()) {
+            last_user_key = ikey.user_key;
+          } else {
+            last_user_key_buf.assign(ikey.user_key.data(),
+                                     ikey.user_key.size());
+            last_user_key = last_user_key_buf;
+          }
+          has_last_user_key = true;
+        }
+        ++num_direct_input_entries;
+        direct_input_raw_key_bytes += key.size();
+        direct_input_raw_value_bytes += iter->value().size();
+      }
     }
-    if (!s.ok()) {
+
+    if (s.ok() && iter->Valid()) {
+      TEST_SYNC_POINT("BuildTable:CompactionIterator");
+      c_iter.SeekToFirst();
+      for (; c_iter.Valid(); c_iter.Next()) {
+        s = add_to_table(c_iter.key(), c_iter.value(), c_iter.ikey());
+        if (!s.ok()) {
+          break;
+        }
+      }
+      if (!s.ok()) {
+        c_iter.status().PermitUncheckedError();
+      } else if (!c_iter.status().ok()) {
+        s = c_iter.status();
+      }
+    } else {
       c_iter.status().PermitUncheckedError();
-    } else if (!c_iter.status().ok()) {
-      s = c_iter.status();
+      if (s.ok()) {
+        s = iter->status();
+      }
     }
 
     if (s.ok()) {
@@ -242,8 +304,9 @@ Status BuildTable(
     TEST_SYNC_POINT("BuildTable:BeforeFinishBuildTable");
     const bool empty = builder->IsEmpty();
     if (num_input_entries != nullptr) {
-      *num_input_entries =
-          c_iter.num_input_entry_scanned() + num_unfragmented_tombstones;
+      *num_input_entries = num_direct_input_entries +
+                           c_iter.num_input_entry_scanned() +
+                           num_unfragmented_tombstones;
     }
     if (!s.ok() || empty) {
       builder->Abandon();
@@ -257,15 +320,18 @@ Status BuildTable(
     if (s.ok() && !empty) {
       uint64_t file_size = builder->FileSize();
       meta->fd.file_size = file_size;
+      meta->tail_size = builder->GetTailSize();
       meta->marked_for_compaction = builder->NeedCompact();
       assert(meta->fd.GetFileSize() > 0);
       tp = builder->GetTableProperties(); // refresh now that builder is finished
       if (memtable_payload_bytes != nullptr &&
           memtable_garbage_bytes != nullptr) {
         const CompactionIterationStats& ci_stats = c_iter.iter_stats();
-        uint64_t total_payload_bytes = ci_stats.total_input_raw_key_bytes +
-                                       ci_stats.total_input_raw_value_bytes +
-                                       total_tombstone_payload_bytes;
+        uint64_t total_payload_bytes =
+            direct_input_raw_key_bytes + direct_input_raw_value_bytes +
+            ci_stats.total_input_raw_key_bytes +
+            ci_stats.total_input_raw_value_bytes +
+            total_tombstone_payload_bytes;
         uint64_t total_payload_bytes_written =
             (tp.raw_key_size + tp.raw_value_size);
         // Prevent underflow, which may still happen at this point
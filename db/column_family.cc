@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <cmath>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -19,6 +20,7 @@
 #include "db/blob/blob_file_cache.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/db_impl/db_impl.h"
@@ -540,6 +542,9 @@ ColumnFamilyData::ColumnFamilyData(
       queued_for_flush_(false),
       queued_for_compaction_(false),
       prev_compaction_needed_bytes_(0),
+      prev_raw_write_stall_pressure_(0),
+      prev_write_stall_pressure_micros_(0),
+      write_stall_pressure_(0),
       allow_2pc_(db_options.allow_2pc),
       last_memtable_id_(0),
       db_paths_registered_(false) {
@@ -574,7 +579,11 @@ ColumnFamilyData::ColumnFamilyData(
         new BlobFileCache(_table_cache, ioptions(), soptions(), id_,
                           internal_stats_->GetBlobFileReadHist(), io_tracer));
 
-    if (ioptions_.compaction_style == kCompactionStyleLevel) {
+    if (ioptions_.compaction_style == kCompactionStyleLevel &&
+        ioptions_.compaction_options_hybrid.leveled_levels > 0) {
+      compaction_picker_.reset(
+          new HybridCompactionPicker(ioptions_, &internal_comparator_));
+    } else if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
           new LevelCompactionPicker(ioptions_, &internal_comparator_));
 #ifndef ROCKSDB_LITE
@@ -737,6 +746,9 @@ const double kIncSlowdownRatio = 0.8;
 const double kDecSlowdownRatio = 1 / kIncSlowdownRatio;
 const double kNearStopSlowdownRatio = 0.6;
 const double kDelayRecoverSlowdownRatio = 1.4;
+// The write stall pressure is raised by how much it rose over the last
+// second, see DBOptions::smooth_write_stalls
+const uint64_t kWriteStallPressureRiseMicros = 1000000;
 
 namespace {
 // If penalize_stop is true, we further reduce slowdown rate.
@@ -803,6 +815,26 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
   return write_controller->GetDelayToken(write_rate);
 }
 
+std::unique_ptr<WriteControllerToken> SetupSmoothedDelay(
+    WriteController* write_controller, double write_stall_pressure,
+    bool auto_comapctions_disabled) {
+  const uint64_t kMinWriteRate = 16 * 1024u;  // Minimum write rate 16KB/s.
+
+  uint64_t max_write_rate = write_controller->max_delayed_write_rate();
+  uint64_t write_rate = max_write_rate;
+  if (!auto_comapctions_disabled && max_write_rate > kMinWriteRate) {
+    // Goes from max_write_rate at pressure 0 to kMinWriteRate at pressure 1
+    // on a log scale, so that each step of pressure slows writes down by the
+    // same ratio.
+    write_rate = static_cast<uint64_t>(
+        static_cast<double>(max_write_rate) *
+        std::pow(static_cast<double>(kMinWriteRate) / max_write_rate,
+                 write_stall_pressure));
+    write_rate = std::max(write_rate, kMinWriteRate);
+  }
+  return write_controller->GetCombinedDelayToken(write_rate);
+}
+
 int GetL0ThresholdSpeedupCompaction(int level0_file_num_compaction_trigger,
                                     int level0_slowdown_writes_trigger) {
   // SanitizeOptions() ensures it.
@@ -874,6 +906,59 @@ ColumnFamilyData::GetWriteStallConditionAndCause(
   return {WriteStallCondition::kNormal, WriteStallCause::kNone};
 }
 
+double ColumnFamilyData::GetWriteStallPressure(
+    int num_unflushed_memtables, int num_l0_files,
+    uint64_t num_compaction_needed_bytes,
+    const MutableCFOptions& mutable_cf_options,
+    const ImmutableCFOptions& immutable_cf_options) {
+  // Counts delay writes from `slowdown` on and stop them at `stop`
+  auto count_pressure = [](int count, int slowdown, int stop) {
+    if (count < slowdown) {
+      return 0.0;
+    }
+    if (count >= stop) {
+      return 1.0;
+    }
+    return static_cast<double>(count - slowdown) / (stop - slowdown);
+  };
+
+  double pressure = 0;
+  if (mutable_cf_options.max_write_buffer_number > 3) {
+    // From the memtables that trigger a flush to the ones that stop writes
+    pressure = count_pressure(
+        num_unflushed_memtables,
+        immutable_cf_options.min_write_buffer_number_to_merge,
+        mutable_cf_options.max_write_buffer_number);
+  }
+  if (mutable_cf_options.disable_auto_compactions) {
+    return pressure;
+  }
+  if (mutable_cf_options.level0_slowdown_writes_trigger >= 0) {
+    pressure = std::max(
+        pressure,
+        count_pressure(num_l0_files,
+                       mutable_cf_options.level0_slowdown_writes_trigger,
+                       std::max(mutable_cf_options.level0_stop_writes_trigger,
+                                mutable_cf_options
+                                    .level0_slowdown_writes_trigger)));
+  }
+  const uint64_t soft_limit =
+      mutable_cf_options.soft_pending_compaction_bytes_limit;
+  if (soft_limit > 0 && num_compaction_needed_bytes > soft_limit) {
+    // Without a hard limit, pressure is full at twice the soft limit
+    const uint64_t hard_limit =
+        mutable_cf_options.hard_pending_compaction_bytes_limit > soft_limit
+            ? mutable_cf_options.hard_pending_compaction_bytes_limit
+            : 2 * soft_limit;
+    pressure = std::max(
+        pressure,
+        std::min(1.0, static_cast<double>(num_compaction_needed_bytes -
+                                          soft_limit) /
+                          static_cast<double>(hard_limit - soft_limit)));
+  }
+  return pressure;
+}
+
 WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     const MutableCFOptions& mutable_cf_options, RateLimiter* rate_limiter) {
   auto write_stall_condition = WriteStallCondition::kNormal;
@@ -893,6 +978,47 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     bool was_stopped = write_controller->IsStopped();
     bool needed_delay = write_controller->NeedsDelay();
 
+    const bool smooth_write_stalls =
+        column_family_set_->db_options_->smooth_write_stalls;
+    const double raw_write_stall_pressure = GetWriteStallPressure(
+        imm()->NumNotFlushed(), vstorage->l0_delay_trigger_count(),
+        compaction_needed_bytes, mutable_cf_options, *ioptions());
+    // Assumes the pressure rose steadily since the last recalculation to
+    // scale its rise to kWriteStallPressureRiseMicros
+    const uint64_t now_micros = ioptions_.clock->NowMicros();
+    const uint64_t elapsed_micros =
+        now_micros > prev_write_stall_pressure_micros_
+            ? now_micros - prev_write_stall_pressure_micros_
+            : 0;
+    double write_stall_pressure_rise =
+        raw_write_stall_pressure - prev_raw_write_stall_pressure_;
+    if (elapsed_micros > kWriteStallPressureRiseMicros) {
+      write_stall_pressure_rise *=
+          static_cast<double>(kWriteStallPressureRiseMicros) / elapsed_micros;
+    }
+    write_stall_pressure_ = std::min(
+        1.0, std::max(0.0,
+                      raw_write_stall_pressure + write_stall_pressure_rise));
+    prev_raw_write_stall_pressure_ = raw_write_stall_pressure;
+    prev_write_stall_pressure_micros_ = now_micros;
+    if (smooth_write_stalls &&
+        write_stall_condition == WriteStallCondition::kNormal &&
+        raw_write_stall_pressure > 0) {
+      // Only the memtables put pressure on writes before their own delay
+      // threshold
+      write_stall_condition = WriteStallCondition::kDelayed;
+      write_stall_cause = WriteStallCause::kMemtableLimit;
+    }
+    auto setup_delay = [&](bool penalize_stop) {
+      if (smooth_write_stalls) {
+        return SetupSmoothedDelay(write_controller, write_stall_pressure_,
+                                  mutable_cf_options.disable_auto_compactions);
+      }
+      return SetupDelay(write_controller, compaction_needed_bytes,
+                        prev_compaction_needed_bytes_, penalize_stop,
+                        mutable_cf_options.disable_auto_compactions);
+    };
+
     if (write_stall_condition == WriteStallCondition::kStopped &&
         write_stall_cause == WriteStallCause::kMemtableLimit &&
         !mutable_cf_options.disable_write_stall) {
@@ -930,10 +1056,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     } else if (write_stall_condition == WriteStallCondition::kDelayed &&
                write_stall_cause == WriteStallCause::kMemtableLimit &&
                !mutable_cf_options.disable_write_stall) {
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped,
-                     mutable_cf_options.disable_auto_compactions);
+      write_controller_token_ = setup_delay(was_stopped);
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_LIMIT_SLOWDOWNS, 1);
       ROCKS_LOG_WARN(
           ioptions_.logger,
@@ -949,10 +1072,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       // L0 is the last two files from stopping.
       bool near_stop = vstorage->l0_delay_trigger_count() >=
                        mutable_cf_options.level0_stop_writes_trigger - 2;
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+      write_controller_token_ = setup_delay(was_stopped || near_stop);
       internal_stats_->AddCFStats(InternalStats::L0_FILE_COUNT_LIMIT_SLOWDOWNS,
                                   1);
       if (compaction_picker_->IsLevel0CompactionInProgress()) {
@@ -978,10 +1098,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
                    mutable_cf_options.soft_pending_compaction_bytes_limit) /
                   4;
 
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+      write_controller_token_ = setup_delay(was_stopped || near_stop);
       internal_stats_->AddCFStats(
           InternalStats::PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS, 1);
       ROCKS_LOG_WARN(
@@ -1031,8 +1148,10 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       // increase signal.
       if (needed_delay) {
         uint64_t write_rate = write_controller->delayed_write_rate();
-        write_controller->set_delayed_write_rate(static_cast<uint64_t>(
-            static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
+        if (!smooth_write_stalls) {
+          write_controller->set_delayed_write_rate(static_cast<uint64_t>(
+              static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
+        }
         // Set the low pri limit to be 1/4 the delayed write rate.
         // Note we don't reset this value even after delay condition is relased.
         // Low-pri rate will continue to apply if there is a compaction
@@ -1100,6 +1219,14 @@ bool ColumnFamilyData::NeedsCompaction() const {
          compaction_picker_->NeedsCompaction(current_->storage_info());
 }
 
+TaskCostEstimate ColumnFamilyData::EstimateNextCompaction() const {
+  TaskCostEstimate estimate = compaction_picker_->EstimateNextCompaction(
+      current_->storage_info(), mutable_cf_options_);
+  estimate.cpu_micros = static_cast<uint64_t>(
+      estimate.io_bytes * internal_stats_->GetCompactionCpuMicrosPerByte());
+  return estimate;
+}
+
 Compaction* ColumnFamilyData::PickCompaction(
     const MutableCFOptions& mutable_options,
     const MutableDBOptions& mutable_db_options, LogBuffer* log_buffer) {
@@ -1402,6 +1529,33 @@ Status ColumnFamilyData::ValidateOptions(
         "Multi thread write is only supported with no successive merges");
   }
 
+  const CompactionOptionsHybrid& hybrid = cf_options.compaction_options_hybrid;
+  if (hybrid.leveled_levels < 0) {
+    return Status::InvalidArgument(
+        "compaction_options_hybrid.leveled_levels should not be negative");
+  }
+  if (hybrid.leveled_levels > 0) {
+    if (cf_options.compaction_style != kCompactionStyleLevel) {
+      return Status::InvalidArgument(
+          "Hybrid compaction is only supported with kCompactionStyleLevel");
+    }
+    if (cf_options.level_compaction_dynamic_level_bytes) {
+      return Status::NotSupported(
+          "Hybrid compaction is not supported with "
+          "level_compaction_dynamic_level_bytes");
+    }
+    if (hybrid.leveled_levels >= cf_options.num_levels - 1) {
+      return Status::InvalidArgument(
+          "compaction_options_hybrid.leveled_levels should be less than "
+          "num_levels - 1");
+    }
+    if (cf_options.cf_paths.size() > 1 ||
+        (cf_options.cf_paths.empty() && db_options.db_paths.size() > 1)) {
+      return Status::NotSupported(
+          "Hybrid compaction does not support more than one DB or CF path");
+    }
+  }
+
   return s;
 }
 
@@ -25,6 +25,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "trace_replay/block_cache_tracer.h"
+#include "util/concurrent_task_limiter_impl.h"
 #include "util/thread_local.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -379,6 +380,10 @@ class ColumnFamilyData {
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
   bool NeedsCompaction() const;
+  // Estimates the cost and benefit of the next compaction, for cost-aware
+  // compaction thread limiters.
+  // REQUIRES: DB mutex held
+  TaskCostEstimate EstimateNextCompaction() const;
   // REQUIRES: DB mutex held
   Compaction* PickCompaction(const MutableCFOptions& mutable_options,
                              const MutableDBOptions& mutable_db_options,
@@ -476,6 +481,17 @@ class ColumnFamilyData {
       const MutableCFOptions& mutable_cf_options,
       const ImmutableCFOptions& immutable_cf_options);
 
+  // Returns how close the column family is to stopping writes, from 0 at
+  // the thresholds that delay writes to 1 at the ones that stop them, for
+  // whichever of the memtables, L0 files and pending compaction bytes is
+  // closest. The memtables count from the ones that trigger a flush. Used
+  // with DBOptions::smooth_write_stalls.
+  static double GetWriteStallPressure(
+      int num_unflushed_memtables, int num_l0_files,
+      uint64_t num_compaction_needed_bytes,
+      const MutableCFOptions& mutable_cf_options,
+      const ImmutableCFOptions& immutable_cf_options);
+
   // Recalculate some small conditions, which are changed only during
   // compaction, adding new memtable and/or
   // recalculation of compaction score. These values are used in
@@ -485,6 +501,11 @@ class ColumnFamilyData {
       const MutableCFOptions& mutable_cf_options,
       RateLimiter* rate_limiter = nullptr);
 
+  // The write stall pressure found by the last
+  // RecalculateWriteStallConditions(), including its rise over the last
+  // second. REQUIRES: DB mutex held
+  double write_stall_pressure() const { return write_stall_pressure_; }
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -604,6 +625,10 @@ class ColumnFamilyData {
   bool queued_for_compaction_;
 
   uint64_t prev_compaction_needed_bytes_;
+  // See GetWriteStallPressure()
+  double prev_raw_write_stall_pressure_;
+  uint64_t prev_write_stall_pressure_micros_;
+  double write_stall_pressure_;
 
   // if the database was opened with 2pc enabled
   bool allow_2pc_;
@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include <algorithm>
+#include <cmath>
 #include <string>
 #include <thread>
 #include <vector>
@@ -2872,6 +2873,121 @@ TEST_P(ColumnFamilyTest, WriteStallTwoColumnFamilies) {
   ASSERT_EQ(kBaseRate / 1.25, GetDbDelayedWriteRate());
 }
 
+TEST_P(ColumnFamilyTest, SmoothWriteStallTwoColumnFamilies) {
+  const uint64_t kBaseRate = 16u << 20;
+  db_options_.delayed_write_rate = kBaseRate;
+  db_options_.smooth_write_stalls = true;
+  env_->SetMockSleep();
+  Open();
+  CreateColumnFamilies({"one"});
+  ColumnFamilyData* cfd =
+      static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())->cfd();
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+
+  ColumnFamilyData* cfd1 =
+      static_cast<ColumnFamilyHandleImpl*>(handles_[1])->cfd();
+  VersionStorageInfo* vstorage1 = cfd1->current()->storage_info();
+
+  MutableCFOptions mutable_cf_options(column_family_options_);
+  mutable_cf_options.level0_slowdown_writes_trigger = 20;
+  mutable_cf_options.level0_stop_writes_trigger = 10000;
+  mutable_cf_options.soft_pending_compaction_bytes_limit = 200;
+  mutable_cf_options.hard_pending_compaction_bytes_limit = 2000;
+  mutable_cf_options.disable_auto_compactions = false;
+
+  // From kBaseRate at pressure 0 to 16KB/s at pressure 1, on a log scale
+  auto rate_at = [&](double pressure) {
+    return static_cast<uint64_t>(
+        static_cast<double>(kBaseRate) *
+        std::pow(16384.0 / static_cast<double>(kBaseRate), pressure));
+  };
+  auto pressure_pct = [&](ColumnFamilyHandle* handle) {
+    uint64_t v = 0;
+    EXPECT_TRUE(
+        db_->GetIntProperty(handle, DB::Properties::kWriteStallPressure, &v));
+    return v;
+  };
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+  ASSERT_EQ(0, pressure_pct(handles_[0]));
+
+  // L0 files add pressure from 0 at the slowdown trigger to 1 at the stop
+  // trigger
+  ASSERT_EQ(0.0, ColumnFamilyData::GetWriteStallPressure(
+                     1, 20, 0, mutable_cf_options, *cfd->ioptions()));
+  ASSERT_EQ(0.5, ColumnFamilyData::GetWriteStallPressure(
+                     1, 5010, 0, mutable_cf_options, *cfd->ioptions()));
+  ASSERT_EQ(1.0, ColumnFamilyData::GetWriteStallPressure(
+                     1, 10000, 0, mutable_cf_options, *cfd->ioptions()));
+
+  // Unflushed memtables add pressure from 0 at the flush trigger to 1 at
+  // max_write_buffer_number
+  MutableCFOptions memtable_cf_options = mutable_cf_options;
+  memtable_cf_options.max_write_buffer_number = 5;
+  ASSERT_EQ(1, cfd->ioptions()->min_write_buffer_number_to_merge);
+  ASSERT_EQ(0.0, ColumnFamilyData::GetWriteStallPressure(
+                     1, 0, 0, memtable_cf_options, *cfd->ioptions()));
+  ASSERT_EQ(0.5, ColumnFamilyData::GetWriteStallPressure(
+                     3, 0, 0, memtable_cf_options, *cfd->ioptions()));
+  ASSERT_EQ(1.0, ColumnFamilyData::GetWriteStallPressure(
+                     5, 0, 0, memtable_cf_options, *cfd->ioptions()));
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(200);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(dbfull()->TEST_write_controler().NeedsDelay());
+  ASSERT_EQ(kBaseRate, GetDbDelayedWriteRate());
+
+  // A quarter of the way to the hard limit, plus as much for the rise
+  vstorage->TEST_set_estimated_compaction_needed_bytes(650);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(50, pressure_pct(handles_[0]));
+  ASSERT_EQ(rate_at(0.5), GetDbDelayedWriteRate());
+
+  // The same rate for the same pressure, however long it lasts
+  for (int i = 0; i < 3; i++) {
+    RecalculateWriteStallConditions(cfd, mutable_cf_options);
+    ASSERT_EQ(25, pressure_pct(handles_[0]));
+    ASSERT_EQ(rate_at(0.25), GetDbDelayedWriteRate());
+  }
+
+  // The lowest rate of the column families applies
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(1100);
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(100, pressure_pct(handles_[1]));
+  ASSERT_EQ(rate_at(1.0), GetDbDelayedWriteRate());
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(50, pressure_pct(handles_[1]));
+  ASSERT_EQ(rate_at(0.5), GetDbDelayedWriteRate());
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(200);
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(0, pressure_pct(handles_[1]));
+  ASSERT_EQ(rate_at(0.25), GetDbDelayedWriteRate());
+
+  // A rise spread over three seconds counts for a third
+  env_->MockSleepForSeconds(3);
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(1100);
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(67, pressure_pct(handles_[1]));
+  ASSERT_LT(GetDbDelayedWriteRate(), rate_at(0.5));
+  ASSERT_GT(GetDbDelayedWriteRate(), rate_at(0.75));
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(50, pressure_pct(handles_[1]));
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(200);
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_EQ(0, pressure_pct(handles_[1]));
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(dbfull()->TEST_write_controler().NeedsDelay());
+  ASSERT_EQ(kBaseRate, GetDbDelayedWriteRate());
+
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd1, mutable_cf_options);
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+}
+
 TEST_P(ColumnFamilyTest, CompactionSpeedupTwoColumnFamilies) {
   db_options_.max_background_compactions = 6;
   column_family_options_.soft_pending_compaction_bytes_limit = 200;
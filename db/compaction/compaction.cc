@@ -577,6 +577,12 @@ std::unique_ptr<SstPartitioner> Compaction::CreateSstPartitioner() const {
   context.output_level = output_level_;
   context.smallest_user_key = smallest_user_key_;
   context.largest_user_key = largest_user_key_;
+  context.comparator = input_vstorage_->InternalComparator()->user_comparator();
+  context.target_output_file_size = max_output_file_size_;
+  context.next_level_boundaries.reserve(grandparents_.size());
+  for (const FileMetaData* f : grandparents_) {
+    context.next_level_boundaries.push_back(f->largest.user_key());
+  }
   return immutable_options_.sst_partitioner_factory->CreatePartitioner(context);
 }
 
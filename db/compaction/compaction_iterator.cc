@@ -10,6 +10,7 @@
 
 #include "db/blob/blob_fetcher.h"
 #include "db/blob/blob_file_builder.h"
+#include "db/blob/blob_garbage_collection_batcher.h"
 #include "db/blob/blob_index.h"
 #include "db/blob/prefetch_buffer_collection.h"
 #include "db/snapshot_checker.h"
@@ -62,7 +63,9 @@ CompactionIterator::CompactionIterator(
     const std::atomic<bool>* manual_compaction_canceled,
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low)
-    : input_(input, cmp,
+    : blob_gc_batcher_(CreateBlobGarbageCollectionBatcherIfNeeded(
+          compaction.get(), input, cmp, range_del_agg)),
+      input_(blob_gc_batcher_ ? blob_gc_batcher_.get() : input, cmp,
              !compaction || compaction->DoesInputReferenceBlobFiles()),
       cmp_(cmp),
       merge_helper_(merge_helper),
@@ -972,18 +975,25 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
       return;
     }
 
-    FilePrefetchBuffer* prefetch_buffer =
-        prefetch_buffers_ ? prefetch_buffers_->GetOrCreatePrefetchBuffer(
-                                blob_index.file_number())
-                          : nullptr;
-
     uint64_t bytes_read = 0;
 
     {
-      assert(blob_fetcher_);
+      Status s;
 
-      const Status s = blob_fetcher_->FetchBlob(
-          user_key(), blob_index, prefetch_buffer, &blob_value_, &bytes_read);
+      if (blob_gc_batcher_) {
+        s = blob_gc_batcher_->FetchBlob(key_, user_key(), blob_index,
+                                        &blob_value_, &bytes_read);
+      } else {
+        FilePrefetchBuffer* prefetch_buffer =
+            prefetch_buffers_ ? prefetch_buffers_->GetOrCreatePrefetchBuffer(
+                                    blob_index.file_number())
+                              : nullptr;
+
+        assert(blob_fetcher_);
+
+        s = blob_fetcher_->FetchBlob(user_key(), blob_index, prefetch_buffer,
+                                     &blob_value_, &bytes_read);
+      }
 
       if (!s.ok()) {
         status_ = s;
@@ -1210,4 +1220,34 @@ CompactionIterator::CreatePrefetchBufferCollectionIfNeeded(
       new PrefetchBufferCollection(readahead_size));
 }
 
+std::unique_ptr<BlobGarbageCollectionBatcher>
+CompactionIterator::CreateBlobGarbageCollectionBatcherIfNeeded(
+    const CompactionProxy* compaction, InternalIterator* input,
+    const Comparator* cmp, CompactionRangeDelAggregator* range_del_agg) {
+  if (!compaction || !compaction->DoesInputReferenceBlobFiles()) {
+    return nullptr;
+  }
+
+  if (!compaction->enable_blob_garbage_collection()) {
+    return nullptr;
+  }
+
+  const uint64_t batch_size = compaction->blob_garbage_collection_batch_size();
+  if (!batch_size) {
+    return nullptr;
+  }
+
+  std::unique_ptr<BlobFetcher> blob_fetcher =
+      CreateBlobFetcherIfNeeded(compaction);
+  if (!blob_fetcher) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<BlobGarbageCollectionBatcher>(
+      new BlobGarbageCollectionBatcher(
+          input, cmp, range_del_agg, std::move(blob_fetcher),
+          ComputeBlobGarbageCollectionCutoffFileNumber(compaction),
+          batch_size));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -24,6 +24,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class BlobFileBuilder;
 class BlobFetcher;
+class BlobGarbageCollectionBatcher;
 class PrefetchBufferCollection;
 
 // A wrapper of internal iterator whose purpose is to count how
@@ -102,6 +103,8 @@ class CompactionIterator {
 
     virtual uint64_t blob_compaction_readahead_size() const = 0;
 
+    virtual uint64_t blob_garbage_collection_batch_size() const = 0;
+
     virtual const Version* input_version() const = 0;
 
     virtual bool DoesInputReferenceBlobFiles() const = 0;
@@ -158,6 +161,11 @@ class CompactionIterator {
       return compaction_->mutable_cf_options()->blob_compaction_readahead_size;
     }
 
+    uint64_t blob_garbage_collection_batch_size() const override {
+      return compaction_->mutable_cf_options()
+          ->blob_garbage_collection_batch_size;
+    }
+
     const Version* input_version() const override {
       return compaction_->input_version();
     }
@@ -307,7 +315,14 @@ class CompactionIterator {
       const CompactionProxy* compaction);
   static std::unique_ptr<PrefetchBufferCollection>
   CreatePrefetchBufferCollectionIfNeeded(const CompactionProxy* compaction);
-
+  static std::unique_ptr<BlobGarbageCollectionBatcher>
+  CreateBlobGarbageCollectionBatcherIfNeeded(
+      const CompactionProxy* compaction, InternalIterator* input,
+      const Comparator* cmp, CompactionRangeDelAggregator* range_del_agg);
+
+  // Wraps the input when the blobs relocated by garbage collection are read
+  // in batches, so it has to be initialized before input_.
+  std::unique_ptr<BlobGarbageCollectionBatcher> blob_gc_batcher_;
   SequenceIterWrapper input_;
   const Comparator* cmp_;
   MergeHelper* merge_helper_;
@@ -176,6 +176,8 @@ class FakeCompaction : public CompactionIterator::CompactionProxy {
 
   uint64_t blob_compaction_readahead_size() const override { return 0; }
 
+  uint64_t blob_garbage_collection_batch_size() const override { return 0; }
+
   const Version* input_version() const override { return nullptr; }
 
   bool DoesInputReferenceBlobFiles() const override { return false; }
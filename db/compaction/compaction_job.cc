@@ -112,6 +112,10 @@ const char* GetCompactionReasonString(CompactionReason compaction_reason) {
       return "ChangeTemperature";
     case CompactionReason::kForcedBlobGC:
       return "ForcedBlobGC";
+    case CompactionReason::kHybridSizeRatio:
+      return "HybridSizeRatio";
+    case CompactionReason::kHybridSortedRunNum:
+      return "HybridSortedRunNum";
     case CompactionReason::kNumOfReasons:
       // fall through
     default:
@@ -408,6 +412,10 @@ void CompactionJob::AggregateStatistics() {
     compact_->num_output_records += sc.num_output_records;
 
     compaction_job_stats_->Add(sc.compaction_job_stats);
+    if (compact_->sub_compact_states.size() > 1) {
+      compaction_job_stats_->subcompaction_elapsed_micros.push_back(
+          sc.compaction_job_stats.elapsed_micros);
+    }
   }
 }
 
@@ -564,105 +572,72 @@ void CompactionJob::Prepare() {
   }
 }
 
-struct RangeWithSize {
-  Range range;
-  uint64_t size;
-
-  RangeWithSize(const Slice& a, const Slice& b, uint64_t s = 0)
-      : range(a, b), size(s) {}
-};
-
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
-  std::vector<Slice> bounds;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
 
-  // Add the starting and/or ending key of certain input files as a potential
-  // boundary
+  // Sample anchor keys from the index of every input file, each weighted by
+  // the approximate size of the file's data between the previous anchor and
+  // it. Files whose table format cannot be sampled count as a single range
+  // ending at their largest key.
+  std::vector<TableReader::Anchor> anchors;
+  // Reading the index blocks could incur I/O. Unlock db mutex to reduce
+  // contention. The input version is referenced by the compaction and will
+  // not change.
+  db_mutex_->Unlock();
   for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
     int lvl = c->level(lvl_idx);
-    if (lvl >= start_lvl && lvl <= out_lvl) {
-      const LevelFilesBrief* flevel = c->input_levels(lvl_idx);
-      size_t num_files = flevel->num_files;
-
-      if (num_files == 0) {
-        continue;
-      }
-
-      if (lvl == 0) {
-        // For level 0 add the starting and ending key of each file since the
-        // files may have greatly differing key ranges (not range-partitioned)
-        for (size_t i = 0; i < num_files; i++) {
-          bounds.emplace_back(flevel->files[i].smallest_key);
-          bounds.emplace_back(flevel->files[i].largest_key);
-        }
-      } else {
-        // For all other levels add the smallest/largest key in the level to
-        // encompass the range covered by that level
-        bounds.emplace_back(flevel->files[0].smallest_key);
-        bounds.emplace_back(flevel->files[num_files - 1].largest_key);
-        if (lvl == out_lvl) {
-          // For the last level include the starting keys of all files since
-          // the last level is the largest and probably has the widest key
-          // range. Since it's range partitioned, the ending key of one file
-          // and the starting key of the next are very close (or identical).
-          for (size_t i = 1; i < num_files; i++) {
-            bounds.emplace_back(flevel->files[i].smallest_key);
-          }
-        }
+    if (lvl < start_lvl || lvl > out_lvl) {
+      continue;
+    }
+    const LevelFilesBrief* flevel = c->input_levels(lvl_idx);
+    for (size_t i = 0; i < flevel->num_files; i++) {
+      const FileMetaData* f = flevel->files[i].file_metadata;
+      const size_t num_anchors = anchors.size();
+      Status s = cfd->table_cache()->ApproximateKeyAnchors(
+          ReadOptions(), cfd->internal_comparator(), f->fd, &anchors,
+          c->mutable_cf_options()->prefix_extractor);
+      if (!s.ok() || anchors.size() == num_anchors) {
+        s.PermitUncheckedError();
+        anchors.resize(num_anchors, TableReader::Anchor(Slice(), 0));
+        anchors.emplace_back(ExtractUserKey(flevel->files[i].largest_key),
+                             f->fd.GetFileSize());
       }
     }
   }
+  db_mutex_->Lock();
 
-  std::sort(bounds.begin(), bounds.end(),
-            [cfd_comparator](const Slice& a, const Slice& b) -> bool {
-              return cfd_comparator->Compare(ExtractUserKey(a),
-                                             ExtractUserKey(b)) < 0;
+  std::sort(anchors.begin(), anchors.end(),
+            [cfd_comparator](const TableReader::Anchor& a,
+                             const TableReader::Anchor& b) -> bool {
+              return cfd_comparator->Compare(a.user_key, b.user_key) < 0;
             });
-  // Remove duplicated entries from bounds
-  bounds.erase(
-      std::unique(bounds.begin(), bounds.end(),
-                  [cfd_comparator](const Slice& a, const Slice& b) -> bool {
-                    return cfd_comparator->Compare(ExtractUserKey(a),
-                                                   ExtractUserKey(b)) == 0;
-                  }),
-      bounds.end());
-
-  // Combine consecutive pairs of boundaries into ranges with an approximate
-  // size of data covered by keys in that range
+  // Merge anchors of the same key, keeping the sum of their sizes
   uint64_t sum = 0;
-  std::vector<RangeWithSize> ranges;
-  // Get input version from CompactionState since it's already referenced
-  // earlier in SetInputVersioCompaction::SetInputVersion and will not change
-  // when db_mutex_ is released below
-  auto* v = compact_->compaction->input_version();
-  for (auto it = bounds.begin();;) {
-    const Slice a = *it;
-    ++it;
-
-    if (it == bounds.end()) {
-      break;
+  size_t num_unique = 0;
+  for (size_t i = 0; i < anchors.size(); i++) {
+    sum += anchors[i].range_size;
+    if (num_unique > 0 && cfd_comparator->Compare(
+                              anchors[num_unique - 1].user_key,
+                              anchors[i].user_key) == 0) {
+      anchors[num_unique - 1].range_size += anchors[i].range_size;
+    } else {
+      if (num_unique != i) {
+        anchors[num_unique] = std::move(anchors[i]);
+      }
+      num_unique++;
     }
-
-    const Slice b = *it;
-
-    // ApproximateSize could potentially create table reader iterator to seek
-    // to the index block and may incur I/O cost in the process. Unlock db
-    // mutex to reduce contention
-    db_mutex_->Unlock();
-    uint64_t size = versions_->ApproximateSize(SizeApproximationOptions(), v, a,
-                                               b, start_lvl, out_lvl + 1,
-                                               TableReaderCaller::kCompaction);
-    db_mutex_->Lock();
-    ranges.emplace_back(a, b, size);
-    sum += size;
   }
+  anchors.resize(num_unique, TableReader::Anchor(Slice(), 0));
 
-  // Group the ranges into subcompactions
+  // Split the key space into more ranges than there are threads, so that a
+  // thread that finishes early picks up remaining ranges instead of waiting
+  // for a straggler, but never into ranges smaller than an output file.
   const double min_file_fill_percent = 4.0 / 5;
+  auto* v = c->input_version();
   int base_level = v->storage_info()->base_level();
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
       sum / min_file_fill_percent /
@@ -671,34 +646,33 @@ void CompactionJob::GenSubcompactionBoundaries() {
           c->immutable_options()->compaction_style, base_level,
           c->immutable_options()->level_compaction_dynamic_level_bytes)));
   uint64_t subcompactions =
-      std::min({static_cast<uint64_t>(ranges.size()),
-                static_cast<uint64_t>(c->max_subcompactions()),
+      std::min({static_cast<uint64_t>(anchors.size()),
+                static_cast<uint64_t>(c->max_subcompactions()) *
+                    kRangesPerSubcompaction,
                 max_output_files});
 
   if (subcompactions > 1) {
     double mean = sum * 1.0 / subcompactions;
-    // Greedily add ranges to the subcompaction until the sum of the ranges'
-    // sizes becomes >= the expected mean size of a subcompaction
-    sum = 0;
-    for (size_t i = 0; i + 1 < ranges.size(); i++) {
-      sum += ranges[i].size;
-      if (subcompactions == 1) {
-        // If there's only one left to schedule then it goes to the end so no
-        // need to put an end boundary
-        continue;
-      }
-      if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
-        sizes_.emplace_back(sum);
-        subcompactions--;
-        sum = 0;
+    // Cut a range at the first anchor that takes the size covered so far to
+    // a multiple of the mean, so that rounding errors do not accumulate
+    uint64_t cumulative = 0;
+    uint64_t range_size = 0;
+    for (size_t i = 0; i + 1 < anchors.size(); i++) {
+      cumulative += anchors[i].range_size;
+      range_size += anchors[i].range_size;
+      if (boundary_keys_.size() + 1 < subcompactions &&
+          cumulative >= mean * (boundary_keys_.size() + 1)) {
+        boundary_keys_.push_back(anchors[i].user_key);
+        sizes_.emplace_back(range_size);
+        range_size = 0;
       }
     }
-    sizes_.emplace_back(sum + ranges.back().size);
+    sizes_.emplace_back(range_size + anchors.back().range_size);
   } else {
     // Only one range so its size is the total sum of sizes computed above
     sizes_.emplace_back(sum);
   }
+  boundaries_.assign(boundary_keys_.begin(), boundary_keys_.end());
 }
 
 Status CompactionJob::Run() {
@@ -707,22 +681,49 @@ Status CompactionJob::Run() {
   TEST_SYNC_POINT("CompactionJob::Run():Start");
   log_buffer_->FlushBufferToLog();
   LogCompaction();
-
-  const size_t num_threads = compact_->sub_compact_states.size();
-  assert(num_threads > 0);
+  FindHotKeyRanges();
+
+  const size_t num_subcompactions = compact_->sub_compact_states.size();
+  assert(num_subcompactions > 0);
+  const size_t num_threads = std::min(
+      num_subcompactions,
+      static_cast<size_t>(
+          std::max(compact_->compaction->max_subcompactions(), 1U)));
   const uint64_t start_micros = db_options_.clock->NowMicros();
 
-  // Launch a thread for each of subcompactions 1...num_threads-1
+  // Threads take the subcompactions from a shared queue, largest first, so
+  // that the ones left over at the end are short
+  std::vector<size_t> queue(num_subcompactions);
+  for (size_t i = 0; i < num_subcompactions; i++) {
+    queue[i] = i;
+  }
+  std::stable_sort(queue.begin(), queue.end(), [this](size_t a, size_t b) {
+    return compact_->sub_compact_states[a].approx_size >
+           compact_->sub_compact_states[b].approx_size;
+  });
+  std::atomic<size_t> next_in_queue(0);
+  auto process_subcompactions = [&]() {
+    size_t i;
+    while ((i = next_in_queue.fetch_add(1)) < num_subcompactions) {
+      SubcompactionState* sub_compact =
+          &compact_->sub_compact_states[queue[i]];
+      const uint64_t sub_start_micros = db_options_.clock->NowMicros();
+      ProcessKeyValueCompaction(sub_compact);
+      sub_compact->compaction_job_stats.elapsed_micros =
+          db_options_.clock->NowMicros() - sub_start_micros;
+    }
+  };
+
+  // Launch threads 1...num_threads-1
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
-                             &compact_->sub_compact_states[i]);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(process_subcompactions);
   }
 
-  // Always schedule the first subcompaction (whether or not there are also
-  // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(&compact_->sub_compact_states[0]);
+  // Always process subcompactions (whether or not there are also other
+  // threads) in the current thread to be efficient with resources
+  process_subcompactions();
 
   // Wait for all other threads (if there are any) to finish execution
   for (auto& thread : thread_pool) {
@@ -852,7 +853,7 @@ Status CompactionJob::Run() {
         }
       }
     };
-    for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
+    for (size_t i = 1; i < num_threads; i++) {
       thread_pool.emplace_back(verify_table,
                                std::ref(compact_->sub_compact_states[i].status));
     }
@@ -1874,6 +1875,7 @@ Status CompactionJob::FinishCompactionOutputFile(
   const uint64_t current_bytes = sub_compact->builder->FileSize();
   if (s.ok()) {
     meta->fd.file_size = current_bytes;
+    meta->tail_size = sub_compact->builder->GetTailSize();
     meta->marked_for_compaction = sub_compact->builder->NeedCompact();
     // With accurate smallest and largest key, we can get a slightly more
     // accurate oldest ancester time.
@@ -2216,6 +2218,7 @@ Status CompactionJob::OpenCompactionOutputFile(
       oldest_ancester_time, 0 /* oldest_key_time */, current_time, db_id_,
       db_session_id_, sub_compact->compaction->max_output_file_size(),
       file_number);
+  tboptions.hot_key_ranges = hot_key_ranges_.get();
   sub_compact->builder.reset(
       NewTableBuilder(tboptions, sub_compact->outfile.get()));
   LogFlush(db_options_.info_log);
@@ -2345,6 +2348,56 @@ void CompactionJob::UpdateCompactionJobStats(
 #endif  // !ROCKSDB_LITE
 }
 
+void CompactionJob::FindHotKeyRanges() {
+  Compaction* c = compact_->compaction;
+  const auto* table_options = c->immutable_options()
+                                  ->table_factory->GetOptions<
+                                      BlockBasedTableOptions>();
+  if (table_options == nullptr ||
+      table_options->prepopulate_block_cache !=
+          BlockBasedTableOptions::PrepopulateBlockCache::
+              kFlushAndHotCompaction ||
+      table_options->block_cache == nullptr) {
+    return;
+  }
+
+  ColumnFamilyData* cfd = c->column_family_data();
+  std::unique_ptr<HotKeyRanges> hot_key_ranges(
+      new HotKeyRanges(cfd->user_comparator()));
+  std::vector<TableReader::KeyRange> ranges;
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    const LevelFilesBrief* flevel = c->input_levels(lvl_idx);
+    for (size_t i = 0; i < flevel->num_files; i++) {
+      const FileMetaData* f = flevel->files[i].file_metadata;
+      ranges.clear();
+      Status s = cfd->table_cache()->GetCachedKeyRanges(
+          ReadOptions(), cfd->internal_comparator(), f->fd, &ranges,
+          c->mutable_cf_options()->prefix_extractor);
+      if (!s.ok()) {
+        // Not being able to tell the hot ranges only costs cache misses
+        ROCKS_LOG_WARN(db_options_.info_log,
+                       "[%s] [JOB %d] Cannot find the cached key ranges of "
+                       "table #%" PRIu64 ": %s",
+                       cfd->GetName().c_str(), job_id_, f->fd.GetNumber(),
+                       s.ToString().c_str());
+        continue;
+      }
+      for (const TableReader::KeyRange& range : ranges) {
+        hot_key_ranges->Add(
+            range.smallest.empty() ? f->smallest.user_key()
+                                   : Slice(range.smallest),
+            range.largest);
+      }
+    }
+  }
+  hot_key_ranges->Finish();
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::FindHotKeyRanges",
+                           hot_key_ranges.get());
+  if (!hot_key_ranges->empty()) {
+    hot_key_ranges_ = std::move(hot_key_ranges);
+  }
+}
+
 void CompactionJob::LogCompaction() {
   Compaction* compaction = compact_->compaction;
   ColumnFamilyData* cfd = compaction->column_family_data();
@@ -2446,6 +2499,7 @@ Status CompactionServiceCompactionJob::Run() {
 
   log_buffer_->FlushBufferToLog();
   LogCompaction();
+  FindHotKeyRanges();
   const uint64_t start_micros = db_options_.clock->NowMicros();
   // Pick the only sub-compaction we should have
   assert(compact_->sub_compact_states.size() == 1);
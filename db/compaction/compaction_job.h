@@ -39,6 +39,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/transaction_log.h"
+#include "table/hot_key_ranges.h"
 #include "table/scoped_arena_iterator.h"
 #include "util/autovector.h"
 #include "util/stop_watch.h"
@@ -116,6 +117,9 @@ class CompactionJob {
   void AggregateStatistics();
   void UpdateCompactionStats();
   void LogCompaction();
+  // Finds the key ranges of the input whose data blocks are in the block
+  // cache, for warming the block cache with the outputs covering them.
+  void FindHotKeyRanges();
   virtual void RecordCompactionIOStats();
   void CleanupCompaction();
 
@@ -138,11 +142,16 @@ class CompactionJob {
   IOStatus io_status_;
 
  private:
+  // Upper bound on the number of subcompactions per subcompaction thread.
+  // Threads take the subcompactions from a shared queue, so having more of
+  // them than threads evens out differences in their running times.
+  static constexpr uint64_t kRangesPerSubcompaction = 4;
+
   // Generates a histogram representing potential divisions of key ranges from
-  // the input. It adds the starting and/or ending keys of certain input files
-  // to the working set and then finds the approximate size of data in between
-  // each consecutive pair of slices. Then it divides these ranges into
-  // consecutive groups such that each group has a similar size.
+  // the input. It samples anchor keys from the index of every input file,
+  // each weighted by the approximate size of the data it covers. Then it
+  // divides the key space at these anchors into consecutive ranges of
+  // similar size.
   void GenSubcompactionBoundaries();
 
   CompactionServiceJobStatus ProcessKeyValueCompactionWithCompactionService(
@@ -210,13 +219,18 @@ class CompactionJob {
 
   bool paranoid_file_checks_;
   bool measure_io_stats_;
-  // Stores the Slices that designate the boundaries for each subcompaction
+  // Stores the keys that designate the boundaries for each subcompaction
+  std::vector<std::string> boundary_keys_;
+  // Slices of boundary_keys_
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
   Env::Priority thread_pri_;
   std::string full_history_ts_low_;
   BlobFileCompletionCallback* blob_callback_;
+  // Key ranges whose output data blocks are inserted into the block cache,
+  // or nullptr if no output block is.
+  std::unique_ptr<HotKeyRanges> hot_key_ranges_;
 
   uint64_t GetCompactionId(SubcompactionState* sub_compact);
 
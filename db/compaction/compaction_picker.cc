@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction_picker.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <limits>
 #include <queue>
@@ -82,6 +83,14 @@ bool FindIntraL0Compaction(const std::vector<FileMetaData*>& level_files,
     }
     compact_bytes_per_del_file = new_compact_bytes_per_del_file;
   }
+  // The files written by a partitioned flush have overlapping sequence
+  // number ranges, so the output must not be ordered between some of them.
+  while (limit > start && limit < level_files.size() &&
+         level_files[limit]->flush_group != 0 &&
+         level_files[limit]->flush_group ==
+             level_files[limit - 1]->flush_group) {
+    --limit;
+  }
 
   if ((limit - start) >= min_files_to_compact &&
       compact_bytes_per_del_file < max_compact_bytes_per_del_file) {
@@ -156,6 +165,46 @@ CompactionPicker::CompactionPicker(const ImmutableOptions& ioptions,
 
 CompactionPicker::~CompactionPicker() {}
 
+TaskCostEstimate CompactionPicker::EstimateNextCompaction(
+    const VersionStorageInfo* vstorage,
+    const MutableCFOptions& /*mutable_cf_options*/) const {
+  TaskCostEstimate estimate;
+  uint64_t input_bytes = 0;
+  uint64_t reclaimed_bytes = 0;
+  int num_runs = 0;
+  for (const FileMetaData* f : vstorage->LevelFiles(0)) {
+    if (f->being_compacted) {
+      continue;
+    }
+    input_bytes += f->fd.GetFileSize();
+    reclaimed_bytes += GetReclaimedBytesEstimate(*f);
+    ++num_runs;
+  }
+  estimate.io_bytes = 2 * input_bytes;
+  estimate.read_amp_reduction = std::max(num_runs - 1, 0);
+  estimate.space_amp_reduction =
+      static_cast<double>(reclaimed_bytes) /
+      std::max<uint64_t>(GetTotalLevelBytes(vstorage), 1);
+  return estimate;
+}
+
+uint64_t CompactionPicker::GetReclaimedBytesEstimate(const FileMetaData& f) {
+  // The compensated size of a file adds an estimate of the older values its
+  // deletions shadow in the lower levels
+  return f.compensated_file_size > f.fd.GetFileSize()
+             ? f.compensated_file_size - f.fd.GetFileSize()
+             : 0;
+}
+
+uint64_t CompactionPicker::GetTotalLevelBytes(
+    const VersionStorageInfo* vstorage) {
+  uint64_t total_bytes = 0;
+  for (int level = 0; level < vstorage->num_levels(); level++) {
+    total_bytes += vstorage->NumLevelBytes(level);
+  }
+  return total_bytes;
+}
+
 // Delete this compaction from the list of running compactions.
 void CompactionPicker::ReleaseCompactionFiles(Compaction* c, Status status) {
   UnregisterCompaction(c);
@@ -293,10 +342,29 @@ bool CompactionPicker::RangeOverlapWithCompaction(
       return true;
     }
   }
+  for (const auto& added_file : files_being_added_) {
+    const AddedFileRange& range = added_file.second;
+    if (range.level == level &&
+        ucmp->Compare(smallest_user_key, range.largest_user_key) <= 0 &&
+        ucmp->Compare(largest_user_key, range.smallest_user_key) >= 0) {
+      return true;
+    }
+  }
   // Did not overlap with any running compaction in level `level`
   return false;
 }
 
+void CompactionPicker::RegisterFileBeingAdded(int level,
+                                              const FileMetaData& f) {
+  assert(level > 0);
+  files_being_added_[f.fd.GetNumber()] = AddedFileRange{
+      level, f.smallest.user_key().ToString(), f.largest.user_key().ToString()};
+}
+
+void CompactionPicker::UnregisterFileBeingAdded(uint64_t file_number) {
+  files_being_added_.erase(file_number);
+}
+
 bool CompactionPicker::FilesRangeOverlapWithCompaction(
     const std::vector<CompactionInputFiles>& inputs, int level) const {
   bool is_empty = true;
@@ -12,6 +12,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "rocksdb/status.h"
+#include "util/concurrent_task_limiter_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -85,6 +87,20 @@ class CompactionPicker {
 
   virtual bool NeedsCompaction(const VersionStorageInfo* vstorage) const = 0;
 
+  // Estimates the cost and benefit of the compaction PickCompaction() would
+  // pick next, from the shape of the LSM tree. Used to order compactions
+  // across column families; `cpu_micros` is left for the caller to fill in.
+  // The default treats L0 files as sorted runs to be merged together.
+  virtual TaskCostEstimate EstimateNextCompaction(
+      const VersionStorageInfo* vstorage,
+      const MutableCFOptions& mutable_cf_options) const;
+
+  // The bytes expected to be reclaimed by compacting file f down
+  static uint64_t GetReclaimedBytesEstimate(const FileMetaData& f);
+
+  // The total size of the table files in all levels
+  static uint64_t GetTotalLevelBytes(const VersionStorageInfo* vstorage);
+
 // Sanitize the input set of compaction input files.
 // When the input parameters do not describe a valid compaction, the
 // function will try to fix the input_files by adding necessary
@@ -137,6 +153,15 @@ class CompactionPicker {
                                   const Slice& largest_user_key,
                                   int level) const;
 
+  // Registers the key range of a flush output (see flush_to_deepest_level)
+  // or an ingested file being added to `level` > 0. Until it is
+  // unregistered, RangeOverlapWithCompaction() treats it like the output of a
+  // running compaction, so that no compaction, flush or ingestion whose
+  // levels are picked before the file is installed adds an overlapping file
+  // to the same level.
+  void RegisterFileBeingAdded(int level, const FileMetaData& f);
+  void UnregisterFileBeingAdded(uint64_t file_number);
+
   // Stores the minimal range that covers all entries in inputs in
   // *smallest, *largest.
   // REQUIRES: inputs is not empty
@@ -236,6 +261,15 @@ class CompactionPicker {
   // Protected by DB mutex
   std::unordered_set<Compaction*> compactions_in_progress_;
 
+  // Key ranges of the flush outputs and ingested files being added to levels
+  // other than L0, by file number. Protected by DB mutex
+  struct AddedFileRange {
+    int level;
+    std::string smallest_user_key;
+    std::string largest_user_key;
+  };
+  std::unordered_map<uint64_t, AddedFileRange> files_being_added_;
+
   const InternalKeyComparator* const icmp_;
 };
 
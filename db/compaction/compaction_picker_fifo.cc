@@ -36,6 +36,22 @@ bool FIFOCompactionPicker::NeedsCompaction(
   return vstorage->CompactionScore(kLevel0) >= 1;
 }
 
+TaskCostEstimate FIFOCompactionPicker::EstimateNextCompaction(
+    const VersionStorageInfo* vstorage,
+    const MutableCFOptions& mutable_cf_options) const {
+  // Dropping the oldest files costs no I/O, and reclaims what is over the
+  // size limit
+  TaskCostEstimate estimate;
+  const uint64_t total_size = GetTotalFilesSize(vstorage->LevelFiles(0));
+  const uint64_t max_size =
+      mutable_cf_options.compaction_options_fifo.max_table_files_size;
+  if (total_size > max_size) {
+    estimate.space_amp_reduction =
+        static_cast<double>(total_size - max_size) / total_size;
+  }
+  return estimate;
+}
+
 Compaction* FIFOCompactionPicker::PickTTLCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
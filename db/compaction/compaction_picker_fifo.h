@@ -40,6 +40,10 @@ class FIFOCompactionPicker : public CompactionPicker {
   virtual bool NeedsCompaction(
       const VersionStorageInfo* vstorage) const override;
 
+  virtual TaskCostEstimate EstimateNextCompaction(
+      const VersionStorageInfo* vstorage,
+      const MutableCFOptions& mutable_cf_options) const override;
+
  private:
   Compaction* PickTTLCompaction(const std::string& cf_name,
                                 const MutableCFOptions& mutable_cf_options,
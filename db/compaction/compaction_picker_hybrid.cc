@@ -0,0 +1,295 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_picker_hybrid.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "logging/log_buffer.h"
+#include "logging/logging.h"
+#include "rocksdb/system_clock.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr uint64_t HybridCompactionPicker::kWriteRateWindowMicros;
+
+namespace {
+// An L0 file, or a level above the leveled levels
+struct SortedRun {
+  int level;
+  // The file, for a run in L0
+  FileMetaData* file;
+  uint64_t size;
+  uint64_t compensated_file_size;
+  bool being_compacted;
+};
+
+// Returns the sorted runs down to `last_tiered_level`, newest first. L0 files
+// newer than `earliest_memtable_seqno`, which were ingested while the
+// memtables were not flushed, are taken as being compacted.
+std::vector<SortedRun> CalculateSortedRuns(
+    const VersionStorageInfo& vstorage, int last_tiered_level,
+    SequenceNumber earliest_memtable_seqno) {
+  std::vector<SortedRun> runs;
+  for (FileMetaData* f : vstorage.LevelFiles(0)) {
+    runs.push_back({0, f, f->fd.GetFileSize(), f->compensated_file_size,
+                    f->being_compacted ||
+                        f->fd.largest_seqno > earliest_memtable_seqno});
+  }
+  for (int level = 1; level <= last_tiered_level; level++) {
+    SortedRun run = {level, nullptr, 0, 0, false};
+    for (FileMetaData* f : vstorage.LevelFiles(level)) {
+      run.size += f->fd.GetFileSize();
+      run.compensated_file_size += f->compensated_file_size;
+      // The level picker compacts single files of a level, which makes all
+      // of it unavailable to size-tiered compactions
+      run.being_compacted |= f->being_compacted;
+    }
+    if (!vstorage.LevelFiles(level).empty()) {
+      runs.push_back(run);
+    }
+  }
+  return runs;
+}
+
+size_t NumSortedRuns(const VersionStorageInfo& vstorage,
+                     int last_tiered_level) {
+  size_t num_runs = vstorage.LevelFiles(0).size();
+  for (int level = 1; level <= last_tiered_level; level++) {
+    if (!vstorage.LevelFiles(level).empty()) {
+      num_runs++;
+    }
+  }
+  return num_runs;
+}
+
+// Picks the first span of at least two consecutive runs that are not being
+// compacted, in which each run is at most `ratio` percent larger than the
+// ones before it together, and of at most `max_runs` runs. The span is
+// [*start, *end).
+bool PickSortedRuns(const std::vector<SortedRun>& runs, unsigned int ratio,
+                    size_t max_runs, size_t* start, size_t* end) {
+  for (size_t i = 0; i < runs.size(); i++) {
+    if (runs[i].being_compacted) {
+      continue;
+    }
+    uint64_t candidate_size = runs[i].compensated_file_size;
+    size_t j = i + 1;
+    for (; j < runs.size() && j - i < max_runs; j++) {
+      if (runs[j].being_compacted ||
+          candidate_size * (100.0 + ratio) / 100.0 <
+              static_cast<double>(runs[j].size)) {
+        break;
+      }
+      candidate_size += runs[j].compensated_file_size;
+    }
+    if (j - i >= 2) {
+      *start = i;
+      *end = j;
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+HybridCompactionPicker::HybridCompactionPicker(
+    const ImmutableOptions& ioptions, const InternalKeyComparator* icmp)
+    : LevelCompactionPicker(ioptions, icmp),
+      tiering_(ioptions.compaction_options_hybrid.min_write_rate_for_tiering ==
+               0) {}
+
+bool HybridCompactionPicker::NeedsCompaction(
+    const VersionStorageInfo* vstorage) const {
+  if (!tiering_ || sorted_run_trigger_ == 0) {
+    return LevelCompactionPicker::NeedsCompaction(vstorage);
+  }
+  const int last_tiered_level = LastTieredLevel(vstorage);
+  if (NumSortedRuns(*vstorage, last_tiered_level) >=
+      static_cast<size_t>(sorted_run_trigger_)) {
+    return true;
+  }
+  return NeedsCompactionFromLevel(vstorage, last_tiered_level);
+}
+
+Compaction* HybridCompactionPicker::PickCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer, SequenceNumber earliest_memtable_seqno) {
+  UpdateTiering(cf_name, vstorage, log_buffer);
+  sorted_run_trigger_ =
+      std::max(mutable_cf_options.level0_file_num_compaction_trigger, 1);
+  if (!tiering_) {
+    return LevelCompactionPicker::PickCompaction(
+        cf_name, mutable_cf_options, mutable_db_options, vstorage, log_buffer,
+        earliest_memtable_seqno);
+  }
+
+  Compaction* c =
+      PickTieredCompaction(cf_name, mutable_cf_options, mutable_db_options,
+                           vstorage, log_buffer, earliest_memtable_seqno);
+  if (c == nullptr) {
+    // Compacts the last size-tiered level into the leveled levels, and
+    // the leveled levels themselves
+    c = PickCompactionFromLevel(cf_name, mutable_cf_options,
+                                mutable_db_options, vstorage, log_buffer,
+                                earliest_memtable_seqno,
+                                LastTieredLevel(vstorage));
+  }
+  return c;
+}
+
+void HybridCompactionPicker::UpdateTiering(const std::string& cf_name,
+                                           const VersionStorageInfo* vstorage,
+                                           LogBuffer* log_buffer) {
+  const uint64_t min_write_rate =
+      ioptions_.compaction_options_hybrid.min_write_rate_for_tiering;
+  if (min_write_rate == 0) {
+    return;
+  }
+  const bool first_call = window_start_micros_ == 0;
+  SequenceNumber largest_seqno = last_seen_seqno_;
+  for (FileMetaData* f : vstorage->LevelFiles(0)) {
+    // The outputs of compactions into L0 only hold keys of files seen
+    // before, unlike flushed and ingested files
+    if (f->fd.smallest_seqno > last_seen_seqno_ && !first_call) {
+      window_bytes_ += f->fd.GetFileSize();
+    }
+    largest_seqno = std::max(largest_seqno, f->fd.largest_seqno);
+  }
+  last_seen_seqno_ = largest_seqno;
+
+  const uint64_t now_micros = ioptions_.clock->NowMicros();
+  if (first_call || now_micros < window_start_micros_) {
+    window_start_micros_ = std::max<uint64_t>(now_micros, 1);
+    window_bytes_ = 0;
+    return;
+  }
+  const uint64_t elapsed_micros = now_micros - window_start_micros_;
+  if (elapsed_micros < kWriteRateWindowMicros) {
+    return;
+  }
+  const double write_rate = static_cast<double>(window_bytes_) * 1000000 /
+                            static_cast<double>(elapsed_micros);
+  // Leaving tiering at a lower rate keeps the mode from flapping
+  const bool tiering =
+      write_rate >= (tiering_ ? static_cast<double>(min_write_rate) / 2
+                              : static_cast<double>(min_write_rate));
+  if (tiering != tiering_) {
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] Hybrid: write rate %.0f bytes/s, switching the "
+                     "upper levels to %s compaction",
+                     cf_name.c_str(), write_rate,
+                     tiering ? "size-tiered" : "leveled");
+    tiering_ = tiering;
+  }
+  window_start_micros_ = now_micros;
+  window_bytes_ = 0;
+}
+
+Compaction* HybridCompactionPicker::PickTieredCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer, SequenceNumber earliest_memtable_seqno) {
+  const int last_tiered_level = LastTieredLevel(vstorage);
+  const std::vector<SortedRun> runs = CalculateSortedRuns(
+      *vstorage, last_tiered_level, earliest_memtable_seqno);
+  if (runs.size() < static_cast<size_t>(sorted_run_trigger_)) {
+    return nullptr;
+  }
+
+  size_t start = 0;
+  size_t end = 0;
+  CompactionReason compaction_reason;
+  if (PickSortedRuns(runs, ioptions_.compaction_options_hybrid.size_ratio,
+                     runs.size(), &start, &end)) {
+    compaction_reason = CompactionReason::kHybridSizeRatio;
+  } else if (PickSortedRuns(runs, UINT_MAX,
+                            std::max<size_t>(
+                                runs.size() - sorted_run_trigger_ + 1, 2),
+                            &start, &end)) {
+    compaction_reason = CompactionReason::kHybridSortedRunNum;
+  } else {
+    return nullptr;
+  }
+
+  // The output goes right above the next older run, keeping the runs in
+  // order of age
+  int output_level;
+  if (end == runs.size()) {
+    output_level = last_tiered_level;
+  } else if (runs[end].level == 0) {
+    output_level = 0;
+  } else {
+    output_level = runs[end].level - 1;
+  }
+  const int start_level = runs[start].level;
+  std::vector<CompactionInputFiles> inputs(output_level - start_level + 1);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    inputs[i].level = start_level + static_cast<int>(i);
+  }
+  for (size_t i = start; i < end; i++) {
+    if (runs[i].level == 0) {
+      inputs[0].files.push_back(runs[i].file);
+    } else {
+      inputs[runs[i].level - start_level].files =
+          vstorage->LevelFiles(runs[i].level);
+    }
+  }
+  if (output_level > 0 &&
+      FilesRangeOverlapWithCompaction(inputs, output_level)) {
+    // Another compaction is writing into the empty output level
+    return nullptr;
+  }
+
+  // Lets the output files be cut where they would overlap too much of the
+  // next level
+  std::vector<FileMetaData*> grandparents;
+  if (output_level > 0) {
+    InternalKey smallest, largest;
+    GetRange(inputs, &smallest, &largest);
+    for (int level = output_level + 1; level < NumberLevels(); level++) {
+      vstorage->GetOverlappingInputs(level, &smallest, &largest,
+                                     &grandparents);
+      if (!grandparents.empty()) {
+        break;
+      }
+    }
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] Hybrid: merging %" ROCKSDB_PRIszt
+                   " sorted runs from level %d into level %d",
+                   cf_name.c_str(), end - start, start_level, output_level);
+
+  Compaction* c = new Compaction(
+      vstorage, ioptions_, mutable_cf_options, mutable_db_options,
+      std::move(inputs), output_level,
+      MaxFileSizeForLevel(mutable_cf_options, output_level,
+                          ioptions_.compaction_style, vstorage->base_level(),
+                          ioptions_.level_compaction_dynamic_level_bytes),
+      mutable_cf_options.max_compaction_bytes, /* output_path_id */ 0,
+      GetCompressionType(ioptions_, vstorage, mutable_cf_options,
+                         output_level, vstorage->base_level()),
+      GetCompressionOptions(mutable_cf_options, vstorage, output_level),
+      Temperature::kUnknown,
+      /* max_subcompactions */ 0, std::move(grandparents),
+      /* is manual */ false,
+      static_cast<double>(runs.size()) / sorted_run_trigger_,
+      false /* deletion_compaction */, compaction_reason);
+  TEST_SYNC_POINT_CALLBACK(
+      "HybridCompactionPicker::PickTieredCompaction:Return", c);
+
+  RegisterCompaction(c);
+  vstorage->ComputeCompactionScore(ioptions_, mutable_cf_options);
+  return c;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
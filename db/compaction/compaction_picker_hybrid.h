@@ -0,0 +1,73 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "db/compaction/compaction_picker_level.h"
+
+namespace ROCKSDB_NAMESPACE {
+// Picking compactions for hybrid compaction, that is leveled compaction with
+// compaction_options_hybrid.leveled_levels > 0. The last leveled_levels
+// levels are always compacted as in leveled compaction. While the write rate
+// of the column family is high enough, the levels above them are compacted
+// size-tiered instead: each L0 file and each of these levels is a sorted run,
+// and consecutive runs of similar sizes are merged into one, as in universal
+// compaction. The last size-tiered level is compacted into the levels below
+// once it exceeds its target size.
+class HybridCompactionPicker : public LevelCompactionPicker {
+ public:
+  HybridCompactionPicker(const ImmutableOptions& ioptions,
+                         const InternalKeyComparator* icmp);
+
+  virtual Compaction* PickCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+      LogBuffer* log_buffer,
+      SequenceNumber earliest_memtable_seqno = kMaxSequenceNumber) override;
+
+  virtual bool NeedsCompaction(
+      const VersionStorageInfo* vstorage) const override;
+
+  // Whether the levels above the leveled levels are compacted size-tiered,
+  // as decided by the last PickCompaction()
+  bool IsTiering() const { return tiering_; }
+
+  // How long the write rate is measured over before deciding again
+  static constexpr uint64_t kWriteRateWindowMicros = 10 * 1000 * 1000;
+
+ private:
+  // The last level compacted size-tiered
+  int LastTieredLevel(const VersionStorageInfo* vstorage) const {
+    return vstorage->num_levels() -
+           ioptions_.compaction_options_hybrid.leveled_levels - 1;
+  }
+
+  // Accounts for the L0 files written since the last call, and decides
+  // whether to compact the upper levels size-tiered once the current write
+  // rate window is over.
+  void UpdateTiering(const std::string& cf_name,
+                     const VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Merges consecutive sorted runs above the leveled levels
+  Compaction* PickTieredCompaction(const std::string& cf_name,
+                                   const MutableCFOptions& mutable_cf_options,
+                                   const MutableDBOptions& mutable_db_options,
+                                   VersionStorageInfo* vstorage,
+                                   LogBuffer* log_buffer,
+                                   SequenceNumber earliest_memtable_seqno);
+
+  bool tiering_;
+  // level0_file_num_compaction_trigger as of the last PickCompaction(), or 0
+  // before the first one
+  int sorted_run_trigger_ = 0;
+  // The largest sequence number of the L0 files seen so far
+  SequenceNumber last_seen_seqno_ = 0;
+  uint64_t window_start_micros_ = 0;
+  uint64_t window_bytes_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,6 +20,57 @@ namespace ROCKSDB_NAMESPACE {
 
 bool LevelCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
+  return NeedsCompactionFromLevel(vstorage, 0 /* min_start_level */);
+}
+
+TaskCostEstimate LevelCompactionPicker::EstimateNextCompaction(
+    const VersionStorageInfo* vstorage,
+    const MutableCFOptions& mutable_cf_options) const {
+  const int level = vstorage->CompactionScoreLevel(0);
+  if (level == 0) {
+    // All of L0 is merged into the base level, which it usually overlaps
+    // entirely
+    TaskCostEstimate estimate =
+        CompactionPicker::EstimateNextCompaction(vstorage, mutable_cf_options);
+    const int base_level = vstorage->base_level();
+    if (base_level > 0 && base_level < vstorage->num_levels()) {
+      estimate.io_bytes += 2 * vstorage->NumLevelBytes(base_level);
+      if (vstorage->NumLevelFiles(base_level) > 0) {
+        // The L0 files no longer add to the runs of the base level
+        estimate.read_amp_reduction += 1;
+      }
+    }
+    return estimate;
+  }
+
+  // One file is compacted with the files it overlaps in the next level,
+  // which are assumed to be in the ratio of the level sizes
+  TaskCostEstimate estimate;
+  const std::vector<FileMetaData*>& files = vstorage->LevelFiles(level);
+  for (int index : vstorage->FilesByCompactionPri(level)) {
+    const FileMetaData* f = files[index];
+    if (f->being_compacted) {
+      continue;
+    }
+    const uint64_t file_bytes = f->fd.GetFileSize();
+    const uint64_t level_bytes = vstorage->NumLevelBytes(level);
+    uint64_t overlap_bytes = 0;
+    if (level + 1 < vstorage->num_levels() && level_bytes > 0) {
+      overlap_bytes = static_cast<uint64_t>(
+          static_cast<double>(file_bytes) *
+          vstorage->NumLevelBytes(level + 1) / level_bytes);
+    }
+    estimate.io_bytes = 2 * (file_bytes + overlap_bytes);
+    estimate.space_amp_reduction =
+        static_cast<double>(GetReclaimedBytesEstimate(*f)) /
+        std::max<uint64_t>(GetTotalLevelBytes(vstorage), 1);
+    break;
+  }
+  return estimate;
+}
+
+bool LevelCompactionPicker::NeedsCompactionFromLevel(
+    const VersionStorageInfo* vstorage, int min_start_level) const {
   if (!vstorage->ExpiredTtlFiles().empty()) {
     return true;
   }
@@ -35,7 +87,8 @@ bool LevelCompactionPicker::NeedsCompaction(
     return true;
   }
   for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
-    if (vstorage->CompactionScore(i) >= 1) {
+    if (vstorage->CompactionScore(i) >= 1 &&
+        vstorage->CompactionScoreLevel(i) >= min_start_level) {
       return true;
     }
   }
@@ -53,7 +106,8 @@ class LevelCompactionBuilder {
                          LogBuffer* log_buffer,
                          const MutableCFOptions& mutable_cf_options,
                          const ImmutableOptions& ioptions,
-                         const MutableDBOptions& mutable_db_options)
+                         const MutableDBOptions& mutable_db_options,
+                         int min_start_level)
       : cf_name_(cf_name),
         vstorage_(vstorage),
         earliest_mem_seqno_(earliest_mem_seqno),
@@ -61,7 +115,8 @@ class LevelCompactionBuilder {
         log_buffer_(log_buffer),
         mutable_cf_options_(mutable_cf_options),
         ioptions_(ioptions),
-        mutable_db_options_(mutable_db_options) {}
+        mutable_db_options_(mutable_db_options),
+        min_start_level_(min_start_level) {}
 
   // Pick and return a compaction.
   Compaction* PickCompaction();
@@ -126,6 +181,8 @@ class LevelCompactionBuilder {
   const MutableCFOptions& mutable_cf_options_;
   const ImmutableOptions& ioptions_;
   const MutableDBOptions& mutable_db_options_;
+  // Compactions by size start from this level or below
+  const int min_start_level_;
   // Pick a path ID to place a newly generated file, with its level
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
                             const MutableCFOptions& mutable_cf_options,
@@ -173,6 +230,9 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     start_level_ = vstorage_->CompactionScoreLevel(i);
     assert(i == 0 || start_level_score_ <= vstorage_->CompactionScore(i - 1));
     if (start_level_score_ >= 1) {
+      if (start_level_ < min_start_level_) {
+        continue;
+      }
       if (skipped_l0_to_base && start_level_ == vstorage_->base_level()) {
         // If L0->base_level compaction is pending, don't schedule further
         // compaction from base level. Otherwise L0->base_level compaction
@@ -513,9 +573,19 @@ Compaction* LevelCompactionPicker::PickCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
     LogBuffer* log_buffer, SequenceNumber earliest_mem_seqno) {
+  return PickCompactionFromLevel(cf_name, mutable_cf_options,
+                                 mutable_db_options, vstorage, log_buffer,
+                                 earliest_mem_seqno, 0 /* min_start_level */);
+}
+
+Compaction* LevelCompactionPicker::PickCompactionFromLevel(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer, SequenceNumber earliest_mem_seqno,
+    int min_start_level) {
   LevelCompactionBuilder builder(cf_name, vstorage, earliest_mem_seqno, this,
                                  log_buffer, mutable_cf_options, ioptions_,
-                                 mutable_db_options);
+                                 mutable_db_options, min_start_level);
   return builder.PickCompaction();
 }
 }  // namespace ROCKSDB_NAMESPACE
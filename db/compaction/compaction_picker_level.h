@@ -28,6 +28,24 @@ class LevelCompactionPicker : public CompactionPicker {
 
   virtual bool NeedsCompaction(
       const VersionStorageInfo* vstorage) const override;
+
+  virtual TaskCostEstimate EstimateNextCompaction(
+      const VersionStorageInfo* vstorage,
+      const MutableCFOptions& mutable_cf_options) const override;
+
+ protected:
+  // Like PickCompaction(), except that compactions by level size or L0 file
+  // count only start from `min_start_level` or below.
+  Compaction* PickCompactionFromLevel(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+      LogBuffer* log_buffer, SequenceNumber earliest_memtable_seqno,
+      int min_start_level);
+
+  // Like NeedsCompaction(), except that compaction scores only count from
+  // `min_start_level` on.
+  bool NeedsCompactionFromLevel(const VersionStorageInfo* vstorage,
+                                int min_start_level) const;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,9 +9,11 @@
 
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/compaction/file_pri.h"
+#include "test_util/mock_time_env.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/string_util.h"
@@ -1335,6 +1337,216 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, HybridMergesSortedRuns) {
+  ioptions_.compaction_options_hybrid.leveled_levels = 2;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(5, kCompactionStyleLevel);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+
+  // L0 and L2 are compacted size-tiered. The much larger L2 is left out.
+  Add(0, 1U, "150", "200", 1000U, 0, 401, 500);
+  Add(0, 2U, "100", "300", 1000U, 0, 301, 400);
+  Add(2, 3U, "100", "300", 100000U, 0, 1, 300);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_TRUE(hybrid_compaction_picker.IsTiering());
+  ASSERT_EQ(CompactionReason::kHybridSizeRatio,
+            compaction->compaction_reason());
+  // Right above L2
+  ASSERT_EQ(1, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_levels());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(0U, compaction->num_input_files(1));
+}
+
+TEST_F(CompactionPickerTest, HybridMergesIntoLastTieredLevel) {
+  ioptions_.compaction_options_hybrid.leveled_levels = 2;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(5, kCompactionStyleLevel);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+
+  Add(0, 1U, "150", "200", 1000U, 0, 401, 500);
+  Add(1, 2U, "100", "300", 1000U, 0, 301, 400);
+  Add(2, 3U, "100", "300", 1500U, 0, 1, 300);
+  Add(3, 4U, "100", "300", 100000U, 0, 1, 1);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // L3 is leveled
+  ASSERT_EQ(2, compaction->output_level());
+  ASSERT_EQ(3U, compaction->num_input_levels());
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(1U, compaction->num_input_files(2));
+}
+
+TEST_F(CompactionPickerTest, HybridSpillsLastTieredLevel) {
+  ioptions_.compaction_options_hybrid.leveled_levels = 2;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(5, kCompactionStyleLevel);
+  mutable_cf_options_.max_bytes_for_level_base = 10000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  // L1 is far larger than its target, but only L2 is compacted into the
+  // leveled levels. L3 is within its target.
+  Add(1, 1U, "100", "300", 50000U, 0, 301, 400);
+  Add(2, 2U, "100", "200", 60000U, 0, 101, 300);
+  Add(2, 3U, "201", "300", 60000U, 0, 101, 300);
+  Add(3, 4U, "100", "200", 400000U, 0, 1, 100);
+  Add(3, 5U, "201", "300", 400000U, 0, 1, 100);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kLevelMaxLevelSize,
+            compaction->compaction_reason());
+  ASSERT_EQ(2, compaction->start_level());
+  ASSERT_EQ(3, compaction->output_level());
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+}
+
+TEST_F(CompactionPickerTest, HybridLeveledWhileWriteRateIsLow) {
+  ioptions_.compaction_options_hybrid.leveled_levels = 2;
+  ioptions_.compaction_options_hybrid.min_write_rate_for_tiering = 1 << 30;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(5, kCompactionStyleLevel);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+
+  Add(0, 1U, "150", "200", 1000U, 0, 401, 500);
+  Add(0, 2U, "100", "300", 1000U, 0, 301, 400);
+  Add(1, 3U, "100", "300", 100000U, 0, 1, 300);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_FALSE(hybrid_compaction_picker.IsTiering());
+  // L0 -> L1, instead of merging the L0 files into L0
+  ASSERT_EQ(CompactionReason::kLevelL0FilesNum,
+            compaction->compaction_reason());
+  ASSERT_EQ(1, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+}
+
+TEST_F(CompactionPickerTest, HybridSwitchesToTieringOnHighWriteRate) {
+  std::shared_ptr<MockSystemClock> clock =
+      std::make_shared<MockSystemClock>(SystemClock::Default());
+  clock->SetCurrentTime(100);
+  ioptions_.clock = clock.get();
+  ioptions_.compaction_options_hybrid.leveled_levels = 2;
+  ioptions_.compaction_options_hybrid.min_write_rate_for_tiering = 1000;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+
+  NewVersionStorage(5, kCompactionStyleLevel);
+  Add(1, 3U, "100", "300", 100000U, 0, 1, 300);
+  UpdateVersionStorageInfo();
+  ASSERT_EQ(nullptr, hybrid_compaction_picker.PickCompaction(
+                         cf_name_, mutable_cf_options_, mutable_db_options_,
+                         vstorage_.get(), &log_buffer_));
+  ASSERT_FALSE(hybrid_compaction_picker.IsTiering());
+
+  // 20000 bytes are flushed over the next 10 seconds
+  NewVersionStorage(5, kCompactionStyleLevel);
+  Add(0, 1U, "150", "200", 10000U, 0, 401, 500);
+  Add(0, 2U, "100", "300", 10000U, 0, 301, 400);
+  Add(1, 3U, "100", "300", 100000U, 0, 1, 300);
+  UpdateVersionStorageInfo();
+  clock->MockSleepForSeconds(static_cast<int>(
+      HybridCompactionPicker::kWriteRateWindowMicros / 1000000));
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_TRUE(hybrid_compaction_picker.IsTiering());
+  // The L0 files are merged together, right above L1
+  ASSERT_EQ(0, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+}
+
+TEST_F(CompactionPickerTest, CompactionPriDeletionReclaim1) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kMaxDeletionReclaimRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 10000000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  Add(2, 6U, "150", "167", 60000000U);  // Overlaps with file 26, 27
+  Add(2, 7U, "201", "300", 60000000U);  // Overlaps with file 28
+  Add(2, 8U, "501", "600", 60000000U);  // No overlap, picked by
+                                        // kMinOverlappingRatio
+  // File 7 is mostly point tombstones
+  file_map_[7U].first->num_entries = 1000;
+  file_map_[7U].first->num_deletions = 900;
+
+  Add(3, 26U, "160", "165", 260000000U);
+  Add(3, 27U, "166", "170", 260000000U);
+  Add(3, 28U, "180", "400", 260000000U);
+  Add(3, 29U, "401", "500", 260000000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, CompactionPriDeletionReclaim2) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kMaxDeletionReclaimRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 10000000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  Add(2, 6U, "150", "167", 60000000U);  // Overlaps with file 26
+  Add(2, 7U, "201", "300", 60000000U);  // Overlaps with file 27, 28
+  Add(2, 8U, "501", "600", 60000000U);  // No overlap
+  // Files 6 and 7 both have range tombstones, but only those of file 7
+  // cover whole files further down
+  file_map_[6U].first->num_entries = 1;
+  file_map_[6U].first->num_deletions = 1;
+  file_map_[6U].first->num_range_deletions = 1;
+  file_map_[6U].first->range_deletion_ranges.emplace_back("150", "162");
+  file_map_[7U].first->num_entries = 2;
+  file_map_[7U].first->num_deletions = 2;
+  file_map_[7U].first->num_range_deletions = 2;
+  file_map_[7U].first->range_deletion_ranges.emplace_back("210", "230");
+  file_map_[7U].first->range_deletion_ranges.emplace_back("250", "280");
+
+  Add(3, 26U, "160", "165", 260000000U);
+  Add(3, 27U, "211", "229", 260000000U);
+  Add(3, 28U, "231", "300", 260000000U);
+  Add(4, 40U, "260", "279", 2600000000U);
+  // The end of a range tombstone is exclusive
+  Add(4, 41U, "280", "290", 2600000000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 // This test exhibits the bug where we don't properly reset parent_index in
 // PickCompaction()
 TEST_F(CompactionPickerTest, ParentIndexResetBug) {
@@ -2368,6 +2580,41 @@ TEST_F(CompactionPickerTest, IntraL0ForEarliestSeqno) {
   ASSERT_EQ(0, compaction->output_level());
 }
 
+TEST_F(CompactionPickerTest, IntraL0KeepsFlushGroups) {
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  mutable_cf_options_.max_compaction_bytes = 1000000u;
+  NewVersionStorage(6, kCompactionStyleLevel);
+
+  // Files 1 and 2 were written by the same partitioned flush. File 2 is
+  // being compacted, so file 1 is left out of the intra L0 compaction rather
+  // than having its output ordered between them. The one L1 file spans
+  // entire L0 key range and is marked as being compacted to avoid L0->L1
+  // compaction.
+  Add(1, 7U, "100", "350", 200000U, 0, 110, 111);
+  Add(0, 6U, "100", "350", 1U, 0, 110, 111);
+  Add(0, 5U, "301", "350", 1U, 0, 108, 109);
+  Add(0, 4U, "251", "300", 1U, 0, 106, 107);
+  Add(0, 3U, "201", "250", 1U, 0, 104, 105);
+  Add(0, 1U, "100", "150", 1U, 0, 100, 103);
+  Add(0, 2U, "151", "200", 1U, 0, 101, 102);
+  file_map_[1U].first->flush_group = 1;
+  file_map_[2U].first->flush_group = 1;
+  file_map_[2U].first->being_compacted = true;
+  vstorage_->LevelFiles(1)[0]->being_compacted = true;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  for (size_t i = 0; i < compaction->num_input_files(0); i++) {
+    ASSERT_NE(1U, compaction->input(0, i)->fd.GetNumber());
+  }
+  ASSERT_EQ(0, compaction->output_level());
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(CompactionPickerTest, UniversalMarkedCompactionFullOverlap) {
   const uint64_t kFileSize = 100000;
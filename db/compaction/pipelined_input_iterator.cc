@@ -0,0 +1,312 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include "monitoring/iostats_context_imp.h"
+#include "monitoring/perf_context_imp.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The counters of the I/O stats and perf contexts that reading table files
+// updates
+#define PIPELINED_INPUT_IOSTATS(X)                          \
+  X(bytes_read)                                             \
+  X(open_nanos)                                             \
+  X(read_nanos)                                             \
+  X(cpu_read_nanos)                                         \
+  X(file_io_stats_by_temperature.hot_file_bytes_read)       \
+  X(file_io_stats_by_temperature.warm_file_bytes_read)      \
+  X(file_io_stats_by_temperature.cold_file_bytes_read)      \
+  X(file_io_stats_by_temperature.hot_file_read_count)       \
+  X(file_io_stats_by_temperature.warm_file_read_count)      \
+  X(file_io_stats_by_temperature.cold_file_read_count)
+#define PIPELINED_INPUT_PERF_COUNTERS(X) \
+  X(user_key_comparison_count)           \
+  X(block_cache_hit_count)               \
+  X(block_read_count)                    \
+  X(block_read_byte)                     \
+  X(block_read_time)                     \
+  X(block_cache_index_hit_count)         \
+  X(index_block_read_count)              \
+  X(block_cache_filter_hit_count)        \
+  X(filter_block_read_count)             \
+  X(compression_dict_block_read_count)   \
+  X(secondary_cache_hit_count)           \
+  X(block_checksum_time)                 \
+  X(block_decompress_time)               \
+  X(read_index_block_nanos)              \
+  X(read_filter_block_nanos)             \
+  X(new_table_block_iter_nanos)          \
+  X(new_table_iterator_nanos)            \
+  X(block_seek_nanos)                    \
+  X(find_table_nanos)                    \
+  X(env_new_random_access_file_nanos)    \
+  X(decrypt_data_nanos)
+
+void CaptureReadStats(std::vector<uint64_t>* stats) {
+  stats->clear();
+#define CAPTURE_IOSTATS(metric) stats->push_back(IOSTATS(metric));
+#define CAPTURE_PERF_COUNTER(metric) stats->push_back(perf_context.metric);
+  PIPELINED_INPUT_IOSTATS(CAPTURE_IOSTATS)
+  PIPELINED_INPUT_PERF_COUNTERS(CAPTURE_PERF_COUNTER)
+#undef CAPTURE_IOSTATS
+#undef CAPTURE_PERF_COUNTER
+}
+
+void AddReadStats(const std::vector<uint64_t>& stats) {
+  if (stats.empty()) {
+    return;
+  }
+  size_t i = 0;
+#define ADD_IOSTATS(metric) IOSTATS_ADD(metric, stats[i++]);
+#ifndef NPERF_CONTEXT
+#define ADD_PERF_COUNTER(metric) perf_context.metric += stats[i++];
+#else
+#define ADD_PERF_COUNTER(metric) ++i;
+#endif
+  PIPELINED_INPUT_IOSTATS(ADD_IOSTATS)
+  PIPELINED_INPUT_PERF_COUNTERS(ADD_PERF_COUNTER)
+#undef ADD_IOSTATS
+#undef ADD_PERF_COUNTER
+  assert(i == stats.size());
+  (void)i;
+}
+}  // namespace
+
+constexpr size_t PipelinedInputIterator::kDefaultBatchBytes;
+constexpr size_t PipelinedInputIterator::kDefaultMaxBatches;
+
+PipelinedInputIterator::PipelinedInputIterator(InternalIterator* iter,
+                                               Env* env, Env::Priority pri,
+                                               size_t batch_bytes,
+                                               size_t max_batches)
+    : iter_(iter),
+      env_(env),
+      pri_(pri),
+      batch_bytes_(batch_bytes),
+      max_batches_(max_batches > 0 ? max_batches : 1),
+      perf_level_(GetPerfLevel()),
+      perf_flags_(GetPerfFlags()) {
+  assert(iter_);
+  assert(env_);
+}
+
+PipelinedInputIterator::~PipelinedInputIterator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  // A job still queued might never run if the thread pool is busy with the
+  // consumer
+  if (env_->UnSchedule(this, pri_) > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scheduled_ = false;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !scheduled_ && !reading_; });
+  }
+  status_.PermitUncheckedError();
+}
+
+void PipelinedInputIterator::SeekToFirst() {
+  Position(Op::kSeekToFirst, Slice());
+}
+
+void PipelinedInputIterator::Seek(const Slice& target) {
+  Position(Op::kSeek, target);
+}
+
+void PipelinedInputIterator::Next() {
+  assert(Valid());
+  ++pos_;
+  if (pos_ < current_->entries.size() || current_->last) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  NextBatch(lock);
+}
+
+void PipelinedInputIterator::SeekToLast() {
+  Invalidate(Status::NotSupported("SeekToLast() on PipelinedInputIterator"));
+}
+
+void PipelinedInputIterator::SeekForPrev(const Slice& /*target*/) {
+  Invalidate(Status::NotSupported("SeekForPrev() on PipelinedInputIterator"));
+}
+
+void PipelinedInputIterator::Prev() {
+  Invalidate(Status::NotSupported("Prev() on PipelinedInputIterator"));
+}
+
+Status PipelinedInputIterator::status() const {
+  if (current_ != nullptr && current_->last &&
+      pos_ >= current_->entries.size()) {
+    return current_->status;
+  }
+  return status_;
+}
+
+void PipelinedInputIterator::Position(Op op, const Slice& target) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  status_ = Status::OK();
+  if (current_) {
+    RecycleBatch(std::move(current_));
+  }
+  while (!ready_.empty()) {
+    RecycleBatch(std::move(ready_.front()));
+    ready_.pop_front();
+  }
+  ++generation_;
+  pending_op_ = op;
+  seek_target_.assign(target.data(), target.size());
+  has_more_ = true;
+  MaybeScheduleRead();
+  NextBatch(lock);
+}
+
+void PipelinedInputIterator::NextBatch(std::unique_lock<std::mutex>& lock) {
+  if (current_) {
+    RecycleBatch(std::move(current_));
+  }
+  while (ready_.empty()) {
+    if (CanRead()) {
+      ReadBatch(lock, /*in_job=*/false);
+    } else {
+      cv_.wait(lock);
+    }
+  }
+  current_ = std::move(ready_.front());
+  ready_.pop_front();
+  pos_ = 0;
+  AddReadStats(current_->read_stats);
+  // There is room in the queue again
+  MaybeScheduleRead();
+}
+
+void PipelinedInputIterator::RecycleBatch(std::unique_ptr<Batch>&& batch) {
+  batch->status.PermitUncheckedError();
+  free_.push_back(std::move(batch));
+}
+
+void PipelinedInputIterator::Invalidate(const Status& s) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_) {
+    RecycleBatch(std::move(current_));
+  }
+  status_ = s;
+}
+
+bool PipelinedInputIterator::CanRead() const {
+  return !shutdown_ && !reading_ && (pending_op_ != Op::kNone || has_more_) &&
+         ready_.size() < max_batches_;
+}
+
+void PipelinedInputIterator::ReadBatch(std::unique_lock<std::mutex>& lock,
+                                       bool in_job) {
+  assert(CanRead());
+  reading_ = true;
+  const Op op = pending_op_;
+  const uint64_t generation = generation_;
+  const std::string target = op == Op::kSeek ? seek_target_ : std::string();
+  pending_op_ = Op::kNone;
+  std::unique_ptr<Batch> batch;
+  if (free_.empty()) {
+    batch.reset(new Batch);
+  } else {
+    batch = std::move(free_.back());
+    free_.pop_back();
+  }
+  lock.unlock();
+
+  ReadStats before;
+  if (in_job) {
+    CaptureReadStats(&before);
+  }
+  if (op == Op::kSeekToFirst) {
+    iter_->SeekToFirst();
+  } else if (op == Op::kSeek) {
+    iter_->Seek(target);
+  }
+  if (op != Op::kNone) {
+    TEST_SYNC_POINT("PipelinedInputIterator::ReadBatch:Positioned");
+  }
+  FillBatch(batch.get());
+  batch->read_stats.clear();
+  if (in_job) {
+    CaptureReadStats(&batch->read_stats);
+    for (size_t i = 0; i < before.size(); ++i) {
+      batch->read_stats[i] -= before[i];
+    }
+  }
+
+  lock.lock();
+  reading_ = false;
+  if (shutdown_ || generation_ != generation) {
+    // The consumer moved on while the batch was read
+    RecycleBatch(std::move(batch));
+  } else {
+    has_more_ = !batch->last;
+    ready_.push_back(std::move(batch));
+  }
+  cv_.notify_all();
+}
+
+void PipelinedInputIterator::MaybeScheduleRead() {
+  if (scheduled_ || !CanRead()) {
+    return;
+  }
+  scheduled_ = true;
+  env_->Schedule(&PipelinedInputIterator::BGWorkRead, this, pri_, this);
+}
+
+void PipelinedInputIterator::BGWorkRead(void* arg) {
+  reinterpret_cast<PipelinedInputIterator*>(arg)->BackgroundRead();
+}
+
+void PipelinedInputIterator::BackgroundRead() {
+  const PerfLevel saved_perf_level = GetPerfLevel();
+  const PerfFlags saved_perf_flags = GetPerfFlags();
+  SetPerfLevel(perf_level_);
+  SetPerfFlags(perf_flags_);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (CanRead()) {
+      ReadBatch(lock, /*in_job=*/true);
+    }
+    scheduled_ = false;
+    // Notify under the lock: the destructor may free this iterator right
+    // after
+    cv_.notify_all();
+  }
+  SetPerfLevel(saved_perf_level);
+  SetPerfFlags(saved_perf_flags);
+}
+
+void PipelinedInputIterator::FillBatch(Batch* batch) {
+  batch->buf.clear();
+  batch->entries.clear();
+  batch->last = false;
+  batch->status = Status::OK();
+  // At least one entry, however big, per batch
+  while (iter_->Valid() &&
+         (batch->entries.empty() || batch->buf.size() < batch_bytes_)) {
+    const Slice k = iter_->key();
+    const Slice v = iter_->value();
+    batch->entries.push_back({batch->buf.size(), k.size(), v.size()});
+    batch->buf.append(k.data(), k.size());
+    batch->buf.append(v.data(), v.size());
+    iter_->Next();
+  }
+  if (!iter_->Valid()) {
+    batch->last = true;
+    batch->status = iter_->status();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
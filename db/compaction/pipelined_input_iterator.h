@@ -0,0 +1,158 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rocksdb/env.h"
+#include "rocksdb/perf_flag.h"
+#include "rocksdb/perf_level.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/status.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An internal iterator that reads its input iterator ahead of the consumer,
+// in jobs scheduled in the `pri` thread pool of `env`. Entries are copied
+// into batches of about `batch_bytes` and handed over through a queue of at
+// most `max_batches`, so that reading and decompressing the input overlaps
+// with whatever the consumer does with the entries. Compactions use it to
+// read several input files in parallel with merging them (see
+// DBOptions::max_compaction_input_threads).
+//
+// A job reads batches until the queue is full, the input is exhausted or the
+// iterator is repositioned. When the consumer runs out of batches while no
+// job is reading, for example because the thread pool is busy with the
+// compaction consuming them, it reads the next batch itself.
+//
+// The jobs run with the perf level and flags of the thread creating the
+// iterator. What they add to the perf and I/O stats contexts of their thread
+// while reading a batch is added to the ones of the consumer thread when it
+// gets to the batch, so that the reads count towards the consumer's work.
+//
+// Only forward iteration is supported. Seek() and SeekToFirst() discard the
+// batches read so far and restart reading at the new position. Keys and
+// values are not pinned: they stay valid until the iterator is moved.
+//
+// The input iterator is owned by this iterator and read by one job (or the
+// consumer) at a time, so it must not rely on state that the consumer
+// mutates. In particular, its range tombstones must have been added to any
+// RangeDelAggregator up front.
+class PipelinedInputIterator : public InternalIterator {
+ public:
+  static constexpr size_t kDefaultBatchBytes = 64 << 10;
+  static constexpr size_t kDefaultMaxBatches = 4;
+
+  PipelinedInputIterator(InternalIterator* iter, Env* env, Env::Priority pri,
+                         size_t batch_bytes = kDefaultBatchBytes,
+                         size_t max_batches = kDefaultMaxBatches);
+  ~PipelinedInputIterator() override;
+
+  // No copying allowed
+  PipelinedInputIterator(const PipelinedInputIterator&) = delete;
+  PipelinedInputIterator& operator=(const PipelinedInputIterator&) = delete;
+
+  bool Valid() const override {
+    return current_ != nullptr && pos_ < current_->entries.size();
+  }
+  void SeekToFirst() override;
+  void Seek(const Slice& target) override;
+  void Next() override;
+  // Not supported; make the iterator invalid with a NotSupported status.
+  void SeekToLast() override;
+  void SeekForPrev(const Slice& target) override;
+  void Prev() override;
+
+  Slice key() const override {
+    assert(Valid());
+    const Entry& e = current_->entries[pos_];
+    return Slice(current_->buf.data() + e.offset, e.key_size);
+  }
+  Slice value() const override {
+    assert(Valid());
+    const Entry& e = current_->entries[pos_];
+    return Slice(current_->buf.data() + e.offset + e.key_size, e.value_size);
+  }
+  Status status() const override;
+
+ private:
+  struct Entry {
+    size_t offset;
+    size_t key_size;
+    size_t value_size;
+  };
+  // Counters of the perf and I/O stats contexts of a thread, see
+  // CaptureReadStats() in the .cc file
+  using ReadStats = std::vector<uint64_t>;
+  struct Batch {
+    // Keys, each followed by its value
+    std::string buf;
+    std::vector<Entry> entries;
+    // Whether the input iterator reached its end after this batch, with
+    // `status`
+    bool last = false;
+    Status status;
+    // What reading the batch in a job added to the counters. Empty if the
+    // consumer read it.
+    ReadStats read_stats;
+  };
+  enum class Op { kNone, kSeekToFirst, kSeek };
+
+  void Position(Op op, const Slice& target);
+  // Waits for the next batch, or reads it, and makes it current
+  void NextBatch(std::unique_lock<std::mutex>& lock);
+  // REQUIRES: mutex_ held
+  void RecycleBatch(std::unique_ptr<Batch>&& batch);
+  void Invalidate(const Status& s);
+  // Whether the next batch can be read now. REQUIRES: mutex_ held
+  bool CanRead() const;
+  // Reads the next batch, releasing mutex_ meanwhile. REQUIRES: CanRead()
+  void ReadBatch(std::unique_lock<std::mutex>& lock, bool in_job);
+  // REQUIRES: mutex_ held
+  void MaybeScheduleRead();
+  static void BGWorkRead(void* arg);
+  void BackgroundRead();
+  void FillBatch(Batch* batch);
+
+  const std::unique_ptr<InternalIterator> iter_;
+  Env* const env_;
+  const Env::Priority pri_;
+  const size_t batch_bytes_;
+  const size_t max_batches_;
+  const PerfLevel perf_level_;
+  const PerfFlags perf_flags_;
+
+  // Owned by the consumer
+  std::unique_ptr<Batch> current_;
+  size_t pos_ = 0;
+  Status status_;
+
+  // Protects the members below
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool shutdown_ = false;
+  // Whether a job is scheduled or running
+  bool scheduled_ = false;
+  // Whether a job or the consumer is reading the input iterator
+  bool reading_ = false;
+  // Whether the input iterator has entries left to read at its position
+  bool has_more_ = false;
+  // Bumped by every repositioning, which invalidates the batches read before
+  uint64_t generation_ = 0;
+  Op pending_op_ = Op::kNone;
+  std::string seek_target_;
+  std::deque<std::unique_ptr<Batch>> ready_;
+  std::vector<std::unique_ptr<Batch>> free_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
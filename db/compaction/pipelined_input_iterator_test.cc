@@ -0,0 +1,265 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/iostats_context.h"
+#include "rocksdb/perf_context.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/vector_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A vector iterator which fails with `status` once it reaches its end
+class FailingVectorIterator : public VectorIterator {
+ public:
+  FailingVectorIterator(const std::vector<std::string>& keys,
+                        const std::vector<std::string>& values,
+                        const Status& status)
+      : VectorIterator(keys, values), status_(status) {}
+
+  Status status() const override {
+    return Valid() ? Status::OK() : status_;
+  }
+
+ private:
+  Status status_;
+};
+
+// A vector iterator which adds one to the bytes_read I/O stat and to the
+// block_read_count perf counter of its thread whenever it is moved, and
+// records the perf levels it was moved with
+class CountingVectorIterator : public VectorIterator {
+ public:
+  CountingVectorIterator(const std::vector<std::string>& keys,
+                         const std::vector<std::string>& values,
+                         std::vector<PerfLevel>* perf_levels)
+      : VectorIterator(keys, values), perf_levels_(perf_levels) {}
+
+  void SeekToFirst() override {
+    Count();
+    VectorIterator::SeekToFirst();
+  }
+  void Next() override {
+    Count();
+    VectorIterator::Next();
+  }
+
+ private:
+  void Count() {
+    get_iostats_context()->bytes_read++;
+    get_perf_context()->block_read_count++;
+    perf_levels_->push_back(GetPerfLevel());
+  }
+
+  std::vector<PerfLevel>* perf_levels_;
+};
+
+class PipelinedInputIteratorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Env::Default()->IncBackgroundThreadsIfNeeded(2, Env::Priority::LOW);
+    for (int i = 0; i < 1000; ++i) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "key%06d", i);
+      keys_.emplace_back(buf);
+      values_.emplace_back("value" + std::to_string(i));
+    }
+  }
+
+  // Batches of a few entries so that most steps cross a batch boundary
+  std::unique_ptr<PipelinedInputIterator> NewIterator(
+      InternalIterator* iter) const {
+    return std::unique_ptr<PipelinedInputIterator>(
+        new PipelinedInputIterator(iter, Env::Default(), Env::Priority::LOW,
+                                   /*batch_bytes=*/64, /*max_batches=*/2));
+  }
+
+  std::vector<std::string> keys_;
+  std::vector<std::string> values_;
+};
+
+TEST_F(PipelinedInputIteratorTest, ForwardIteration) {
+  auto iter = NewIterator(new VectorIterator(keys_, values_));
+
+  iter->SeekToFirst();
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys_[i], iter->key().ToString());
+    ASSERT_EQ(values_[i], iter->value().ToString());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(PipelinedInputIteratorTest, Empty) {
+  auto iter = NewIterator(new VectorIterator({}, {}));
+
+  iter->SeekToFirst();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(PipelinedInputIteratorTest, LargeEntry) {
+  const std::string large_value(1000, 'v');
+  auto iter = NewIterator(
+      new VectorIterator({"a", "b", "c"}, {"x", large_value, "y"}));
+
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("a", iter->key().ToString());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+  ASSERT_EQ(large_value, iter->value().ToString());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("y", iter->value().ToString());
+  iter->Next();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(PipelinedInputIteratorTest, Seek) {
+  auto iter = NewIterator(new VectorIterator(keys_, values_));
+
+  // Seek while the background thread is still reading ahead
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  for (size_t target : {500, 10, 999, 0}) {
+    iter->Seek(keys_[target]);
+    for (size_t i = target; i < std::min(keys_.size(), target + 50); ++i) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys_[i], iter->key().ToString());
+      iter->Next();
+    }
+  }
+
+  iter->Seek("key999999");
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(keys_[0], iter->key().ToString());
+}
+
+TEST_F(PipelinedInputIteratorTest, BackwardNotSupported) {
+  auto iter = NewIterator(new VectorIterator(keys_, values_));
+
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  iter->Prev();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsNotSupported());
+
+  iter->SeekToLast();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsNotSupported());
+
+  iter->SeekForPrev(keys_[10]);
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsNotSupported());
+
+  // Forward positioning recovers
+  iter->Seek(keys_[10]);
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(keys_[10], iter->key().ToString());
+}
+
+TEST_F(PipelinedInputIteratorTest, ErrorStatus) {
+  auto iter = NewIterator(
+      new FailingVectorIterator(keys_, values_, Status::IOError("injected")));
+
+  iter->SeekToFirst();
+  size_t count = 0;
+  for (; iter->Valid(); iter->Next()) {
+    // The error only shows once the entries read before it are consumed
+    ASSERT_OK(iter->status());
+    ++count;
+  }
+  ASSERT_EQ(keys_.size(), count);
+  ASSERT_TRUE(iter->status().IsIOError());
+}
+
+TEST_F(PipelinedInputIteratorTest, ReadStats) {
+  std::vector<PerfLevel> perf_levels;
+  SetPerfLevel(PerfLevel::kEnableTimeExceptForMutex);
+  get_iostats_context()->Reset();
+  get_perf_context()->Reset();
+  {
+    auto iter = NewIterator(
+        new CountingVectorIterator(keys_, values_, &perf_levels));
+    iter->SeekToFirst();
+    size_t count = 0;
+    for (; iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_EQ(keys_.size(), count);
+    ASSERT_OK(iter->status());
+  }
+  SetPerfLevel(PerfLevel::kEnableCount);
+
+  // Whichever thread read the input, its reads count towards this one
+  ASSERT_EQ(keys_.size() + 1, get_iostats_context()->bytes_read);
+  ASSERT_EQ(keys_.size() + 1, get_perf_context()->block_read_count);
+  ASSERT_EQ(keys_.size() + 1, perf_levels.size());
+  for (PerfLevel level : perf_levels) {
+    ASSERT_EQ(PerfLevel::kEnableTimeExceptForMutex, level);
+  }
+}
+
+TEST_F(PipelinedInputIteratorTest, BusyThreadPool) {
+  // The consumer reads the input itself while the jobs cannot run
+  std::vector<test::SleepingBackgroundTask> sleeping_tasks(2);
+  for (auto& sleeping_task : sleeping_tasks) {
+    Env::Default()->Schedule(&test::SleepingBackgroundTask::DoSleepTask,
+                             &sleeping_task, Env::Priority::LOW);
+    sleeping_task.WaitUntilSleeping();
+  }
+  {
+    auto iter = NewIterator(new VectorIterator(keys_, values_));
+    iter->SeekToFirst();
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys_[i], iter->key().ToString());
+      iter->Next();
+    }
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+    // And destroying it does not wait for them
+    iter->Seek(keys_[10]);
+    ASSERT_TRUE(iter->Valid());
+  }
+  for (auto& sleeping_task : sleeping_tasks) {
+    sleeping_task.WakeUp();
+    sleeping_task.WaitUntilDone();
+  }
+}
+
+TEST_F(PipelinedInputIteratorTest, DestroyWhileReading) {
+  for (int i = 0; i < 10; ++i) {
+    auto iter = NewIterator(new VectorIterator(keys_, values_));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+  }
+  // Never positioned: no job to wait for
+  auto iter = NewIterator(new VectorIterator(keys_, values_));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
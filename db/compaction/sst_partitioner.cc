@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "rocksdb/comparator.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
@@ -58,6 +59,69 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_next_level_boundary_type_info = {
+#ifndef ROCKSDB_LITE
+        {"min_file_size",
+         {0, OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+#endif  // ROCKSDB_LITE
+};
+
+SstPartitionerNextLevelBoundary::SstPartitionerNextLevelBoundary(
+    const SstPartitioner::Context& context, uint64_t min_file_size)
+    : comparator_(context.comparator),
+      boundaries_(context.next_level_boundaries),
+      min_file_size_(min_file_size != 0 ? min_file_size
+                                        : context.target_output_file_size / 4) {
+  if (comparator_ == nullptr) {
+    boundaries_.clear();
+  }
+}
+
+PartitionerResult SstPartitionerNextLevelBoundary::ShouldPartition(
+    const PartitionerRequest& request) {
+  // Skip the boundaries before the previous key
+  while (next_boundary_ < boundaries_.size() &&
+         comparator_->Compare(boundaries_[next_boundary_],
+                              *request.prev_user_key) < 0) {
+    next_boundary_++;
+  }
+  // A file of the next level ends between the two keys
+  if (next_boundary_ < boundaries_.size() &&
+      comparator_->Compare(boundaries_[next_boundary_],
+                           *request.current_user_key) < 0 &&
+      request.current_output_file_size >= min_file_size_) {
+    return kRequired;
+  }
+  return kNotRequired;
+}
+
+bool SstPartitionerNextLevelBoundary::CanDoTrivialMove(
+    const Slice& /* smallest_user_key */, const Slice& /* largest_user_key */) {
+  return true;
+}
+
+SstPartitionerNextLevelBoundaryFactory::SstPartitionerNextLevelBoundaryFactory(
+    uint64_t min_file_size)
+    : min_file_size_(min_file_size) {
+  RegisterOptions("MinFileSize", &min_file_size_,
+                  &sst_next_level_boundary_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerNextLevelBoundaryFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(
+      new SstPartitionerNextLevelBoundary(context, min_file_size_));
+}
+
+std::shared_ptr<SstPartitionerFactory>
+NewSstPartitionerNextLevelBoundaryFactory(uint64_t min_file_size) {
+  return std::make_shared<SstPartitionerNextLevelBoundaryFactory>(
+      min_file_size);
+}
+
 #ifndef ROCKSDB_LITE
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
@@ -70,7 +134,15 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerNextLevelBoundaryFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerNextLevelBoundaryFactory(0));
+        return guard->get();
+      });
+  return 2;
 }
 }  // namespace
 #endif  // ROCKSDB_LITE
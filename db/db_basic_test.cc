@@ -9,6 +9,7 @@
 
 #include <cstring>
 
+#include "cache/cache_reservation_manager.h"
 #include "db/db_test_util.h"
 #include "options/options_helper.h"
 #include "port/stack_trace.h"
@@ -556,6 +557,35 @@ TEST_F(DBBasicTest, ManifestRollOver) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, ManifestRollOverSpaceAmp) {
+  Options options = CurrentOptions();
+  options.max_manifest_file_size = 10;  // 10 bytes
+  // Leave room for edits up to 1000 times the size of the snapshot
+  options.max_manifest_space_amp_pct = 100000;
+  DestroyAndReopen(options);
+
+  const uint64_t manifest_after_open = dbfull()->TEST_Current_Manifest_FileNo();
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(Put("key" + std::to_string(i), std::string(1000, 'v')));
+    ASSERT_OK(Flush());
+    ASSERT_EQ(manifest_after_open, dbfull()->TEST_Current_Manifest_FileNo());
+  }
+
+  // Without the allowance, the edits alone exceed max_manifest_file_size
+  options.max_manifest_space_amp_pct = 0;
+  Reopen(options);
+  const uint64_t manifest_after_reopen =
+      dbfull()->TEST_Current_Manifest_FileNo();
+  ASSERT_GT(manifest_after_reopen, manifest_after_open);
+  ASSERT_OK(Put("key3", std::string(1000, 'v')));
+  ASSERT_OK(Flush());
+  ASSERT_GT(dbfull()->TEST_Current_Manifest_FileNo(), manifest_after_reopen);
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(std::string(1000, 'v'), Get("key" + std::to_string(i)));
+  }
+}
+
 TEST_F(DBBasicTest, IdentityAcrossRestarts1) {
   do {
     std::string id1;
@@ -2162,6 +2192,88 @@ TEST_P(DBMultiGetRowCacheTest, MultiGetBatched) {
 INSTANTIATE_TEST_CASE_P(DBMultiGetRowCacheTest, DBMultiGetRowCacheTest,
                         testing::Values(true, false));
 
+TEST_F(DBBasicTest, GetWithDataBlockLookupIndex) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.data_block_lookup_index = true;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.block_size = 256;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 300;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Merge(Key(7), "m1"));
+  ASSERT_OK(Merge(Key(7), "m2"));
+  ASSERT_OK(Delete(Key(8)));
+  // Versions of "k_span" kept by snapshots span several data blocks
+  std::vector<const Snapshot*> snapshots;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put("k_span", std::string(100, static_cast<char>('a' + i))));
+    snapshots.push_back(db_->GetSnapshot());
+  }
+  ASSERT_OK(Flush());
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; ++i) {
+      if (i == 7) {
+        ASSERT_EQ("v7,m1,m2", Get(Key(i)));
+      } else if (i == 8) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else {
+        ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+      }
+    }
+    ASSERT_EQ("NOT_FOUND", Get(Key(kNumKeys)));
+    ASSERT_EQ("NOT_FOUND", Get("k_missing"));
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_EQ(std::string(100, static_cast<char>('a' + i)),
+                Get("k_span", snapshots[i]));
+    }
+  };
+
+  const uint64_t index_accesses_before =
+      TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT) +
+      TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+  for (int i = 0; i < kNumKeys; ++i) {
+    if (i != 7 && i != 8) {
+      ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+    }
+  }
+  // Apart from the odd key that happens to span a block boundary, none of
+  // these needs the index block
+  ASSERT_LT(TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT) +
+                TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS) -
+                index_accesses_before,
+            5U);
+  verify();
+  // The lookup index is charged to the block cache
+  ASSERT_GE(table_options.block_cache->GetUsage(),
+            CacheReservationManager::GetDummyEntrySize());
+
+  // Files with a lookup index can be read without using it, and vice versa
+  table_options.data_block_lookup_index = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  for (auto* snapshot : snapshots) {
+    db_->ReleaseSnapshot(snapshot);
+  }
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; ++i) {
+    if (i != 7 && i != 8) {
+      ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+    }
+  }
+  ASSERT_EQ("v7,m1,m2", Get(Key(7)));
+  ASSERT_EQ(std::string(100, 'j'), Get("k_span"));
+}
+
 TEST_F(DBBasicTest, GetAllKeyVersions) {
   Options options = CurrentOptions();
   options.env = env_;
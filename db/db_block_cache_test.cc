@@ -18,6 +18,7 @@
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
+#include "table/hot_key_ranges.h"
 #include "util/compression.h"
 #include "util/defer.h"
 #include "util/random.h"
@@ -795,6 +796,76 @@ TEST_F(DBBlockCacheTest, DynamicallyWarmCacheDuringFlush) {
               options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_HIT));
   }
 }
+
+TEST_F(DBBlockCacheTest, WarmCacheWithHotDataBlocksDuringCompaction) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  // One key per data block
+  table_options.block_size = 1;
+  table_options.prepopulate_block_cache =
+      BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndHotCompaction;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 20;
+  for (int i = 0; i < 2; i++) {
+    for (int k = 0; k < kNumKeys; k++) {
+      ASSERT_OK(Put(Key(k), std::string(kValueSize, 'a' + i)));
+    }
+    ASSERT_OK(Flush());
+    // Flushes still warm every block
+    ASSERT_EQ(static_cast<uint64_t>(kNumKeys),
+              options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD));
+  }
+
+  // Only keys 5 and 6 are hot
+  table_options.block_cache->EraseUnRefEntries();
+  ASSERT_EQ(std::string(kValueSize, 'b'), Get(Key(5)));
+  ASSERT_EQ(std::string(kValueSize, 'b'), Get(Key(6)));
+  ASSERT_EQ(2,
+            options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD));
+
+  size_t num_hot_ranges = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::FindHotKeyRanges", [&](void* arg) {
+        num_hot_ranges = static_cast<HotKeyRanges*>(arg)->size();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(1, num_hot_ranges);
+
+  // The output blocks of the hot keys are warmed, plus at most the block
+  // before them, whose key can be the separator starting the hot range
+  const uint64_t num_warmed =
+      options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD);
+  ASSERT_GE(num_warmed, 2U);
+  ASSERT_LE(num_warmed, 3U);
+  // Not counting the reads of the input blocks by the compaction
+  options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_HIT);
+  options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS);
+
+  ASSERT_EQ(std::string(kValueSize, 'b'), Get(Key(5)));
+  ASSERT_EQ(std::string(kValueSize, 'b'), Get(Key(6)));
+  ASSERT_EQ(2,
+            options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_HIT));
+  ASSERT_EQ(0,
+            options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS));
+
+  ASSERT_EQ(std::string(kValueSize, 'b'), Get(Key(15)));
+  ASSERT_EQ(0,
+            options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_HIT));
+  ASSERT_EQ(1,
+            options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS));
+}
 #endif
 
 namespace {
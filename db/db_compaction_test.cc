@@ -1029,6 +1029,145 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevelBoundary) {
+  // 0 stands for a quarter of target_file_size_base, which no file reaches
+  for (uint64_t min_file_size : {uint64_t{1}, uint64_t{0}, uint64_t{1} << 30}) {
+    Options options = CurrentOptions();
+    options.compaction_style = kCompactionStyleLevel;
+    options.disable_auto_compactions = true;
+    options.sst_partitioner_factory =
+        NewSstPartitionerNextLevelBoundaryFactory(min_file_size);
+    DestroyAndReopen(options);
+
+    // Three files @ L2, ending at keys 9, 19 and 29
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 10; j++) {
+        ASSERT_OK(Put(Key(i * 10 + j), "old"));
+      }
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(2);
+    // Two overlapping files @ L0 spanning all of them, which cannot be
+    // trivially moved. The values are large enough for the output file to
+    // have flushed data blocks by the time a boundary is crossed.
+    const std::string new_value(1000, 'n');
+    for (const std::string& value : {std::string(1000, 't'), new_value}) {
+      for (int i = 0; i < 30; i++) {
+        ASSERT_OK(Put(Key(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_EQ("2,0,3", FilesPerLevel());
+
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    std::vector<LiveFileMetaData> files;
+    dbfull()->GetLiveFilesMetaData(&files);
+    std::vector<std::string> l1_largest_keys;
+    for (const auto& file : files) {
+      if (file.level == 1) {
+        l1_largest_keys.push_back(file.largestkey);
+      }
+    }
+    std::sort(l1_largest_keys.begin(), l1_largest_keys.end());
+    if (min_file_size == 1) {
+      // Cut where the L2 files end
+      ASSERT_EQ(std::vector<std::string>({Key(9), Key(19), Key(29)}),
+                l1_largest_keys);
+    } else {
+      // The output never gets big enough to be cut
+      ASSERT_EQ(std::vector<std::string>({Key(29)}), l1_largest_keys);
+    }
+    for (int i = 0; i < 30; i++) {
+      ASSERT_EQ(new_value, Get(Key(i)));
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, HybridCompaction) {
+  Options options = CurrentOptions();
+  options.num_levels = 4;
+  // L0 to L2 are size-tiered, L3 is leveled
+  options.compaction_options_hybrid.leveled_levels = 1;
+  options.level0_file_num_compaction_trigger = 3;
+  options.max_bytes_for_level_base = 10 << 10;
+  options.max_bytes_for_level_multiplier = 2;
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_tiered_compactions{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "HybridCompactionPicker::PickTieredCompaction:Return",
+      [&](void* /*arg*/) { num_tiered_compactions++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  std::vector<std::string> values(100);
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 20; j++) {
+      int key_id = rnd.Uniform(100);
+      values[key_id] = rnd.RandomString(1000);
+      ASSERT_OK(Put(Key(key_id), values[key_id]));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(num_tiered_compactions, 0);
+  // L2 went over its target size
+  ASSERT_GT(NumTableFilesAtLevel(3), 0);
+  int num_sorted_runs = NumTableFilesAtLevel(0);
+  for (int level = 1; level < 3; level++) {
+    if (NumTableFilesAtLevel(level) > 0) {
+      num_sorted_runs++;
+    }
+  }
+  ASSERT_LT(num_sorted_runs, options.level0_file_num_compaction_trigger);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(values[i].empty() ? "NOT_FOUND" : values[i], Get(Key(i)));
+  }
+
+  options.level_compaction_dynamic_level_bytes = true;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+  options.level_compaction_dynamic_level_bytes = false;
+  options.compaction_options_hybrid.leveled_levels = 3;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
+TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevelBoundaryWriteAmp) {
+  // The bytes written by compactions for the same random overwrites, without
+  // and with the partitioner
+  uint64_t compaction_bytes_written[2];
+  for (int partitioned = 0; partitioned < 2; partitioned++) {
+    Options options = CurrentOptions();
+    options.compaction_style = kCompactionStyleLevel;
+    options.write_buffer_size = 64 << 10;
+    options.target_file_size_base = 64 << 10;
+    options.max_bytes_for_level_base = 256 << 10;
+    options.level0_file_num_compaction_trigger = 2;
+    options.num_levels = 4;
+    options.statistics = CreateDBStatistics();
+    if (partitioned) {
+      options.sst_partitioner_factory =
+          NewSstPartitionerNextLevelBoundaryFactory();
+    }
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    for (int i = 0; i < 40000; i++) {
+      ASSERT_OK(Put(Key(static_cast<int>(rnd.Uniform(20000))),
+                    rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+    compaction_bytes_written[partitioned] =
+        options.statistics->getTickerCount(COMPACT_WRITE_BYTES);
+  }
+  fprintf(stderr, "Compaction bytes written: %" PRIu64 " -> %" PRIu64 "\n",
+          compaction_bytes_written[0], compaction_bytes_written[1]);
+  ASSERT_LT(compaction_bytes_written[1], compaction_bytes_written[0]);
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -4945,6 +5084,205 @@ TEST_F(DBCompactionTest, CompactionLimiter) {
   ASSERT_OK(dbfull()->TEST_WaitForCompact());
 }
 
+TEST_F(DBCompactionTest, CostAwareCompactionLimiter) {
+  std::shared_ptr<ConcurrentTaskLimiter> limiter(
+      NewCostAwareConcurrentTaskLimiter("cost_aware_limiter", 1));
+
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.level0_file_num_compaction_trigger = 4;
+  options.max_background_jobs = 2;
+  options.compaction_thread_limiter = limiter;
+  env_->SetBackgroundThreads(1, Env::HIGH);
+  env_->SetBackgroundThreads(1, Env::LOW);
+  // Keep the compactions from starting until both column families need one
+  test::SleepingBackgroundTask sleeping_task_low;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task_low,
+                 Env::Priority::LOW);
+  sleeping_task_low.WaitUntilSleeping();
+
+  CreateAndReopenWithCF({"big", "small"}, options);
+
+  std::vector<std::string> compacted_cfs;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:BeforeCompaction", [&](void* arg) {
+        compacted_cfs.push_back(static_cast<ColumnFamilyData*>(arg)->GetName());
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Both column families have as many sorted runs to merge, but those of
+  // "small" take far fewer bytes to merge. "big" asks first.
+  Random rnd(301);
+  for (int cf = 1; cf <= 2; cf++) {
+    const int value_size = cf == 1 ? 10 << 10 : 10;
+    for (int n = 0; n < options.level0_file_num_compaction_trigger; n++) {
+      for (int i = 0; i < 10; i++) {
+        ASSERT_OK(Put(cf, Key(i), rnd.RandomString(value_size)));
+      }
+      ASSERT_OK(Flush(cf));
+    }
+  }
+
+  sleeping_task_low.WakeUp();
+  sleeping_task_low.WaitUntilDone();
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(std::vector<std::string>({"small", "big"}), compacted_cfs);
+  ASSERT_EQ(0, limiter->GetOutstandingTask());
+}
+
+TEST_F(DBCompactionTest, IncrementalManualCompaction) {
+  class ProgressListener : public EventListener {
+   public:
+    void OnManualCompactionProgress(
+        DB* /*db*/, const ManualCompactionProgressInfo& info) override {
+      infos.push_back(info);
+    }
+    std::vector<ManualCompactionProgressInfo> infos;
+  };
+  auto listener = std::make_shared<ProgressListener>();
+
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 4;
+  options.listeners.emplace_back(listener);
+  Reopen(options);
+
+  Random rnd(301);
+  for (int n = 0; n < 3; n++) {
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    if (n == 0) {
+      MoveFilesToLevel(2);
+    } else if (n == 1) {
+      MoveFilesToLevel(1);
+    }
+  }
+  ASSERT_EQ("1,1,1", FilesPerLevel());
+
+  int num_compactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:BeforeCompaction",
+      [&](void* /*arg*/) { num_compactions++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  CompactRangeOptions cro;
+  cro.exclusive_manual_compaction = false;
+  cro.incremental = true;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The data was moved down by the automatic compactions
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+  ASSERT_GE(num_compactions, 2);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+
+  ASSERT_GE(listener->infos.size(), 2U);
+  const ManualCompactionProgressInfo& first = listener->infos.front();
+  ASSERT_EQ(kDefaultColumnFamilyName, first.cf_name);
+  ASSERT_GT(first.total_bytes, 0U);
+  ASSERT_EQ(first.total_bytes, first.remaining_bytes);
+  ASSERT_EQ(0U, first.num_compacted_files);
+  const ManualCompactionProgressInfo& last = listener->infos.back();
+  ASSERT_EQ(first.total_bytes, last.total_bytes);
+  ASSERT_EQ(0U, last.remaining_bytes);
+  ASSERT_GT(last.num_compacted_files, 0U);
+}
+
+TEST_F(DBCompactionTest, IncrementalManualCompactionStopped) {
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 4;
+  Reopen(options);
+
+  Random rnd(301);
+  for (int n = 0; n < 3; n++) {
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    if (n == 0) {
+      MoveFilesToLevel(2);
+    } else if (n == 1) {
+      MoveFilesToLevel(1);
+    }
+  }
+  ASSERT_EQ("1,1,1", FilesPerLevel());
+
+  CompactRangeOptions cro;
+  cro.exclusive_manual_compaction = false;
+  cro.incremental = true;
+  std::atomic<bool> canceled(false);
+  cro.canceled = &canceled;
+  // Keep the marked files from being picked until the call is stopped. The
+  // compaction thread is released once the call returns, unless the call
+  // needs it to compact the range level by level.
+  auto run_stopped = [&](const std::function<void()>& stop,
+                         const std::function<void(Status)>& check,
+                         bool release_before_return) {
+    test::SleepingBackgroundTask sleeping_task_low;
+    env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask,
+                   &sleeping_task_low, Env::Priority::LOW);
+    sleeping_task_low.WaitUntilSleeping();
+    SyncPoint::GetInstance()->LoadDependency(
+        {{"DBImpl::RunIncrementalManualCompaction:Wait",
+          "DBCompactionTest::IncrementalManualCompactionStopped:Marked"}});
+    SyncPoint::GetInstance()->EnableProcessing();
+    port::Thread compact_thread(
+        [&] { check(db_->CompactRange(cro, nullptr, nullptr)); });
+    TEST_SYNC_POINT(
+        "DBCompactionTest::IncrementalManualCompactionStopped:Marked");
+    stop();
+    if (release_before_return) {
+      sleeping_task_low.WakeUp();
+    }
+    compact_thread.join();
+    if (!release_before_return) {
+      sleeping_task_low.WakeUp();
+    }
+    sleeping_task_low.WaitUntilDone();
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearTrace();
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  };
+
+  // The marks are removed when the call is canceled, so automatic
+  // compactions leave the files alone
+  run_stopped([&] { canceled.store(true); },
+              [](Status s) { ASSERT_TRUE(s.IsIncomplete()); },
+              false /* release_before_return */);
+  ASSERT_EQ("1,1,1", FilesPerLevel());
+  canceled.store(false);
+
+  // Disabling automatic compactions falls back to the level by level
+  // compaction of the whole range
+  run_stopped(
+      [&] {
+        ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "true"}}));
+      },
+      [](Status s) { ASSERT_OK(s); }, true /* release_before_return */);
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+
+  // And so do automatic compactions disabled from the start
+  for (int n = 0; n < 2; n++) {
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    if (n == 0) {
+      MoveFilesToLevel(1);
+    }
+  }
+  ASSERT_EQ("1,1,1", FilesPerLevel());
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+}
+
 INSTANTIATE_TEST_CASE_P(DBCompactionTestWithParam, DBCompactionTestWithParam,
                         ::testing::Values(std::make_tuple(1, true),
                                           std::make_tuple(1, false),
@@ -5264,6 +5602,126 @@ TEST_F(DBCompactionTest, ManualCompactionMax) {
   ASSERT_TRUE(num_compactions.load() == num_split);
 }
 
+TEST_F(DBCompactionTest, SubcompactionWorkQueue) {
+  class SubcompactionListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      subcompaction_elapsed_micros_ = ci.stats.subcompaction_elapsed_micros;
+    }
+    void OnSubcompactionBegin(const SubcompactionJobInfo& /*si*/) override {
+      ++num_subcompactions_;
+    }
+
+    std::mutex mutex_;
+    std::vector<uint64_t> subcompaction_elapsed_micros_;
+    std::atomic<int> num_subcompactions_{0};
+  };
+  auto* listener = new SubcompactionListener();
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 2;
+  options.target_file_size_base = 32 << 10;
+  options.listeners.emplace_back(listener);
+  DestroyAndReopen(options);
+
+  // Subcompactions are only formed when the output level has files
+  Random rnd(301);
+  for (int j = 0; j < 1200; j += 100) {
+    ASSERT_OK(Put(Key(j), rnd.RandomString(500)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  // Few large overlapping L0 files
+  for (int i = 0; i < 3; i++) {
+    for (int j = i; j < 1200; j += 3) {
+      ASSERT_OK(Put(Key(j), rnd.RandomString(500)));
+    }
+    ASSERT_OK(Flush());
+  }
+  const std::string expected = Contents();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(expected, Contents());
+
+  // More ranges than threads, each with its duration reported
+  std::lock_guard<std::mutex> lock(listener->mutex_);
+  ASSERT_GT(listener->subcompaction_elapsed_micros_.size(), 2U);
+  ASSERT_LE(listener->subcompaction_elapsed_micros_.size(), 8U);
+  ASSERT_EQ(listener->subcompaction_elapsed_micros_.size(),
+            static_cast<size_t>(listener->num_subcompactions_.load()));
+}
+
+TEST_F(DBCompactionTest, PipelinedCompactionInputs) {
+  std::atomic<int> num_positioned(0);
+  SyncPoint::GetInstance()->SetCallBack(
+      "PipelinedInputIterator::ReadBatch:Positioned",
+      [&](void* /*arg*/) { ++num_positioned; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // 1 pipelines a single L0 file only; 8 covers all inputs
+  uint64_t unpipelined_read_bytes = 0;
+  for (int threads : {0, 1, 8}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.max_compaction_input_threads = threads;
+    options.statistics = CreateDBStatistics();
+    options.target_file_size_base = 16 << 10;
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    for (int i = 0; i < 400; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(200)));
+      if (i % 100 == 99) {
+        ASSERT_OK(Flush());
+      }
+    }
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(50), Key(70)));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(2);
+    for (int i = 0; i < 400; i += 3) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(200)));
+    }
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(120), Key(250)));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    for (int i = 0; i < 3; i++) {
+      for (int j = i; j < 400; j += 7) {
+        ASSERT_OK(Put(Key(j), rnd.RandomString(200)));
+      }
+      ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                 Key(300 + i * 20), Key(310 + i * 20)));
+      ASSERT_OK(Flush());
+    }
+    ASSERT_EQ("3,1,4", FilesPerLevel());
+    const std::string expected = Contents();
+
+    num_positioned.store(0);
+    CompactRangeOptions cro;
+    cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+    ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+    ASSERT_EQ(expected, Contents());
+    // The reads of the inputs count towards the compaction wherever they
+    // were done
+    const uint64_t read_bytes =
+        options.statistics->getTickerCount(COMPACT_READ_BYTES);
+    if (threads == 0) {
+      ASSERT_EQ(0, num_positioned.load());
+      unpipelined_read_bytes = read_bytes;
+    } else {
+      ASSERT_GT(num_positioned.load(), 0);
+      ASSERT_EQ(unpipelined_read_bytes, read_bytes);
+    }
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBCompactionTest, CompactionDuringShutdown) {
   Options opts = CurrentOptions();
   opts.level0_file_num_compaction_trigger = 2;
@@ -23,6 +23,7 @@
 #include "util/mutexlock.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
+#include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -267,6 +268,290 @@ TEST_F(DBFlushTest, ManualFlushWithMinWriteBufferNumberToMerge) {
   t.join();
 }
 
+TEST_F(DBFlushTest, PartitionedFlush) {
+  class FlushedFilesListener : public EventListener {
+   public:
+    void OnFlushCompleted(DB* /*db*/, const FlushJobInfo& info) override {
+      MutexLock l(&mutex_);
+      flushed_files_.emplace(info.file_number, info);
+    }
+
+    port::Mutex mutex_;
+    std::map<uint64_t, FlushJobInfo> flushed_files_;
+  };
+
+  Options options = CurrentOptions();
+  options.write_buffer_size = 64 << 20;
+  options.target_file_size_base = 256 << 10;
+  options.max_flush_partitions = 8;
+  // Caps the files of a flush
+  options.level0_file_num_compaction_trigger = 4;
+  // Room for the two memtables flushed together and a new one
+  options.max_write_buffer_number = 4;
+  options.disable_auto_compactions = true;
+  auto listener = std::make_shared<FlushedFilesListener>();
+  options.listeners.push_back(listener);
+  Reopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 2000;
+  std::vector<std::string> values(kNumKeys);
+  // Written in decreasing key order, so that the sequence number range of
+  // the files of the first keys is within the one of the last keys'
+  for (int i = kNumKeys - 1; i >= 0; i--) {
+    values[i] = rnd.RandomString(1000);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  // Overwrite some keys in a second memtable flushed together with the first
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  for (int i = 0; i < kNumKeys; i += 7) {
+    values[i] = rnd.RandomString(1000);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(4U, files.size());
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+              return a.smallestkey < b.smallestkey;
+            });
+  for (size_t i = 0; i < files.size(); i++) {
+    ASSERT_EQ(0, files[i].level);
+    if (i > 0) {
+      ASSERT_LT(files[i - 1].largestkey, files[i].smallestkey);
+      // Each file keeps its own sequence number range
+      ASSERT_GT(files[i - 1].smallest_seqno, files[i].smallest_seqno);
+      ASSERT_LE(files[i - 1].largest_seqno, files[i].largest_seqno);
+    }
+  }
+#ifndef ROCKSDB_LITE
+  // Listeners are told about each file
+  {
+    MutexLock l(&listener->mutex_);
+    ASSERT_EQ(files.size(), listener->flushed_files_.size());
+    for (const LiveFileMetaData& file : files) {
+      auto it = listener->flushed_files_.find(file.file_number);
+      ASSERT_NE(it, listener->flushed_files_.end());
+      ASSERT_EQ(file.smallest_seqno, it->second.smallest_seqno);
+      ASSERT_EQ(file.largest_seqno, it->second.largest_seqno);
+      ASSERT_GT(it->second.table_properties.num_entries, 0U);
+    }
+  }
+#endif  // !ROCKSDB_LITE
+  ASSERT_EQ(Key(0), files.front().smallestkey);
+  ASSERT_EQ(Key(kNumKeys - 1), files.back().largestkey);
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+  verify();
+  // The files pass the consistency checks of the L0 files
+  Reopen(options);
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  verify();
+}
+
+TEST_F(DBFlushTest, FlushToDeepestLevel) {
+  Options options = CurrentOptions();
+  options.flush_to_deepest_level = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  DestroyAndReopen(options);
+
+  // Increasing keys never overlap the files already flushed
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 10; j++) {
+      ASSERT_OK(Put(Key(i * 10 + j), "v1"));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("0,0,0,3", FilesPerLevel());
+
+  // Overlapping files go right above the files they overlap
+  ASSERT_OK(Put(Key(5), "v2"));
+  ASSERT_OK(Put(Key(6), "v2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,0,1,3", FilesPerLevel());
+  ASSERT_OK(Put(Key(5), "v3"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,1,1,3", FilesPerLevel());
+  ASSERT_OK(Put(Key(5), "v4"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,1,1,3", FilesPerLevel());
+
+  auto verify = [&]() {
+    ASSERT_EQ("v4", Get(Key(5)));
+    ASSERT_EQ("v2", Get(Key(6)));
+    ASSERT_EQ("v1", Get(Key(7)));
+    ASSERT_EQ("v1", Get(Key(29)));
+  };
+  verify();
+  Reopen(options);
+  ASSERT_EQ("1,1,1,3", FilesPerLevel());
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+}
+
+#ifndef ROCKSDB_LITE
+TEST_F(DBFlushTest, FlushToDeepestLevelDuringIngestion) {
+  Options options = CurrentOptions();
+  options.flush_to_deepest_level = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  DestroyAndReopen(options);
+
+  // The memtable does not overlap the keys of the ingested file, but the
+  // flushed file covers its key range
+  ASSERT_OK(Put(Key(0), "v1"));
+  ASSERT_OK(Put(Key(20), "v1"));
+  const std::string external_file = dbname_ + "/ingested.sst";
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  ASSERT_OK(sst_file_writer.Open(external_file));
+  ASSERT_OK(sst_file_writer.Put(Key(5), "v2"));
+  ASSERT_OK(sst_file_writer.Put(Key(6), "v2"));
+  ASSERT_OK(sst_file_writer.Finish());
+
+  // The flush places its output while the ingestion, which picked its level
+  // before, writes the MANIFEST
+  std::atomic<bool> ingestion_writing{false};
+  std::atomic<bool> flush_written{false};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::IngestExternalFiles:BeforeLogAndApply",
+      [&](void* /*arg*/) { ingestion_writing.store(true); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:WriteManifestStart", [&](void* /*arg*/) {
+        if (ingestion_writing.load() && !flush_written.load()) {
+          TEST_SYNC_POINT(
+              "DBFlushTest::FlushToDeepestLevelDuringIngestion:Ingesting");
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::FlushJob:Flush",
+      [&](void* /*arg*/) { flush_written.store(true); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:BeforeWriterWaiting", [&](void* /*arg*/) {
+        if (flush_written.load()) {
+          TEST_SYNC_POINT(
+              "DBFlushTest::FlushToDeepestLevelDuringIngestion:FlushWaiting");
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:WriteManifestDone", [&](void* /*arg*/) {
+        if (ingestion_writing.exchange(false)) {
+          TEST_SYNC_POINT(
+              "DBFlushTest::FlushToDeepestLevelDuringIngestion:Ingested");
+        }
+      });
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBFlushTest::FlushToDeepestLevelDuringIngestion:Ingesting",
+        "DBImpl::FlushJob:Flush"},
+       {"DBFlushTest::FlushToDeepestLevelDuringIngestion:FlushWaiting",
+        "DBFlushTest::FlushToDeepestLevelDuringIngestion:Ingested"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  FlushOptions flush_options;
+  flush_options.wait = false;
+  ASSERT_OK(db_->Flush(flush_options));
+  ASSERT_OK(db_->IngestExternalFile({external_file},
+                                    IngestExternalFileOptions()));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The flushed file goes above the ingested one
+  ASSERT_EQ("0,0,1,1", FilesPerLevel());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  for (const LiveFileMetaData& file : files) {
+    ASSERT_EQ(file.smallestkey == Key(0) ? 2 : 3, file.level);
+  }
+  ASSERT_EQ("v1", Get(Key(0)));
+  ASSERT_EQ("v2", Get(Key(5)));
+  ASSERT_EQ("v1", Get(Key(20)));
+}
+#endif  // !ROCKSDB_LITE
+
+TEST_F(DBFlushTest, FlushPutsAndDeletesWithoutCompactionIterator) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  // Room for the two memtables flushed together and a new one
+  options.max_write_buffer_number = 4;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  int compaction_iterator_flushes = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BuildTable:CompactionIterator",
+      [&](void* /*arg*/) { compaction_iterator_flushes++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  auto flushed_entries = [&]() {
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    std::sort(files.begin(), files.end(),
+              [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+                return a.file_number < b.file_number;
+              });
+    return std::make_pair(files.back().num_entries,
+                          files.back().num_deletions);
+  };
+
+  // Only the newest entry of each key is kept, whatever the older ones are
+  ASSERT_OK(Merge("a", "m1"));
+  ASSERT_OK(Put("a", "v1"));
+  ASSERT_OK(Put("b", "v1"));
+  ASSERT_OK(Put("b", "v2"));
+  ASSERT_OK(Put("c", "v1"));
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  ASSERT_OK(Delete("c"));
+  ASSERT_OK(Put("d", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(0, compaction_iterator_flushes);
+  ASSERT_EQ(std::make_pair(uint64_t{4}, uint64_t{1}), flushed_entries());
+
+  // A merge hands the rest of the flush over to CompactionIterator
+  ASSERT_OK(Put("e", "v1"));
+  ASSERT_OK(Put("f", "v1"));
+  ASSERT_OK(Merge("f", "m1"));
+  ASSERT_OK(Put("g", "v1"));
+  ASSERT_OK(Put("g", "v2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, compaction_iterator_flushes);
+  ASSERT_EQ(std::make_pair(uint64_t{3}, uint64_t{0}), flushed_entries());
+
+  // So does a snapshot
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("h", "v1"));
+  ASSERT_OK(Put("h", "v2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, compaction_iterator_flushes);
+  db_->ReleaseSnapshot(snapshot);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  auto verify = [&]() {
+    ASSERT_EQ("v1", Get("a"));
+    ASSERT_EQ("v2", Get("b"));
+    ASSERT_EQ("NOT_FOUND", Get("c"));
+    ASSERT_EQ("v1", Get("d"));
+    ASSERT_EQ("v1", Get("e"));
+    ASSERT_EQ("v1,m1", Get("f"));
+    ASSERT_EQ("v2", Get("g"));
+    ASSERT_EQ("v2", Get("h"));
+  };
+  verify();
+  Reopen(options);
+  verify();
+}
+
 TEST_F(DBFlushTest, ScheduleOnlyOneBgThread) {
   Options options = CurrentOptions();
   Reopen(options);
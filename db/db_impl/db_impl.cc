@@ -515,6 +515,9 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 }
 
 Status DBImpl::CloseHelper() {
+  // The background WAL syncer must not touch the WAL while it is closed
+  StopWALSyncer();
+
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
   mutex_.Lock();
@@ -1320,6 +1323,8 @@ int DBImpl::FindMinimumEmptyLevelFitting(
 Status DBImpl::FlushWAL(bool sync) {
   if (manual_wal_flush_) {
     IOStatus io_s;
+    // All the writes up to this sequence number are in the WAL buffer by now
+    const SequenceNumber flushed_seq = versions_->LastSequence();
     {
       // We need to lock log_write_mutex_ since logs_ might change concurrently
       InstrumentedMutexLock wl(&log_write_mutex_);
@@ -1339,6 +1344,12 @@ Status DBImpl::FlushWAL(bool sync) {
       ROCKS_LOG_DEBUG(immutable_db_options_.info_log, "FlushWAL sync=false");
       return std::move(io_s);
     }
+    ROCKS_LOG_DEBUG(immutable_db_options_.info_log, "FlushWAL sync=true");
+    Status s = SyncWAL();
+    if (s.ok()) {
+      AdvanceDurableSequence(flushed_seq);
+    }
+    return s;
   }
   if (!sync) {
     return Status::OK();
@@ -1350,6 +1361,9 @@ Status DBImpl::FlushWAL(bool sync) {
 
 Status DBImpl::SyncWAL() {
   TEST_SYNC_POINT("DBImpl::SyncWAL:Begin");
+  // All the writes up to this sequence number are in the WAL files by now,
+  // unless they are still buffered with manual_wal_flush
+  const SequenceNumber synced_seq = versions_->LastSequence();
   autovector<log::Writer*, 1> logs_to_sync;
   bool need_log_dir_sync;
   uint64_t current_log_number;
@@ -1425,12 +1439,68 @@ Status DBImpl::SyncWAL() {
     InstrumentedMutexLock l(&mutex_);
     status = ApplyWALToManifest(&synced_wals);
   }
+  if (status.ok() && !manual_wal_flush_) {
+    AdvanceDurableSequence(synced_seq);
+  }
 
   TEST_SYNC_POINT("DBImpl::SyncWAL:BeforeMarkLogsSynced:2");
 
   return status;
 }
 
+void DBImpl::MaybeScheduleWALSync() {
+  {
+    std::lock_guard<std::mutex> lock(wal_syncer_mutex_);
+    if (wal_sync_scheduled_ || wal_syncer_shutdown_) {
+      return;
+    }
+    wal_sync_scheduled_ = true;
+  }
+  // A sync may wait for the ones of other writers, so use the flush pool
+  // rather than hold up compactions
+  const Env::Priority pri = env_->GetBackgroundThreads(Env::Priority::HIGH) > 0
+                                ? Env::Priority::HIGH
+                                : Env::Priority::LOW;
+  env_->Schedule(&DBImpl::BGWorkWALSync, this, pri);
+}
+
+void DBImpl::StopWALSyncer() {
+  std::unique_lock<std::mutex> lock(wal_syncer_mutex_);
+  wal_syncer_shutdown_ = true;
+  wal_syncer_cv_.wait(lock, [this] { return !wal_sync_scheduled_; });
+}
+
+void DBImpl::BGWorkWALSync(void* arg) {
+  reinterpret_cast<DBImpl*>(arg)->BackgroundCallWALSync();
+}
+
+void DBImpl::BackgroundCallWALSync() {
+  const uint64_t max_unsynced = immutable_db_options_.max_unsynced_wal_bytes;
+  while (true) {
+    // The bytes written from now on count towards the next sync
+    unsynced_wal_bytes_.store(0);
+    TEST_SYNC_POINT("DBImpl::BGWorkWALSync:BeforeSync");
+    Status s = SyncWAL();
+    if (!s.ok()) {
+      // Retried once the bound is crossed again. An I/O error is already set
+      // as the background error by SyncWAL().
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Background WAL sync failed: %s", s.ToString().c_str());
+    }
+    TEST_SYNC_POINT("DBImpl::BGWorkWALSync:AfterSync");
+    std::lock_guard<std::mutex> lock(wal_syncer_mutex_);
+    // The writes crossing the bound during the sync did not schedule
+    // another one, as this one was still scheduled
+    if (!s.ok() || wal_syncer_shutdown_ ||
+        unsynced_wal_bytes_.load() < max_unsynced) {
+      wal_sync_scheduled_ = false;
+      // Notify under the lock: StopWALSyncer() may destroy the DB right after
+      wal_syncer_cv_.notify_all();
+      return;
+    }
+  }
+}
+
 Status DBImpl::ApplyWALToManifest(VersionEdit* synced_wals) {
   // not empty, write to MANIFEST.
   mutex_.AssertHeld();
@@ -1503,6 +1573,21 @@ SequenceNumber DBImpl::GetLatestSequenceNumber() const {
   return versions_->LastSequence();
 }
 
+SequenceNumber DBImpl::GetLatestDurableSequenceNumber() const {
+  return durable_sequence_.load(std::memory_order_acquire);
+}
+
+void DBImpl::AdvanceDurableSequence(SequenceNumber seq) {
+  if (!recovered_wals_synced_) {
+    // The writes of the recovered WALs, below `seq`, may not be durable
+    return;
+  }
+  SequenceNumber cur = durable_sequence_.load(std::memory_order_relaxed);
+  while (cur < seq && !durable_sequence_.compare_exchange_weak(
+                          cur, seq, std::memory_order_acq_rel)) {
+  }
+}
+
 void DBImpl::SetLastPublishedSequence(SequenceNumber seq) {
   versions_->SetLastPublishedSequence(seq);
 }
@@ -4868,9 +4953,26 @@ Status DBImpl::IngestExternalFiles(
         }
         assert(0 == num_entries);
       }
+      // LogAndApply() releases the mutex while writing the MANIFEST, so
+      // flushes placing their outputs in the meantime must see the files
+      for (size_t i = 0; i != cfds_to_commit.size(); ++i) {
+        for (const auto& new_file : edit_lists[i][0]->GetNewFiles()) {
+          if (new_file.first > 0) {
+            cfds_to_commit[i]->compaction_picker()->RegisterFileBeingAdded(
+                new_file.first, new_file.second);
+          }
+        }
+      }
+      TEST_SYNC_POINT("DBImpl::IngestExternalFiles:BeforeLogAndApply");
       status =
           versions_->LogAndApply(cfds_to_commit, mutable_cf_options_list,
                                  edit_lists, &mutex_, directories_.GetDbDir());
+      for (size_t i = 0; i != cfds_to_commit.size(); ++i) {
+        for (const auto& new_file : edit_lists[i][0]->GetNewFiles()) {
+          cfds_to_commit[i]->compaction_picker()->UnregisterFileBeingAdded(
+              new_file.second.fd.GetNumber());
+        }
+      }
     }
 
     if (status.ok()) {
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <limits>
@@ -369,6 +370,7 @@ class DBImpl : public DB {
   virtual Status UnlockWAL() override;
 
   virtual SequenceNumber GetLatestSequenceNumber() const override;
+  virtual SequenceNumber GetLatestDurableSequenceNumber() const override;
 
   // IncreaseFullHistoryTsLow(ColumnFamilyHandle*, std::string) will acquire
   // and release db_mutex
@@ -670,6 +672,19 @@ class DBImpl : public DB {
                              bool exclusive, bool disallow_trivial_move,
                              uint64_t max_file_num_to_ignore);
 
+  // Moves the data of the range down to the deepest level holding some of it
+  // by marking its files for compaction and letting automatic compactions
+  // pick them. See CompactRangeOptions::incremental. *first_level and
+  // *output_level are the shallowest and deepest levels overlapping the range
+  // on input. On output, they are the levels left to compact level by level:
+  // only *output_level, the level the data was moved to, unless automatic
+  // compactions are disabled or paused. The marks not acted upon are removed
+  // on return.
+  Status RunIncrementalManualCompaction(
+      ColumnFamilyData* cfd, const CompactRangeOptions& compact_range_options,
+      const Slice* begin, const Slice* end, int* first_level,
+      int* output_level);
+
   // Return an internal iterator over the current state of the database.
   // The keys of this iterator are internal keys (see format.h).
   // The returned iterator should be deleted when no longer needed.
@@ -1282,6 +1297,10 @@ class DBImpl : public DB {
                                const Status& st,
                                const CompactionJobStats& job_stats, int job_id);
 
+  // REQUIRES: mutex locked, released while notifying
+  void NotifyOnManualCompactionProgress(
+      const ManualCompactionProgressInfo& info);
+
   void NotifyOnCompactionCompleted(ColumnFamilyData* cfd, Compaction* c,
                                    const Status& st,
                                    const CompactionJobStats& job_stats,
@@ -1702,6 +1721,17 @@ class DBImpl : public DB {
                          SequenceNumber* next_sequence, bool read_only,
                          bool* corrupted_log_found);
 
+  // Inserts `batches`, read from WAL `wal_number`, into the memtables with
+  // concurrent memtable writes, on up to max_wal_recovery_threads threads.
+  // Sets (*statuses)[i] to the status of inserting batches[i] and
+  // (*next_sequences)[i] to the sequence number following it, and returns
+  // whether any batch had writes to a live column family.
+  // REQUIRES: mutex locked; held while inserting
+  bool InsertRecoveredBatchesConcurrently(
+      const std::vector<WriteBatch>& batches, uint64_t wal_number,
+      std::vector<Status>* statuses,
+      std::vector<SequenceNumber>* next_sequences);
+
   // The following two methods are used to flush a memtable to
   // storage. The first one is used at database RecoveryTime (when the
   // database is opened) and is heavyweight because it holds the mutex
@@ -1722,6 +1752,9 @@ class DBImpl : public DB {
   // in case total_log_size > max_total_wal_size.
   Status RestoreAliveLogFiles(const std::vector<uint64_t>& log_numbers);
 
+  // Sync a WAL recovered by RestoreAliveLogFiles().
+  Status SyncRecoveredWAL(uint64_t wal_number);
+
   // num_bytes: for slowdown case, delay time is calculated based on
   //            `num_bytes` going through.
   Status DelayWrite(uint64_t num_bytes, const WriteOptions& write_options);
@@ -1922,6 +1955,19 @@ class DBImpl : public DB {
   // Schedule background tasks
   void StartPeriodicWorkScheduler();
 
+  // Schedule a background WAL sync in the flush thread pool (or the
+  // compaction one if it is empty), see DBOptions::max_unsynced_wal_bytes.
+  // No-op if one is already scheduled or the DB is closing.
+  void MaybeScheduleWALSync();
+  // Wait for the scheduled background WAL sync, if any, and prevent new ones
+  void StopWALSyncer();
+  static void BGWorkWALSync(void* arg);
+  void BackgroundCallWALSync();
+
+  // Raise the value returned by GetLatestDurableSequenceNumber() to `seq`,
+  // if it is lower. Called once all writes up to `seq` are synced in the WAL.
+  void AdvanceDurableSequence(SequenceNumber seq);
+
   void PrintStatistics();
 
   size_t EstimateInMemoryStatsHistorySize() const;
@@ -2392,6 +2438,21 @@ class DBImpl : public DB {
   // Used when disableWAL is true.
   std::atomic<bool> has_unpersisted_data_;
 
+  // See GetLatestDurableSequenceNumber()
+  std::atomic<SequenceNumber> durable_sequence_{0};
+  // Bytes written to the WAL since the background syncer was last
+  // requested to sync it, when DBOptions::max_unsynced_wal_bytes is set
+  std::atomic<uint64_t> unsynced_wal_bytes_{0};
+  // Protects the two flags below. Signaled when a background WAL sync ends.
+  std::mutex wal_syncer_mutex_;
+  std::condition_variable wal_syncer_cv_;
+  bool wal_sync_scheduled_ = false;
+  bool wal_syncer_shutdown_ = false;
+  // False if a WAL recovered by RestoreAliveLogFiles() could not be synced.
+  // GetLatestDurableSequenceNumber() then stays at the writes flushed to SST
+  // files when the DB was opened. Only set by DB::Open().
+  bool recovered_wals_synced_ = true;
+
   // if an attempt was made to flush all column families that
   // the oldest log depends on but uncommitted data in the oldest
   // log prevents the log from being released.
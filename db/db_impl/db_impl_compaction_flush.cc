@@ -70,6 +70,25 @@ bool DBImpl::RequestCompactionToken(ColumnFamilyData* cfd, bool force,
   if (limiter == nullptr) {
     return true;
   }
+  if (!force && limiter->IsCostAware()) {
+    const TaskCostEstimate estimate = cfd->EstimateNextCompaction();
+    *token = limiter->GetToken(force, cfd, estimate);
+    if (*token != nullptr) {
+      ROCKS_LOG_BUFFER(log_buffer,
+                       "Thread limiter [%s] increase [%s] compaction task, "
+                       "estimated I/O bytes: %" PRIu64
+                       ", CPU micros: %" PRIu64
+                       ", read-amp reduction: %.2f, space-amp reduction: "
+                       "%.4f, tasks after: %d",
+                       limiter->GetName().c_str(), cfd->GetName().c_str(),
+                       estimate.io_bytes, estimate.cpu_micros,
+                       estimate.read_amp_reduction,
+                       estimate.space_amp_reduction,
+                       limiter->GetOutstandingTask());
+      return true;
+    }
+    return false;
+  }
   *token = limiter->GetToken(force);
   if (*token != nullptr) {
     ROCKS_LOG_BUFFER(log_buffer,
@@ -360,6 +379,11 @@ Status DBImpl::FlushMemTableToOutputFile(
       // exists. Otherwise, some tests may fail.  Ignore the error in the
       // interim.
       sfm->OnAddFile(file_path).PermitUncheckedError();
+      for (uint64_t file_number : flush_job.GetPartitionFileNumbers()) {
+        sfm->OnAddFile(MakeTableFileName(cfd->ioptions()->cf_paths[0].path,
+                                         file_number))
+            .PermitUncheckedError();
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error =
             Status::SpaceLimit("Max allowed space was reached");
@@ -785,6 +809,11 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         // exists. Otherwise, some tests may fail.  Ignore the error in the
         // interim.
         sfm->OnAddFile(file_path).PermitUncheckedError();
+        for (uint64_t file_number : jobs[i]->GetPartitionFileNumbers()) {
+          std::string partition_file_path = MakeTableFileName(
+              cfds[i]->ioptions()->cf_paths[0].path, file_number);
+          sfm->OnAddFile(partition_file_path).PermitUncheckedError();
+        }
         if (sfm->IsMaxAllowedSpaceReached() &&
             error_handler_.GetBGError().ok()) {
           Status new_bg_error =
@@ -1120,10 +1149,19 @@ Status DBImpl::CompactRangeInternal(const CompactRangeOptions& options,
       // files, useful for bottom level compaction in a manual compaction
       uint64_t max_file_num_to_ignore = port::kMaxUint64;
       uint64_t next_file_number = versions_->current_next_file_number();
+      if (options.incremental && !exclusive &&
+          cfd->ioptions()->compaction_style == kCompactionStyleLevel &&
+          cfd->NumberLevels() > 1) {
+        // Only the bottommost level is left for the loop below, unless
+        // automatic compactions are stopped
+        s = RunIncrementalManualCompaction(cfd, options, begin, end,
+                                           &first_overlapped_level,
+                                           &max_overlapped_level);
+      }
       final_output_level = max_overlapped_level;
       int output_level;
-      for (int level = first_overlapped_level; level <= max_overlapped_level;
-           level++) {
+      for (int level = first_overlapped_level;
+           s.ok() && level <= max_overlapped_level; level++) {
         bool disallow_trivial_move = false;
         // in case the compaction is universal or if we're compacting the
         // bottom-most level, the output level will be the same as input one.
@@ -1685,7 +1723,8 @@ Status DBImpl::ReFitLevel(ColumnFamilyData* cfd, int level, int target_level) {
           f->smallest, f->largest, f->fd.smallest_seqno, f->fd.largest_seqno,
           f->marked_for_compaction, f->temperature, f->oldest_blob_file_number,
           f->oldest_ancester_time, f->file_creation_time, f->file_checksum,
-          f->file_checksum_func_name, f->min_timestamp, f->max_timestamp);
+          f->file_checksum_func_name, f->min_timestamp, f->max_timestamp,
+          f->tail_size);
     }
     ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
                     "[%s] Apply version edit:\n%s", cfd->GetName().c_str(),
@@ -1992,6 +2031,185 @@ Status DBImpl::RunManualCompaction(
   return manual.status;
 }
 
+Status DBImpl::RunIncrementalManualCompaction(
+    ColumnFamilyData* cfd, const CompactRangeOptions& compact_range_options,
+    const Slice* begin, const Slice* end, int* first_level,
+    int* output_level) {
+  assert(first_level != nullptr);
+  assert(output_level != nullptr);
+  InternalKey begin_storage, end_storage;
+  const InternalKey* begin_key = nullptr;
+  const InternalKey* end_key = nullptr;
+  if (begin != nullptr) {
+    begin_storage.SetMinPossibleForUserKey(*begin);
+    begin_key = &begin_storage;
+  }
+  if (end != nullptr) {
+    end_storage.SetMaxPossibleForUserKey(*end);
+    end_key = &end_storage;
+  }
+
+  InstrumentedMutexLock l(&mutex_);
+  // Nothing picks the marked files then. Leave it all to the level by level
+  // compaction.
+  auto auto_compactions_stopped = [&]() {
+    mutex_.AssertHeld();
+    return cfd->GetLatestMutableCFOptions()->disable_auto_compactions ||
+           bg_compaction_paused_ > 0;
+  };
+  if (auto_compactions_stopped()) {
+    return Status::OK();
+  }
+  // Data written since the start does not need to be moved down. Files with
+  // older data keep their smallest sequence number through compactions until
+  // they reach the output level.
+  const SequenceNumber start_seqno = versions_->LastSequence();
+  const int target_level =
+      std::max(*output_level, cfd->current()->storage_info()->base_level());
+
+  const uint64_t kPollMicros = 100 * 1000;
+  ManualCompactionProgressInfo info;
+  info.cf_id = cfd->GetID();
+  info.cf_name = cfd->GetName();
+  std::unordered_set<uint64_t> marked_files;
+  uint64_t last_notified_bytes = port::kMaxUint64;
+  bool stopped = false;
+  Status s;
+  while (true) {
+    if (manual_compaction_paused_.load(std::memory_order_acquire) > 0 ||
+        (compact_range_options.canceled != nullptr &&
+         compact_range_options.canceled->load(std::memory_order_acquire))) {
+      s = Status::Incomplete(Status::SubCode::kManualCompactionPaused);
+      break;
+    }
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      s = Status::ShutdownInProgress();
+      break;
+    }
+    if (cfd->IsDropped()) {
+      s = Status::ColumnFamilyDropped();
+      break;
+    }
+    s = error_handler_.GetBGError();
+    if (!s.ok()) {
+      break;
+    }
+    if (auto_compactions_stopped()) {
+      stopped = true;
+      break;
+    }
+
+    VersionStorageInfo* vstorage = cfd->current()->storage_info();
+    uint64_t remaining_bytes = 0;
+    uint64_t num_remaining_marked_files = 0;
+    bool marked_any = false;
+    std::vector<FileMetaData*> files;
+    for (int level = 0; level <= target_level; level++) {
+      files.clear();
+      vstorage->GetOverlappingInputs(level, begin_key, end_key, &files);
+      for (FileMetaData* f : files) {
+        const bool marked_by_us = marked_files.count(f->fd.GetNumber()) > 0;
+        if (level == target_level) {
+          // Trivially moved files keep their mark, which must not push them
+          // further down
+          if (marked_by_us && f->marked_for_compaction && !f->being_compacted) {
+            f->marked_for_compaction = false;
+            vstorage->ComputeFilesMarkedForCompaction();
+          }
+          continue;
+        }
+        if (f->fd.smallest_seqno > start_seqno) {
+          continue;
+        }
+        remaining_bytes += f->fd.GetFileSize();
+        if (marked_by_us) {
+          ++num_remaining_marked_files;
+        } else if (!f->being_compacted && !f->marked_for_compaction) {
+          f->marked_for_compaction = true;
+          marked_files.insert(f->fd.GetNumber());
+          ++num_remaining_marked_files;
+          marked_any = true;
+        }
+      }
+    }
+    if (marked_any) {
+      vstorage->ComputeFilesMarkedForCompaction();
+      SchedulePendingCompaction(cfd);
+      MaybeScheduleFlushOrCompaction();
+    }
+    if (last_notified_bytes == port::kMaxUint64) {
+      info.total_bytes = remaining_bytes;
+    }
+    info.num_compacted_files = marked_files.size() - num_remaining_marked_files;
+    if (remaining_bytes != last_notified_bytes) {
+      info.remaining_bytes = remaining_bytes;
+      last_notified_bytes = remaining_bytes;
+      NotifyOnManualCompactionProgress(info);
+      // The version might have changed while notifying
+      continue;
+    }
+    if (remaining_bytes == 0) {
+      break;
+    }
+    TEST_SYNC_POINT("DBImpl::RunIncrementalManualCompaction:Wait");
+    // Compactions signal bg_cv_ as they finish. Also wake up periodically in
+    // case a marked file could not be picked for lack of a finishing
+    // compaction to retry it.
+    bg_cv_.TimedWait(immutable_db_options_.clock->NowMicros() +
+                     kPollMicros);
+  }
+  // Remove the marks not acted upon, so that automatic compactions do not
+  // keep moving these files down after the call
+  if (!marked_files.empty() && !cfd->IsDropped()) {
+    VersionStorageInfo* vstorage = cfd->current()->storage_info();
+    bool unmarked_any = false;
+    for (int level = 0; level < vstorage->num_levels(); level++) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        if (f->marked_for_compaction && !f->being_compacted &&
+            marked_files.count(f->fd.GetNumber()) > 0) {
+          f->marked_for_compaction = false;
+          unmarked_any = true;
+        }
+      }
+    }
+    if (unmarked_any) {
+      vstorage->ComputeFilesMarkedForCompaction();
+    }
+  }
+  if (s.ok()) {
+    // The data already moved down is compacted from there
+    *output_level = target_level;
+    if (!stopped) {
+      *first_level = target_level;
+    }
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "[%s] Incremental manual compaction to level-%d %s, %" PRIu64
+                 " files compacted: %s",
+                 cfd->GetName().c_str(), target_level,
+                 stopped ? "stopped" : "done", info.num_compacted_files,
+                 s.ToString().c_str());
+  return s;
+}
+
+void DBImpl::NotifyOnManualCompactionProgress(
+    const ManualCompactionProgressInfo& info) {
+#ifndef ROCKSDB_LITE
+  if (immutable_db_options_.listeners.empty()) {
+    return;
+  }
+  mutex_.AssertHeld();
+  // release lock while notifying events
+  mutex_.Unlock();
+  for (auto listener : immutable_db_options_.listeners) {
+    listener->OnManualCompactionProgress(this, info);
+  }
+  mutex_.Lock();
+#else
+  (void)info;
+#endif  // ROCKSDB_LITE
+}
+
 void DBImpl::GenerateFlushRequest(const autovector<ColumnFamilyData*>& cfds,
                                   FlushRequest* req) {
   assert(req != nullptr);
@@ -2587,6 +2805,16 @@ ColumnFamilyData* DBImpl::PickCompactionFromQueue(
     std::unique_ptr<TaskLimiterToken>* token, LogBuffer* log_buffer) {
   assert(!compaction_queue_.empty());
   assert(*token == nullptr);
+  // Let the cost-aware limiters know about all the candidates first, so that
+  // they grant the token to the one with the highest benefit per cost rather
+  // than to the first one asking
+  for (ColumnFamilyData* queued_cfd : compaction_queue_) {
+    auto limiter = static_cast<ConcurrentTaskLimiterImpl*>(
+        queued_cfd->ioptions()->compaction_thread_limiter.get());
+    if (limiter != nullptr && limiter->IsCostAware()) {
+      limiter->Enqueue(queued_cfd, queued_cfd->EstimateNextCompaction());
+    }
+  }
   autovector<ColumnFamilyData*> throttled_candidates;
   ColumnFamilyData* cfd = nullptr;
   while (!compaction_queue_.empty()) {
@@ -3313,7 +3541,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
             f->fd.largest_seqno, f->marked_for_compaction, f->temperature,
             f->oldest_blob_file_number, f->oldest_ancester_time,
             f->file_creation_time, f->file_checksum, f->file_checksum_func_name,
-            f->min_timestamp, f->max_timestamp);
+            f->min_timestamp, f->max_timestamp, f->tail_size);
 
         ROCKS_LOG_BUFFER(
             log_buffer,
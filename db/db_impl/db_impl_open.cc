@@ -11,6 +11,7 @@
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
+#include "db/log_prefetching_reader.h"
 #include "db/periodic_work_scheduler.h"
 #include "env/composite_env_wrapper.h"
 #include "file/filename.h"
@@ -23,7 +24,9 @@
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/compression.h"
 #include "util/rate_limiter.h"
+#include "util/run_in_thread_pool.h"
 
 namespace ROCKSDB_NAMESPACE {
 Options SanitizeOptions(const std::string& dbname, const Options& src,
@@ -114,6 +117,14 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
     result.recycle_log_file_num = 0;
   }
 
+  if (!StreamingCompressionTypeSupported(result.wal_compression)) {
+    ROCKS_LOG_WARN(result.info_log,
+                   "wal_compression is disabled since %s is not supported for "
+                   "streaming compression",
+                   CompressionTypeToString(result.wal_compression).c_str());
+    result.wal_compression = kNoCompression;
+  }
+
   if (result.db_paths.size() == 0) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   } else if (result.wal_dir.empty()) {
@@ -264,6 +275,19 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "be disabled. ");
   }
 
+  if (db_options.allow_mmap_writes && db_options.use_direct_io_for_wal) {
+    return Status::NotSupported(
+        "If memory mapped writes (allow_mmap_writes) are enabled "
+        "then direct I/O WAL writes (use_direct_io_for_wal) must be disabled.");
+  }
+
+  if (db_options.allow_mmap_writes && db_options.max_unsynced_wal_bytes > 0) {
+    return Status::NotSupported(
+        "If memory mapped writes (allow_mmap_writes) are enabled "
+        "then background WAL syncs (max_unsynced_wal_bytes) must be "
+        "disabled.");
+  }
+
   if (db_options.keep_log_file_num == 0) {
     return Status::InvalidArgument("keep_log_file_num must be greater than 0");
   }
@@ -804,6 +828,46 @@ Status DBImpl::InitPersistStatsColumnFamily() {
 }
 
 // REQUIRES: wal_numbers are sorted in ascending order
+bool DBImpl::InsertRecoveredBatchesConcurrently(
+    const std::vector<WriteBatch>& batches, uint64_t wal_number,
+    std::vector<Status>* statuses,
+    std::vector<SequenceNumber>* next_sequences) {
+  mutex_.AssertHeld();
+  statuses->assign(batches.size(), Status::OK());
+  next_sequences->assign(batches.size(), 0);
+  std::atomic<size_t> next_batch{0};
+  std::atomic<bool> has_valid_writes{false};
+  auto insert = [&]() {
+    // Keeps the column family of the current write, so one per thread
+    ColumnFamilyMemTablesImpl column_family_memtables(
+        versions_->GetColumnFamilySet());
+    bool thread_has_valid_writes = false;
+    size_t i;
+    while ((i = next_batch.fetch_add(1, std::memory_order_relaxed)) <
+           batches.size()) {
+      bool batch_has_valid_writes = false;
+      // Missing column families were dropped after the write, see
+      // RecoverLogFiles()
+      (*statuses)[i] = WriteBatchInternal::InsertInto(
+          &batches[i], &column_family_memtables, &flush_scheduler_,
+          &trim_history_scheduler_, true, wal_number, 0, this,
+          true /* concurrent_memtable_writes */, &(*next_sequences)[i],
+          &batch_has_valid_writes, seq_per_batch_, batch_per_txn_);
+      thread_has_valid_writes |= batch_has_valid_writes;
+    }
+    if (thread_has_valid_writes) {
+      has_valid_writes.store(true, std::memory_order_relaxed);
+    }
+  };
+
+  const size_t num_threads =
+      std::min(batches.size(),
+               static_cast<size_t>(std::max(
+                   immutable_db_options_.max_wal_recovery_threads, 1)));
+  RunInThreadPool(env_, Env::Priority::LOW, num_threads, insert);
+  return has_valid_writes.load(std::memory_order_relaxed);
+}
+
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
                                bool* corrupted_wal_found) {
@@ -859,6 +923,36 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
   }
 #endif
 
+  // With max_wal_recovery_threads, WAL records are read on a thread of their
+  // own. Write batches are also inserted concurrently in rounds of about
+  // kRoundBytes when the memtables allow it. Write-prepared and 2PC
+  // recovery keep inserting one batch at a time, in order.
+  //
+  // A batch failing to be inserted stops the replay of its WAL, while the
+  // batches following it in its round are already inserted. Rounds are thus
+  // only used when such a failure is ignored or fails the open anyway, and
+  // not by the WAL recovery modes recovering up to the failed batch.
+  const size_t kRoundBytes = 4 << 20;
+  const bool prefetch_wal = immutable_db_options_.max_wal_recovery_threads > 1;
+  bool concurrent_replay =
+      prefetch_wal && immutable_db_options_.allow_concurrent_memtable_write &&
+      !allow_2pc() && !seq_per_batch_ &&
+      (!immutable_db_options_.paranoid_checks ||
+       immutable_db_options_.wal_recovery_mode ==
+           WALRecoveryMode::kAbsoluteConsistency ||
+       immutable_db_options_.wal_recovery_mode ==
+           WALRecoveryMode::kTolerateCorruptedTailRecords);
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (!cfd->ioptions()->memtable_factory->IsInsertConcurrentlySupported() ||
+        cfd->ioptions()->inplace_update_support) {
+      concurrent_replay = false;
+    }
+  }
+  std::vector<WriteBatch> round;
+  size_t round_bytes = 0;
+  std::vector<Status> round_statuses;
+  std::vector<SequenceNumber> round_next_sequences;
+
   bool stop_replay_by_wal_filter = false;
   bool stop_replay_for_corruption = false;
   bool flushed = false;
@@ -938,21 +1032,97 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
-    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+    std::unique_ptr<log::Reader> reader;
+    std::unique_ptr<log::PrefetchingReader> prefetching_reader;
+    if (prefetch_wal) {
+      prefetching_reader.reset(new log::PrefetchingReader(
+          immutable_db_options_.info_log, std::move(file_reader), &reporter,
+          true /*checksum*/, wal_number,
+          immutable_db_options_.wal_recovery_mode, 2 * kRoundBytes));
+    } else {
+      reader.reset(new log::Reader(immutable_db_options_.info_log,
+                                   std::move(file_reader), &reporter,
+                                   true /*checksum*/, wal_number));
+    }
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
     std::string scratch;
     Slice record;
     WriteBatch batch;
+    auto read_record = [&]() {
+      if (prefetching_reader) {
+        return prefetching_reader->ReadRecord(&record, &scratch);
+      }
+      return reader->ReadRecord(&record, &scratch,
+                                immutable_db_options_.wal_recovery_mode);
+    };
+
+    // Flushes the memtables that filled up. Errors fail the recovery.
+    auto flush_scheduled_memtables = [&]() -> Status {
+      // we can do this because this is called before client has access to the
+      // DB and there is only a single thread operating on DB
+      ColumnFamilyData* cfd;
+
+      while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+        cfd->UnrefAndTryDelete();
+        // If this asserts, it means that InsertInto failed in
+        // filtering updates to already-flushed column families
+        assert(cfd->GetLogNumber() <= wal_number);
+        auto iter = version_edits.find(cfd->GetID());
+        assert(iter != version_edits.end());
+        VersionEdit* edit = &iter->second;
+        Status s = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+        if (!s.ok()) {
+          return s;
+        }
+        flushed = true;
+
+        cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                               *next_sequence);
+      }
+      return Status::OK();
+    };
+
+    // Inserts the batches of the current round concurrently. Insertion
+    // errors are handled in the order of the batches, as if the batches had
+    // been inserted one at a time. The batches following a failed one in the
+    // same round have been inserted too, which only happens in the modes
+    // failing the open on the error (see concurrent_replay).
+    auto replay_round = [&]() -> Status {
+      if (round.empty()) {
+        return Status::OK();
+      }
+      bool has_valid_writes = InsertRecoveredBatchesConcurrently(
+          round, wal_number, &round_statuses, &round_next_sequences);
+      bool failed = false;
+      for (size_t i = 0; i < round.size(); i++) {
+        *next_sequence = round_next_sequences[i];
+        Status s = round_statuses[i];
+        MaybeIgnoreError(&s);
+        if (!s.ok()) {
+          reporter.Corruption(round[i].GetDataSize(), s);
+          if (status.ok()) {
+            status = s;
+          }
+          for (size_t j = i + 1; j < round.size(); j++) {
+            round_statuses[j].PermitUncheckedError();
+          }
+          failed = true;
+          break;
+        }
+      }
+      round.clear();
+      round_bytes = 0;
+      if (failed || !has_valid_writes || read_only) {
+        return Status::OK();
+      }
+      return flush_scheduled_memtables();
+    };
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode) &&
-           status.ok()) {
+    while (!stop_replay_by_wal_filter && read_record() && status.ok()) {
       if (record.size() < WriteBatchInternal::kHeader) {
         reporter.Corruption(record.size(),
                             Status::Corruption("log record too small"));
@@ -1058,6 +1228,22 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
 #endif  // ROCKSDB_LITE
 
+      if (concurrent_replay) {
+        // The sequence numbers of the batch are known up front, so that the
+        // point-in-time check above can be done before inserting it
+        *next_sequence = WriteBatchInternal::Sequence(&batch) +
+                         WriteBatchInternal::Count(&batch);
+        round_bytes += batch.GetDataSize();
+        round.push_back(std::move(batch));
+        if (round_bytes >= kRoundBytes) {
+          Status s = replay_round();
+          if (!s.ok()) {
+            return s;
+          }
+        }
+        continue;
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -1078,31 +1264,21 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
 
       if (has_valid_writes && !read_only) {
-        // we can do this because this is called before client has access to the
-        // DB and there is only a single thread operating on DB
-        ColumnFamilyData* cfd;
-
-        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
-          cfd->UnrefAndTryDelete();
-          // If this asserts, it means that InsertInto failed in
-          // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= wal_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
-          VersionEdit* edit = &iter->second;
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Reflect errors immediately so that conditions like full
-            // file-systems cause the DB::Open() to fail.
-            return status;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 *next_sequence);
+        status = flush_scheduled_memtables();
+        if (!status.ok()) {
+          // Reflect errors immediately so that conditions like full
+          // file-systems cause the DB::Open() to fail.
+          return status;
         }
       }
     }
+    // The batches read before the end of the WAL, or before a corruption
+    {
+      Status s = replay_round();
+      if (!s.ok()) {
+        return s;
+      }
+    }
 
     if (!status.ok()) {
       if (status.IsNotSupported()) {
@@ -1377,10 +1553,48 @@ Status DBImpl::RestoreAliveLogFiles(const std::vector<uint64_t>& wal_numbers) {
     }
     total_log_size_ += log.size;
     alive_log_files_.push_back(log);
+    // The WAL may have been written without syncing before the DB was last
+    // closed. Sync it, so that the recovered writes are durable and can be
+    // reported by GetLatestDurableSequenceNumber().
+    if (recovered_wals_synced_) {
+      Status sync_status = SyncRecoveredWAL(wal_number);
+      if (!sync_status.ok()) {
+        // Not a critical error, but the writes that were not flushed are
+        // not known to be durable.
+        ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                       "Failed to sync recovered log #%" PRIu64 ": %s",
+                       wal_number, sync_status.ToString().c_str());
+        recovered_wals_synced_ = false;
+      }
+    }
   }
   return s;
 }
 
+Status DBImpl::SyncRecoveredWAL(uint64_t wal_number) {
+  std::unique_ptr<FSWritableFile> file;
+  IOStatus io_s = fs_->ReopenWritableFile(
+      LogFileName(immutable_db_options_.GetWalDir(), wal_number),
+      fs_->OptimizeForLogWrite(
+          file_options_,
+          BuildDBOptions(immutable_db_options_, mutable_db_options_)),
+      &file, nullptr);
+  if (io_s.ok()) {
+    io_s = immutable_db_options_.use_fsync ? file->Fsync(IOOptions(), nullptr)
+                                           : file->Sync(IOOptions(), nullptr);
+  }
+  if (file != nullptr) {
+    IOStatus close_s = file->Close(IOOptions(), nullptr);
+    if (io_s.ok()) {
+      io_s = close_s;
+    } else {
+      close_s.PermitUncheckedError();
+    }
+  }
+  TEST_SYNC_POINT_CALLBACK("DBImpl::SyncRecoveredWAL:Status", &io_s);
+  return io_s;
+}
+
 Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                                            MemTable* mem, VersionEdit* edit) {
   mutex_.AssertHeld();
@@ -1484,13 +1698,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
   constexpr int level = 0;
 
   if (s.ok() && has_output) {
-    edit->AddFile(
-        level, meta.fd.GetNumber(), meta.fd.GetPathId(), meta.fd.GetFileSize(),
-        meta.smallest, meta.largest, meta.fd.smallest_seqno,
-        meta.fd.largest_seqno, meta.marked_for_compaction, meta.temperature,
-        meta.oldest_blob_file_number, meta.oldest_ancester_time,
-        meta.file_creation_time, meta.file_checksum,
-        meta.file_checksum_func_name, meta.min_timestamp, meta.max_timestamp);
+    edit->AddFile(level, meta);
 
     for (const auto& blob : blob_file_additions) {
       edit->AddBlobFile(blob);
@@ -1579,13 +1787,49 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
     TEST_SYNC_POINT("DBImpl::CreateWAL:BeforeReuseWritableFile2");
     io_s = fs_->ReuseWritableFile(log_fname, old_log_fname, opt_file_options,
                                   &lfile, /*dbg=*/nullptr);
+  } else if (immutable_db_options_.wal_zero_fill &&
+             preallocate_block_size > 0) {
+    // Fill a temporary file and then reuse it like a recycled log file, so
+    // that the WAL is complete as soon as it has its name
+    std::string tmp_fname = TempFileName(wal_dir, log_file_num);
+    std::unique_ptr<FSWritableFile> fill_file;
+    io_s = NewWritableFile(fs_.get(), tmp_fname, &fill_file, opt_file_options);
+    if (io_s.ok()) {
+      std::unique_ptr<WritableFileWriter> fill_writer(new WritableFileWriter(
+          std::move(fill_file), tmp_fname, opt_file_options,
+          immutable_db_options_.clock, io_tracer_));
+      const std::string zeros(
+          std::min(preallocate_block_size, size_t{1} << 20), '\0');
+      for (size_t left = preallocate_block_size; io_s.ok() && left > 0;) {
+        const size_t n = std::min(left, zeros.size());
+        io_s = fill_writer->Append(Slice(zeros.data(), n));
+        left -= n;
+      }
+      if (io_s.ok()) {
+        io_s = fill_writer->Sync(/*use_fsync=*/true);
+      }
+      if (io_s.ok()) {
+        io_s = fill_writer->Close();
+      }
+    }
+    if (io_s.ok()) {
+      io_s = fs_->ReuseWritableFile(log_fname, tmp_fname, opt_file_options,
+                                    &lfile, /*dbg=*/nullptr);
+    }
+    if (!io_s.ok()) {
+      fs_->DeleteFile(tmp_fname, IOOptions(), /*dbg=*/nullptr)
+          .PermitUncheckedError();
+    }
   } else {
     io_s = NewWritableFile(fs_.get(), log_fname, &lfile, opt_file_options);
   }
 
   if (io_s.ok()) {
     lfile->SetWriteLifeTimeHint(CalculateWALWriteHint());
-    lfile->SetPreallocationBlockSize(preallocate_block_size);
+    // Zero-filled files already have their space and keep it
+    if (!immutable_db_options_.wal_zero_fill) {
+      lfile->SetPreallocationBlockSize(preallocate_block_size);
+    }
 
     const auto& listeners = immutable_db_options_.listeners;
     FileTypeSet tmp_set = immutable_db_options_.checksum_handoff_file_types;
@@ -1594,9 +1838,19 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
         immutable_db_options_.clock, io_tracer_, nullptr /* stats */, listeners,
         nullptr, tmp_set.Contains(FileType::kWalFile),
         tmp_set.Contains(FileType::kWalFile)));
+    file_writer->SetSyncDirectWrites();
+    if (immutable_db_options_.wal_zero_fill) {
+      file_writer->SetKeepFileSize();
+    }
     *new_log = new log::Writer(std::move(file_writer), log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
-                               immutable_db_options_.manual_wal_flush);
+                               immutable_db_options_.manual_wal_flush,
+                               immutable_db_options_.wal_compression);
+    io_s = (*new_log)->AddCompressionTypeRecord();
+    if (!io_s.ok()) {
+      delete *new_log;
+      *new_log = nullptr;
+    }
   }
   return io_s;
 }
@@ -1895,6 +2149,21 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
                    persist_options_status.ToString().c_str());
   }
   if (s.ok()) {
+    // The recovered writes not flushed to SST files are durable once
+    // RestoreAliveLogFiles() synced their WALs. Otherwise only the ones
+    // flushed are.
+    SequenceNumber durable_seq = impl->versions_->LastSequence();
+    if (!impl->recovered_wals_synced_) {
+      impl->mutex_.Lock();
+      for (auto cfd : *impl->versions_->GetColumnFamilySet()) {
+        const SequenceNumber first_seq = cfd->mem()->GetFirstSequenceNumber();
+        if (first_seq != 0 && first_seq <= durable_seq) {
+          durable_seq = first_seq - 1;
+        }
+      }
+      impl->mutex_.Unlock();
+    }
+    impl->durable_sequence_.store(durable_seq, std::memory_order_release);
     impl->StartPeriodicWorkScheduler();
   } else {
     for (auto* h : *handles) {
@@ -1428,11 +1428,26 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Lock();
   }
+  const uint64_t file_size_before = log_writer->file()->GetFileSize();
   IOStatus io_s = log_writer->AddRecord(log_entry);
+  const uint64_t written_bytes =
+      log_writer->file()->GetFileSize() - file_size_before;
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
   }
+  if (io_s.ok()) {
+    RecordTick(stats_, WAL_FILE_WRITTEN_BYTES, written_bytes);
+    const uint64_t max_unsynced = immutable_db_options_.max_unsynced_wal_bytes;
+    if (max_unsynced > 0) {
+      const uint64_t unsynced =
+          unsynced_wal_bytes_.fetch_add(written_bytes) + written_bytes;
+      // Only the write crossing the bound schedules a background sync
+      if (unsynced >= max_unsynced && unsynced - written_bytes < max_unsynced) {
+        MaybeScheduleWALSync();
+      }
+    }
+  }
   if (log_used != nullptr) {
     *log_used = logfile_number_;
   }
@@ -1514,6 +1529,15 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
           IOOptions(), nullptr,
           DirFsyncOptions(DirFsyncOptions::FsyncReason::kNewFileSynced));
     }
+    if (io_s.ok()) {
+      // The writes of the earlier groups precede this one in the WAL. With
+      // seq_per_batch_ the batches of the group do not have one sequence
+      // number per key, so only the first one is known to be durable here.
+      AdvanceDurableSequence(
+          seq_per_batch_ ? sequence
+                         : sequence + WriteBatchInternal::Count(merged_batch) -
+                               1);
+    }
   }
 
   if (merged_batch == &tmp_batch_) {
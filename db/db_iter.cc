@@ -73,6 +73,7 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       read_tier_(read_options.read_tier),
       verify_checksums_(read_options.verify_checksums),
       expose_blob_index_(expose_blob_index),
+      keys_only_(read_options.keys_only),
       is_blob_(false),
       arena_mode_(arena_mode),
       range_del_agg_(&ioptions.internal_comparator, s),
@@ -180,6 +181,10 @@ bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
     return true;
   }
 
+  if (keys_only_) {
+    return true;
+  }
+
   if (!version_) {
     status_ = Status::Corruption("Encountered unexpected blob index.");
     valid_ = false;
@@ -431,8 +436,13 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
             } else {
               // By now, we are sure the current ikey is going to yield a
               // value
-              current_entry_is_merged_ = true;
               valid_ = true;
+              if (keys_only_) {
+                // No need to look at the operands. Next() skips them along
+                // with the rest of the key's entries.
+                return true;
+              }
+              current_entry_is_merged_ = true;
               return MergeValuesNewToOld();  // Go to a different state machine
             }
             break;
@@ -904,7 +914,8 @@ bool DBIter::FindValueForCurrentKey() {
           last_not_merge_type = last_key_entry_type;
           PERF_COUNTER_ADD(internal_delete_skipped_count, 1);
         } else {
-          assert(merge_operator_ != nullptr);
+          // With keys_only, the operands are collected but never merged
+          assert(merge_operator_ != nullptr || keys_only_);
           merge_context_.PushOperandBack(
               iter_.value(),
               iter_.iter()->IsValuePinned() /* operand_pinned */);
@@ -1183,6 +1194,10 @@ bool DBIter::FindValueForCurrentKeyUsingSeek() {
 }
 
 Status DBIter::Merge(const Slice* val, const Slice& user_key) {
+  if (keys_only_) {
+    valid_ = true;
+    return Status::OK();
+  }
   Status s = MergeHelper::TimedFullMerge(
       merge_operator_, user_key, val, merge_context_.GetOperands(),
       &saved_value_, logger_, statistics_, clock_, &pinned_value_, true);
@@ -161,7 +161,9 @@ class DBIter final : public Iterator {
   Slice value() const override {
     assert(valid_);
 
-    if (!expose_blob_index_ && is_blob_) {
+    if (keys_only_) {
+      return Slice();
+    } else if (!expose_blob_index_ && is_blob_) {
       return blob_value_;
     } else if (current_entry_is_merged_) {
       // If pinned_value_ is set then the result of merge operator is one of
@@ -361,6 +363,9 @@ class DBIter final : public Iterator {
   // Whether the iterator is allowed to expose blob references. Set to true when
   // the stacked BlobDB implementation is used, false otherwise.
   bool expose_blob_index_;
+  // ReadOptions::keys_only: values are neither merged nor fetched from blob
+  // files, and value() is always empty.
+  const bool keys_only_;
   bool is_blob_;
   bool arena_mode_;
   // List of operands for merge operator.
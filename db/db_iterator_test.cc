@@ -2181,6 +2181,73 @@ TEST_P(DBIteratorTest, IteratorWithLocalStatistics) {
 
 }
 
+TEST_P(DBIteratorTest, KeysOnly) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.separate_values_in_data_blocks = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Merge("b", "x"));
+  ASSERT_OK(Put("c", "vc"));
+  ASSERT_OK(Put("d", "vd"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Merge("b", "y"));
+  ASSERT_OK(Delete("d"));
+  ASSERT_OK(Put("e", "ve"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("x,y", Get("b"));
+
+  // Without a merge operator, "b" can only be read with keys_only
+  options.merge_operator.reset();
+  Reopen(options);
+  {
+    std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+    iter->Seek("b");
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_NOK(iter->status());
+  }
+
+  ReadOptions ro;
+  ro.keys_only = true;
+  std::unique_ptr<Iterator> iter(NewIterator(ro));
+  std::string keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys += iter->key().ToString();
+    ASSERT_TRUE(iter->value().empty());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ("abce", keys);
+
+  keys.clear();
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    keys += iter->key().ToString();
+    ASSERT_TRUE(iter->value().empty());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ("ecba", keys);
+
+  // Change directions around the merged key
+  iter->Seek("b");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("c", iter->key().ToString());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("a", iter->key().ToString());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+  ASSERT_OK(iter->status());
+}
+
 TEST_P(DBIteratorTest, ReadAhead) {
   Options options;
   env_->count_random_reads_ = true;
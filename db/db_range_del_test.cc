@@ -82,6 +82,35 @@ TEST_F(DBRangeDelTest, DictionaryCompressionWithOnlyRangeTombstones) {
   ASSERT_OK(db_->Flush(FlushOptions()));
 }
 
+TEST_F(DBRangeDelTest, DeletionReclaimRatioLoadsRangeTombstones) {
+  Options opts = CurrentOptions();
+  opts.compaction_pri = kMaxDeletionReclaimRatio;
+  opts.disable_auto_compactions = true;
+  DestroyAndReopen(opts);
+  ASSERT_OK(Put("b", "val"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "c"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "b",
+                             "d"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "x",
+                             "z"));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+
+  VersionStorageInfo* vstorage = dbfull()
+                                     ->GetVersionSet()
+                                     ->GetColumnFamilySet()
+                                     ->GetDefault()
+                                     ->current()
+                                     ->storage_info();
+  ASSERT_EQ(1U, vstorage->LevelFiles(0).size());
+  const FileMetaData* file = vstorage->LevelFiles(0)[0];
+  ASSERT_EQ(3U, file->num_range_deletions);
+  // Overlapping tombstones are merged
+  std::vector<std::pair<std::string, std::string>> expected = {{"a", "d"},
+                                                               {"x", "z"}};
+  ASSERT_EQ(expected, file->range_deletion_ranges);
+}
+
 TEST_F(DBRangeDelTest, CompactionOutputHasOnlyRangeTombstone) {
   do {
     Options opts = CurrentOptions();
@@ -11,12 +11,14 @@
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <set>
 
 #include "db/db_test_util.h"
 #include "db/read_callback.h"
 #include "options/options_helper.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
+#include "rocksdb/experimental.h"
 #include "rocksdb/iostats_context.h"
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/trace_record.h"
@@ -24,6 +26,7 @@
 #include "rocksdb/utilities/replayer.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/testutil.h"
+#include "util/fsst.h"
 #include "util/random.h"
 #include "utilities/fault_injection_env.h"
 
@@ -1445,6 +1448,51 @@ TEST_F(DBTest2, PresetCompressionDictLocality) {
   }
 }
 
+TEST_F(DBTest2, FSSTSymbolTableIgnoresZstdMaxTrainBytes) {
+  // A ZSTD dictionary must not be trained in place of the FSST symbol table
+  // when zstd_max_train_bytes is set, or no block could be compressed.
+  if (!ZSTD_TrainDictionarySupported()) {
+    ROCKSDB_GTEST_SKIP("Test requires the ZSTD dictionary trainer");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.compression = kFSSTCompression;
+  options.compression_opts.max_dict_bytes = 1 << 14;        // 16KB
+  options.compression_opts.zstd_max_train_bytes = 1 << 18;  // 256KB
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+
+  std::vector<std::string> compression_dicts;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteCompressionDictBlock:RawDict",
+      [&](void* arg) {
+        compression_dicts.emplace_back(static_cast<Slice*>(arg)->ToString());
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(rnd.RandomString(32) + std::string(96, 'a' + i % 26));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The dictionary block holds a valid symbol table
+  ASSERT_EQ(1U, compression_dicts.size());
+  std::string compressed;
+  ASSERT_TRUE(fsst::Compress(values[0].data(), values[0].size(),
+                             compression_dicts[0], &compressed));
+  ASSERT_GT(options.statistics->getTickerCount(NUMBER_BLOCK_COMPRESSED), 0);
+  ASSERT_EQ(0,
+            options.statistics->getTickerCount(NUMBER_BLOCK_NOT_COMPRESSED));
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 class PresetCompressionDictTest
     : public DBTestBase,
       public testing::WithParamInterface<std::tuple<CompressionType, bool>> {
@@ -5201,6 +5249,7 @@ TEST_F(DBTest2, PinnableSliceAndMmapReads) {
   options.allow_mmap_reads = true;
   options.max_open_files = 100;
   options.compression = kNoCompression;
+  options.statistics = CreateDBStatistics();
   Reopen(options);
 
   ASSERT_OK(Put("foo", "bar"));
@@ -5208,9 +5257,13 @@ TEST_F(DBTest2, PinnableSliceAndMmapReads) {
 
   PinnableSlice pinned_value;
   ASSERT_EQ(Get("foo", &pinned_value), Status::OK());
-  // It is not safe to pin mmap files as they might disappear by compaction
-  ASSERT_FALSE(pinned_value.IsPinned());
+  // Uncompressed data blocks are served straight from the mapping, and the
+  // value keeps the file alive, so it can be pinned without a copy.
+  ASSERT_TRUE(pinned_value.IsPinned());
   ASSERT_EQ(pinned_value.ToString(), "bar");
+  // Such data blocks never go through the block cache.
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT));
 
   ASSERT_OK(dbfull()->TEST_CompactRange(
       0 /* level */, nullptr /* begin */, nullptr /* end */,
@@ -5222,11 +5275,14 @@ TEST_F(DBTest2, PinnableSliceAndMmapReads) {
 
 #ifndef ROCKSDB_LITE
   pinned_value.Reset();
-  // Unsafe to pin mmap files when they could be kicked out of table cache
+  // Still pinned when files could be kicked out of table cache
   Close();
   ASSERT_OK(ReadOnlyReopen(options));
   ASSERT_EQ(Get("foo", &pinned_value), Status::OK());
-  ASSERT_FALSE(pinned_value.IsPinned());
+  ASSERT_TRUE(pinned_value.IsPinned());
+  ASSERT_EQ(pinned_value.ToString(), "bar");
+  // Evicting the table reader does not invalidate the value.
+  dbfull()->TEST_table_cache()->EraseUnRefEntries();
   ASSERT_EQ(pinned_value.ToString(), "bar");
 
   pinned_value.Reset();
@@ -5349,7 +5405,9 @@ TEST_F(DBTest2, DISABLED_IteratorPinnedMemory) {
 
 TEST_F(DBTest2, TestBBTTailPrefetch) {
   std::atomic<bool> called(false);
-  size_t expected_lower_bound = 512 * 1024;
+  // New files are opened with their tail size known, and read their whole
+  // tail, however small, instead of the default 512KB
+  size_t expected_lower_bound = 0;
   size_t expected_higher_bound = 512 * 1024;
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
       "BlockBasedTable::Open::TailPrefetchLen", [&](void* arg) {
@@ -5389,7 +5447,8 @@ TEST_F(DBTest2, TestBBTTailPrefetch) {
       "BlockBasedTable::Open::TailPrefetchLen", [&](void* arg) {
         size_t* prefetch_size = static_cast<size_t*>(arg);
         if (first_call) {
-          EXPECT_EQ(4 * 1024, *prefetch_size);
+          // 4KB without history, less if the whole tail is read
+          EXPECT_GE(4 * 1024, *prefetch_size);
           first_call = false;
         } else {
           EXPECT_GE(4 * 1024, *prefetch_size);
@@ -5429,6 +5488,74 @@ TEST_F(DBTest2, TestBBTTailPrefetch) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+TEST_F(DBTest2, TestBBTTailPrefetchRecordedTailSize) {
+  Options options = CurrentOptions();
+  options.max_open_files = -1;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  // Files that do not overlap, so that they can be moved without rewriting
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 1000; j++) {
+      ASSERT_OK(Put(Key(i * 1000 + j), "value" + ToString(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  // The meta blocks, metaindex block and footer follow the data blocks
+  std::multiset<size_t> tail_sizes;
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3U, files.size());
+  for (const auto& file : files) {
+    auto it = props.find(file.db_path + file.name);
+    ASSERT_NE(props.end(), it);
+    tail_sizes.insert(static_cast<size_t>(file.size - it->second->data_size));
+  }
+
+  // The tail sizes are kept when the files are promoted to L1, trivially
+  // moved to L2, then refitted to L3
+  ASSERT_OK(experimental::PromoteL0(db_, db_->DefaultColumnFamily(), 1));
+  ASSERT_EQ("0,3", FilesPerLevel());
+  bool trivially_moved = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:TrivialMove",
+      [&](void* /*arg*/) { trivially_moved = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(dbfull()->TEST_CompactRange(1, nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(trivially_moved);
+  CompactRangeOptions cro;
+  cro.change_level = true;
+  cro.target_level = 3;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ("0,0,0,3", FilesPerLevel());
+
+  // Each file reads its whole tail at once when opened, also after a reopen
+  // has rewritten the MANIFEST
+  for (int reopen = 0; reopen < 2; reopen++) {
+    port::Mutex mutex;
+    std::multiset<size_t> prefetch_sizes;
+    SyncPoint::GetInstance()->SetCallBack(
+        "BlockBasedTable::Open::TailPrefetchLen", [&](void* arg) {
+          MutexLock l(&mutex);
+          prefetch_sizes.insert(*static_cast<size_t*>(arg));
+        });
+    SyncPoint::GetInstance()->EnableProcessing();
+    Reopen(options);
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_EQ(tail_sizes, prefetch_sizes);
+  }
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 1000; j++) {
+      ASSERT_EQ("value" + ToString(i), Get(Key(i * 1000 + j)));
+    }
+  }
+}
+
 TEST_F(DBTest2, TestGetColumnFamilyHandleUnlocked) {
   // Setup sync point dependency to reproduce the race condition of
   // DBImpl::GetColumnFamilyHandleUnlocked
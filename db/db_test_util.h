@@ -773,6 +773,8 @@ class CacheWrapper : public Cache {
     return target_->Lookup(key, stats);
   }
 
+  bool Probe(const Slice& key) override { return target_->Probe(key); }
+
   bool Ref(Handle* handle) override { return target_->Ref(handle); }
 
   using Cache::Release;
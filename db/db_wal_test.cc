@@ -13,6 +13,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/file_system.h"
 #include "test_util/sync_point.h"
+#include "util/compression.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
 
@@ -1045,6 +1046,175 @@ TEST_F(DBWALTest, RecoverWithLargeLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverWithMultipleThreads) {
+  for (bool concurrent_writes : {true, false}) {
+    Options options = CurrentOptions();
+    options.write_buffer_size = 64 << 20;
+    options.disable_auto_compactions = true;
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    // About 8MB of WAL, so that it takes several rounds of concurrent
+    // inserts to replay
+    Random rnd(301);
+    std::map<std::string, std::string> expected[2];
+    for (int i = 0; i < 2000; i++) {
+      WriteBatch batch;
+      for (int cf = 0; cf < 2; cf++) {
+        std::string key = Key(rnd.Uniform(500));
+        std::string value = rnd.RandomString(2000);
+        ASSERT_OK(batch.Put(handles_[cf], key, value));
+        expected[cf][key] = value;
+      }
+      if (i % 10 == 0) {
+        ASSERT_OK(batch.Delete(handles_[1], Key(i % 500)));
+        expected[1].erase(Key(i % 500));
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    }
+    const SequenceNumber last_sequence = db_->GetLatestSequenceNumber();
+
+    // Memtables fill up during the replay. Batches are only inserted
+    // concurrently in the modes failing the open on insertion errors.
+    options.write_buffer_size = 1 << 20;
+    options.max_wal_recovery_threads = 4;
+    options.allow_concurrent_memtable_write = concurrent_writes;
+    options.wal_recovery_mode = WALRecoveryMode::kTolerateCorruptedTailRecords;
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    ASSERT_EQ(last_sequence, db_->GetLatestSequenceNumber());
+    ASSERT_GT(NumTableFilesAtLevel(0, 1), 1);
+    for (int cf = 0; cf < 2; cf++) {
+      for (int i = 0; i < 500; i++) {
+        auto it = expected[cf].find(Key(i));
+        ASSERT_EQ(it == expected[cf].end() ? "NOT_FOUND" : it->second,
+                  Get(cf, Key(i)));
+      }
+    }
+  }
+}
+
+TEST_F(DBWALTest, RecoverWithMultipleThreadsInsertFailure) {
+  for (WALRecoveryMode mode :
+       {WALRecoveryMode::kPointInTimeRecovery,
+        WALRecoveryMode::kSkipAnyCorruptedRecords,
+        WALRecoveryMode::kTolerateCorruptedTailRecords}) {
+    Options options = CurrentOptions();
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    options.wal_recovery_mode = mode;
+    options.allow_concurrent_memtable_write = true;
+    DestroyAndReopen(options);
+
+    // Without a merge operator, the batch holding the merge fails to be
+    // inserted, in the middle of the WAL
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), "v1"));
+    }
+    ASSERT_OK(Merge(Key(100), "m1"));
+    for (int i = 101; i < 200; i++) {
+      ASSERT_OK(Put(Key(i), "v1"));
+    }
+
+    options.merge_operator.reset();
+    options.max_wal_recovery_threads = 4;
+    Status s = TryReopen(options);
+    if (mode == WALRecoveryMode::kTolerateCorruptedTailRecords) {
+      ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+    } else {
+      // As with a single thread, the replay of the WAL stops right before
+      // the failed batch
+      ASSERT_OK(s);
+      ASSERT_EQ("v1", Get(Key(99)));
+      ASSERT_EQ("NOT_FOUND", Get(Key(100)));
+      ASSERT_EQ("NOT_FOUND", Get(Key(101)));
+    }
+  }
+}
+
+TEST_F(DBWALTest, RecoverWithCompressedWAL) {
+  if (!StreamingCompressionTypeSupported(kZSTD)) {
+    ROCKSDB_GTEST_SKIP("Test requires ZSTD streaming compression");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.wal_compression = kZSTD;
+  options.avoid_flush_during_recovery = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(1000, static_cast<char>('a' + i % 26))));
+  }
+  // Each value is compressed against the earlier ones
+  ASSERT_LT(TestGetTickerCount(options, WAL_FILE_WRITTEN_BYTES),
+            TestGetTickerCount(options, WAL_FILE_BYTES) / 10);
+
+#ifndef ROCKSDB_LITE
+  std::unique_ptr<TransactionLogIterator> iter;
+  ASSERT_OK(db_->GetUpdatesSince(0, &iter));
+  SequenceNumber expected_sequence = 1;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ(expected_sequence++, iter->GetBatch().sequence);
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(static_cast<SequenceNumber>(kNumKeys) + 1, expected_sequence);
+  iter.reset();
+#endif  // ROCKSDB_LITE
+
+  // The compressed WAL is kept along the new ones, compressed or not
+  for (CompressionType wal_compression : {kZSTD, kNoCompression, kZSTD}) {
+    options.wal_compression = wal_compression;
+    Reopen(options);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(std::string(1000, static_cast<char>('a' + i % 26)),
+                Get(Key(i)));
+    }
+    ASSERT_OK(Put("last", CompressionTypeToString(wal_compression)));
+  }
+  Reopen(options);
+  ASSERT_EQ(CompressionTypeToString(kZSTD), Get("last"));
+}
+
+TEST_F(DBWALTest, ZeroFilledWAL) {
+  for (bool use_direct_io : {false, true}) {
+    if (use_direct_io && !IsDirectIOSupported()) {
+      ROCKSDB_GTEST_BYPASS("Test requires Direct IO support");
+      continue;
+    }
+    Options options = CurrentOptions();
+    options.write_buffer_size = 64 << 10;
+    options.recycle_log_file_num = 2;
+    options.wal_zero_fill = true;
+    options.use_direct_io_for_wal = use_direct_io;
+    options.track_and_verify_wals_in_manifest = true;
+    DestroyAndReopen(options);
+    const size_t fill_size =
+        dbfull()->TEST_GetWalPreallocateBlockSize(options.write_buffer_size);
+
+    for (int round = 0; round < 5; round++) {
+      WriteOptions write_options;
+      write_options.sync = true;
+      for (int i = 0; i < 10; i++) {
+        ASSERT_OK(db_->Put(write_options, Key(i), "v" + ToString(round)));
+      }
+      // New and recycled WAL files keep the whole fill
+      uint64_t wal_size = 0;
+      ASSERT_OK(env_->GetFileSize(
+          LogFileName(dbname_, dbfull()->TEST_LogfileNumber()), &wal_size));
+      ASSERT_GE(wal_size, fill_size);
+      if (round % 2 == 0) {
+        ASSERT_OK(Flush());
+      } else {
+        Reopen(options);
+        for (int i = 0; i < 10; i++) {
+          ASSERT_EQ("v" + ToString(round), Get(Key(i)));
+        }
+      }
+    }
+    Close();
+  }
+}
+
 // In https://reviews.facebook.net/D20661 we change
 // recovery behavior: previously for each log file each column family
 // memtable was flushed, even it was empty. Now it's changed:
@@ -1231,6 +1401,101 @@ TEST_F(DBWALTest, PartOfWritesWithWALDisabled) {
   Destroy(options);
 }
 
+TEST_F(DBWALTest, BackgroundWALSync) {
+  std::unique_ptr<FaultInjectionTestEnv> fault_env(
+      new FaultInjectionTestEnv(env_));
+  Options options = CurrentOptions();
+  options.env = fault_env.get();
+  options.disable_auto_compactions = true;
+  options.max_unsynced_wal_bytes = 4096;
+  DestroyAndReopen(options);
+  ASSERT_EQ(0, db_->GetLatestDurableSequenceNumber());
+
+  WriteOptions sync_write;
+  sync_write.sync = true;
+  ASSERT_OK(db_->Put(sync_write, "key", "v1"));  // seq id 1
+  ASSERT_EQ(1, db_->GetLatestDurableSequenceNumber());
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::BGWorkWALSync:AfterSync",
+        "DBWALTest::BackgroundWALSync:Synced"}});
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  // About 10KB of unsynced writes, with seq ids 2 to 101
+  const int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'a' + i % 26)));
+  }
+  TEST_SYNC_POINT("DBWALTest::BackgroundWALSync:Synced");
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The background syncer synced the first bytes beyond the bound
+  const SequenceNumber durable_seq = db_->GetLatestDurableSequenceNumber();
+  ASSERT_GT(durable_seq, 1);
+  ASSERT_LE(durable_seq, db_->GetLatestSequenceNumber());
+
+  // Simulate a crash losing the data not synced
+  fault_env->SetFilesystemActive(false);
+  Close();
+  ASSERT_OK(fault_env->DropUnsyncedFileData());
+  fault_env->ResetState();
+  Reopen(options);
+  ASSERT_EQ("v1", Get("key"));
+  for (int i = 0; static_cast<SequenceNumber>(i) + 2 <= durable_seq; i++) {
+    ASSERT_EQ(std::string(100, 'a' + i % 26), Get(Key(i)));
+  }
+  ASSERT_GE(db_->GetLatestDurableSequenceNumber(), durable_seq);
+
+  // SyncWAL() makes all the writes durable
+  ASSERT_OK(Put("key", "v2"));
+  ASSERT_OK(db_->SyncWAL());
+  ASSERT_EQ(db_->GetLatestSequenceNumber(),
+            db_->GetLatestDurableSequenceNumber());
+
+  // Destroy DB before destruct fault_env.
+  Destroy(options);
+}
+
+TEST_F(DBWALTest, DurableSequenceAfterRecovery) {
+  Options options = CurrentOptions();
+  options.avoid_flush_during_recovery = true;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "v1"));  // seq id 1
+  ASSERT_OK(Put("b", "v1"));  // seq id 2
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("c", "v1"));  // seq id 3, not synced
+  ASSERT_OK(Put("d", "v1"));  // seq id 4, not synced
+
+  // The recovered WAL is synced, so all its writes are durable
+  Reopen(options);
+  ASSERT_EQ(4, db_->GetLatestSequenceNumber());
+  ASSERT_EQ(4, db_->GetLatestDurableSequenceNumber());
+
+  // If it cannot be synced, only the flushed writes are
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::SyncRecoveredWAL:Status", [](void* arg) {
+        *reinterpret_cast<IOStatus*>(arg) = IOStatus::IOError("injected");
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  Reopen(options);
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ("v1", Get("d"));
+  ASSERT_EQ(2, db_->GetLatestDurableSequenceNumber());
+  // Later syncs do not cover the recovered writes
+  WriteOptions sync_write;
+  sync_write.sync = true;
+  ASSERT_OK(db_->Put(sync_write, "e", "v1"));  // seq id 5
+  ASSERT_OK(db_->SyncWAL());
+  ASSERT_EQ(2, db_->GetLatestDurableSequenceNumber());
+
+  Reopen(options);
+  ASSERT_EQ(5, db_->GetLatestSequenceNumber());
+  ASSERT_EQ(5, db_->GetLatestDurableSequenceNumber());
+}
+
 //
 // Test WAL recovery for the various modes available
 //
@@ -12,9 +12,11 @@
 #include <cinttypes>
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/clipping_iterator.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -36,6 +38,7 @@
 #include "port/port.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/memtablerep.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
@@ -793,6 +796,238 @@ bool FlushJob::MemPurgeDecider() {
           threshold);
 }
 
+std::vector<uint64_t> FlushJob::GetPartitionFileNumbers() const {
+  std::vector<uint64_t> file_numbers;
+  for (const FileMetaData& meta : partition_metas_) {
+    if (meta.fd.GetFileSize() > 0) {
+      file_numbers.push_back(meta.fd.GetNumber());
+    }
+  }
+  return file_numbers;
+}
+
+void FlushJob::PickPartitionBoundaries(uint64_t total_data_size,
+                                       std::vector<std::string>* boundaries) {
+  boundaries->clear();
+  const ImmutableCFOptions* ioptions = cfd_->ioptions();
+  if (mutable_cf_options_.max_flush_partitions <= 1 ||
+      ioptions->compaction_style != kCompactionStyleLevel ||
+      mutable_cf_options_.enable_blob_files ||
+      cfd_->user_comparator()->timestamp_size() > 0 ||
+      !ioptions->memtable_factory->IsInstanceOf(
+          SkipListFactory::kClassName())) {
+    return;
+  }
+  uint64_t num_partitions = std::min<uint64_t>(
+      mutable_cf_options_.max_flush_partitions,
+      total_data_size /
+          std::max<uint64_t>(mutable_cf_options_.target_file_size_base, 1));
+  // Each file counts towards the L0 triggers. A single flush does not write
+  // more files than it takes to trigger an L0 compaction.
+  if (mutable_cf_options_.level0_file_num_compaction_trigger > 0) {
+    num_partitions = std::min<uint64_t>(
+        num_partitions,
+        mutable_cf_options_.level0_file_num_compaction_trigger);
+  }
+  if (num_partitions <= 1) {
+    return;
+  }
+
+  // Samples of the user keys, each weighted by the bytes of memtable data it
+  // stands for
+  const uint64_t kSamplesPerPartition = 128;
+  std::vector<std::pair<Slice, double>> samples;
+  for (MemTable* m : mems_) {
+    if (m->num_entries() == 0) {
+      continue;
+    }
+    std::unordered_set<const char*> entries;
+    m->UniqueRandomSample(kSamplesPerPartition * num_partitions, &entries);
+    if (entries.empty()) {
+      continue;
+    }
+    const double weight = static_cast<double>(m->get_data_size()) /
+                          static_cast<double>(entries.size());
+    for (const char* entry : entries) {
+      samples.emplace_back(ExtractUserKey(GetLengthPrefixedSlice(entry)),
+                           weight);
+    }
+  }
+  const Comparator* ucmp = cfd_->user_comparator();
+  std::sort(samples.begin(), samples.end(),
+            [ucmp](const std::pair<Slice, double>& a,
+                   const std::pair<Slice, double>& b) {
+              return ucmp->Compare(a.first, b.first) < 0;
+            });
+  double total_weight = 0;
+  for (const auto& sample : samples) {
+    total_weight += sample.second;
+  }
+
+  // Cuts at the weighted quantiles, between different user keys so that all
+  // the versions of a key go to the same file
+  double cumulative_weight = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    cumulative_weight += samples[i].second;
+    const double target = total_weight *
+                          static_cast<double>(boundaries->size() + 1) /
+                          static_cast<double>(num_partitions);
+    if (cumulative_weight < target || i + 1 == samples.size()) {
+      continue;
+    }
+    const Slice& next = samples[i + 1].first;
+    if (ucmp->Compare(samples[i].first, next) == 0 ||
+        (!boundaries->empty() &&
+         ucmp->Compare(boundaries->back(), next) >= 0)) {
+      continue;
+    }
+    boundaries->push_back(next.ToString());
+    if (boundaries->size() + 1 == num_partitions) {
+      break;
+    }
+  }
+}
+
+Status FlushJob::BuildPartitionedTables(
+    const std::vector<std::string>& boundaries, uint64_t creation_time,
+    int64_t oldest_key_time, uint64_t file_creation_time,
+    Env::WriteLifeTimeHint write_hint, const std::string* full_history_ts_low,
+    std::vector<BlobFileAddition>* blob_file_additions, IOStatus* io_s,
+    uint64_t* num_input_entries, uint64_t* memtable_payload_bytes,
+    uint64_t* memtable_garbage_bytes) {
+  assert(!boundaries.empty());
+  const size_t num_partitions = boundaries.size() + 1;
+  // The file numbers are covered by the pending output of the flush, which
+  // keeps them from being deleted as obsolete
+  partition_metas_.resize(num_partitions - 1);
+  for (FileMetaData& meta : partition_metas_) {
+    meta.fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+    meta.oldest_ancester_time = meta_.oldest_ancester_time;
+    meta.file_creation_time = meta_.file_creation_time;
+  }
+
+  struct PartitionOutput {
+    FileMetaData* meta = nullptr;
+    Status status;
+    IOStatus io_status;
+    TableProperties table_properties;
+    std::vector<BlobFileAddition> blob_file_additions;
+    uint64_t num_input_entries = 0;
+    uint64_t memtable_payload_bytes = 0;
+    uint64_t memtable_garbage_bytes = 0;
+  };
+  std::vector<PartitionOutput> outputs(num_partitions);
+  for (size_t i = 0; i < num_partitions; i++) {
+    outputs[i].meta = i == 0 ? &meta_ : &partition_metas_[i - 1];
+  }
+
+  auto build = [&](size_t i) {
+    PartitionOutput& output = outputs[i];
+    ReadOptions ro;
+    ro.total_order_seek = true;
+    Arena arena;
+    std::vector<InternalIterator*> memtables;
+    for (MemTable* m : mems_) {
+      memtables.push_back(m->NewIterator(ro, &arena));
+    }
+    ScopedArenaIterator merged(
+        NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
+                           static_cast<int>(memtables.size()), &arena));
+    IterKey start_ikey;
+    IterKey end_ikey;
+    Slice start_slice;
+    Slice end_slice;
+    if (i > 0) {
+      start_ikey.SetInternalKey(boundaries[i - 1], kMaxSequenceNumber,
+                                kValueTypeForSeek);
+      start_slice = start_ikey.GetInternalKey();
+    }
+    if (i < boundaries.size()) {
+      end_ikey.SetInternalKey(boundaries[i], kMaxSequenceNumber,
+                              kValueTypeForSeek);
+      end_slice = end_ikey.GetInternalKey();
+    }
+    ClippingIterator input(merged.get(), i > 0 ? &start_slice : nullptr,
+                           i < boundaries.size() ? &end_slice : nullptr,
+                           &cfd_->internal_comparator());
+
+    TableBuilderOptions tboptions(
+        *cfd_->ioptions(), mutable_cf_options_, cfd_->internal_comparator(),
+        cfd_->int_tbl_prop_collector_factories(), output_compression_,
+        mutable_cf_options_.compression_opts, cfd_->GetID(), cfd_->GetName(),
+        0 /* level */, false /* is_bottommost */,
+        TableFileCreationReason::kFlush, creation_time, oldest_key_time,
+        file_creation_time, db_id_, db_session_id_, 0 /* target_file_size */,
+        output.meta->fd.GetNumber());
+    output.status = BuildTable(
+        dbname_, versions_, db_options_, tboptions, file_options_,
+        cfd_->table_cache(), &input,
+        std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>(),
+        output.meta, &output.blob_file_additions, existing_snapshots_,
+        earliest_write_conflict_snapshot_, snapshot_checker_,
+        mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+        &output.io_status, io_tracer_, BlobFileCreationReason::kFlush,
+        event_logger_, job_context_->job_id, Env::IO_HIGH,
+        &output.table_properties, write_hint, full_history_ts_low,
+        blob_callback_, &output.num_input_entries,
+        &output.memtable_payload_bytes, &output.memtable_garbage_bytes);
+  };
+
+  // The partitions are built by no more threads than the flush thread pool
+  // has, counting the one running this job, so that concurrent flushes do not
+  // multiply the threads writing files.
+  int pool_threads = db_options_.env->GetBackgroundThreads(Env::HIGH);
+  if (pool_threads == 0) {
+    // Flushes are scheduled in the low priority pool
+    pool_threads = db_options_.env->GetBackgroundThreads(Env::LOW);
+  }
+  const size_t num_threads = std::min(
+      num_partitions, static_cast<size_t>(std::max(pool_threads, 1)));
+  std::atomic<size_t> next_partition{0};
+  auto build_partitions = [&]() {
+    for (size_t i = next_partition.fetch_add(1); i < num_partitions;
+         i = next_partition.fetch_add(1)) {
+      build(i);
+    }
+  };
+  std::vector<port::Thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(build_partitions);
+  }
+  build_partitions();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  Status s;
+  table_properties_ = outputs[0].table_properties;
+  partition_table_properties_.clear();
+  for (size_t i = 1; i < num_partitions; i++) {
+    partition_table_properties_.push_back(outputs[i].table_properties);
+  }
+  for (PartitionOutput& output : outputs) {
+    if (s.ok() && !output.status.ok()) {
+      s = output.status;
+    }
+    if (io_s->ok() && !output.io_status.ok()) {
+      *io_s = output.io_status;
+    }
+    output.status.PermitUncheckedError();
+    output.io_status.PermitUncheckedError();
+    *num_input_entries += output.num_input_entries;
+    *memtable_payload_bytes += output.memtable_payload_bytes;
+    *memtable_garbage_bytes += output.memtable_garbage_bytes;
+    blob_file_additions->insert(blob_file_additions->end(),
+                                output.blob_file_additions.begin(),
+                                output.blob_file_additions.end());
+    // The files keep their own sequence number ranges, which overlap. The
+    // flush group tells VersionBuilder that their L0 order does not matter.
+    output.meta->flush_group = meta_.fd.GetNumber();
+  }
+  return s;
+}
+
 Status FlushJob::WriteLevel0Table() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_FLUSH_WRITE_L0);
@@ -847,6 +1082,13 @@ Status FlushJob::WriteLevel0Table() {
                          << total_memory_usage << "flush_reason"
                          << GetFlushReasonString(cfd_->GetFlushReason());
 
+    // The key ranges of the output files. Range tombstones would have to be
+    // cut at the boundaries, so flushes holding some write a single file.
+    std::vector<std::string> partition_boundaries;
+    if (range_del_iters.empty()) {
+      PickPartitionBoundaries(total_data_size, &partition_boundaries);
+    }
+
     {
       ScopedArenaIterator iter(
           NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
@@ -903,16 +1145,25 @@ Status FlushJob::WriteLevel0Table() {
           TableFileCreationReason::kFlush, creation_time, oldest_key_time,
           current_time, db_id_, db_session_id_, 0 /* target_file_size */,
           meta_.fd.GetNumber());
-      s = BuildTable(
-          dbname_, versions_, db_options_, tboptions, file_options_,
-          cfd_->table_cache(), iter.get(), std::move(range_del_iters), &meta_,
-          &blob_file_additions, existing_snapshots_,
-          earliest_write_conflict_snapshot_, snapshot_checker_,
-          mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
-          &io_s, io_tracer_, BlobFileCreationReason::kFlush, event_logger_,
-          job_context_->job_id, Env::IO_HIGH, &table_properties_, write_hint,
-          full_history_ts_low, blob_callback_, &num_input_entries,
-          &memtable_payload_bytes, &memtable_garbage_bytes);
+      if (partition_boundaries.empty()) {
+        s = BuildTable(
+            dbname_, versions_, db_options_, tboptions, file_options_,
+            cfd_->table_cache(), iter.get(), std::move(range_del_iters),
+            &meta_, &blob_file_additions, existing_snapshots_,
+            earliest_write_conflict_snapshot_, snapshot_checker_,
+            mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+            &io_s, io_tracer_, BlobFileCreationReason::kFlush, event_logger_,
+            job_context_->job_id, Env::IO_HIGH, &table_properties_,
+            write_hint, full_history_ts_low, blob_callback_,
+            &num_input_entries, &memtable_payload_bytes,
+            &memtable_garbage_bytes);
+      } else {
+        s = BuildPartitionedTables(
+            partition_boundaries, creation_time, oldest_key_time,
+            current_time, write_hint, full_history_ts_low,
+            &blob_file_additions, &io_s, &num_input_entries,
+            &memtable_payload_bytes, &memtable_garbage_bytes);
+      }
       if (!io_s.ok()) {
         io_status_ = io_s;
       }
@@ -944,6 +1195,13 @@ Status FlushJob::WriteLevel0Table() {
                    meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
                    s.ToString().c_str(),
                    meta_.marked_for_compaction ? " (needs compaction)" : "");
+    for (const FileMetaData& meta : partition_metas_) {
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                     ": %" PRIu64 " bytes (partition)",
+                     cfd_->GetName().c_str(), job_context_->job_id,
+                     meta.fd.GetNumber(), meta.fd.GetFileSize());
+    }
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->FsyncWithDirOptions(
@@ -957,7 +1215,16 @@ Status FlushJob::WriteLevel0Table() {
 
   // Note that if file_size is zero, the file has been deleted and
   // should not be added to the manifest.
-  const bool has_output = meta_.fd.GetFileSize() > 0;
+  std::vector<const FileMetaData*> outputs;
+  if (meta_.fd.GetFileSize() > 0) {
+    outputs.push_back(&meta_);
+  }
+  for (const FileMetaData& meta : partition_metas_) {
+    if (meta.fd.GetFileSize() > 0) {
+      outputs.push_back(&meta);
+    }
+  }
+  const bool has_output = !outputs.empty();
 
   if (s.ok() && has_output) {
     TEST_SYNC_POINT("DBImpl::FlushJob:SSTFileCreated");
@@ -966,14 +1233,9 @@ Status FlushJob::WriteLevel0Table() {
     // threads could be concurrently producing compacted files for
     // that key range.
     // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
-                   meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
-                   meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
-                   meta_.marked_for_compaction, meta_.temperature,
-                   meta_.oldest_blob_file_number, meta_.oldest_ancester_time,
-                   meta_.file_creation_time, meta_.file_checksum,
-                   meta_.file_checksum_func_name, meta_.min_timestamp,
-                   meta_.max_timestamp);
+    for (const FileMetaData* meta : outputs) {
+      edit_->AddFile(0 /* level */, *meta);
+    }
 
     edit_->SetBlobFileAdditions(std::move(blob_file_additions));
   }
@@ -995,9 +1257,9 @@ Status FlushJob::WriteLevel0Table() {
                  cfd_->GetName().c_str(), job_context_->job_id, micros,
                  cpu_micros);
 
-  if (has_output) {
-    stats.bytes_written = meta_.fd.GetFileSize();
-    stats.num_output_files = 1;
+  for (const FileMetaData* meta : outputs) {
+    stats.bytes_written += meta->fd.GetFileSize();
+    stats.num_output_files++;
   }
 
   const auto& blobs = edit_->GetBlobFileAdditions();
@@ -1018,22 +1280,36 @@ Status FlushJob::WriteLevel0Table() {
 }
 
 #ifndef ROCKSDB_LITE
-std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo() const {
+std::list<std::unique_ptr<FlushJobInfo>> FlushJob::GetFlushJobInfo() const {
   db_mutex_->AssertHeld();
+  std::list<std::unique_ptr<FlushJobInfo>> infos;
+  infos.push_back(GetFlushJobInfo(meta_, table_properties_));
+  // The other files written by a partitioned flush
+  for (size_t i = 0; i < partition_metas_.size(); i++) {
+    if (partition_metas_[i].fd.GetFileSize() > 0) {
+      infos.push_back(GetFlushJobInfo(partition_metas_[i],
+                                      partition_table_properties_[i]));
+    }
+  }
+  return infos;
+}
+
+std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo(
+    const FileMetaData& meta, const TableProperties& table_properties) const {
   std::unique_ptr<FlushJobInfo> info(new FlushJobInfo{});
   info->cf_id = cfd_->GetID();
   info->cf_name = cfd_->GetName();
 
-  const uint64_t file_number = meta_.fd.GetNumber();
+  const uint64_t file_number = meta.fd.GetNumber();
   info->file_path =
       MakeTableFileName(cfd_->ioptions()->cf_paths[0].path, file_number);
   info->file_number = file_number;
-  info->oldest_blob_file_number = meta_.oldest_blob_file_number;
+  info->oldest_blob_file_number = meta.oldest_blob_file_number;
   info->thread_id = db_options_.env->GetThreadID();
   info->job_id = job_context_->job_id;
-  info->smallest_seqno = meta_.fd.smallest_seqno;
-  info->largest_seqno = meta_.fd.largest_seqno;
-  info->table_properties = table_properties_;
+  info->smallest_seqno = meta.fd.smallest_seqno;
+  info->largest_seqno = meta.fd.largest_seqno;
+  info->table_properties = table_properties;
   info->flush_reason = cfd_->GetFlushReason();
   info->blob_compression_type = mutable_cf_options_.blob_compression_type;
 
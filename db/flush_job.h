@@ -99,12 +99,34 @@ class FlushJob {
   // Return the IO status
   IOStatus io_status() const { return io_status_; }
 
+  // The numbers of the files written by the flush besides the one returned
+  // by Run(), see max_flush_partitions
+  std::vector<uint64_t> GetPartitionFileNumbers() const;
+
  private:
   void ReportStartedFlush();
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
 
+  // Picks the user keys splitting the flushed data into the key ranges of
+  // the output files. Leaves `boundaries` empty if the flush writes a single
+  // file.
+  void PickPartitionBoundaries(uint64_t total_data_size,
+                               std::vector<std::string>* boundaries);
+  // Builds one file per key range delimited by `boundaries`, concurrently on
+  // up to as many threads as the flush thread pool has, into meta_ and
+  // partition_metas_. The results are merged as if a single
+  // BuildTable() call had produced them.
+  Status BuildPartitionedTables(
+      const std::vector<std::string>& boundaries, uint64_t creation_time,
+      int64_t oldest_key_time, uint64_t file_creation_time,
+      Env::WriteLifeTimeHint write_hint,
+      const std::string* full_history_ts_low,
+      std::vector<BlobFileAddition>* blob_file_additions, IOStatus* io_s,
+      uint64_t* num_input_entries, uint64_t* memtable_payload_bytes,
+      uint64_t* memtable_garbage_bytes);
+
   // Memtable Garbage Collection algorithm: a MemPurge takes the list
   // of immutable memtables and filters out (or "purge") the outdated bytes
   // out of it. The output (the filtered bytes, or "useful payload") is
@@ -128,7 +150,10 @@ class FlushJob {
   Status MemPurge();
   bool MemPurgeDecider();
 #ifndef ROCKSDB_LITE
-  std::unique_ptr<FlushJobInfo> GetFlushJobInfo() const;
+  // One FlushJobInfo per file written
+  std::list<std::unique_ptr<FlushJobInfo>> GetFlushJobInfo() const;
+  std::unique_ptr<FlushJobInfo> GetFlushJobInfo(
+      const FileMetaData& meta, const TableProperties& table_properties) const;
 #endif  // !ROCKSDB_LITE
 
   const std::string& dbname_;
@@ -157,6 +182,10 @@ class FlushJob {
   Statistics* stats_;
   EventLogger* event_logger_;
   TableProperties table_properties_;
+  // The files written besides meta_'s by a partitioned flush, and their
+  // properties
+  std::vector<FileMetaData> partition_metas_;
+  std::vector<TableProperties> partition_table_properties_;
   bool measure_io_stats_;
   // True if this flush job should call fsync on the output directory. False
   // otherwise.
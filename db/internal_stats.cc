@@ -295,6 +295,7 @@ static const std::string num_running_flushes = "num-running-flushes";
 static const std::string actual_delayed_write_rate =
     "actual-delayed-write-rate";
 static const std::string is_write_stopped = "is-write-stopped";
+static const std::string write_stall_pressure = "write-stall-pressure";
 static const std::string is_write_stalled = "is-write-stalled";
 static const std::string estimate_oldest_key_time = "estimate-oldest-key-time";
 static const std::string block_cache_capacity = "block-cache-capacity";
@@ -386,6 +387,8 @@ const std::string DB::Properties::kActualDelayedWriteRate =
     rocksdb_prefix + actual_delayed_write_rate;
 const std::string DB::Properties::kIsWriteStopped =
     rocksdb_prefix + is_write_stopped;
+const std::string DB::Properties::kWriteStallPressure =
+    rocksdb_prefix + write_stall_pressure;
 const std::string DB::Properties::kIsWriteStalled =
     rocksdb_prefix + is_write_stalled;
 const std::string DB::Properties::kEstimateOldestKeyTime =
@@ -542,6 +545,9 @@ const std::unordered_map<std::string, DBPropertyInfo>
         {DB::Properties::kIsWriteStalled,
          {false, nullptr, &InternalStats::HandleIsWriteStalled, nullptr,
           nullptr}},
+        {DB::Properties::kWriteStallPressure,
+         {false, nullptr, &InternalStats::HandleWriteStallPressure, nullptr,
+          nullptr}},
         {DB::Properties::kEstimateOldestKeyTime,
          {false, nullptr, &InternalStats::HandleEstimateOldestKeyTime, nullptr,
           nullptr}},
@@ -1240,6 +1246,12 @@ bool InternalStats::HandleIsWriteStalled(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleWriteStallPressure(uint64_t* value, DBImpl* /*db*/,
+                                             Version* /*version*/) {
+  *value = static_cast<uint64_t>(cfd_->write_stall_pressure() * 100 + 0.5);
+  return true;
+}
+
 bool InternalStats::HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* /*db*/,
                                                 Version* /*version*/) {
   // TODO(yiwu): The property is currently available for fifo compaction
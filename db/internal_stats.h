@@ -418,6 +418,19 @@ class InternalStats {
     comp_stats_by_pri_[thread_pri].Add(stats);
   }
 
+  // The CPU time past compactions took per byte they read or wrote, or 0 if
+  // there were none
+  double GetCompactionCpuMicrosPerByte() const {
+    uint64_t cpu_micros = 0;
+    uint64_t bytes = 0;
+    for (const auto& comp_stat : comp_stats_) {
+      cpu_micros += comp_stat.cpu_micros;
+      bytes += comp_stat.bytes_read_non_output_levels +
+               comp_stat.bytes_read_output_level + comp_stat.bytes_written;
+    }
+    return bytes == 0 ? 0 : static_cast<double>(cpu_micros) / bytes;
+  }
+
   void IncBytesMoved(int level, uint64_t amount) {
     comp_stats_[level].bytes_moved += amount;
   }
@@ -677,6 +690,8 @@ class InternalStats {
                                     Version* version);
   bool HandleIsWriteStopped(uint64_t* value, DBImpl* db, Version* version);
   bool HandleIsWriteStalled(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleWriteStallPressure(uint64_t* value, DBImpl* db,
+                                Version* version);
   bool HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* db,
                                    Version* version);
   bool HandleBlockCacheCapacity(uint64_t* value, DBImpl* db, Version* version);
@@ -772,6 +787,8 @@ class InternalStats {
   void AddCompactionStats(int /*level*/, Env::Priority /*thread_pri*/,
                           const CompactionStats& /*stats*/) {}
 
+  double GetCompactionCpuMicrosPerByte() const { return 0; }
+
   void IncBytesMoved(int /*level*/, uint64_t /*amount*/) {}
 
   void AddCFStats(InternalCFStatsType /*type*/, uint64_t /*value*/) {}
@@ -32,8 +32,21 @@ enum RecordType {
   kRecyclableFirstType = 6,
   kRecyclableMiddleType = 7,
   kRecyclableLastType = 8,
+
+  // Sets the compression type of the records following it, if the first
+  // record of the file. Types 9 to 14 are skipped as older readers take them
+  // for their internal end-of-file and bad record markers, instead of failing
+  // on an unknown record type.
+  kSetCompressionType = 15,
+  kRecyclableSetCompressionType = 16,
 };
-static const int kMaxRecordType = kRecyclableLastType;
+static const int kMaxRecordType = kRecyclableSetCompressionType;
+
+// Whether records of type `type` have the recyclable header
+inline bool IsRecyclableRecordType(unsigned int type) {
+  return (type >= kRecyclableFullType && type <= kRecyclableLastType) ||
+         type == kRecyclableSetCompressionType;
+}
 
 static const unsigned int kBlockSize = 32768;
 
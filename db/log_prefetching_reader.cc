@@ -0,0 +1,98 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/log_prefetching_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace log {
+
+PrefetchingReader::PrefetchingReader(
+    std::shared_ptr<Logger> info_log,
+    std::unique_ptr<SequentialFileReader>&& file, Reader::Reporter* reporter,
+    bool checksum, uint64_t log_num, WALRecoveryMode wal_recovery_mode,
+    size_t max_buffered_bytes)
+    : reporter_(reporter),
+      wal_recovery_mode_(wal_recovery_mode),
+      max_buffered_bytes_(max_buffered_bytes > 0 ? max_buffered_bytes : 1),
+      queueing_reporter_(this),
+      reader_(std::move(info_log), std::move(file), &queueing_reporter_,
+              checksum, log_num) {
+  thread_ = port::Thread([this] { BGWorkRead(); });
+}
+
+PrefetchingReader::~PrefetchingReader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+bool PrefetchingReader::ReadRecord(Slice* record, std::string* scratch) {
+  while (true) {
+    Entry entry;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !entries_.empty() || done_; });
+      if (entries_.empty()) {
+        return false;
+      }
+      entry = std::move(entries_.front());
+      entries_.pop_front();
+      buffered_bytes_ -= entry.record.size();
+    }
+    // Wake up the background thread if it waits for room in the queue
+    cv_.notify_all();
+    if (!entry.is_record) {
+      if (reporter_ != nullptr) {
+        reporter_->Corruption(entry.dropped_bytes, entry.status);
+      }
+      continue;
+    }
+    *scratch = std::move(entry.record);
+    *record = Slice(*scratch);
+    return true;
+  }
+}
+
+void PrefetchingReader::QueueingReporter::Corruption(size_t bytes,
+                                                     const Status& status) {
+  owner_->Push(Entry{false, std::string(), bytes, status});
+}
+
+bool PrefetchingReader::Push(Entry&& entry) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Always let one record through, however large
+  cv_.wait(lock, [this] {
+    return shutdown_ || buffered_bytes_ < max_buffered_bytes_;
+  });
+  if (shutdown_) {
+    return false;
+  }
+  buffered_bytes_ += entry.record.size();
+  entries_.push_back(std::move(entry));
+  lock.unlock();
+  cv_.notify_all();
+  return true;
+}
+
+void PrefetchingReader::BGWorkRead() {
+  Slice record;
+  std::string scratch;
+  while (reader_.ReadRecord(&record, &scratch, wal_recovery_mode_)) {
+    if (!Push(Entry{true, record.ToString(), 0, Status::OK()})) {
+      return;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace log
+}  // namespace ROCKSDB_NAMESPACE
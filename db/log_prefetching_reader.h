@@ -0,0 +1,95 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "db/log_reader.h"
+#include "port/port.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace log {
+
+// Reads the records of a log file with a log::Reader on a background thread
+// of its own, ahead of the consumer, so that reading and checksumming the
+// log overlaps with whatever the consumer does with the records. Used to
+// replay WALs during DB::Open() (see DBOptions::max_wal_recovery_threads).
+//
+// Corruptions found by the background reader are passed on to `reporter` in
+// the thread calling ReadRecord(), in the order they were found relative to
+// the records, just as a log::Reader would report them. Records are buffered
+// up to about `max_buffered_bytes`.
+class PrefetchingReader {
+ public:
+  PrefetchingReader(std::shared_ptr<Logger> info_log,
+                    std::unique_ptr<SequentialFileReader>&& file,
+                    Reader::Reporter* reporter, bool checksum,
+                    uint64_t log_num, WALRecoveryMode wal_recovery_mode,
+                    size_t max_buffered_bytes);
+  // Stops the background thread, discarding the records not read yet
+  ~PrefetchingReader();
+
+  // No copying allowed
+  PrefetchingReader(const PrefetchingReader&) = delete;
+  PrefetchingReader& operator=(const PrefetchingReader&) = delete;
+
+  // Same as log::Reader::ReadRecord(), with the recovery mode given to the
+  // constructor.
+  bool ReadRecord(Slice* record, std::string* scratch);
+
+ private:
+  // A record, or a corruption reported while reading
+  struct Entry {
+    bool is_record;
+    std::string record;
+    size_t dropped_bytes;
+    Status status;
+  };
+
+  // Queues the corruptions reported by the background reader
+  class QueueingReporter : public Reader::Reporter {
+   public:
+    explicit QueueingReporter(PrefetchingReader* owner) : owner_(owner) {}
+    void Corruption(size_t bytes, const Status& status) override;
+
+   private:
+    PrefetchingReader* owner_;
+  };
+
+  // Waits for room in the queue and appends `entry` to it. Returns false if
+  // the reader is shutting down.
+  bool Push(Entry&& entry);
+  void BGWorkRead();
+
+  Reader::Reporter* const reporter_;
+  const WALRecoveryMode wal_recovery_mode_;
+  const size_t max_buffered_bytes_;
+  QueueingReporter queueing_reporter_;
+  // Only used by the background thread
+  Reader reader_;
+
+  // Protects the members below
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Entry> entries_;
+  size_t buffered_bytes_ = 0;
+  // Set once the background reader reached the end of the log
+  bool done_ = false;
+  bool shutdown_ = false;
+
+  port::Thread thread_;
+};
+
+}  // namespace log
+}  // namespace ROCKSDB_NAMESPACE
@@ -15,6 +15,7 @@
 #include "rocksdb/env.h"
 #include "test_util/sync_point.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -95,6 +96,16 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         in_fragmented_record = true;
         break;
 
+      case kSetCompressionType:
+      case kRecyclableSetCompressionType:
+        if (in_fragmented_record) {
+          ReportCorruption(scratch->size(), "error in middle of record");
+          in_fragmented_record = false;
+          scratch->clear();
+        }
+        InitCompression(fragment, physical_record_offset);
+        break;
+
       case kMiddleType:
       case kRecyclableMiddleType:
         if (!in_fragmented_record) {
@@ -365,7 +376,7 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size) {
     const unsigned int type = header[6];
     const uint32_t length = a | (b << 8);
     int header_size = kHeaderSize;
-    if (type >= kRecyclableFullType && type <= kRecyclableLastType) {
+    if (IsRecyclableRecordType(type)) {
       if (end_of_buffer_offset_ - buffer_.size() == 0) {
         recycled_ = true;
       }
@@ -422,10 +433,66 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size) {
     buffer_.remove_prefix(header_size + length);
 
     *result = Slice(header + header_size, length);
+    if (uncompress_ && type != kSetCompressionType &&
+        type != kRecyclableSetCompressionType) {
+      if (!UncompressRecord(*result, result)) {
+        return kBadRecord;
+      }
+    }
     return type;
   }
 }
 
+void Reader::InitCompression(const Slice& payload, uint64_t offset) {
+  if (uncompress_ != nullptr || offset != 0) {
+    ReportCorruption(payload.size(),
+                     "compression type record not at the start of the log");
+    return;
+  }
+  CompressionTypeRecord record(kNoCompression);
+  Slice input = payload;
+  Status s = record.DecodeFrom(&input);
+  if (s.ok() && record.GetCompressionType() == kNoCompression) {
+    return;
+  }
+  if (s.ok()) {
+    uncompress_.reset(
+        StreamingUncompress::Create(record.GetCompressionType(), kBlockSize));
+    if (uncompress_ == nullptr) {
+      s = Status::NotSupported(
+          "WAL compression type not supported: " +
+          CompressionTypeToString(record.GetCompressionType()));
+    }
+  }
+  if (!s.ok()) {
+    // E.g. a log written by a build with ZSTD read by one without it. None
+    // of the records that follow can be read.
+    ReportDrop(payload.size(), s);
+    buffer_.clear();
+    read_error_ = true;
+    return;
+  }
+  uncompressed_buffer_.reset(new char[kBlockSize]);
+}
+
+bool Reader::UncompressRecord(const Slice& payload, Slice* result) {
+  uncompressed_record_.clear();
+  int remaining = 0;
+  do {
+    size_t uncompressed_size = 0;
+    remaining = uncompress_->Uncompress(payload.data(), payload.size(),
+                                        uncompressed_buffer_.get(),
+                                        &uncompressed_size);
+    if (remaining < 0) {
+      ReportCorruption(payload.size(), "failed to uncompress record");
+      return false;
+    }
+    uncompressed_record_.append(uncompressed_buffer_.get(), uncompressed_size);
+  } while (remaining > 0);
+  *result = Slice(uncompressed_record_);
+  return true;
+}
+
 bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
                                         WALRecoveryMode /*unused*/) {
   assert(record != nullptr);
@@ -462,6 +529,16 @@ bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
         in_fragmented_record_ = true;
         break;
 
+      case kSetCompressionType:
+      case kRecyclableSetCompressionType:
+        if (in_fragmented_record_) {
+          ReportCorruption(fragments_.size(), "error in middle of record");
+          in_fragmented_record_ = false;
+          fragments_.clear();
+        }
+        InitCompression(fragment, physical_record_offset);
+        break;
+
       case kMiddleType:
       case kRecyclableMiddleType:
         if (!in_fragmented_record_) {
@@ -593,7 +670,7 @@ bool FragmentBufferedReader::TryReadFragment(
   const unsigned int type = header[6];
   const uint32_t length = a | (b << 8);
   int header_size = kHeaderSize;
-  if (type >= kRecyclableFullType && type <= kRecyclableLastType) {
+  if (IsRecyclableRecordType(type)) {
     if (end_of_buffer_offset_ - buffer_.size() == 0) {
       recycled_ = true;
     }
@@ -647,6 +724,12 @@ bool FragmentBufferedReader::TryReadFragment(
 
   *fragment = Slice(header + header_size, length);
   *fragment_type_or_err = type;
+  if (uncompress_ && type != kSetCompressionType &&
+      type != kRecyclableSetCompressionType) {
+    if (!UncompressRecord(*fragment, fragment)) {
+      *fragment_type_or_err = kBadRecord;
+    }
+  }
   return true;
 }
 
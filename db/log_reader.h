@@ -19,6 +19,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 class Logger;
+class StreamingUncompress;
 
 namespace log {
 
@@ -128,6 +129,11 @@ class Reader {
   // Whether this is a recycled log file
   bool recycled_;
 
+  // Set by the compression type record of a compressed log file
+  std::unique_ptr<StreamingUncompress> uncompress_;
+  std::unique_ptr<char[]> uncompressed_buffer_;
+  std::string uncompressed_record_;
+
   // Extend record types with the following special values
   enum {
     kEof = kMaxRecordType + 1,
@@ -149,6 +155,18 @@ class Reader {
   // Return type, or one of the preceding special values
   unsigned int ReadPhysicalRecord(Slice* result, size_t* drop_size);
 
+  // Sets up the uncompression of the records following the compression type
+  // record `payload`, read at file offset `offset`. Reports a corruption if
+  // it is not the first record. Stops reading the log if the record cannot
+  // be decoded, or with NotSupported if the compression type is not
+  // supported, since the records that follow cannot be read either.
+  void InitCompression(const Slice& payload, uint64_t offset);
+
+  // Uncompresses the payload of a record of a compressed log file, following
+  // the payloads of the records before it, into `*result`. Returns false on
+  // a corruption.
+  bool UncompressRecord(const Slice& payload, Slice* result);
+
   // Read some more
   bool ReadMore(size_t* drop_size, int *error);
 
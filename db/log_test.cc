@@ -15,6 +15,7 @@
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/random.h"
 
@@ -44,10 +45,12 @@ static std::string RandomSkewedString(int i, Random* rnd) {
   return BigString(NumberString(i), rnd->Skewed(17));
 }
 
-// Param type is tuple<int, bool>
+// Param type is tuple<int, bool, CompressionType>
 // get<0>(tuple): non-zero if recycling log, zero if regular log
 // get<1>(tuple): true if allow retry after read EOF, false otherwise
-class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
+// get<2>(tuple): type of compression used
+class LogTest
+    : public ::testing::TestWithParam<std::tuple<int, bool, CompressionType>> {
  private:
   class StringSource : public FSSequentialFile {
    public:
@@ -158,8 +161,9 @@ class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
     std::unique_ptr<FSWritableFile> sink_holder(sink_);
     std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
         std::move(sink_holder), "" /* don't care */, FileOptions()));
-    writer_.reset(
-        new Writer(std::move(file_writer), 123, std::get<0>(GetParam())));
+    writer_.reset(new Writer(std::move(file_writer), 123,
+                             std::get<0>(GetParam()), false /* manual_flush */,
+                             std::get<2>(GetParam())));
     std::unique_ptr<FSSequentialFile> source_holder(source_);
     std::unique_ptr<SequentialFileReader> file_reader(
         new SequentialFileReader(std::move(source_holder), "" /* file name */));
@@ -175,6 +179,10 @@ class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
 
   Slice* get_reader_contents() { return &reader_contents_; }
 
+  IOStatus AddCompressionTypeRecord() {
+    return writer_->AddCompressionTypeRecord();
+  }
+
   void Write(const std::string& msg) {
     ASSERT_OK(writer_->AddRecord(Slice(msg)));
   }
@@ -676,11 +684,137 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, UnsupportedCompressionType) {
+  // A compression type record for a type without streaming support, as
+  // written by a build supporting it
+  const bool recyclable = std::get<0>(GetParam()) != 0;
+  std::string payload;
+  CompressionTypeRecord(kSnappyCompression).EncodeTo(&payload);
+  Write(std::string(payload.size(), 'x'));
+  SetByte(6, static_cast<char>(recyclable ? kRecyclableSetCompressionType
+                                          : kSetCompressionType));
+  const int header_size = recyclable ? kRecyclableHeaderSize : kHeaderSize;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    SetByte(header_size + static_cast<int>(i), payload[i]);
+  }
+  FixChecksum(0, static_cast<int>(payload.size()), recyclable);
+  Write("foo");
+
+  // The records that follow are not read as if they were not compressed
+  ASSERT_EQ("EOF", Read(WALRecoveryMode::kAbsoluteConsistency));
+  ASSERT_EQ("OK", MatchError("WAL compression type not supported: Snappy"));
+  ASSERT_EQ("EOF", Read());
+}
+
 INSTANTIATE_TEST_CASE_P(bool, LogTest,
-                        ::testing::Values(std::make_tuple(0, false),
-                                          std::make_tuple(0, true),
-                                          std::make_tuple(1, false),
-                                          std::make_tuple(1, true)));
+                        ::testing::Values(std::make_tuple(0, false,
+                                                          kNoCompression),
+                                          std::make_tuple(0, true,
+                                                          kNoCompression),
+                                          std::make_tuple(1, false,
+                                                          kNoCompression),
+                                          std::make_tuple(1, true,
+                                                          kNoCompression)));
+
+class CompressionLogTest : public LogTest {
+ public:
+  // Returns false if the compression type is not supported
+  bool SetupTestEnv() {
+    if (!StreamingCompressionTypeSupported(std::get<2>(GetParam()))) {
+      return false;
+    }
+    EXPECT_OK(AddCompressionTypeRecord());
+    return true;
+  }
+};
+
+TEST_P(CompressionLogTest, Empty) {
+  if (!SetupTestEnv()) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  // The compression type record, if any
+  size_t expected_size = 0;
+  if (std::get<2>(GetParam()) != kNoCompression) {
+    expected_size =
+        (std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize) + 4;
+  }
+  ASSERT_EQ(expected_size, WrittenBytes());
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, ReadWrite) {
+  if (!SetupTestEnv()) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  Write("foo");
+  Write("bar");
+  Write("");
+  Write("xxxx");
+  ASSERT_EQ("foo", Read());
+  ASSERT_EQ("bar", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ("xxxx", Read());
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ("EOF", Read());  // Make sure reads at eof work
+}
+
+TEST_P(CompressionLogTest, ManyBlocks) {
+  if (!SetupTestEnv()) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  for (int i = 0; i < 100000; i++) {
+    Write(NumberString(i));
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(NumberString(i), Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, Fragmentation) {
+  if (!SetupTestEnv()) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  Random rnd(301);
+  // Incompressible records take several compressed chunks
+  const std::vector<std::string> records = {
+      "small", BigString("medium", 50000), rnd.RandomString(100000),
+      BigString("large", 100000), rnd.RandomString(3 * kBlockSize)};
+  for (const std::string& record : records) {
+    Write(record);
+  }
+  for (const std::string& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, CompressesAcrossRecords) {
+  if (!SetupTestEnv() || std::get<2>(GetParam()) == kNoCompression) {
+    ROCKSDB_GTEST_SKIP("Test requires compression");
+    return;
+  }
+  Random rnd(301);
+  const std::string record = rnd.RandomString(1000);
+  Write(record);
+  const size_t first_record_size = WrittenBytes();
+  // Repeating the record costs much less than the record itself
+  Write(record);
+  ASSERT_LT(WrittenBytes() - first_record_size, record.size() / 10);
+  ASSERT_EQ(record, Read());
+  ASSERT_EQ(record, Read());
+  ASSERT_EQ("EOF", Read());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Compression, CompressionLogTest,
+    ::testing::Combine(::testing::Values(0, 1), ::testing::Bool(),
+                       ::testing::Values(CompressionType::kNoCompression,
+                                         CompressionType::kZSTD)));
 
 class RetriableLogTest : public ::testing::TestWithParam<int> {
  private:
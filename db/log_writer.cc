@@ -13,18 +13,21 @@
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace log {
 
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-               bool recycle_log_files, bool manual_flush)
+               bool recycle_log_files, bool manual_flush,
+               CompressionType compression_type)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
-      manual_flush_(manual_flush) {
+      manual_flush_(manual_flush),
+      compression_type_(compression_type) {
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
@@ -61,7 +64,22 @@ IOStatus Writer::AddRecord(const Slice& slice) {
   // zero-length record
   IOStatus s;
   bool begin = true;
+  // When compressing, the fragments are taken from the chunks of compressed
+  // output, up to a block each, and the record ends with the last chunk
+  bool compress_start = compress_ != nullptr;
+  int compress_remaining = 0;
   do {
+    if (compress_ && (compress_start || left == 0)) {
+      compress_remaining = compress_->Compress(
+          slice.data(), slice.size(), compressed_buffer_.get(), &left);
+      if (compress_remaining < 0) {
+        s = IOStatus::IOError("Failed to compress WAL record");
+        break;
+      }
+      ptr = compressed_buffer_.get();
+      compress_start = false;
+    }
+
     const int64_t leftover = kBlockSize - block_offset_;
     assert(leftover >= 0);
     if (leftover < header_size) {
@@ -86,7 +104,7 @@ IOStatus Writer::AddRecord(const Slice& slice) {
     const size_t fragment_length = (left < avail) ? left : avail;
 
     RecordType type;
-    const bool end = (left == fragment_length);
+    const bool end = (left == fragment_length && compress_remaining == 0);
     if (begin && end) {
       type = recycle_log_files_ ? kRecyclableFullType : kFullType;
     } else if (begin) {
@@ -101,7 +119,7 @@ IOStatus Writer::AddRecord(const Slice& slice) {
     ptr += fragment_length;
     left -= fragment_length;
     begin = false;
-  } while (s.ok() && left > 0);
+  } while (s.ok() && (left > 0 || compress_remaining > 0));
 
   if (s.ok()) {
     if (!manual_flush_) {
@@ -112,6 +130,37 @@ IOStatus Writer::AddRecord(const Slice& slice) {
   return s;
 }
 
+IOStatus Writer::AddCompressionTypeRecord() {
+  // Should be the first record
+  assert(block_offset_ == 0);
+  if (compression_type_ == kNoCompression) {
+    return IOStatus::OK();
+  }
+
+  const size_t max_output_len =
+      kBlockSize - (recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize);
+  compress_.reset(StreamingCompress::Create(
+      compression_type_, CompressionOptions(), max_output_len));
+  if (compress_ == nullptr) {
+    return IOStatus::NotSupported(
+        "WAL compression type not supported: " +
+        CompressionTypeToString(compression_type_));
+  }
+  compressed_buffer_.reset(new char[max_output_len]);
+
+  CompressionTypeRecord record(compression_type_);
+  std::string encoded;
+  record.EncodeTo(&encoded);
+  IOStatus s = EmitPhysicalRecord(recycle_log_files_
+                                      ? kRecyclableSetCompressionType
+                                      : kSetCompressionType,
+                                  encoded.data(), encoded.size());
+  if (s.ok() && !manual_flush_) {
+    s = dest_->Flush();
+  }
+  return s;
+}
+
 bool Writer::TEST_BufferIsEmpty() { return dest_->TEST_BufferIsEmpty(); }
 
 IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
@@ -126,7 +175,7 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   buf[6] = static_cast<char>(t);
 
   uint32_t crc = type_crc_[t];
-  if (t < kRecyclableFullType) {
+  if (!IsRecyclableRecordType(t)) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -12,12 +12,14 @@
 #include <memory>
 
 #include "db/log_format.h"
+#include "rocksdb/compression_type.h"
 #include "rocksdb/io_status.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class StreamingCompress;
 class WritableFileWriter;
 
 namespace log {
@@ -64,6 +66,12 @@ namespace log {
  * Same as above, with the addition of
  * Log number = 32bit log file number, so that we can distinguish between
  * records written by the most recent log writer vs a previous one.
+ *
+ * Compressed logs start with a kSetCompressionType (or
+ * kRecyclableSetCompressionType) record holding the compression type. The
+ * payloads of the records following it are then parts of a single stream of
+ * compressed data, flushed at the end of each record, so that each record
+ * can be uncompressed as soon as it is read, given the ones before it.
  */
 class Writer {
  public:
@@ -72,7 +80,8 @@ class Writer {
   // "*dest" must remain live while this Writer is in use.
   explicit Writer(std::unique_ptr<WritableFileWriter>&& dest,
                   uint64_t log_number, bool recycle_log_files,
-                  bool manual_flush = false);
+                  bool manual_flush = false,
+                  CompressionType compression_type = kNoCompression);
   // No copying allowed
   Writer(const Writer&) = delete;
   void operator=(const Writer&) = delete;
@@ -81,6 +90,11 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice);
 
+  // Writes the record setting the compression type, which must be the first
+  // record of the file, and compresses the records added after it. Does
+  // nothing without compression.
+  IOStatus AddCompressionTypeRecord();
+
   WritableFileWriter* file() { return dest_.get(); }
   const WritableFileWriter* file() const { return dest_.get(); }
 
@@ -108,6 +122,12 @@ class Writer {
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
+
+  // Compression type of the records following the compression type record
+  CompressionType compression_type_;
+  // Set once the compression type record is written
+  std::unique_ptr<StreamingCompress> compress_;
+  std::unique_ptr<char[]> compressed_buffer_;
 };
 
 }  // namespace log
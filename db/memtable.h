@@ -11,6 +11,7 @@
 #include <atomic>
 #include <deque>
 #include <functional>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -499,11 +500,12 @@ class MemTable {
   }
 
 #ifndef ROCKSDB_LITE
-  void SetFlushJobInfo(std::unique_ptr<FlushJobInfo>&& info) {
+  // One FlushJobInfo per file written by the flush
+  void SetFlushJobInfo(std::list<std::unique_ptr<FlushJobInfo>>&& info) {
     flush_job_info_ = std::move(info);
   }
 
-  std::unique_ptr<FlushJobInfo> ReleaseFlushJobInfo() {
+  std::list<std::unique_ptr<FlushJobInfo>> ReleaseFlushJobInfo() {
     return std::move(flush_job_info_);
   }
 #endif  // !ROCKSDB_LITE
@@ -598,7 +600,7 @@ class MemTable {
 
 #ifndef ROCKSDB_LITE
   // Flush job info of the current memtable.
-  std::unique_ptr<FlushJobInfo> flush_job_info_;
+  std::list<std::unique_ptr<FlushJobInfo>> flush_job_info_;
 #endif  // !ROCKSDB_LITE
 
   // Updates flush_state_ using ShouldFlushNow()
@@ -480,10 +480,8 @@ Status MemTableList::TryInstallMemtableFlushResults(
         edit_list.push_back(&m->edit_);
         memtables_to_flush.push_back(m);
 #ifndef ROCKSDB_LITE
-        std::unique_ptr<FlushJobInfo> info = m->ReleaseFlushJobInfo();
-        if (info != nullptr) {
-          committed_flush_jobs_info->push_back(std::move(info));
-        }
+        committed_flush_jobs_info->splice(committed_flush_jobs_info->end(),
+                                          m->ReleaseFlushJobInfo());
 #else
         (void)committed_flush_jobs_info;
 #endif  // !ROCKSDB_LITE
@@ -532,12 +530,18 @@ Status MemTableList::TryInstallMemtableFlushResults(
                                       to_delete, mu);
       };
       if (write_edits) {
+        std::vector<uint64_t> moved_files;
+        AssignFlushOutputLevels(cfd, mutable_cf_options, edit_list,
+                                log_buffer, &moved_files);
         // this can release and reacquire the mutex.
         s = vset->LogAndApply(cfd, mutable_cf_options, edit_list, mu,
                               db_directory, /*new_descriptor_log=*/false,
                               /*column_family_options=*/nullptr,
                               manifest_write_cb);
         *io_s = vset->io_status();
+        for (uint64_t moved_file_number : moved_files) {
+          cfd->compaction_picker()->UnregisterFileBeingAdded(moved_file_number);
+        }
       } else {
         // If write_edit is false (e.g: successful mempurge),
         // then remove old memtables, wake up manifest write queue threads,
@@ -639,6 +643,77 @@ void MemTableList::InstallNewVersion() {
   }
 }
 
+void MemTableList::AssignFlushOutputLevels(
+    ColumnFamilyData* cfd, const MutableCFOptions& mutable_cf_options,
+    const autovector<VersionEdit*>& edit_list, LogBuffer* log_buffer,
+    std::vector<uint64_t>* moved_files) {
+  const ImmutableOptions* ioptions = cfd->ioptions();
+  if (!mutable_cf_options.flush_to_deepest_level ||
+      ioptions->compaction_style != kCompactionStyleLevel ||
+      ioptions->num_levels < 2) {
+    return;
+  }
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  CompactionPicker* picker = cfd->compaction_picker();
+  const Comparator* ucmp = cfd->user_comparator();
+  int max_level = ioptions->num_levels - 1;
+  if (ioptions->allow_ingest_behind) {
+    // The last level is reserved for ingested files
+    max_level--;
+  }
+
+  // The files of the older flushes, which the files of the newer ones must
+  // not be placed under
+  std::vector<std::pair<int, const FileMetaData*>> assigned;
+  for (VersionEdit* edit : edit_list) {
+    const VersionEdit::NewFiles& new_files = edit->GetNewFiles();
+    for (size_t i = 0; i < new_files.size(); i++) {
+      assert(new_files[i].first == 0);
+      const FileMetaData& f = new_files[i].second;
+      const Slice smallest = f.smallest.user_key();
+      const Slice largest = f.largest.user_key();
+      auto overlaps = [&](int level) {
+        if (vstorage->OverlapInLevel(level, &smallest, &largest) ||
+            picker->RangeOverlapWithCompaction(smallest, largest, level)) {
+          return true;
+        }
+        for (const auto& other : assigned) {
+          if (other.first == level &&
+              ucmp->Compare(smallest, other.second->largest.user_key()) <=
+                  0 &&
+              ucmp->Compare(largest, other.second->smallest.user_key()) >=
+                  0) {
+            return true;
+          }
+        }
+        return false;
+      };
+
+      int level = 0;
+      if (!overlaps(0)) {
+        // The levels between L0 and the base level are empty
+        for (int lvl = std::max(1, vstorage->base_level()); lvl <= max_level;
+             lvl++) {
+          if (overlaps(lvl)) {
+            break;
+          }
+          level = lvl;
+        }
+      }
+      assigned.emplace_back(level, &f);
+      if (level > 0) {
+        edit->SetNewFileLevel(i, level);
+        picker->RegisterFileBeingAdded(level, f);
+        moved_files->push_back(f.fd.GetNumber());
+        ROCKS_LOG_BUFFER(log_buffer,
+                         "[%s] Level-0 commit table #%" PRIu64
+                         ": added to level %d",
+                         cfd->GetName().c_str(), f.fd.GetNumber(), level);
+      }
+    }
+  }
+}
+
 void MemTableList::RemoveMemTablesOrRestoreFlags(
     const Status& s, ColumnFamilyData* cfd, size_t batch_count,
     LogBuffer* log_buffer, autovector<MemTable*>* to_delete,
@@ -782,9 +857,9 @@ Status InstallMemtableAtomicFlushResults(
     if (committed_flush_jobs_info[k]) {
       assert(!mems_list[k]->empty());
       assert((*mems_list[k])[0]);
-      std::unique_ptr<FlushJobInfo> flush_job_info =
-          (*mems_list[k])[0]->ReleaseFlushJobInfo();
-      committed_flush_jobs_info[k]->push_back(std::move(flush_job_info));
+      committed_flush_jobs_info[k]->splice(
+          committed_flush_jobs_info[k]->end(),
+          (*mems_list[k])[0]->ReleaseFlushJobInfo());
     }
 #else   //! ROCKSDB_LITE
     (void)committed_flush_jobs_info;
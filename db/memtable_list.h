@@ -406,6 +406,17 @@ class MemTableList {
   // DB mutex held
   void InstallNewVersion();
 
+  // DB mutex held
+  // Moves the table files added by `edit_list`, from the oldest flush to the
+  // newest, from L0 to the deepest level they can go to (see
+  // flush_to_deepest_level). The moved files are registered with the
+  // compaction picker and their numbers appended to `moved_files`.
+  void AssignFlushOutputLevels(ColumnFamilyData* cfd,
+                               const MutableCFOptions& mutable_cf_options,
+                               const autovector<VersionEdit*>& edit_list,
+                               LogBuffer* log_buffer,
+                               std::vector<uint64_t>* moved_files);
+
   // DB mutex held
   // Called after writing to MANIFEST
   void RemoveMemTablesOrRestoreFlags(const Status& s, ColumnFamilyData* cfd,
@@ -104,7 +104,8 @@ Status TableCache::GetTableReader(
     std::unique_ptr<TableReader>* table_reader,
     const std::shared_ptr<const SliceTransform>& prefix_extractor,
     bool skip_filters, int level, bool prefetch_index_and_filter_in_cache,
-    size_t max_file_size_for_l0_meta_pin, Temperature file_temperature) {
+    size_t max_file_size_for_l0_meta_pin, Temperature file_temperature,
+    uint64_t tail_size) {
   std::string fname =
       TableFileName(ioptions_.cf_paths, fd.GetNumber(), fd.GetPathId());
   std::unique_ptr<FSRandomAccessFile> file;
@@ -145,7 +146,8 @@ Status TableCache::GetTableReader(
             ioptions_, prefix_extractor, file_options, internal_comparator,
             skip_filters, immortal_tables_, false /* force_direct_prefetch */,
             level, fd.largest_seqno, block_cache_tracer_,
-            max_file_size_for_l0_meta_pin, db_session_id_, fd.GetNumber()),
+            max_file_size_for_l0_meta_pin, db_session_id_, fd.GetNumber(),
+            tail_size),
         std::move(file_reader), fd.GetFileSize(), table_reader,
         prefetch_index_and_filter_in_cache);
     TEST_SYNC_POINT("TableCache::GetTableReader:0");
@@ -167,7 +169,8 @@ Status TableCache::FindTable(
     const std::shared_ptr<const SliceTransform>& prefix_extractor,
     const bool no_io, bool record_read_stats, HistogramImpl* file_read_hist,
     bool skip_filters, int level, bool prefetch_index_and_filter_in_cache,
-    size_t max_file_size_for_l0_meta_pin, Temperature file_temperature) {
+    size_t max_file_size_for_l0_meta_pin, Temperature file_temperature,
+    uint64_t tail_size) {
   PERF_TIMER_GUARD_WITH_CLOCK(find_table_nanos, ioptions_.clock);
   uint64_t number = fd.GetNumber();
   Slice key = GetSliceForFileNumber(&number);
@@ -191,7 +194,7 @@ Status TableCache::FindTable(
         ro, file_options, internal_comparator, fd, false /* sequential mode */,
         record_read_stats, file_read_hist, &table_reader, prefix_extractor,
         skip_filters, level, prefetch_index_and_filter_in_cache,
-        max_file_size_for_l0_meta_pin, file_temperature);
+        max_file_size_for_l0_meta_pin, file_temperature, tail_size);
     if (!s.ok()) {
       assert(table_reader == nullptr);
       RecordTick(ioptions_.stats, NO_FILE_ERRORS);
@@ -237,7 +240,8 @@ InternalIterator* TableCache::NewIterator(
         options.read_tier == kBlockCacheTier /* no_io */,
         !for_compaction /* record_read_stats */, file_read_hist, skip_filters,
         level, true /* prefetch_index_and_filter_in_cache */,
-        max_file_size_for_l0_meta_pin, file_meta.temperature);
+        max_file_size_for_l0_meta_pin, file_meta.temperature,
+        file_meta.tail_size);
     if (s.ok()) {
       table_reader = GetTableReaderFromHandle(handle);
     }
@@ -436,7 +440,8 @@ Status TableCache::Get(
                     options.read_tier == kBlockCacheTier /* no_io */,
                     true /* record_read_stats */, file_read_hist, skip_filters,
                     level, true /* prefetch_index_and_filter_in_cache */,
-                    max_file_size_for_l0_meta_pin, file_meta.temperature);
+                    max_file_size_for_l0_meta_pin, file_meta.temperature,
+                    file_meta.tail_size);
       if (s.ok()) {
         t = GetTableReaderFromHandle(handle);
       }
@@ -540,7 +545,8 @@ Status TableCache::MultiGet(
                     options.read_tier == kBlockCacheTier /* no_io */,
                     true /* record_read_stats */, file_read_hist, skip_filters,
                     level, true /* prefetch_index_and_filter_in_cache */,
-                    0 /*max_file_size_for_l0_meta_pin*/, file_meta.temperature);
+                    0 /*max_file_size_for_l0_meta_pin*/, file_meta.temperature,
+                    file_meta.tail_size);
       TEST_SYNC_POINT_CALLBACK("TableCache::MultiGet:FindTable", &s);
       if (s.ok()) {
         t = GetTableReaderFromHandle(handle);
@@ -727,4 +733,58 @@ uint64_t TableCache::ApproximateSize(
 
   return result;
 }
+
+Status TableCache::ApproximateKeyAnchors(
+    const ReadOptions& read_options,
+    const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
+    std::vector<TableReader::Anchor>* anchors,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor) {
+  Status s;
+  TableReader* table_reader = fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(read_options, file_options_, internal_comparator, fd,
+                  &table_handle, prefix_extractor, false /* no_io */,
+                  false /* record_read_stats */);
+    if (s.ok()) {
+      table_reader = GetTableReaderFromHandle(table_handle);
+    }
+  }
+
+  if (table_reader != nullptr) {
+    s = table_reader->ApproximateKeyAnchors(read_options, anchors);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+
+  return s;
+}
+
+Status TableCache::GetCachedKeyRanges(
+    const ReadOptions& read_options,
+    const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
+    std::vector<TableReader::KeyRange>* ranges,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor) {
+  Status s;
+  TableReader* table_reader = fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(read_options, file_options_, internal_comparator, fd,
+                  &table_handle, prefix_extractor, false /* no_io */,
+                  false /* record_read_stats */);
+    if (s.ok()) {
+      table_reader = GetTableReaderFromHandle(table_handle);
+    }
+  }
+
+  if (table_reader != nullptr) {
+    s = table_reader->GetCachedKeyRanges(read_options, ranges);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+
+  return s;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -145,7 +145,8 @@ class TableCache {
       HistogramImpl* file_read_hist = nullptr, bool skip_filters = false,
       int level = -1, bool prefetch_index_and_filter_in_cache = true,
       size_t max_file_size_for_l0_meta_pin = 0,
-      Temperature file_temperature = Temperature::kUnknown);
+      Temperature file_temperature = Temperature::kUnknown,
+      uint64_t tail_size = 0);
 
   // Get TableReader from a cache handle.
   TableReader* GetTableReaderFromHandle(Cache::Handle* handle);
@@ -186,6 +187,23 @@ class TableCache {
       const InternalKeyComparator& internal_comparator,
       const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr);
 
+  // Appends sampled user keys of a file represented by fd to `*anchors`. See
+  // TableReader::ApproximateKeyAnchors().
+  Status ApproximateKeyAnchors(
+      const ReadOptions& read_options,
+      const InternalKeyComparator& internal_comparator,
+      const FileDescriptor& fd, std::vector<TableReader::Anchor>* anchors,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr);
+
+  // Appends the key ranges of the data blocks of a file represented by fd
+  // that are in the block cache to `*ranges`. See
+  // TableReader::GetCachedKeyRanges().
+  Status GetCachedKeyRanges(
+      const ReadOptions& read_options,
+      const InternalKeyComparator& internal_comparator,
+      const FileDescriptor& fd, std::vector<TableReader::KeyRange>* ranges,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr);
+
   // Release the handle from a cache
   void ReleaseHandle(Cache::Handle* handle);
 
@@ -214,7 +232,8 @@ class TableCache {
       bool skip_filters = false, int level = -1,
       bool prefetch_index_and_filter_in_cache = true,
       size_t max_file_size_for_l0_meta_pin = 0,
-      Temperature file_temperature = Temperature::kUnknown);
+      Temperature file_temperature = Temperature::kUnknown,
+      uint64_t tail_size = 0);
 
   // Create a key prefix for looking up the row cache. The prefix is of the
   // format row_cache_id + fd_number + seq_no. Later, the user key can be
@@ -384,6 +384,26 @@ class VersionBuilder::Rep {
             return Status::Corruption("VersionBuilder", oss.str());
           }
 
+          if (lhs->flush_group != 0 &&
+              lhs->flush_group == rhs->flush_group) {
+            // Files written by the same flush, one per key range (see
+            // max_flush_partitions)
+            const Comparator* ucmp =
+                base_vstorage_->InternalComparator()->user_comparator();
+            if (ucmp->Compare(lhs->largest.user_key(),
+                              rhs->smallest.user_key()) >= 0 &&
+                ucmp->Compare(rhs->largest.user_key(),
+                              lhs->smallest.user_key()) >= 0) {
+              std::ostringstream oss;
+              oss << "L0 files #" << lhs->fd.GetNumber() << " and #"
+                  << rhs->fd.GetNumber() << " of flush group "
+                  << lhs->flush_group << " overlap";
+
+              return Status::Corruption("VersionBuilder", oss.str());
+            }
+            return Status::OK();
+          }
+
           if (rhs->fd.smallest_seqno == rhs->fd.largest_seqno) {
             // This is an external file that we ingested
             const SequenceNumber external_file_seqno = rhs->fd.smallest_seqno;
@@ -1223,7 +1243,7 @@ class VersionBuilder::Rep {
             true /* record_read_stats */,
             internal_stats->GetFileReadHist(level), false, level,
             prefetch_index_and_filter_in_cache, max_file_size_for_l0_meta_pin,
-            file_meta->temperature);
+            file_meta->temperature, file_meta->tail_size);
         if (file_meta->table_reader_handle != nullptr) {
           // Load table_reader
           file_meta->fd.table_reader = table_cache_->GetTableReaderFromHandle(
@@ -224,6 +224,18 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       PutVarint64(&oldest_blob_file_number, f.oldest_blob_file_number);
       PutLengthPrefixedSlice(dst, Slice(oldest_blob_file_number));
     }
+    if (f.tail_size != 0) {
+      PutVarint32(dst, NewFileCustomTag::kTailSize);
+      std::string varint_tail_size;
+      PutVarint64(&varint_tail_size, f.tail_size);
+      PutLengthPrefixedSlice(dst, Slice(varint_tail_size));
+    }
+    if (f.flush_group != 0) {
+      PutVarint32(dst, NewFileCustomTag::kFlushGroup);
+      std::string varint_flush_group;
+      PutVarint64(&varint_flush_group, f.flush_group);
+      PutLengthPrefixedSlice(dst, Slice(varint_flush_group));
+    }
     TEST_SYNC_POINT_CALLBACK("VersionEdit::EncodeTo:NewFile4:CustomizeFields",
                              dst);
 
@@ -395,6 +407,16 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
         case kMaxTimestamp:
           f.max_timestamp = field.ToString();
           break;
+        case kTailSize:
+          if (!GetVarint64(&field, &f.tail_size)) {
+            return "invalid tail size";
+          }
+          break;
+        case kFlushGroup:
+          if (!GetVarint64(&field, &f.flush_group)) {
+            return "invalid flush group";
+          }
+          break;
         default:
           if ((custom_tag & kCustomTagNonSafeIgnoreMask) != 0) {
             // Should not proceed if cannot understand it
@@ -905,6 +927,12 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
       if (f.oldest_blob_file_number != kInvalidBlobFileNumber) {
         jw << "OldestBlobFile" << f.oldest_blob_file_number;
       }
+      if (f.tail_size != 0) {
+        jw << "TailSize" << f.tail_size;
+      }
+      if (f.flush_group != 0) {
+        jw << "FlushGroup" << f.flush_group;
+      }
       if (f.temperature != Temperature::kUnknown) {
         // Maybe change to human readable format whenthe feature becomes
         // permanent
@@ -86,6 +86,7 @@ enum NewFileCustomTag : uint32_t {
   kTemperature = 9,
   kMinTimestamp = 10,
   kMaxTimestamp = 11,
+  kTailSize = 12,
 
   // If this bit for the custom tag is set, opening DB should fail if
   // we don't know this field.
@@ -93,6 +94,7 @@ enum NewFileCustomTag : uint32_t {
 
   // Forward incompatible (aka unignorable) fields
   kPathId,
+  kFlushGroup,
 };
 
 class VersionSet;
@@ -184,6 +186,11 @@ struct FileMetaData {
   uint64_t num_deletions = 0;   // the number of deletion entries.
   uint64_t raw_key_size = 0;    // total uncompressed key size.
   uint64_t raw_value_size = 0;  // total uncompressed value size.
+  uint64_t num_range_deletions = 0;  // the number of range tombstones.
+  // Only loaded for CompactionPri::kMaxDeletionReclaimRatio: the disjoint
+  // user key ranges [start, end) covered by the range tombstones of the
+  // file, in order, at most Version::kMaxRangeDeletionRanges of them.
+  std::vector<std::pair<std::string, std::string>> range_deletion_ranges;
 
   int refs = 0;  // Reference count
 
@@ -218,6 +225,17 @@ struct FileMetaData {
   // Max (newest) timestamp of keys in this file
   std::string max_timestamp;
 
+  // Size of the end of the file that follows the data blocks, holding the
+  // meta blocks, the metaindex block and the footer. Lets the table reader
+  // read all of it at once when opening the file. 0 means unknown.
+  uint64_t tail_size = 0;
+
+  // For the L0 files written by a flush split into key ranges (see
+  // max_flush_partitions), the number of the first file of the flush, 0
+  // otherwise. The sequence number ranges of the files of a flush group
+  // overlap, while their key ranges do not.
+  uint64_t flush_group = 0;
+
   FileMetaData() = default;
 
   FileMetaData(uint64_t file, uint32_t file_path_id, uint64_t file_size,
@@ -444,6 +462,9 @@ class VersionEdit {
   // REQUIRES: "smallest" and "largest" are smallest and largest keys in file
   // REQUIRES: "oldest_blob_file_number" is the number of the oldest blob file
   // referred to by this file if any, kInvalidBlobFileNumber otherwise.
+  // "tail_size" is 0 if unknown, e.g. for files not written by this DB.
+  // "flush_group" is 0 unless the file is an L0 file written by a
+  // partitioned flush, see FileMetaData::flush_group.
   void AddFile(int level, uint64_t file, uint32_t file_path_id,
                uint64_t file_size, const InternalKey& smallest,
                const InternalKey& largest, const SequenceNumber& smallest_seqno,
@@ -453,7 +474,8 @@ class VersionEdit {
                const std::string& file_checksum,
                const std::string& file_checksum_func_name,
                const std::string& min_timestamp,
-               const std::string& max_timestamp) {
+               const std::string& max_timestamp, uint64_t tail_size = 0,
+               uint64_t flush_group = 0) {
     assert(smallest_seqno <= largest_seqno);
     new_files_.emplace_back(
         level,
@@ -462,6 +484,8 @@ class VersionEdit {
                      temperature, oldest_blob_file_number, oldest_ancester_time,
                      file_creation_time, file_checksum, file_checksum_func_name,
                      min_timestamp, max_timestamp));
+    new_files_.back().second.tail_size = tail_size;
+    new_files_.back().second.flush_group = flush_group;
     if (!HasLastSequence() || largest_seqno > GetLastSequence()) {
       SetLastSequence(largest_seqno);
     }
@@ -479,6 +503,16 @@ class VersionEdit {
   using NewFiles = std::vector<std::pair<int, FileMetaData>>;
   const NewFiles& GetNewFiles() const { return new_files_; }
 
+  // Moves the i-th table file added to another level
+  void SetNewFileLevel(size_t i, int level) {
+    assert(i < new_files_.size());
+    new_files_[i].first = level;
+    if (level > 0) {
+      // Only L0 files are ordered by their sequence numbers
+      new_files_[i].second.flush_group = 0;
+    }
+  }
+
   // Add a new blob file.
   void AddBlobFile(uint64_t blob_file_number, uint64_t total_blob_count,
                    uint64_t total_blob_bytes, std::string checksum_method,
@@ -121,6 +121,59 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_EQ("789", new_files[3].second.max_timestamp);
 }
 
+TEST_F(VersionEditTest, EncodeDecodeTailSize) {
+  FileMetaData f(300, 0, 10000, InternalKey("foo", 500, kTypeValue),
+                 InternalKey("zoo", 600, kTypeDeletion), 500, 600, false,
+                 Temperature::kUnknown, kInvalidBlobFileNumber,
+                 kUnknownOldestAncesterTime, kUnknownFileCreationTime,
+                 kUnknownFileChecksum, kUnknownFileChecksumFuncName, "", "");
+  f.tail_size = 1234;
+  VersionEdit edit;
+  edit.AddFile(1, f);
+  f.fd = FileDescriptor(301, 0, 10000, 500, 600);
+  f.tail_size = 0;
+  edit.AddFile(1, f);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  const auto& new_files = parsed.GetNewFiles();
+  ASSERT_EQ(2U, new_files.size());
+  ASSERT_EQ(1234U, new_files[0].second.tail_size);
+  // Unknown
+  ASSERT_EQ(0U, new_files[1].second.tail_size);
+}
+
+TEST_F(VersionEditTest, EncodeDecodeFlushGroup) {
+  FileMetaData f(300, 0, 10000, InternalKey("foo", 500, kTypeValue),
+                 InternalKey("goo", 600, kTypeDeletion), 500, 600, false,
+                 Temperature::kUnknown, kInvalidBlobFileNumber,
+                 kUnknownOldestAncesterTime, kUnknownFileCreationTime,
+                 kUnknownFileChecksum, kUnknownFileChecksumFuncName, "", "");
+  f.flush_group = 300;
+  VersionEdit edit;
+  edit.AddFile(0, f);
+  f.fd = FileDescriptor(301, 0, 10000, 450, 650);
+  f.smallest = InternalKey("hoo", 450, kTypeValue);
+  f.largest = InternalKey("zoo", 650, kTypeValue);
+  edit.AddFile(0, f);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  const auto& new_files = parsed.GetNewFiles();
+  ASSERT_EQ(2U, new_files.size());
+  ASSERT_EQ(300U, new_files[0].second.flush_group);
+  ASSERT_EQ(300U, new_files[1].second.flush_group);
+  // Not a flush group once out of L0
+  parsed.SetNewFileLevel(1, 1);
+  ASSERT_EQ(0U, parsed.GetNewFiles()[1].second.flush_group);
+}
+
 TEST_F(VersionEditTest, ForwardCompatibleNewFile4) {
   static const uint64_t kBig = 1ull << 50;
   VersionEdit edit;
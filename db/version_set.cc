@@ -27,6 +27,7 @@
 #include "db/blob/blob_log_format.h"
 #include "db/compaction/compaction.h"
 #include "db/compaction/file_pri.h"
+#include "db/compaction/pipelined_input_iterator.h"
 #include "db/internal_stats.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
@@ -1962,6 +1963,86 @@ void Version::MultiGetBlob(
   }
 }
 
+void Version::MultiGetBlobFromFile(
+    const ReadOptions& read_options, uint64_t blob_file_number,
+    const autovector<std::reference_wrapper<const Slice>>& user_keys,
+    const autovector<std::reference_wrapper<const BlobIndex>>& blob_indexes,
+    autovector<Status*>& statuses, autovector<PinnableSlice*>& values,
+    uint64_t* bytes_read) const {
+  const size_t num_blobs = blob_indexes.size();
+  assert(num_blobs == user_keys.size());
+  assert(num_blobs == statuses.size());
+  assert(num_blobs == values.size());
+
+  if (bytes_read) {
+    *bytes_read = 0;
+  }
+
+  Status status;
+  if (read_options.read_tier == kBlockCacheTier) {
+    status = Status::Incomplete("Cannot read blob(s): no disk I/O allowed");
+  } else if (storage_info_.GetBlobFiles().find(blob_file_number) ==
+             storage_info_.GetBlobFiles().end()) {
+    status = Status::Corruption("Invalid blob file number");
+  }
+
+  CacheHandleGuard<BlobFileReader> blob_file_reader;
+  if (status.ok()) {
+    assert(blob_file_cache_);
+    status = blob_file_cache_->GetBlobFileReader(blob_file_number,
+                                                 &blob_file_reader);
+  }
+  if (!status.ok()) {
+    for (size_t i = 0; i < num_blobs; ++i) {
+      *statuses[i] = status;
+    }
+    return;
+  }
+
+  assert(blob_file_reader.GetValue());
+  const uint64_t file_size = blob_file_reader.GetValue()->GetFileSize();
+  const CompressionType compression =
+      blob_file_reader.GetValue()->GetCompressionType();
+
+  autovector<std::reference_wrapper<const Slice>> valid_user_keys;
+  autovector<uint64_t> offsets;
+  autovector<uint64_t> value_sizes;
+  autovector<Status*> valid_statuses;
+  autovector<PinnableSlice*> valid_values;
+  for (size_t i = 0; i < num_blobs; ++i) {
+    const BlobIndex& blob_index = blob_indexes[i];
+    assert(blob_index.file_number() == blob_file_number);
+    assert(i == 0 ||
+           blob_indexes[i - 1].get().offset() <= blob_index.offset());
+    if (blob_index.HasTTL() || blob_index.IsInlined()) {
+      *statuses[i] = Status::Corruption("Unexpected TTL/inlined blob index");
+      continue;
+    }
+    if (!IsValidBlobOffset(blob_index.offset(), user_keys[i].get().size(),
+                           blob_index.size(), file_size)) {
+      *statuses[i] = Status::Corruption("Invalid blob offset");
+      continue;
+    }
+    if (blob_index.compression() != compression) {
+      *statuses[i] =
+          Status::Corruption("Compression type mismatch when reading a blob");
+      continue;
+    }
+    valid_user_keys.emplace_back(user_keys[i]);
+    offsets.push_back(blob_index.offset());
+    value_sizes.push_back(blob_index.size());
+    valid_statuses.push_back(statuses[i]);
+    valid_values.push_back(values[i]);
+  }
+  if (valid_user_keys.empty()) {
+    return;
+  }
+
+  blob_file_reader.GetValue()->MultiGetBlob(
+      read_options, valid_user_keys, offsets, value_sizes, valid_statuses,
+      valid_values, bytes_read);
+}
+
 void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                   PinnableSlice* value, std::string* timestamp, Status* status,
                   MergeContext* merge_context,
@@ -2455,10 +2536,50 @@ bool Version::MaybeInitializeFileMetaData(FileMetaData* file_meta) {
   file_meta->num_deletions = tp->num_deletions;
   file_meta->raw_value_size = tp->raw_value_size;
   file_meta->raw_key_size = tp->raw_key_size;
+  file_meta->num_range_deletions = tp->num_range_deletions;
+  if (file_meta->num_range_deletions > 0 &&
+      cfd_->ioptions()->compaction_pri == kMaxDeletionReclaimRatio) {
+    LoadRangeDeletionRanges(file_meta);
+  }
 
   return true;
 }
 
+constexpr size_t Version::kMaxRangeDeletionRanges;
+
+void Version::LoadRangeDeletionRanges(FileMetaData* file_meta) {
+  std::unique_ptr<FragmentedRangeTombstoneIterator> iter;
+  Status s = cfd_->table_cache()->GetRangeTombstoneIterator(
+      ReadOptions(), cfd_->internal_comparator(), *file_meta, &iter);
+  if (!s.ok()) {
+    ROCKS_LOG_ERROR(vset_->db_options_->info_log,
+                    "Unable to load range tombstones for file %" PRIu64
+                    " --- %s\n",
+                    file_meta->fd.GetNumber(), s.ToString().c_str());
+    return;
+  }
+  if (iter == nullptr) {
+    return;
+  }
+  const Comparator* ucmp = cfd_->internal_comparator().user_comparator();
+  auto& ranges = file_meta->range_deletion_ranges;
+  // The fragments come sorted by start key
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    if (!ranges.empty() &&
+        ucmp->Compare(iter->start_key(), ranges.back().second) <= 0) {
+      if (ucmp->Compare(iter->end_key(), ranges.back().second) > 0) {
+        ranges.back().second = iter->end_key().ToString();
+      }
+    } else if (ranges.size() < kMaxRangeDeletionRanges) {
+      ranges.emplace_back(iter->start_key().ToString(),
+                          iter->end_key().ToString());
+    } else {
+      // Underestimates the coverage
+      break;
+    }
+  }
+}
+
 void VersionStorageInfo::UpdateAccumulatedStats(FileMetaData* file_meta) {
   TEST_SYNC_POINT_CALLBACK("VersionStorageInfo::UpdateAccumulatedStats",
                            nullptr);
@@ -2588,7 +2709,7 @@ int VersionStorageInfo::MaxOutputLevel(bool allow_ingest_behind) const {
 }
 
 void VersionStorageInfo::EstimateCompactionBytesNeeded(
-    const MutableCFOptions& mutable_cf_options) {
+    const MutableCFOptions& mutable_cf_options, int first_level) {
   // Only implemented for level-based compaction
   if (compaction_style_ != kCompactionStyleLevel) {
     estimated_compaction_needed_bytes_ = 0;
@@ -2612,9 +2733,11 @@ void VersionStorageInfo::EstimateCompactionBytesNeeded(
   }
   // Level 0
   bool level0_compact_triggered = false;
-  if (static_cast<int>(files_[0].size()) >=
-          mutable_cf_options.level0_file_num_compaction_trigger ||
-      level_size >= mutable_cf_options.max_bytes_for_level_base) {
+  if (first_level > 0) {
+    estimated_compaction_needed_bytes_ = 0;
+  } else if (static_cast<int>(files_[0].size()) >=
+                 mutable_cf_options.level0_file_num_compaction_trigger ||
+             level_size >= mutable_cf_options.max_bytes_for_level_base) {
     level0_compact_triggered = true;
     estimated_compaction_needed_bytes_ = level_size;
     bytes_compact_to_next_level = level_size;
@@ -2624,7 +2747,8 @@ void VersionStorageInfo::EstimateCompactionBytesNeeded(
 
   // Level 1 and up.
   uint64_t bytes_next_level = 0;
-  for (int level = base_level(); level <= MaxInputLevel(); level++) {
+  for (int level = std::max(base_level(), first_level);
+       level <= MaxInputLevel(); level++) {
     level_size = 0;
     if (bytes_next_level > 0) {
 #ifndef NDEBUG
@@ -2828,7 +2952,16 @@ void VersionStorageInfo::ComputeCompactionScore(
         mutable_cf_options.blob_garbage_collection_force_threshold);
   }
 
-  EstimateCompactionBytesNeeded(mutable_cf_options);
+  int first_estimated_level = 0;
+  if (compaction_style_ == kCompactionStyleLevel &&
+      immutable_options.compaction_options_hybrid.leveled_levels > 0) {
+    // With hybrid compaction, the levels above the last size-tiered one are
+    // not meant to stay within their target sizes
+    first_estimated_level =
+        num_levels() -
+        immutable_options.compaction_options_hybrid.leveled_levels - 1;
+  }
+  EstimateCompactionBytesNeeded(mutable_cf_options, first_estimated_level);
 }
 
 void VersionStorageInfo::ComputeFilesMarkedForCompaction() {
@@ -3132,25 +3265,13 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
-void SortFileByOverlappingRatio(
+// Returns the bytes in `next_level_files` overlapping with each of `files`
+std::vector<uint64_t> GetNextLevelOverlappingBytes(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
-    const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
-    int level, int num_non_empty_levels, uint64_t ttl,
-    std::vector<Fsize>* temp) {
-  std::unordered_map<uint64_t, uint64_t> file_to_order;
+    const std::vector<FileMetaData*>& next_level_files) {
+  std::vector<uint64_t> result;
+  result.reserve(files.size());
   auto next_level_it = next_level_files.begin();
-
-  int64_t curr_time;
-  Status status = clock->GetCurrentTime(&curr_time);
-  if (!status.ok()) {
-    // If we can't get time, disable TTL.
-    ttl = 0;
-  }
-
-  FileTtlBooster ttl_booster(static_cast<uint64_t>(curr_time), ttl,
-                             num_non_empty_levels, level);
-
   for (auto& file : files) {
     uint64_t overlapping_bytes = 0;
     // Skip files in next level that is smaller than current file
@@ -3169,11 +3290,37 @@ void SortFileByOverlappingRatio(
       }
       next_level_it++;
     }
+    result.push_back(overlapping_bytes);
+  }
+  return result;
+}
 
+// Sort `temp` based on ratio of overlapping size over file size
+void SortFileByOverlappingRatio(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
+    int level, int num_non_empty_levels, uint64_t ttl,
+    std::vector<Fsize>* temp) {
+  std::unordered_map<uint64_t, uint64_t> file_to_order;
+
+  int64_t curr_time;
+  Status status = clock->GetCurrentTime(&curr_time);
+  if (!status.ok()) {
+    // If we can't get time, disable TTL.
+    ttl = 0;
+  }
+
+  FileTtlBooster ttl_booster(static_cast<uint64_t>(curr_time), ttl,
+                             num_non_empty_levels, level);
+
+  std::vector<uint64_t> overlapping_bytes =
+      GetNextLevelOverlappingBytes(icmp, files, next_level_files);
+  for (size_t i = 0; i < files.size(); i++) {
+    FileMetaData* file = files[i];
     uint64_t ttl_boost_score = (ttl > 0) ? ttl_booster.GetBoostScore(file) : 1;
     assert(ttl_boost_score > 0);
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] = overlapping_bytes * 1024U /
+    file_to_order[file->fd.GetNumber()] = overlapping_bytes[i] * 1024U /
                                           file->compensated_file_size /
                                           ttl_boost_score;
   }
@@ -3184,6 +3331,91 @@ void SortFileByOverlappingRatio(
                      file_to_order[f2.file->fd.GetNumber()];
             });
 }
+
+// Returns the size of the files in `level_files`, sorted by key, that lie
+// entirely within the user key ranges of `ranges`
+uint64_t GetRangeDeletionCoveredBytes(
+    const Comparator* ucmp,
+    const std::vector<std::pair<std::string, std::string>>& ranges,
+    const std::vector<FileMetaData*>& level_files) {
+  uint64_t covered_bytes = 0;
+  for (const auto& range : ranges) {
+    // The first file ending at or after the start of the range
+    auto it = std::lower_bound(
+        level_files.begin(), level_files.end(), range.first,
+        [ucmp](const FileMetaData* f, const std::string& key) {
+          return ucmp->Compare(f->largest.user_key(), key) < 0;
+        });
+    for (; it != level_files.end() &&
+           ucmp->Compare((*it)->smallest.user_key(), range.second) < 0;
+         ++it) {
+      // The end of a range tombstone is exclusive
+      if (ucmp->Compare((*it)->smallest.user_key(), range.first) >= 0 &&
+          ucmp->Compare((*it)->largest.user_key(), range.second) < 0) {
+        covered_bytes += (*it)->fd.GetFileSize();
+      }
+    }
+  }
+  return covered_bytes;
+}
+
+// Sort `temp` based on the bytes that compacting each file is expected to
+// free, over the bytes it rewrites, largest first. Ties are broken by the
+// ratio of overlapping size over file size, smallest first.
+void SortFileByDeletionReclaimRatio(
+    const InternalKeyComparator& icmp,
+    const std::vector<FileMetaData*>* files, int num_levels, int level,
+    uint64_t average_value_size, std::vector<Fsize>* temp) {
+  struct Order {
+    uint64_t reclaim_ratio;
+    uint64_t overlapping_ratio;
+  };
+  std::unordered_map<uint64_t, Order> file_to_order;
+
+  const std::vector<FileMetaData*>& level_files = files[level];
+  std::vector<uint64_t> overlapping_bytes =
+      GetNextLevelOverlappingBytes(icmp, level_files, files[level + 1]);
+  for (size_t i = 0; i < level_files.size(); i++) {
+    FileMetaData* file = level_files[i];
+    const uint64_t file_size = file->fd.GetFileSize();
+
+    // A point tombstone frees itself and, on average, one older value
+    const uint64_t num_point_deletions =
+        file->num_deletions > file->num_range_deletions
+            ? file->num_deletions - file->num_range_deletions
+            : 0;
+    const uint64_t average_entry_size =
+        file->num_entries > 0 ? file_size / file->num_entries : 0;
+    uint64_t reclaimable_bytes =
+        num_point_deletions * (average_entry_size + average_value_size);
+    if (!file->range_deletion_ranges.empty()) {
+      // Levels below L0 are sorted by key
+      for (int lower_level = std::max(level + 1, 1); lower_level < num_levels;
+           lower_level++) {
+        reclaimable_bytes += GetRangeDeletionCoveredBytes(
+            icmp.user_comparator(), file->range_deletion_ranges,
+            files[lower_level]);
+      }
+    }
+
+    const uint64_t rewritten_bytes =
+        std::max<uint64_t>(file_size + overlapping_bytes[i], 1);
+    assert(file->compensated_file_size != 0);
+    file_to_order[file->fd.GetNumber()] = {
+        reclaimable_bytes * 1024U / rewritten_bytes,
+        overlapping_bytes[i] * 1024U / file->compensated_file_size};
+  }
+
+  std::sort(temp->begin(), temp->end(),
+            [&](const Fsize& f1, const Fsize& f2) -> bool {
+              const Order& o1 = file_to_order[f1.file->fd.GetNumber()];
+              const Order& o2 = file_to_order[f2.file->fd.GetNumber()];
+              if (o1.reclaim_ratio != o2.reclaim_ratio) {
+                return o1.reclaim_ratio > o2.reclaim_ratio;
+              }
+              return o1.overlapping_ratio < o2.overlapping_ratio;
+            });
+}
 }  // namespace
 
 void VersionStorageInfo::UpdateFilesByCompactionPri(
@@ -3236,6 +3468,11 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
                                    files_[level + 1], ioptions.clock, level,
                                    num_non_empty_levels_, options.ttl, &temp);
         break;
+      case kMaxDeletionReclaimRatio:
+        SortFileByDeletionReclaimRatio(*internal_comparator_, files_,
+                                       num_levels(), level,
+                                       GetAverageValueSize(), &temp);
+        break;
       default:
         assert(false);
     }
@@ -4084,6 +4321,7 @@ VersionSet::VersionSet(const std::string& dbname,
       prev_log_number_(0),
       current_version_number_(0),
       manifest_file_size_(0),
+      manifest_snapshot_size_(0),
       file_options_(storage_options),
       block_cache_tracer_(block_cache_tracer),
       io_tracer_(io_tracer),
@@ -4126,6 +4364,7 @@ void VersionSet::Reset() {
   current_version_number_ = 0;
   manifest_writers_.clear();
   manifest_file_size_ = 0;
+  manifest_snapshot_size_ = 0;
   obsolete_files_.clear();
   obsolete_manifests_.clear();
   wals_.Reset();
@@ -4337,8 +4576,22 @@ Status VersionSet::ProcessManifestWrites(
 #endif  // NDEBUG
 
   assert(pending_manifest_file_number_ == 0);
-  if (!descriptor_log_ ||
-      manifest_file_size_ > db_options_->max_manifest_file_size) {
+  uint64_t max_manifest_file_size = db_options_->max_manifest_file_size;
+  if (db_options_->max_manifest_space_amp_pct > 0) {
+    // Leave room for the edits in proportion to the snapshot, so that large
+    // DBs do not roll over after every few edits. Multiplied first so that
+    // small snapshots get their allowance too, saturating on overflow.
+    const uint64_t pct =
+        static_cast<uint64_t>(db_options_->max_manifest_space_amp_pct);
+    const uint64_t kMaxSize = std::numeric_limits<uint64_t>::max();
+    uint64_t allowance = manifest_snapshot_size_ <= kMaxSize / pct
+                             ? manifest_snapshot_size_ * pct / 100
+                             : kMaxSize;
+    allowance = std::min(allowance, kMaxSize - manifest_snapshot_size_);
+    max_manifest_file_size = std::max(max_manifest_file_size,
+                                      manifest_snapshot_size_ + allowance);
+  }
+  if (!descriptor_log_ || manifest_file_size_ > max_manifest_file_size) {
     TEST_SYNC_POINT("VersionSet::ProcessManifestWrites:BeforeNewManifest");
     new_descriptor_log = true;
   } else {
@@ -4373,6 +4626,7 @@ Status VersionSet::ProcessManifestWrites(
   }
 
   uint64_t new_manifest_file_size = 0;
+  uint64_t new_manifest_snapshot_size = manifest_snapshot_size_;
   Status s;
   IOStatus io_s;
   IOStatus manifest_io_status;
@@ -4427,6 +4681,9 @@ Status VersionSet::ProcessManifestWrites(
             new log::Writer(std::move(file_writer), 0, false));
         s = WriteCurrentStateToManifest(curr_state, wal_additions,
                                         descriptor_log_.get(), io_s);
+        if (s.ok()) {
+          new_manifest_snapshot_size = descriptor_log_->file()->GetFileSize();
+        }
       } else {
         manifest_io_status = io_s;
         s = io_s;
@@ -4593,6 +4850,7 @@ Status VersionSet::ProcessManifestWrites(
     descriptor_last_sequence_ = max_last_sequence;
     manifest_file_number_ = pending_manifest_file_number_;
     manifest_file_size_ = new_manifest_file_size;
+    manifest_snapshot_size_ = new_manifest_snapshot_size;
     prev_log_number_ = first_writer.edit_list.front()->prev_log_number_;
   } else {
     std::string version_edits;
@@ -4608,6 +4866,7 @@ Status VersionSet::ProcessManifestWrites(
     if (manifest_io_status.ok()) {
       manifest_file_number_ = pending_manifest_file_number_;
       manifest_file_size_ = new_manifest_file_size;
+      manifest_snapshot_size_ = new_manifest_snapshot_size;
     }
     // If manifest append failed for whatever reason, the file could be
     // corrupted. So we need to force the next version update to start a
@@ -5435,7 +5694,8 @@ Status VersionSet::WriteCurrentStateToManifest(
               f->fd.largest_seqno, f->marked_for_compaction, f->temperature,
               f->oldest_blob_file_number, f->oldest_ancester_time,
               f->file_creation_time, f->file_checksum,
-              f->file_checksum_func_name, f->min_timestamp, f->max_timestamp);
+              f->file_checksum_func_name, f->min_timestamp, f->max_timestamp,
+              f->tail_size, f->flush_group);
         }
       }
 
@@ -5791,10 +6051,52 @@ void VersionSet::AddLiveFiles(std::vector<uint64_t>* live_table_files,
   }
 }
 
+namespace {
+// Adds the range tombstones of all files of a compaction input level to
+// `range_del_agg` up front, as a LevelIterator would when opening each file.
+// This lets the level be read on another thread.
+Status AddLevelRangeTombstones(
+    TableCache* table_cache, const ReadOptions& read_options,
+    const InternalKeyComparator& icmp, const LevelFilesBrief* flevel,
+    const std::vector<AtomicCompactionUnitBoundary>* boundaries,
+    RangeDelAggregator* range_del_agg) {
+  if (read_options.ignore_range_deletions) {
+    return Status::OK();
+  }
+  for (size_t i = 0; i < flevel->num_files; i++) {
+    const FileMetaData& file_meta = *flevel->files[i].file_metadata;
+    if (!range_del_agg->AddFile(file_meta.fd.GetNumber())) {
+      continue;
+    }
+    std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter;
+    Status s = table_cache->GetRangeTombstoneIterator(read_options, icmp,
+                                                      file_meta,
+                                                      &range_del_iter);
+    if (s.ok() && range_del_iter != nullptr) {
+      s = range_del_iter->status();
+    }
+    if (!s.ok()) {
+      return s;
+    }
+    if (range_del_iter != nullptr) {
+      const InternalKey* smallest = &file_meta.smallest;
+      const InternalKey* largest = &file_meta.largest;
+      if (boundaries != nullptr) {
+        smallest = (*boundaries)[i].smallest;
+        largest = (*boundaries)[i].largest;
+      }
+      range_del_agg->AddTombstones(std::move(range_del_iter), smallest,
+                                   largest);
+    }
+  }
+  return Status::OK();
+}
+}  // namespace
+
 InternalIterator* VersionSet::MakeInputIterator(
     const ReadOptions& read_options, const Compaction* c,
     RangeDelAggregator* range_del_agg,
-    const FileOptions& file_options_compactions) {
+    const FileOptions& file_options_compactions, bool pipeline_inputs) {
   auto cfd = c->column_family_data();
   // Level-0 files have to be merged together.  For other levels,
   // we will make a concatenating iterator per level.
@@ -5804,12 +6106,15 @@ InternalIterator* VersionSet::MakeInputIterator(
                                         : c->num_input_levels());
   InternalIterator** list = new InternalIterator* [space];
   size_t num = 0;
+  // Inputs read ahead of the merge by jobs of their own
+  int input_threads_left =
+      pipeline_inputs ? db_options_->max_compaction_input_threads : 0;
   for (size_t which = 0; which < c->num_input_levels(); which++) {
     if (c->input_levels(which)->num_files != 0) {
       if (c->level(which) == 0) {
         const LevelFilesBrief* flevel = c->input_levels(which);
         for (size_t i = 0; i < flevel->num_files; i++) {
-          list[num++] = cfd->table_cache()->NewIterator(
+          InternalIterator* iter = cfd->table_cache()->NewIterator(
               read_options, file_options_compactions,
               cfd->internal_comparator(), *flevel->files[i].file_metadata,
               range_del_agg, c->mutable_cf_options()->prefix_extractor,
@@ -5822,18 +6127,40 @@ InternalIterator* VersionSet::MakeInputIterator(
               /*smallest_compaction_key=*/nullptr,
               /*largest_compaction_key=*/nullptr,
               /*allow_unprepared_value=*/false);
+          // The file's range tombstones were added along with the iterator
+          if (input_threads_left > 0) {
+            --input_threads_left;
+            iter = new PipelinedInputIterator(iter, env_, Env::Priority::LOW);
+          }
+          list[num++] = iter;
         }
       } else {
+        RangeDelAggregator* level_range_del_agg = range_del_agg;
+        if (input_threads_left > 0) {
+          Status s = AddLevelRangeTombstones(
+              cfd->table_cache(), read_options, cfd->internal_comparator(),
+              c->input_levels(which), c->boundaries(which), range_del_agg);
+          if (!s.ok()) {
+            list[num++] = NewErrorInternalIterator<Slice>(s);
+            continue;
+          }
+          level_range_del_agg = nullptr;
+        }
         // Create concatenating iterator for the files from this level
-        list[num++] = new LevelIterator(
+        InternalIterator* iter = new LevelIterator(
             cfd->table_cache(), read_options, file_options_compactions,
             cfd->internal_comparator(), c->input_levels(which),
             c->mutable_cf_options()->prefix_extractor,
             /*should_sample=*/false,
             /*no per level latency histogram=*/nullptr,
             TableReaderCaller::kCompaction, /*skip_filters=*/false,
-            /*level=*/static_cast<int>(c->level(which)), range_del_agg,
+            /*level=*/static_cast<int>(c->level(which)), level_range_del_agg,
             c->boundaries(which));
+        if (level_range_del_agg == nullptr) {
+          --input_threads_left;
+          iter = new PipelinedInputIterator(iter, env_, Env::Priority::LOW);
+        }
+        list[num++] = iter;
       }
     }
   }
@@ -153,9 +153,10 @@ class VersionStorageInfo {
   void ComputeCompactionScore(const ImmutableOptions& immutable_options,
                               const MutableCFOptions& mutable_cf_options);
 
-  // Estimate est_comp_needed_bytes_
-  void EstimateCompactionBytesNeeded(
-      const MutableCFOptions& mutable_cf_options);
+  // Estimate est_comp_needed_bytes_, leaving out the levels above
+  // `first_level`
+  void EstimateCompactionBytesNeeded(const MutableCFOptions& mutable_cf_options,
+                                     int first_level = 0);
 
   // This computes files_marked_for_compaction_ and is called by
   // ComputeCompactionScore()
@@ -806,6 +807,16 @@ class Version {
   void MultiGetBlob(const ReadOptions& read_options, MultiGetRange& range,
                     std::unordered_map<uint64_t, BlobReadRequests>& blob_rqs);
 
+  // Retrieves the blobs referenced by blob_indexes from a single blob file of
+  // this Version with one MultiRead, and saves them in *values. The blob
+  // references must be sorted by offset.
+  void MultiGetBlobFromFile(
+      const ReadOptions& read_options, uint64_t blob_file_number,
+      const autovector<std::reference_wrapper<const Slice>>& user_keys,
+      const autovector<std::reference_wrapper<const BlobIndex>>& blob_indexes,
+      autovector<Status*>& statuses, autovector<PinnableSlice*>& values,
+      uint64_t* bytes_read) const;
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -919,6 +930,13 @@ class Version {
   // Returns true if it does initialize FileMetaData.
   bool MaybeInitializeFileMetaData(FileMetaData* file_meta);
 
+  // Caps the memory used by FileMetaData::range_deletion_ranges
+  static constexpr size_t kMaxRangeDeletionRanges = 64;
+
+  // Fills FileMetaData::range_deletion_ranges from the range tombstones of
+  // the file.
+  void LoadRangeDeletionRanges(FileMetaData* file_meta);
+
   // Update the accumulated stats associated with the current version.
   // This accumulated stats will be used in compaction.
   void UpdateAccumulatedStats(bool update_stats);
@@ -1261,10 +1279,13 @@ class VersionSet {
   // Create an iterator that reads over the compaction inputs for "*c".
   // The caller should delete the iterator when no longer needed.
   // @param read_options Must outlive the returned iterator.
+  // @param pipeline_inputs Whether inputs may be read ahead on threads of
+  //   their own, see max_compaction_input_threads.
   InternalIterator* MakeInputIterator(
       const ReadOptions& read_options, const Compaction* c,
       RangeDelAggregator* range_del_agg,
-      const FileOptions& file_options_compactions);
+      const FileOptions& file_options_compactions,
+      bool pipeline_inputs = true);
 
   // Add all files listed in any live version to *live_table_files and
   // *live_blob_files. Note that these lists may contain duplicates.
@@ -1450,6 +1471,9 @@ class VersionSet {
 
   // Current size of manifest file
   uint64_t manifest_file_size_;
+  // Size of the snapshot of the full state at the start of the manifest file,
+  // 0 if unknown (see max_manifest_space_amp_pct)
+  uint64_t manifest_snapshot_size_;
 
   std::vector<ObsoleteFileInfo> obsolete_files_;
   std::vector<ObsoleteBlobFileInfo> obsolete_blob_files_;
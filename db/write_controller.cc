@@ -33,6 +33,19 @@ std::unique_ptr<WriteControllerToken> WriteController::GetDelayToken(
   return std::unique_ptr<WriteControllerToken>(new DelayWriteToken(this));
 }
 
+std::unique_ptr<WriteControllerToken> WriteController::GetCombinedDelayToken(
+    uint64_t write_rate) {
+  if (0 == total_delayed_++) {
+    // Starting delay, so reset counters.
+    next_refill_time_ = 0;
+    credit_in_bytes_ = 0;
+  }
+  combined_delayed_write_rates_.insert(write_rate);
+  set_delayed_write_rate(*combined_delayed_write_rates_.begin());
+  return std::unique_ptr<WriteControllerToken>(
+      new CombinedDelayWriteToken(this, write_rate));
+}
+
 std::unique_ptr<WriteControllerToken>
 WriteController::GetCompactionPressureToken() {
   ++total_compaction_pressure_;
@@ -113,6 +126,16 @@ DelayWriteToken::~DelayWriteToken() {
   assert(controller_->total_delayed_.load() >= 0);
 }
 
+CombinedDelayWriteToken::~CombinedDelayWriteToken() {
+  auto& rates = controller_->combined_delayed_write_rates_;
+  auto it = rates.find(write_rate_);
+  assert(it != rates.end());
+  rates.erase(it);
+  if (!rates.empty()) {
+    controller_->set_delayed_write_rate(*rates.begin());
+  }
+}
+
 CompactionPressureToken::~CompactionPressureToken() {
   controller_->total_compaction_pressure_--;
   assert(controller_->total_compaction_pressure_ >= 0);
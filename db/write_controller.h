@@ -9,6 +9,8 @@
 
 #include <atomic>
 #include <memory>
+#include <set>
+
 #include "rocksdb/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -44,6 +46,12 @@ class WriteController {
   // which returns number of microseconds to sleep.
   std::unique_ptr<WriteControllerToken> GetDelayToken(
       uint64_t delayed_write_rate);
+  // Same as GetDelayToken(), except that the rates of the live tokens from
+  // this method are combined: writes are delayed to the lowest of them.
+  // Each column family then asks for its own rate, as with
+  // DBOptions::smooth_write_stalls.
+  std::unique_ptr<WriteControllerToken> GetCombinedDelayToken(
+      uint64_t delayed_write_rate);
   // When an actor (column family) requests a moderate token, compaction
   // threads will be increased
   std::unique_ptr<WriteControllerToken> GetCompactionPressureToken();
@@ -90,6 +98,7 @@ class WriteController {
   friend class WriteControllerToken;
   friend class StopWriteToken;
   friend class DelayWriteToken;
+  friend class CombinedDelayWriteToken;
   friend class CompactionPressureToken;
 
   std::atomic<int> total_stopped_;
@@ -104,6 +113,8 @@ class WriteController {
   uint64_t max_delayed_write_rate_;
   // Current write rate (bytes / second)
   uint64_t delayed_write_rate_;
+  // Write rates of the live tokens from GetCombinedDelayToken()
+  std::multiset<uint64_t> combined_delayed_write_rates_;
 
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
 };
@@ -137,6 +148,16 @@ class DelayWriteToken : public WriteControllerToken {
   virtual ~DelayWriteToken();
 };
 
+class CombinedDelayWriteToken : public DelayWriteToken {
+ public:
+  CombinedDelayWriteToken(WriteController* controller, uint64_t write_rate)
+      : DelayWriteToken(controller), write_rate_(write_rate) {}
+  virtual ~CombinedDelayWriteToken();
+
+ private:
+  uint64_t write_rate_;
+};
+
 class CompactionPressureToken : public WriteControllerToken {
  public:
   explicit CompactionPressureToken(WriteController* controller)
@@ -917,6 +917,28 @@ IOStatus PosixMmapReadableFile::Read(uint64_t offset, size_t n,
   return s;
 }
 
+IOStatus PosixMmapReadableFile::Prefetch(uint64_t offset, size_t n,
+                                         const IOOptions& /*opts*/,
+                                         IODebugContext* /*dbg*/) {
+  if (offset >= length_ || n == 0) {
+    return IOStatus::OK();
+  }
+  n = static_cast<size_t>(std::min<uint64_t>(n, length_ - offset));
+  // madvise() requires a page aligned start address.
+  uintptr_t start = reinterpret_cast<uintptr_t>(mmapped_region_) +
+                    static_cast<uintptr_t>(offset);
+  uintptr_t aligned_start =
+      start & ~(static_cast<uintptr_t>(port::kPageSize) - 1);
+  int ret = madvise(reinterpret_cast<void*>(aligned_start),
+                    n + (start - aligned_start), MADV_WILLNEED);
+  if (ret != 0) {
+    return IOError("While madvise willneed. Offset " + ToString(offset) +
+                       " len " + ToString(n),
+                   filename_, errno);
+  }
+  return IOStatus::OK();
+}
+
 IOStatus PosixMmapReadableFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   (void)offset;
@@ -296,6 +296,9 @@ class PosixMmapReadableFile : public FSRandomAccessFile {
   virtual IOStatus Read(uint64_t offset, size_t n, const IOOptions& opts,
                         Slice* result, char* scratch,
                         IODebugContext* dbg) const override;
+  // Asks the kernel to fault in the mapped range ahead of use.
+  virtual IOStatus Prefetch(uint64_t offset, size_t n, const IOOptions& opts,
+                            IODebugContext* dbg) override;
   virtual IOStatus InvalidateCache(size_t offset, size_t length) override;
 };
 
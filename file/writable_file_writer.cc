@@ -209,7 +209,7 @@ IOStatus WritableFileWriter::Close() {
   IOStatus interim;
   // In direct I/O mode we write whole pages so
   // we need to let the file know where data ends.
-  if (use_direct_io()) {
+  if (use_direct_io() && !keep_file_size_) {
     {
 #ifndef ROCKSDB_LITE
       FileOperationInfo::StartTimePoint start_ts;
@@ -396,7 +396,7 @@ IOStatus WritableFileWriter::Sync(bool use_fsync) {
     return s;
   }
   TEST_KILL_RANDOM("WritableFileWriter::Sync:0");
-  if (!use_direct_io() && pending_sync_) {
+  if ((!use_direct_io() || sync_direct_writes_) && pending_sync_) {
     s = SyncInternal(use_fsync);
     if (!s.ok()) {
       return s;
@@ -691,6 +691,8 @@ IOStatus WritableFileWriter::WriteDirect() {
   // will write it again in the future either on Close() OR when the current
   // whole page fills out.
   const size_t leftover_tail = buf_.CurrentSize() - file_advance;
+  // The padding written after it does not count as flushed data
+  const uint64_t data_end = next_write_offset_ + buf_.CurrentSize();
 
   // Round up and pad
   buf_.PadToAlignmentWith(0);
@@ -748,8 +750,8 @@ IOStatus WritableFileWriter::WriteDirect() {
     left -= size;
     src += size;
     write_offset += size;
-    uint64_t cur_size = flushed_size_.load(std::memory_order_acquire);
-    flushed_size_.store(cur_size + size, std::memory_order_release);
+    flushed_size_.store(std::min(write_offset, data_end),
+                        std::memory_order_release);
     assert((next_write_offset_ % alignment) == 0);
   }
 
@@ -782,6 +784,8 @@ IOStatus WritableFileWriter::WriteDirectWithChecksum() {
   // will write it again in the future either on Close() OR when the current
   // whole page fills out.
   const size_t leftover_tail = buf_.CurrentSize() - file_advance;
+  // The padding written after it does not count as flushed data
+  const uint64_t data_end = next_write_offset_ + buf_.CurrentSize();
 
   // Round up, pad, and combine the checksum.
   size_t last_cur_size = buf_.CurrentSize();
@@ -846,8 +850,7 @@ IOStatus WritableFileWriter::WriteDirectWithChecksum() {
 
   IOSTATS_ADD(bytes_written, left);
   assert((next_write_offset_ % alignment) == 0);
-  uint64_t cur_size = flushed_size_.load(std::memory_order_acquire);
-  flushed_size_.store(cur_size + left, std::memory_order_release);
+  flushed_size_.store(data_end, std::memory_order_release);
 
   if (s.ok()) {
     // Move the tail to the beginning of the buffer
@@ -160,6 +160,8 @@ class WritableFileWriter {
   bool perform_data_verification_;
   uint32_t buffered_data_crc32c_checksum_;
   bool buffered_data_with_checksum_;
+  bool sync_direct_writes_;
+  bool keep_file_size_;
 
  public:
   WritableFileWriter(
@@ -191,7 +193,9 @@ class WritableFileWriter {
         checksum_finalized_(false),
         perform_data_verification_(perform_data_verification),
         buffered_data_crc32c_checksum_(0),
-        buffered_data_with_checksum_(buffered_data_with_checksum) {
+        buffered_data_with_checksum_(buffered_data_with_checksum),
+        sync_direct_writes_(false),
+        keep_file_size_(false) {
     TEST_SYNC_POINT_CALLBACK("WritableFileWriter::WritableFileWriter:0",
                              reinterpret_cast<void*>(max_buffer_size_));
     buf_.Alignment(writable_file_->GetRequiredBufferAlignment());
@@ -252,7 +256,8 @@ class WritableFileWriter {
   }
 
   // Returns the size of data flushed to the underlying `FSWritableFile`.
-  // Expected to match `writable_file()->GetFileSize()`.
+  // Expected to match `writable_file()->GetFileSize()`, but for the zero
+  // padding of the last page in direct I/O mode.
   // The return value can serve as a lower-bound for the amount of data synced
   // by a future call to `SyncWithoutFlush()`.
   uint64_t GetFlushedSize() const {
@@ -267,6 +272,16 @@ class WritableFileWriter {
 
   bool use_direct_io() { return writable_file_->use_direct_io(); }
 
+  // In direct I/O mode, Sync() only flushes the buffer by default, as direct
+  // writes bypass the OS cache. Makes Sync() also sync the file, to persist
+  // the file size and the device write cache, as WAL syncs must.
+  void SetSyncDirectWrites() { sync_direct_writes_ = true; }
+
+  // In direct I/O mode, Close() truncates the file to the data written, to
+  // drop the padding of the last page. Makes Close() keep the file size, for
+  // files written over space allocated ahead (see DBOptions::wal_zero_fill).
+  void SetKeepFileSize() { keep_file_size_ = true; }
+
   bool TEST_BufferIsEmpty() { return buf_.CurrentSize() == 0; }
 
   void TEST_SetFileChecksumGenerator(
@@ -54,6 +54,14 @@ enum CompactionPri : char {
   // and its size is the smallest. It in many cases can optimize write
   // amplification.
   kMinOverlappingRatio = 0x3,
+  // First compact files whose compaction is expected to free the most space
+  // per byte rewritten. The space freed counts the point tombstones of a
+  // file with the older values they shadow, and the lower-level files
+  // entirely covered by its range tombstones. The bytes rewritten are the
+  // file and its overlap in the next level. Files without tombstones are
+  // ordered as with kMinOverlappingRatio. Try this if you delete large
+  // parts of the key space, and tombstones linger and slow down scans.
+  kMaxDeletionReclaimRatio = 0x4,
 };
 
 struct CompactionOptionsFIFO {
@@ -80,6 +88,37 @@ struct CompactionOptionsFIFO {
         allow_compaction(_allow_compaction) {}
 };
 
+// Hybrid compaction runs leveled compaction in the last levels of the LSM
+// tree and size-tiered compaction, as in universal compaction, in the levels
+// above them. Only for kCompactionStyleLevel.
+struct CompactionOptionsHybrid {
+  // The number of levels at the bottom of the LSM tree that are compacted the
+  // leveled way. In the levels above them, L0 included, each L0 file and
+  // each level is a sorted run, and similarly sized runs are merged together
+  // instead of each file being merged into the next level. The last of these
+  // levels is compacted into the levels below as in leveled compaction once
+  // it exceeds its target size. Must be less than num_levels - 1.
+  // level_compaction_dynamic_level_bytes is not supported with it.
+  // Default: 0, which disables hybrid compaction
+  int leveled_levels = 0;
+
+  // Sorted runs are merged while the next older run is at most this percent
+  // larger than the runs picked so far, as
+  // CompactionOptionsUniversal::size_ratio. Besides, as soon as there are
+  // level0_file_num_compaction_trigger sorted runs above the leveled levels,
+  // the newest of them are merged regardless of their sizes.
+  // Default: 1
+  unsigned int size_ratio = 1;
+
+  // The upper levels are compacted the size-tiered way only while the write
+  // rate of the column family, measured from the bytes flushed and ingested
+  // into L0 over periods of a few seconds, is at least this many bytes per
+  // second. They go back to leveled compaction once it falls below half of
+  // it.
+  // Default: 0, which always compacts them the size-tiered way
+  uint64_t min_write_rate_for_tiering = 0;
+};
+
 // Compression options for different compression algorithms like Zlib
 struct CompressionOptions {
   // RocksDB's generic default compression level. Internally it'll be translated
@@ -655,6 +694,11 @@ struct AdvancedColumnFamilyOptions {
   // SetOptions("compaction_options_fifo", "{max_table_files_size=100;}")
   CompactionOptionsFIFO compaction_options_fifo;
 
+  // The options for hybrid compaction, with kCompactionStyleLevel
+  //
+  // Not dynamically changeable through SetOptions() API
+  CompactionOptionsHybrid compaction_options_hybrid;
+
   // An iteration->Next() sequentially skips over keys with the same
   // user-key unless this option is set. This number specifies the number
   // of keys (with the same userkey) that will be sequentially
@@ -738,6 +782,43 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   bool paranoid_file_checks = false;
 
+  // If larger than 1, a flush with at least twice target_file_size_base
+  // bytes of memtable data writes
+  // min(max_flush_partitions, data size / target_file_size_base) L0 files
+  // instead of one, of about the same size each. The files cover disjoint key
+  // ranges, picked from a sample of the memtable keys, and are built
+  // concurrently, by up to as many threads as the flush thread pool has
+  // (see max_background_flushes). They are installed together, each with
+  // its own sequence number range, and recorded in the MANIFEST as one flush
+  // group, which older versions cannot open. EventListener::OnFlushCompleted()
+  // is called once per file. Each file counts towards the L0 file triggers:
+  // a flush writes no more files than level0_file_num_compaction_trigger,
+  // and the L0 write stall triggers may need to be raised accordingly.
+  //
+  // Only supported with level compaction and the skip list memtable. Flushes
+  // of memtables holding range deletions, and column families with
+  // user-defined timestamps, still write a single file.
+  //
+  // Default: 1
+  //
+  // Dynamically changeable through SetOptions() API
+  uint32_t max_flush_partitions = 1;
+
+  // If true, flush outputs are not always added to L0: like files ingested
+  // with IngestExternalFile(), each of them goes to the deepest level that
+  // neither it nor any level above it overlaps, considering both the files
+  // of the levels and the outputs of running compactions. Column families
+  // written with mostly increasing keys, such as time series, then skip the
+  // L0->L1 compactions of most of their data.
+  //
+  // Only supported with level compaction, and ignored by atomic flushes.
+  // The last level is left alone with allow_ingest_behind.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool flush_to_deepest_level = false;
+
   // In debug mode, RocksDB runs consistency checks on the LSM every time the
   // LSM changes (Flush, Compaction, AddFile). When this option is true, these
   // checks are also enabled in release mode. These checks were historically
@@ -828,8 +909,8 @@ struct AdvancedColumnFamilyOptions {
   // of indirection for reads. See also the options min_blob_size,
   // blob_file_size, blob_compression_type, enable_blob_garbage_collection,
   // blob_garbage_collection_age_cutoff,
-  // blob_garbage_collection_force_threshold, and blob_compaction_readahead_size
-  // below.
+  // blob_garbage_collection_force_threshold, blob_compaction_readahead_size,
+  // and blob_garbage_collection_batch_size below.
   //
   // Default: false
   //
@@ -909,6 +990,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   uint64_t blob_compaction_readahead_size = 0;
 
+  // If non-zero, blobs relocated by garbage collection are read in batches of
+  // about this many bytes instead of one at a time. Compaction looks ahead
+  // in its input for the blob references to relocate, and reads the blobs of
+  // each blob file in ascending order of file offset with a single MultiRead,
+  // which turns the random reads of garbage collection into mostly
+  // sequential ones. The input entries looked ahead are buffered in memory,
+  // up to about the same size. Note that enable_blob_garbage_collection has
+  // to be set in order for this option to have any effect, and that
+  // blob_compaction_readahead_size is not used while it is.
+  //
+  // Default: 0
+  //
+  // Dynamically changeable through the SetOptions() API
+  uint64_t blob_garbage_collection_batch_size = 0;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
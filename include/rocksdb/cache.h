@@ -272,6 +272,19 @@ class Cache {
   // function.
   virtual Handle* Lookup(const Slice& key, Statistics* stats = nullptr) = 0;
 
+  // Returns true if the cache has a mapping for "key". Unlike Lookup(), this
+  // does not count as a use of the entry: where the cache supports it, the
+  // entry keeps its place in the eviction order. The default implementation
+  // is a Lookup() followed by a Release().
+  virtual bool Probe(const Slice& key) {
+    Handle* handle = Lookup(key);
+    if (handle == nullptr) {
+      return false;
+    }
+    Release(handle);
+    return true;
+  }
+
   // Increments the reference count for the handle if it refers to an entry in
   // the cache. Returns true if refcount was incremented; otherwise, returns
   // false.
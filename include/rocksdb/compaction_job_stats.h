@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "rocksdb/rocksdb_namespace.h"
 
@@ -23,6 +24,10 @@ struct CompactionJobStats {
   // the elapsed CPU time of this compaction in microseconds.
   uint64_t cpu_micros;
 
+  // the elapsed time of each subcompaction in microseconds, in key order.
+  // Empty unless the compaction was split into several subcompactions.
+  std::vector<uint64_t> subcompaction_elapsed_micros;
+
   // the number of compaction input records.
   uint64_t num_input_records;
   // the number of blobs read from blob files
@@ -25,6 +25,11 @@ enum CompressionType : unsigned char {
   kLZ4HCCompression = 0x5,
   kXpressCompression = 0x6,
   kZSTD = 0x7,
+  // Lightweight in-tree codec based on a per-block static symbol table
+  // (FSST). Compresses less than LZ4 on binary data but decodes several times
+  // faster, which makes it a good fit for the upper levels of
+  // compression_per_level where most reads are served.
+  kFSSTCompression = 0x8,
 
   // Only use kZSTDNotFinalCompression if you have to use ZSTD lib older than
   // 0.8.0 or consider a possibility of downgrading the service or copying
@@ -11,12 +11,15 @@
 
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 
 #include "rocksdb/rocksdb_namespace.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class RateLimiter;
+
 // This is NOT an extensible interface but a public interface for result of
 // NewConcurrentTaskLimiter. Any derived classes must be RocksDB internal.
 class ConcurrentTaskLimiter {
@@ -48,4 +51,31 @@ class ConcurrentTaskLimiter {
 extern ConcurrentTaskLimiter* NewConcurrentTaskLimiter(const std::string& name,
                                                        int32_t limit);
 
+// Create a ConcurrentTaskLimiter that, in addition to limiting the number of
+// concurrent compactions, decides which of the waiting compactions get the
+// free slots, across all the CFs and RocksDB instances sharing it.
+//
+// The cost of the next compaction of a CF is estimated from the bytes it
+// reads and writes and from the CPU time past compactions of the CF took per
+// byte; its benefit from the sorted runs it removes from the read path (read
+// amplification reduction) and the space it is expected to reclaim. A
+// throttled compaction gets a free slot only if no waiting compaction has a
+// higher benefit per second of cost, so L0 compactions of CFs about to stall
+// go before the routine compactions of other CFs.
+//
+// @param name: Name of the limiter.
+// @param limit: max concurrent tasks.
+//        limit = 0 means no new task allowed.
+//        limit < 0 means no limitation.
+// @param rate_limiter: if not nullptr, usually the rate limiter of the DBs
+//        sharing the limiter, e.g. one from NewWriteAmpBasedRateLimiter().
+//        Its rate weighs I/O against CPU time, and the estimated bytes of
+//        the running compactions are kept below what it lets through in
+//        `max_inflight_seconds`. A compaction that reduces read
+//        amplification and waits for this budget paces it up.
+extern ConcurrentTaskLimiter* NewCostAwareConcurrentTaskLimiter(
+    const std::string& name, int32_t limit,
+    std::shared_ptr<RateLimiter> rate_limiter = nullptr,
+    uint64_t max_inflight_seconds = 60);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -1011,6 +1011,12 @@ class DB {
     //  "rocksdb.is-write-stalled" - Return 1 if write has been stalled.
     static const std::string kIsWriteStalled;
 
+    //  "rocksdb.write-stall-pressure" - returns how close the column family
+    //      is to stopping writes, in percent, from 0 at the thresholds that
+    //      delay writes to 100 at the ones that stop them (see
+    //      DBOptions::smooth_write_stalls).
+    static const std::string kWriteStallPressure;
+
     //  "rocksdb.estimate-oldest-key-time" - returns an estimation of
     //      oldest key timestamp in the DB. Currently only available for
     //      FIFO compaction with
@@ -1105,6 +1111,7 @@ class DB {
   //  "rocksdb.actual-delayed-write-rate"
   //  "rocksdb.is-write-stopped"
   //  "rocksdb.is-write-stalled"
+  //  "rocksdb.write-stall-pressure"
   //  "rocksdb.estimate-oldest-key-time"
   //  "rocksdb.block-cache-capacity"
   //  "rocksdb.block-cache-usage"
@@ -1403,6 +1410,18 @@ class DB {
   // The sequence number of the most recent transaction.
   virtual SequenceNumber GetLatestSequenceNumber() const = 0;
 
+  // The sequence number up to which all writes are known to be durable in
+  // the WAL, as of the last successful WAL sync (by a WriteOptions::sync
+  // write, SyncWAL(), FlushWAL(true) or the background syncer, see
+  // DBOptions::max_unsynced_wal_bytes). With avoid_flush_during_recovery,
+  // the WALs recovered when opening the DB are synced, and their writes count
+  // as durable if that succeeds. Otherwise only the writes flushed to SST
+  // files by then do, until the DB is reopened. Only meaningful for writes
+  // with the WAL enabled: writes with WriteOptions::disableWAL are never made
+  // durable by a WAL sync, even if their sequence number is below the
+  // returned one.
+  virtual SequenceNumber GetLatestDurableSequenceNumber() const { return 0; }
+
   // Prevent file deletions. Compactions will continue to occur,
   // but no obsolete files will be deleted. Calling this multiple
   // times have the same effect as calling it once.
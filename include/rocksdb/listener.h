@@ -147,6 +147,11 @@ enum class CompactionReason : int {
   kChangeTemperature,
   // Compaction scheduled to force garbage collection of blob files
   kForcedBlobGC,
+  // [Hybrid] Size-tiered compaction of the upper levels for size ratio
+  kHybridSizeRatio,
+  // [Hybrid] Size-tiered compaction of the upper levels as the number of
+  // sorted runs > level0_file_num_compaction_trigger
+  kHybridSortedRunNum,
   // total number of compaction reasons, new reasons must be added above this.
   kNumOfReasons,
 };
@@ -440,6 +445,24 @@ struct SubcompactionJobInfo {
   int output_level;
 };
 
+struct ManualCompactionProgressInfo {
+  ManualCompactionProgressInfo() = default;
+
+  // the id of the column family being compacted.
+  uint32_t cf_id;
+  // the name of the column family being compacted.
+  std::string cf_name;
+  // the total size of the files of the range that had to be moved down when
+  // the compaction started.
+  uint64_t total_bytes = 0;
+  // the total size of the files of the range that still have to be moved
+  // down. Since the data of a file can be moved down more than once, this
+  // can also grow.
+  uint64_t remaining_bytes = 0;
+  // the number of files of the range compacted so far.
+  uint64_t num_compacted_files = 0;
+};
+
 struct MemTableInfo {
   // the name of the column family to which memtable belongs
   std::string cf_name;
@@ -610,6 +633,13 @@ class EventListener : public Customizable {
   // callback is called by each subcompaction and in the same thread.
   virtual void OnSubcompactionCompleted(const SubcompactionJobInfo& /*si*/) {}
 
+  // A callback function for RocksDB which will be called by
+  // DB::CompactRange() with `CompactRangeOptions::incremental`, in the
+  // calling thread, when it starts, whenever the size of the data of the
+  // range left to compact changes, and when it is done.
+  virtual void OnManualCompactionProgress(
+      DB* /*db*/, const ManualCompactionProgressInfo& /*info*/) {}
+
   // A callback function for RocksDB which will be called whenever
   // a SST file is created.  Different from OnCompactionCompleted and
   // OnFlushCompleted, this callback is designed for external logging
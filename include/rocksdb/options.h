@@ -574,6 +574,21 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // The number of threads replaying the WALs during DB::Open(). When larger
+  // than 1, WAL records are read and checksummed by a thread of their own
+  // ahead of the replay. If allow_concurrent_memtable_write is also set, and
+  // 2PC is not used, the write batches read are then inserted into the
+  // memtables by up to this many threads at a time, the opening one and
+  // threads of the LOW priority thread pool, in groups of a few MB.
+  // Memtables filling up during the replay are flushed between groups.
+  // Since the batches of a group are inserted before the failure of one of
+  // them is known, the batches are only inserted concurrently when
+  // wal_recovery_mode is kAbsoluteConsistency or
+  // kTolerateCorruptedTailRecords, or paranoid_checks is false.
+  //
+  // Default: 1
+  int max_wal_recovery_threads = 1;
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -700,6 +715,22 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint32_t max_subcompactions = 1;
 
+  // If positive, each compaction (or subcompaction) reads and decompresses
+  // up to this many of its inputs ahead of merging them, in jobs scheduled in
+  // the LOW priority thread pool: one per input file of L0 and one per other
+  // input level. This lets a large compaction that cannot be split into
+  // subcompactions, typically from L0 to L1, keep several cores busy when the
+  // pool has idle threads (see Env::SetBackgroundThreads()). Other inputs,
+  // and the ones whose jobs do not get a thread in time, are read by the
+  // compaction thread itself. Set CompressionOptions::parallel_threads to
+  // also compress the output blocks on other threads.
+  //
+  // The reads done by these jobs count towards the I/O stats and perf
+  // context of the compaction thread.
+  //
+  // Default: 0
+  int max_compaction_input_threads = 0;
+
   // DEPRECATED: RocksDB automatically decides this based on the
   // value of max_background_jobs. For backwards compatibility we will set
   // `max_background_jobs = max_background_compactions + max_background_flushes`
@@ -750,12 +781,33 @@ struct DBOptions {
   // Default: 0
   size_t recycle_log_file_num = 0;
 
+  // If true, a new WAL file is filled with zeros, up to the space that
+  // would otherwise be preallocated for it (a bit more than
+  // write_buffer_size), and synced before it is used, and WAL files keep
+  // their size when closed instead of being truncated to their data. The
+  // records then overwrite allocated blocks without growing the file, so
+  // that WAL syncs need not update the inode, as with recycled log files.
+  // Filling a file writes it twice, so this is best combined with
+  // recycle_log_file_num, which keeps a ring of the filled files.
+  // Default: false
+  bool wal_zero_fill = false;
+
   // manifest file is rolled over on reaching this limit.
   // The older manifest file be deleted.
   // The default value is 1GB so that the manifest file can grow, but not
   // reach the limit of storage capacity.
   uint64_t max_manifest_file_size = 1024 * 1024 * 1024;
 
+  // If positive, the manifest file is rolled over once it is larger than
+  // both max_manifest_file_size and the snapshot of the full state (all the
+  // table and blob files, and the tracked WALs) written at its start, plus
+  // this percentage of the snapshot size. max_manifest_file_size can then be
+  // lowered, say to a few MB, to bound the edits that DB::Open() and
+  // secondary instances replay after the snapshot, without rolling over
+  // too often when a large number of files makes the snapshot itself large.
+  // Default: 0 (roll over on max_manifest_file_size only)
+  int max_manifest_space_amp_pct = 0;
+
   // Number of shards used for table cache.
   int table_cache_numshardbits = 6;
 
@@ -812,6 +864,15 @@ struct DBOptions {
   // Not supported in ROCKSDB_LITE mode!
   bool use_direct_io_for_flush_and_compaction = false;
 
+  // Use O_DIRECT for writes to WAL files. The WAL is written in whole pages
+  // of the logical block size, the last one padded with zeros and written
+  // again with the next records, and WAL syncs still sync the file, to
+  // persist its size and the device write cache. Best combined with
+  // wal_zero_fill, so that the sync only has data to flush.
+  // Default: false
+  // Not supported in ROCKSDB_LITE mode!
+  bool use_direct_io_for_wal = false;
+
   // If false, fallocate() calls are bypassed, which disables file
   // preallocation. The file space preallocation is used to increase the file
   // write/append performance. By default, RocksDB preallocates space for WAL,
@@ -1027,6 +1088,18 @@ struct DBOptions {
   // Default: false
   bool strict_bytes_per_sync = false;
 
+  // If non-zero, a background job in the flush thread pool syncs the WAL (as
+  // SyncWAL() does) whenever writes with WriteOptions::sync=false have
+  // appended this many bytes to it since the last sync, so that an occasional
+  // sync=true write or SyncWAL() call does not have to wait for an unbounded
+  // amount of dirty data. Combine with wal_bytes_per_sync to have the data
+  // written back gradually in between. DB::GetLatestDurableSequenceNumber()
+  // reports what is durable so far. Not supported together with
+  // allow_mmap_writes.
+  //
+  // Default: 0, turned off
+  uint64_t max_unsynced_wal_bytes = 0;
+
   // A vector of EventListeners whose callback functions will be called
   // when specific RocksDB event happens.
   std::vector<std::shared_ptr<EventListener>> listeners;
@@ -1055,6 +1128,24 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint64_t delayed_write_rate = 0;
 
+  // If true, writes are delayed at a rate that follows the write stall
+  // pressure of the column families continuously, instead of being slowed
+  // down and sped up by fixed ratios whenever the stall conditions are
+  // recalculated. The pressure of a column family goes from 0 at the
+  // slowdown thresholds (level0_slowdown_writes_trigger,
+  // soft_pending_compaction_bytes_limit) to 1 at the stop thresholds, and
+  // for the unflushed memtables, from min_write_buffer_number_to_merge to
+  // max_write_buffer_number when max_write_buffer_number is more than 3.
+  // It is raised by how much it rose over the last second, interpolated
+  // from its previous recalculation. The delayed write rate then goes
+  // from delayed_write_rate at pressure 0 down to 16KB/s at pressure 1, on a
+  // log scale, and writes are paced at the lowest rate of all the column
+  // families. The pressure of each column family is reported by the
+  // "rocksdb.write-stall-pressure" property.
+  //
+  // Default: false
+  bool smooth_write_stalls = false;
+
   // By default, a single write thread queue is maintained. The thread gets
   // to the head of the queue becomes write batch group leader and responsible
   // for writing to WAL and memtable for the batch group.
@@ -1250,6 +1341,17 @@ struct DBOptions {
   // file.
   bool manual_wal_flush = false;
 
+  // If not kNoCompression, the records of new WAL files are compressed with
+  // this compression type, as a single stream per file: each record is
+  // compressed against the records before it in the file, and flushed so
+  // that it can be recovered on its own. Only kZSTD is supported, and only
+  // with ZSTD 1.4.0 or later; other types are ignored. WAL files written
+  // with compression cannot be read by older versions.
+  //
+  // Default: kNoCompression
+  // Immutable.
+  CompressionType wal_compression = kNoCompression;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1635,6 +1737,19 @@ struct ReadOptions {
   // Default: false
   bool adaptive_readahead;
 
+  // If true, iterators only return keys; value() returns an empty slice.
+  // This only filters what the DB iterator does with the entries it gets
+  // from the memtables and table files, which are read, decompressed and
+  // iterated as usual: merge operands are not merged and blob values are not
+  // fetched, and a key whose entries are all merge operands is returned as
+  // long as it exists. With BlockBasedTableOptions::
+  // separate_values_in_data_blocks, the data block iterators locate the
+  // values without reading them, so the values of such blocks are then
+  // decompressed but not otherwise touched. Ignored by Get() and MultiGet().
+  //
+  // Default: false
+  bool keys_only;
+
   ReadOptions();
   ReadOptions(bool cksum, bool cache);
 };
@@ -1791,6 +1906,22 @@ struct CompactRangeOptions {
   // Cancellation can be delayed waiting on automatic compactions when used
   // together with `exclusive_manual_compaction == true`.
   std::atomic<bool>* canceled = nullptr;
+  // If true, with level compaction and `exclusive_manual_compaction ==
+  // false`, the data of the range is moved down to the deepest level holding
+  // some of it by many small compactions instead of level by level. The files
+  // of the range are marked for compaction, and automatic compactions pick
+  // them one at a time, together with the files they overlap in the next
+  // level, whenever there is no compaction needed to keep the levels within
+  // their target sizes. So they run concurrently with, and yield to, the
+  // regular compactions. Progress is reported to
+  // `EventListener::OnManualCompactionProgress()`. The bottommost level is
+  // then compacted as usual.
+  //
+  // Requires automatic compactions. If they are disabled or paused, before or
+  // during the call, the rest of the range is compacted level by level. The
+  // marks of the files not picked yet are removed when the call returns,
+  // including when it is canceled or paused.
+  bool incremental = false;
 };
 
 // IngestExternalFileOptions is used by IngestExternalFile()
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -15,6 +16,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Comparator;
 class Slice;
 
 enum PartitionerResult : char {
@@ -75,6 +77,14 @@ class SstPartitioner {
     Slice smallest_user_key;
     // Largest key for compaction
     Slice largest_user_key;
+    // The user key comparator of the column family
+    const Comparator* comparator = nullptr;
+    // The largest user keys of the files in the level after output_level
+    // that overlap with the compaction, in increasing order. They stay valid
+    // as long as the partitioner.
+    std::vector<Slice> next_level_boundaries;
+    // The size the output files of the compaction are cut at, 0 if unknown
+    uint64_t target_output_file_size = 0;
   };
 };
 
@@ -139,4 +149,65 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 extern std::shared_ptr<SstPartitionerFactory>
 NewSstPartitionerFixedPrefixFactory(size_t prefix_len);
 
+/*
+ * Next level boundary partitioner. It splits the output SST files where
+ * files of the level after the output level end, so that output files
+ * overlap as few of those files as possible and their later compactions
+ * rewrite less data. A boundary is skipped while the current output file is
+ * smaller than `min_file_size`, which keeps files from getting too small.
+ * A `min_file_size` of 0 stands for a quarter of the target output file size
+ * of the compaction. The usual cuts by target file size and
+ * max_compaction_bytes still apply.
+ */
+class SstPartitionerNextLevelBoundary : public SstPartitioner {
+ public:
+  SstPartitionerNextLevelBoundary(const SstPartitioner::Context& context,
+                                  uint64_t min_file_size);
+
+  ~SstPartitionerNextLevelBoundary() override {}
+
+  const char* Name() const override {
+    return "SstPartitionerNextLevelBoundary";
+  }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+ private:
+  const Comparator* comparator_;
+  std::vector<Slice> boundaries_;
+  // The first boundary not before the keys seen so far
+  size_t next_boundary_ = 0;
+  uint64_t min_file_size_;
+};
+
+/*
+ * Factory for next level boundary partitioner.
+ */
+class SstPartitionerNextLevelBoundaryFactory : public SstPartitionerFactory {
+ public:
+  explicit SstPartitionerNextLevelBoundaryFactory(uint64_t min_file_size = 0);
+
+  ~SstPartitionerNextLevelBoundaryFactory() override {}
+
+  static const char* kClassName() {
+    return "SstPartitionerNextLevelBoundaryFactory";
+  }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+ private:
+  uint64_t min_file_size_;
+};
+
+// The default `min_file_size` of 0 cuts output files no smaller than a
+// quarter of the target output file size, which keeps most of them
+// reasonably large.
+extern std::shared_ptr<SstPartitionerFactory>
+NewSstPartitionerNextLevelBoundaryFactory(uint64_t min_file_size = 0);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -425,6 +425,10 @@ enum Tickers : uint32_t {
   WARM_FILE_READ_COUNT,
   COLD_FILE_READ_COUNT,
 
+  // Number of bytes written to WAL files, after compression (see
+  // DBOptions::wal_compression) and including the log record headers
+  WAL_FILE_WRITTEN_BYTES,
+
   TICKER_ENUM_MAX
 };
 
@@ -227,6 +227,26 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, each file gets an additional meta block mapping whole user keys
+  // to the data block holding them, which lets point lookups go straight to
+  // that data block without searching the index block first. False positives
+  // and keys that span several data blocks fall back to the index block.
+  //
+  // The memory taken by the loaded lookup indexes is charged to the block
+  // cache, if any; a file whose index does not fit is read without it. Costs
+  // about 4-5 bytes per key in the file. Ignored when user-defined timestamps
+  // are enabled or the comparator can treat different bytes as equal keys.
+  bool data_block_lookup_index = false;
+
+  // If true, data blocks store all their values together at the start of the
+  // block, ahead of the (still prefix-compressed) keys. Scans that only need
+  // keys, like iterators with ReadOptions::keys_only, then walk a dense run
+  // of keys without touching the values. Costs a couple of bytes per entry.
+  //
+  // Data blocks are still compressed as a whole. Files written with this
+  // option cannot be read by older versions of RocksDB.
+  bool separate_values_in_data_blocks = false;
+
   // This option is now deprecated. No matter what value it is set to,
   // it will behave as if hash_index_allow_collision=true.
   bool hash_index_allow_collision = true;
@@ -499,6 +519,12 @@ struct BlockBasedTableOptions {
   // of the reads go to recently written data. This also helps in case of
   // Distributed FileSystem.
   //
+  // With kFlushAndHotCompaction, compactions also insert the data blocks they
+  // write into the block cache, but only those that cover key ranges whose
+  // input data blocks were in the block cache when the compaction started.
+  // This avoids the burst of cache misses on hot keys after a compaction
+  // rewrites them, without flooding the cache with cold data.
+  //
   // This parameter can be changed dynamically by
   // DB::SetOptions({{"block_based_table_factory",
   //                  "{prepopulate_block_cache=kFlushOnly;}"}}));
@@ -507,6 +533,9 @@ struct BlockBasedTableOptions {
     kDisable,
     // Prepopulate blocks during flush only.
     kFlushOnly,
+    // Prepopulate blocks during flush, and data blocks of hot key ranges
+    // during compaction.
+    kFlushAndHotCompaction,
   };
 
   PrepopulateBlockCache prepopulate_block_cache =
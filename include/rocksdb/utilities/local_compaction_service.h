@@ -0,0 +1,110 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// A CompactionService that runs the compactions of a DB in worker processes
+// on the same host, so that compaction CPU usage does not disturb the
+// foreground work of the DB process. The DB process sends each compaction
+// job over a Unix domain socket to a LocalCompactionWorker, which usually
+// runs in the `compaction_worker` executable (tools/compaction_worker.cc).
+// The worker runs the job with DB::OpenAndCompact(), writing the output
+// files to a subdirectory of the DB directory, from where the DB installs
+// them.
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct LocalCompactionServiceOptions {
+  // The Unix domain socket that the LocalCompactionWorker listens on.
+  // Required.
+  std::string socket_path;
+
+  // If the worker cannot be reached, or goes away while running a job, run
+  // the compaction in the DB process instead of failing it.
+  // Default: true
+  bool fallback_to_local = true;
+
+  // Used to clean up the output directories of the jobs.
+  Env* env = Env::Default();
+};
+
+class LocalCompactionService : public CompactionService {
+ public:
+  static const char* kClassName() { return "LocalCompactionService"; }
+  const char* Name() const override { return kClassName(); }
+
+  // Cancels the jobs currently running on the worker, which kills their
+  // processes. Their compactions stop like a paused manual compaction,
+  // without setting a background error, and the DB picks them again later.
+  // Jobs started afterwards are not affected.
+  virtual void CancelAllJobs() = 0;
+
+  // Returns the number of jobs currently running on the worker.
+  virtual size_t GetNumRunningJobs() = 0;
+};
+
+// Creates a LocalCompactionService to be set as DBOptions::compaction_service
+extern Status NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options,
+    std::shared_ptr<LocalCompactionService>* service);
+
+struct LocalCompactionWorkerOptions {
+  // The Unix domain socket to listen on. Any file at this path is replaced.
+  // Required.
+  std::string socket_path;
+
+  // Maximum number of jobs to run at a time. Further jobs wait for a slot.
+  // Default: 1
+  int max_jobs = 1;
+
+  // Run each job in a process of its own, forked from the worker. A
+  // cancelled job has its process killed. Otherwise jobs run on threads of
+  // the worker, and a cancelled job runs to completion with its result
+  // discarded. Only a single-threaded process may fork jobs.
+  // Default: true
+  bool fork_jobs = true;
+
+  // If not empty, a cgroup (v2) directory, such as
+  // "/sys/fs/cgroup/rocksdb-compaction", that the job processes are moved
+  // to. Limits set on the cgroup, e.g. in its cpu.max file, then apply to
+  // all jobs together. Without `fork_jobs`, the whole worker process is
+  // moved instead.
+  std::string cgroup_path;
+
+  // Options for DB::OpenAndCompact(). Pointer options that can be restored
+  // from the options the DB sends with each job are taken from there:
+  // built-in table factories, comparators, merge operators and prefix
+  // extractors, and objects registered with ObjectRegistry::Default(). The
+  // fields of `options_override` are used for the others.
+  CompactionServiceOptionsOverride options_override;
+};
+
+// Serves compaction jobs sent by LocalCompactionService.
+class LocalCompactionWorker {
+ public:
+  static Status Create(const LocalCompactionWorkerOptions& options,
+                       std::unique_ptr<LocalCompactionWorker>* worker);
+
+  virtual ~LocalCompactionWorker() {}
+
+  // Listens on the socket and serves compaction jobs until Shutdown() is
+  // called. Returns an error if the socket cannot be set up.
+  virtual Status Run() = 0;
+
+  // Makes Run() return once running jobs have been killed (with
+  // `fork_jobs`) or have finished. Safe to call from a signal handler.
+  virtual void Shutdown() = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // !ROCKSDB_LITE
@@ -436,6 +436,10 @@ class StackableDB : public DB {
     return db_->GetLatestSequenceNumber();
   }
 
+  virtual SequenceNumber GetLatestDurableSequenceNumber() const override {
+    return db_->GetLatestDurableSequenceNumber();
+  }
+
   Status IncreaseFullHistoryTsLow(ColumnFamilyHandle* column_family,
                                   std::string ts_low) override {
     return db_->IncreaseFullHistoryTsLow(column_family, ts_low);
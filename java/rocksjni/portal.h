@@ -4539,6 +4539,8 @@ class CompressionTypeJni {
         return 0x6;
       case ROCKSDB_NAMESPACE::CompressionType::kZSTD:
         return 0x7;
+      case ROCKSDB_NAMESPACE::CompressionType::kFSSTCompression:
+        return 0x8;
       case ROCKSDB_NAMESPACE::CompressionType::kDisableCompressionOption:
       default:
         return 0x7F;
@@ -4566,6 +4568,8 @@ class CompressionTypeJni {
         return ROCKSDB_NAMESPACE::CompressionType::kXpressCompression;
       case 0x7:
         return ROCKSDB_NAMESPACE::CompressionType::kZSTD;
+      case 0x8:
+        return ROCKSDB_NAMESPACE::CompressionType::kFSSTCompression;
       case 0x7F:
       default:
         return ROCKSDB_NAMESPACE::CompressionType::kDisableCompressionOption;
@@ -4589,6 +4593,8 @@ class CompactionPriorityJni {
         return 0x2;
       case ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio:
         return 0x3;
+      case ROCKSDB_NAMESPACE::CompactionPri::kMaxDeletionReclaimRatio:
+        return 0x4;
       default:
         return 0x0;  // undefined
     }
@@ -4607,6 +4613,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kOldestSmallestSeqFirst;
       case 0x3:
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::CompactionPri::kMaxDeletionReclaimRatio;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -5045,6 +5053,8 @@ class TickerTypeJni {
         return -0x28;
       case ROCKSDB_NAMESPACE::Tickers::COLD_FILE_READ_COUNT:
         return -0x29;
+      case ROCKSDB_NAMESPACE::Tickers::WAL_FILE_WRITTEN_BYTES:
+        return -0x2A;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5406,6 +5416,8 @@ class TickerTypeJni {
         return ROCKSDB_NAMESPACE::Tickers::WARM_FILE_READ_COUNT;
       case -0x29:
         return ROCKSDB_NAMESPACE::Tickers::COLD_FILE_READ_COUNT;
+      case -0x2A:
+        return ROCKSDB_NAMESPACE::Tickers::WAL_FILE_WRITTEN_BYTES;
       case 0x5F:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -33,7 +33,15 @@ public enum CompactionPriority {
    * and its size is the smallest. It in many cases can optimize write
    * amplification.
    */
-  MinOverlappingRatio((byte)0x3);
+  MinOverlappingRatio((byte)0x3),
+
+  /**
+   * First compact files whose compaction is expected to free the most space
+   * per byte rewritten, counting their point tombstones and the lower-level
+   * files covered by their range tombstones. Try this if you delete large
+   * parts of the key space.
+   */
+  MaxDeletionReclaimRatio((byte)0x4);
 
 
   private final byte value;
@@ -796,6 +796,12 @@ public enum TickerType {
     WARM_FILE_READ_COUNT((byte) -0x28),
     COLD_FILE_READ_COUNT((byte) -0x29),
 
+    /**
+     * Number of bytes written to WAL files, after compression and including
+     * the log record headers.
+     */
+    WAL_FILE_WRITTEN_BYTES((byte) -0x2A),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
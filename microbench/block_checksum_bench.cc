@@ -0,0 +1,75 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// A micro-benchmark of block checksum computation, as done for every block
+// read by MultiGet, compaction and VerifyChecksum.
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "table/block_based/block_based_table_reader.h"
+#include "table/format.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// benchmark arguments:
+// 0. checksum type
+// 1. block size
+// 2. number of blocks
+static void CustomArguments(benchmark::internal::Benchmark* b) {
+  for (int checksum_type : {kCRC32c, kxxHash, kxxHash64, kXXH3}) {
+    for (int64_t block_size : {256, 4 << 10, 16 << 10}) {
+      b->Args({checksum_type, block_size, 32});
+    }
+  }
+}
+
+struct Blocks {
+  explicit Blocks(const benchmark::State& state)
+      : type(static_cast<ChecksumType>(state.range(0))),
+        sizes(static_cast<size_t>(state.range(2))),
+        data(sizes.size()),
+        checksums(sizes.size()) {
+    Random rnd(301);
+    const size_t block_size = static_cast<size_t>(state.range(1));
+    buf = rnd.RandomBinaryString(static_cast<int>(
+        (block_size + BlockBasedTable::kBlockTrailerSize) * sizes.size()));
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      // Blocks are stored back to back, each followed by its trailer
+      data[i] = buf.data() +
+                (block_size + BlockBasedTable::kBlockTrailerSize) * i;
+      // Include the compression type byte
+      sizes[i] = block_size + 1;
+    }
+  }
+
+  int64_t TotalBytes() const {
+    return static_cast<int64_t>(sizes.size() * sizes[0]);
+  }
+
+  ChecksumType type;
+  std::string buf;
+  std::vector<size_t> sizes;
+  std::vector<const char*> data;
+  std::vector<uint32_t> checksums;
+};
+
+static void ChecksumBlocks(benchmark::State& state) {
+  Blocks blocks(state);
+  for (auto _ : state) {
+    for (size_t i = 0; i < blocks.sizes.size(); ++i) {
+      blocks.checksums[i] = ComputeBuiltinChecksum(
+          blocks.type, blocks.data[i], blocks.sizes[i]);
+    }
+    benchmark::DoNotOptimize(blocks.checksums.data());
+  }
+  state.SetBytesProcessed(state.iterations() * blocks.TotalBytes());
+}
+BENCHMARK(ChecksumBlocks)->Apply(CustomArguments);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
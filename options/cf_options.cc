@@ -186,6 +186,22 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionTypeFlags::kMutable}},
 };
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    hybrid_compaction_options_type_info = {
+        {"leveled_levels",
+         {offsetof(struct CompactionOptionsHybrid, leveled_levels),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"size_ratio",
+         {offsetof(struct CompactionOptionsHybrid, size_ratio),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"min_write_rate_for_tiering",
+         {offsetof(struct CompactionOptionsHybrid, min_write_rate_for_tiering),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
 static std::unordered_map<std::string, OptionTypeInfo>
     universal_compaction_options_type_info = {
         {"size_ratio",
@@ -247,6 +263,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, paranoid_file_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"max_flush_partitions",
+         {offsetof(struct MutableCFOptions, max_flush_partitions),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"flush_to_deepest_level",
+         {offsetof(struct MutableCFOptions, flush_to_deepest_level),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"verify_checksums_in_compaction",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -442,6 +466,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, blob_compaction_readahead_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_garbage_collection_batch_size",
+         {offsetof(struct MutableCFOptions, blob_garbage_collection_batch_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"sample_for_compression",
          {offsetof(struct MutableCFOptions, sample_for_compression),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -720,6 +748,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ImmutableCFOptions::compaction_pri),
           OptionType::kCompactionPri, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"compaction_options_hybrid",
+         OptionTypeInfo::Struct(
+             "compaction_options_hybrid", &hybrid_compaction_options_type_info,
+             offset_of(&ImmutableCFOptions::compaction_options_hybrid),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone)},
         {"sst_partitioner_factory",
          OptionTypeInfo::AsCustomSharedPtr<SstPartitionerFactory>(
              offset_of(&ImmutableCFOptions::sst_partitioner_factory),
@@ -835,6 +868,7 @@ ImmutableCFOptions::ImmutableCFOptions() : ImmutableCFOptions(Options()) {}
 ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
     : compaction_style(cf_options.compaction_style),
       compaction_pri(cf_options.compaction_pri),
+      compaction_options_hybrid(cf_options.compaction_options_hybrid),
       user_comparator(cf_options.comparator),
       internal_comparator(InternalKeyComparator(cf_options.comparator)),
       merge_operator(cf_options.merge_operator),
@@ -1018,6 +1052,10 @@ void MutableCFOptions::Dump(Logger* log) const {
                  check_flush_compaction_key_order);
   ROCKS_LOG_INFO(log, "                     paranoid_file_checks: %d",
                  paranoid_file_checks);
+  ROCKS_LOG_INFO(log, "                     max_flush_partitions: %" PRIu32,
+                 max_flush_partitions);
+  ROCKS_LOG_INFO(log, "                   flush_to_deepest_level: %d",
+                 flush_to_deepest_level);
   ROCKS_LOG_INFO(log, "                       report_bg_io_stats: %d",
                  report_bg_io_stats);
   ROCKS_LOG_INFO(log, "                              compression: %d",
@@ -1067,6 +1105,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  blob_garbage_collection_force_threshold);
   ROCKS_LOG_INFO(log, "           blob_compaction_readahead_size: %" PRIu64,
                  blob_compaction_readahead_size);
+  ROCKS_LOG_INFO(log, "       blob_garbage_collection_batch_size: %" PRIu64,
+                 blob_garbage_collection_batch_size);
 }
 
 MutableCFOptions::MutableCFOptions(const Options& options)
@@ -29,6 +29,8 @@ struct ImmutableCFOptions {
 
   CompactionPri compaction_pri;
 
+  CompactionOptionsHybrid compaction_options_hybrid;
+
   const Comparator* user_comparator;
   InternalKeyComparator internal_comparator;  // Only in Immutable
 
@@ -145,11 +147,15 @@ struct MutableCFOptions {
         blob_garbage_collection_force_threshold(
             options.blob_garbage_collection_force_threshold),
         blob_compaction_readahead_size(options.blob_compaction_readahead_size),
+        blob_garbage_collection_batch_size(
+            options.blob_garbage_collection_batch_size),
         max_sequential_skip_in_iterations(
             options.max_sequential_skip_in_iterations),
         check_flush_compaction_key_order(
             options.check_flush_compaction_key_order),
         paranoid_file_checks(options.paranoid_file_checks),
+        max_flush_partitions(options.max_flush_partitions),
+        flush_to_deepest_level(options.flush_to_deepest_level),
         report_bg_io_stats(options.report_bg_io_stats),
         compression(options.compression),
         bottommost_compression(options.bottommost_compression),
@@ -194,9 +200,12 @@ struct MutableCFOptions {
         blob_garbage_collection_age_cutoff(0.0),
         blob_garbage_collection_force_threshold(0.0),
         blob_compaction_readahead_size(0),
+        blob_garbage_collection_batch_size(0),
         max_sequential_skip_in_iterations(0),
         check_flush_compaction_key_order(true),
         paranoid_file_checks(false),
+        max_flush_partitions(1),
+        flush_to_deepest_level(false),
         report_bg_io_stats(false),
         compression(Snappy_Supported() ? kSnappyCompression : kNoCompression),
         bottommost_compression(kDisableCompressionOption),
@@ -261,11 +270,14 @@ struct MutableCFOptions {
   double blob_garbage_collection_age_cutoff;
   double blob_garbage_collection_force_threshold;
   uint64_t blob_compaction_readahead_size;
+  uint64_t blob_garbage_collection_batch_size;
 
   // Misc options
   uint64_t max_sequential_skip_in_iterations;
   bool check_flush_compaction_key_order;
   bool paranoid_file_checks;
+  uint32_t max_flush_partitions;
+  bool flush_to_deepest_level;
   bool report_bg_io_stats;
   CompressionType compression;
   CompressionType bottommost_compression;
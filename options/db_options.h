@@ -32,6 +32,8 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  int max_compaction_input_threads;
+  int max_wal_recovery_threads;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -44,7 +46,9 @@ struct ImmutableDBOptions {
   size_t log_file_time_to_roll;
   size_t keep_log_file_num;
   size_t recycle_log_file_num;
+  bool wal_zero_fill;
   uint64_t max_manifest_file_size;
+  int max_manifest_space_amp_pct;
   int table_cache_numshardbits;
   uint64_t WAL_ttl_seconds;
   uint64_t WAL_size_limit_MB;
@@ -54,6 +58,8 @@ struct ImmutableDBOptions {
   bool allow_mmap_writes;
   bool use_direct_reads;
   bool use_direct_io_for_flush_and_compaction;
+  bool use_direct_io_for_wal;
+  uint64_t max_unsynced_wal_bytes;
   bool allow_fallocate;
   bool is_fd_close_on_exec;
   bool advise_random_on_open;
@@ -66,6 +72,7 @@ struct ImmutableDBOptions {
   bool use_adaptive_mutex;
   std::vector<std::shared_ptr<EventListener>> listeners;
   bool enable_thread_tracking;
+  bool smooth_write_stalls;
   bool enable_pipelined_write;
   bool unordered_write;
   bool enable_multi_batch_write;
@@ -87,6 +94,7 @@ struct ImmutableDBOptions {
   bool allow_ingest_behind;
   bool two_write_queues;
   bool manual_wal_flush;
+  CompressionType wal_compression;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
   bool persist_stats_to_disk;
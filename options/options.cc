@@ -78,6 +78,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       compaction_pri(options.compaction_pri),
       compaction_options_universal(options.compaction_options_universal),
       compaction_options_fifo(options.compaction_options_fifo),
+      compaction_options_hybrid(options.compaction_options_hybrid),
       max_sequential_skip_in_iterations(
           options.max_sequential_skip_in_iterations),
       memtable_factory(options.memtable_factory),
@@ -86,6 +87,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       max_successive_merges(options.max_successive_merges),
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       paranoid_file_checks(options.paranoid_file_checks),
+      max_flush_partitions(options.max_flush_partitions),
+      flush_to_deepest_level(options.flush_to_deepest_level),
       force_consistency_checks(options.force_consistency_checks),
       report_bg_io_stats(options.report_bg_io_stats),
       ttl(options.ttl),
@@ -100,7 +103,9 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
           options.blob_garbage_collection_age_cutoff),
       blob_garbage_collection_force_threshold(
           options.blob_garbage_collection_force_threshold),
-      blob_compaction_readahead_size(options.blob_compaction_readahead_size) {
+      blob_compaction_readahead_size(options.blob_compaction_readahead_size),
+      blob_garbage_collection_batch_size(
+          options.blob_garbage_collection_batch_size) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -346,6 +351,15 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "Options.compaction_options_fifo.allow_compaction: %d",
                      compaction_options_fifo.allow_compaction);
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_hybrid.leveled_levels: %d",
+                     compaction_options_hybrid.leveled_levels);
+    ROCKS_LOG_HEADER(log, "Options.compaction_options_hybrid.size_ratio: %u",
+                     compaction_options_hybrid.size_ratio);
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_hybrid."
+                     "min_write_rate_for_tiering: %" PRIu64,
+                     compaction_options_hybrid.min_write_rate_for_tiering);
     std::ostringstream collector_info;
     for (const auto& collector_factory : table_properties_collector_factories) {
       collector_info << collector_factory->ToString() << ';';
@@ -383,6 +397,11 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      optimize_filters_for_hits);
     ROCKS_LOG_HEADER(log, "               Options.paranoid_file_checks: %d",
                      paranoid_file_checks);
+    ROCKS_LOG_HEADER(log,
+                     "               Options.max_flush_partitions: %" PRIu32,
+                     max_flush_partitions);
+    ROCKS_LOG_HEADER(log, "               Options.flush_to_deepest_level: %d",
+                     flush_to_deepest_level);
     ROCKS_LOG_HEADER(log, "               Options.force_consistency_checks: %d",
                      force_consistency_checks);
     ROCKS_LOG_HEADER(log, "               Options.report_bg_io_stats: %d",
@@ -411,6 +430,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "         Options.blob_compaction_readahead_size: %" PRIu64,
         blob_compaction_readahead_size);
+    ROCKS_LOG_HEADER(
+        log, "     Options.blob_garbage_collection_batch_size: %" PRIu64,
+        blob_garbage_collection_batch_size);
 }  // ColumnFamilyOptions::Dump
 
 void Options::Dump(Logger* log) const {
@@ -669,7 +691,8 @@ ReadOptions::ReadOptions()
       deadline(std::chrono::microseconds::zero()),
       io_timeout(std::chrono::microseconds::zero()),
       value_size_soft_limit(std::numeric_limits<uint64_t>::max()),
-      adaptive_readahead(false) {}
+      adaptive_readahead(false),
+      keys_only(false) {}
 
 ReadOptions::ReadOptions(bool cksum, bool cache)
     : snapshot(nullptr),
@@ -693,6 +716,7 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       deadline(std::chrono::microseconds::zero()),
       io_timeout(std::chrono::microseconds::zero()),
       value_size_soft_limit(std::numeric_limits<uint64_t>::max()),
-      adaptive_readahead(false) {}
+      adaptive_readahead(false),
+      keys_only(false) {}
 
 }  // namespace ROCKSDB_NAMESPACE
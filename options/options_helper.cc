@@ -79,6 +79,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.max_compaction_input_threads =
+      immutable_db_options.max_compaction_input_threads;
+  options.max_wal_recovery_threads =
+      immutable_db_options.max_wal_recovery_threads;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
   options.use_fsync = immutable_db_options.use_fsync;
@@ -101,7 +105,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
   options.recycle_log_file_num = immutable_db_options.recycle_log_file_num;
+  options.wal_zero_fill = immutable_db_options.wal_zero_fill;
   options.max_manifest_file_size = immutable_db_options.max_manifest_file_size;
+  options.max_manifest_space_amp_pct =
+      immutable_db_options.max_manifest_space_amp_pct;
   options.table_cache_numshardbits =
       immutable_db_options.table_cache_numshardbits;
   options.WAL_ttl_seconds = immutable_db_options.WAL_ttl_seconds;
@@ -113,6 +120,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.use_direct_reads = immutable_db_options.use_direct_reads;
   options.use_direct_io_for_flush_and_compaction =
       immutable_db_options.use_direct_io_for_flush_and_compaction;
+  options.use_direct_io_for_wal = immutable_db_options.use_direct_io_for_wal;
+  options.max_unsynced_wal_bytes = immutable_db_options.max_unsynced_wal_bytes;
   options.allow_fallocate = immutable_db_options.allow_fallocate;
   options.is_fd_close_on_exec = immutable_db_options.is_fd_close_on_exec;
   options.stats_dump_period_sec = mutable_db_options.stats_dump_period_sec;
@@ -137,6 +146,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.use_adaptive_mutex = immutable_db_options.use_adaptive_mutex;
   options.listeners = immutable_db_options.listeners;
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
+  options.smooth_write_stalls = immutable_db_options.smooth_write_stalls;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
   options.enable_multi_batch_write =
@@ -172,6 +182,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.allow_ingest_behind = immutable_db_options.allow_ingest_behind;
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
+  options.wal_compression = immutable_db_options.wal_compression;
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
@@ -257,6 +268,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_garbage_collection_force_threshold;
   cf_opts->blob_compaction_readahead_size =
       moptions.blob_compaction_readahead_size;
+  cf_opts->blob_garbage_collection_batch_size =
+      moptions.blob_garbage_collection_batch_size;
 
   // Misc options
   cf_opts->max_sequential_skip_in_iterations =
@@ -264,6 +277,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   cf_opts->check_flush_compaction_key_order =
       moptions.check_flush_compaction_key_order;
   cf_opts->paranoid_file_checks = moptions.paranoid_file_checks;
+  cf_opts->max_flush_partitions = moptions.max_flush_partitions;
+  cf_opts->flush_to_deepest_level = moptions.flush_to_deepest_level;
   cf_opts->report_bg_io_stats = moptions.report_bg_io_stats;
   cf_opts->compression = moptions.compression;
   cf_opts->compression_opts = moptions.compression_opts;
@@ -276,6 +291,7 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
                                ColumnFamilyOptions* cf_opts) {
   cf_opts->compaction_style = ioptions.compaction_style;
   cf_opts->compaction_pri = ioptions.compaction_pri;
+  cf_opts->compaction_options_hybrid = ioptions.compaction_options_hybrid;
   cf_opts->comparator = ioptions.user_comparator;
   cf_opts->merge_operator = ioptions.merge_operator;
   cf_opts->compaction_filter = ioptions.compaction_filter;
@@ -322,7 +338,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
-    {kMinOverlappingRatio, "kMinOverlappingRatio"}};
+    {kMinOverlappingRatio, "kMinOverlappingRatio"},
+    {kMaxDeletionReclaimRatio, "kMaxDeletionReclaimRatio"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -347,6 +364,7 @@ std::unordered_map<std::string, CompressionType>
         {"kXpressCompression", kXpressCompression},
         {"kZSTD", kZSTD},
         {"kZSTDNotFinalCompression", kZSTDNotFinalCompression},
+        {"kFSSTCompression", kFSSTCompression},
         {"kDisableCompressionOption", kDisableCompressionOption}};
 
 std::vector<CompressionType> GetSupportedCompressions() {
@@ -823,7 +841,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kByCompensatedSize", kByCompensatedSize},
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
-        {"kMinOverlappingRatio", kMinOverlappingRatio}};
+        {"kMinOverlappingRatio", kMinOverlappingRatio},
+        {"kMaxDeletionReclaimRatio", kMaxDeletionReclaimRatio}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
@@ -2019,6 +2019,23 @@ TEST_F(OptionsTest, SstPartitionerTest) {
   ASSERT_OK(RocksDBOptionsParser::VerifyCFOptions(cfg_opts, cf_opts, new_opt));
   ASSERT_TRUE(cf_opts.sst_partitioner_factory->AreEquivalent(
       cfg_opts, new_opt.sst_partitioner_factory.get(), &mismatch));
+
+  ASSERT_OK(GetColumnFamilyOptionsFromString(
+      cfg_opts, ColumnFamilyOptions(),
+      std::string("sst_partitioner_factory={id=") +
+          SstPartitionerNextLevelBoundaryFactory::kClassName() +
+          "; min_file_size=1048576;}",
+      &cf_opts));
+  ASSERT_NE(cf_opts.sst_partitioner_factory, nullptr);
+  ASSERT_STREQ(cf_opts.sst_partitioner_factory->Name(),
+               SstPartitionerNextLevelBoundaryFactory::kClassName());
+  ASSERT_OK(GetStringFromColumnFamilyOptions(cfg_opts, cf_opts, &opts_str));
+  ASSERT_OK(
+      GetColumnFamilyOptionsFromString(cfg_opts, cf_opts, opts_str, &new_opt));
+  ASSERT_STREQ(new_opt.sst_partitioner_factory->Name(),
+               SstPartitionerNextLevelBoundaryFactory::kClassName());
+  ASSERT_TRUE(cf_opts.sst_partitioner_factory->AreEquivalent(
+      cfg_opts, new_opt.sst_partitioner_factory.get(), &mismatch));
 }
 
 TEST_F(OptionsTest, FileChecksumGenFactoryTest) {
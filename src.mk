@@ -16,6 +16,7 @@ LIB_SOURCES =                                                   \
   db/blob/blob_file_meta.cc                                     \
   db/blob/blob_file_reader.cc                                   \
   db/blob/blob_garbage_meter.cc                                 \
+  db/blob/blob_garbage_collection_batcher.cc                    \
   db/blob/blob_log_format.cc                                    \
   db/blob/blob_log_sequential_reader.cc                         \
   db/blob/blob_log_writer.cc                                    \
@@ -28,8 +29,10 @@ LIB_SOURCES =                                                   \
   db/compaction/compaction_job.cc                               \
   db/compaction/compaction_picker.cc                            \
   db/compaction/compaction_picker_fifo.cc                       \
+  db/compaction/compaction_picker_hybrid.cc                     \
   db/compaction/compaction_picker_level.cc                      \
   db/compaction/compaction_picker_universal.cc                  \
+  db/compaction/pipelined_input_iterator.cc                     \
   db/compaction/sst_partitioner.cc                              \
   db/convenience.cc                                             \
   db/db_filesnapshot.cc                                         \
@@ -58,6 +61,7 @@ LIB_SOURCES =                                                   \
   db/internal_stats.cc                                          \
   db/logs_with_prep_tracker.cc                                  \
   db/log_reader.cc                                              \
+  db/log_prefetching_reader.cc                                  \
   db/log_writer.cc                                              \
   db/malloc_stats.cc                                            \
   db/memtable.cc                                                \
@@ -166,6 +170,7 @@ LIB_SOURCES =                                                   \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
   table/block_based/data_block_hash_index.cc                    \
+  table/block_based/data_block_lookup_index.cc                  \
   table/block_based/data_block_footer.cc                        \
   table/block_based/filter_block_reader_common.cc               \
   table/block_based/filter_policy.cc                            \
@@ -186,6 +191,7 @@ LIB_SOURCES =                                                   \
   table/cuckoo/cuckoo_table_reader.cc                           \
   table/format.cc                                               \
   table/get_context.cc                                          \
+  table/hot_key_ranges.cc                                       \
   table/iterator.cc                                             \
   table/merging_iterator.cc                                     \
   table/meta_blocks.cc                                          \
@@ -218,16 +224,19 @@ LIB_SOURCES =                                                   \
   util/compaction_job_stats_impl.cc                             \
   util/comparator.cc                                            \
   util/compression_context_cache.cc                             \
+  util/compression.cc                                           \
   util/concurrent_task_limiter_impl.cc                          \
   util/crc32c.cc                                                \
   util/crc32c_arm64.cc                                          \
   util/dynamic_bloom.cc                                         \
+  util/fsst.cc                                                  \
   util/hash.cc                                                  \
   util/murmurhash.cc                                            \
   util/random.cc                                                \
   util/rate_limiter.cc                                          \
   util/ribbon_config.cc                                         \
   util/regex.cc                                                 \
+  util/run_in_thread_pool.cc                                    \
   util/slice.cc                                                 \
   util/file_checksum_helper.cc                                  \
   util/status.cc                                                \
@@ -257,6 +266,9 @@ LIB_SOURCES =                                                   \
   utilities/fault_injection_fs.cc                               \
   utilities/fault_injection_secondary_cache.cc                  \
   utilities/leveldb_options/leveldb_options.cc                  \
+  utilities/local_compaction_service/local_compaction_protocol.cc \
+  utilities/local_compaction_service/local_compaction_service.cc  \
+  utilities/local_compaction_service/local_compaction_worker.cc   \
   utilities/memory/memory_util.cc                               \
   utilities/merge_operators.cc                                  \
   utilities/merge_operators/max.cc                              \
@@ -380,6 +392,7 @@ TOOLS_MAIN_SOURCES =                                                    \
   db_stress_tool/db_stress.cc                                           \
   tools/blob_dump.cc                                                    \
   tools/block_cache_analyzer/block_cache_trace_analyzer_tool.cc         \
+  tools/compaction_worker.cc                                            \
   tools/db_repl_stress.cc                                               \
   tools/db_sanity_test.cc                                               \
   tools/ldb.cc                                                          \
@@ -424,6 +437,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/compaction/compaction_job_stats_test.cc                            \
   db/compaction/compaction_picker_test.cc                               \
   db/compaction/compaction_service_test.cc                              \
+  db/compaction/pipelined_input_iterator_test.cc                        \
   db/comparator_db_test.cc                                              \
   db/corruption_test.cc                                                 \
   db/cuckoo_table_db_test.cc                                            \
@@ -522,6 +536,7 @@ TEST_MAIN_SOURCES =                                                     \
   table/block_based/block_based_table_reader_test.cc                    \
   table/block_based/block_test.cc                                       \
   table/block_based/data_block_hash_index_test.cc                       \
+  table/block_based/data_block_lookup_index_test.cc                     \
   table/block_based/full_filter_block_test.cc                           \
   table/block_based/partitioned_filter_block_test.cc                    \
   table/cleanable_test.cc                                               \
@@ -543,11 +558,13 @@ TEST_MAIN_SOURCES =                                                     \
   util/autovector_test.cc                                               \
   util/bloom_test.cc                                                    \
   util/coding_test.cc                                                   \
+  util/concurrent_task_limiter_test.cc                                  \
   util/crc32c_test.cc                                                   \
   util/defer_test.cc                                                    \
   util/dynamic_bloom_test.cc                                            \
   util/filelock_test.cc                                                 \
   util/file_reader_writer_test.cc                                       \
+  util/fsst_test.cc                                                     \
   util/hash_test.cc                                                     \
   util/heap_test.cc                                                     \
   util/random_test.cc                                                   \
@@ -573,6 +590,7 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/merge_operators/string_append/stringappend_test.cc          \
   utilities/object_registry_test.cc                                     \
   utilities/option_change_migration/option_change_migration_test.cc     \
+  utilities/local_compaction_service/local_compaction_service_test.cc   \
   utilities/options/options_util_test.cc                                \
   utilities/persistent_cache/hash_table_test.cc                         \
   utilities/persistent_cache/persistent_cache_test.cc                   \
@@ -593,6 +611,7 @@ TEST_MAIN_SOURCES_C = \
   db/c_test.c                                                           \
 
 MICROBENCH_SOURCES =                                          \
+  microbench/block_checksum_bench.cc                          \
   microbench/ribbon_bench.cc                                  \
 
 JNI_NATIVE_SOURCES =                                          \
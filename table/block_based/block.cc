@@ -223,6 +223,11 @@ void DataBlockIter::PrevImpl() {
     // (i.e., keys in it are not actually pinned).
     raw_key_.SetKey(current_key, raw_key_cached /* copy */);
     value_ = current_prev_entry.value;
+    if (separated_values_) {
+      // Validated when the entry was first parsed
+      bool ok __attribute__((__unused__)) = DecodeSeparatedValue();
+      assert(ok);
+    }
 
     return;
   }
@@ -252,18 +257,19 @@ void DataBlockIter::PrevImpl() {
       break;
     }
     Slice current_key = raw_key_.GetKey();
+    MarkReadAmpBitmap();
 
     if (raw_key_.IsKeyPinned()) {
       // The key is not delta encoded
       prev_entries_.emplace_back(current_, current_key.data(), 0,
-                                 current_key.size(), value());
+                                 current_key.size(), value_);
     } else {
       // The key is delta encoded, cache decoded key in buffer
       size_t new_key_offset = prev_entries_keys_buff_.size();
       prev_entries_keys_buff_.append(current_key.data(), current_key.size());
 
       prev_entries_.emplace_back(current_, nullptr, new_key_offset,
-                                 current_key.size(), value());
+                                 current_key.size(), value_);
     }
     // Loop until end of current entry hits the start of original entry
   } while (NextEntryOffset() < original);
@@ -619,8 +625,45 @@ bool BlockIter<TValue>::ParseNextKey(bool* is_shared) {
   }
 }
 
+bool DataBlockIter::DecodeSeparatedValue() {
+  const char* p = value_.data();
+  const char* limit = p + value_.size();
+  uint32_t offset = 0;
+  uint32_t size = 0;
+  p = GetVarint32Ptr(p, limit, &offset);
+  if (p != nullptr) {
+    p = GetVarint32Ptr(p, limit, &size);
+  }
+  // The slot must be fully consumed, so that NextEntryOffset() is right
+  if (p != limit || offset > values_end_ || size > values_end_ - offset) {
+    return false;
+  }
+  separated_value_ = Slice(data_ + offset, size);
+  return true;
+}
+
+void DataBlockIter::MarkReadAmpBitmap() const {
+  if (read_amp_bitmap_ && current_ < restarts_ &&
+      current_ != last_bitmap_offset_) {
+    read_amp_bitmap_->Mark(current_ /* current entry offset */,
+                           NextEntryOffset() - 1);
+    if (separated_values_ && !separated_value_.empty()) {
+      uint32_t value_offset =
+          static_cast<uint32_t>(separated_value_.data() - data_);
+      read_amp_bitmap_->Mark(
+          value_offset,
+          value_offset + static_cast<uint32_t>(separated_value_.size()) - 1);
+    }
+    last_bitmap_offset_ = current_;
+  }
+}
+
 bool DataBlockIter::ParseNextDataKey(bool* is_shared) {
   if (ParseNextKey<DecodeEntry>(is_shared)) {
+    if (separated_values_ && !DecodeSeparatedValue()) {
+      CorruptionError();
+      return false;
+    }
 #ifndef NDEBUG
     if (global_seqno_ != kDisableGlobalSequenceNumber) {
       // If we are reading a file with a global sequence number we should
@@ -948,7 +991,7 @@ uint32_t Block::NumRestarts() const {
     // Such check is for backward compatibility. We can ensure legacy block
     // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
     // correctly as no HashIndex even if the MSB of num_restarts is set.
-    return num_restarts;
+    return num_restarts & ~kDataBlockSeparatedValuesFlag;
   }
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
@@ -980,13 +1023,17 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       data_(contents_.data.data()),
       size_(contents_.data.size()),
       restart_offset_(0),
-      num_restarts_(0) {
+      num_restarts_(0),
+      separated_values_(false) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    separated_values_ =
+        (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) &
+         kDataBlockSeparatedValuesFlag) != 0;
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
         restart_offset_ = static_cast<uint32_t>(size_) -
@@ -1033,7 +1080,7 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
 
 MetaBlockIter* Block::NewMetaIterator(bool block_contents_pinned) {
   MetaBlockIter* iter = new MetaBlockIter();
-  if (size_ < 2 * sizeof(uint32_t)) {
+  if (size_ < 2 * sizeof(uint32_t) || separated_values_) {
     iter->Invalidate(Status::Corruption("bad block contents"));
     return iter;
   } else if (num_restarts_ == 0) {
@@ -1068,7 +1115,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        separated_values_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1091,7 +1139,7 @@ IndexBlockIter* Block::NewIndexIterator(
   } else {
     ret_iter = new IndexBlockIter;
   }
-  if (size_ < 2 * sizeof(uint32_t)) {
+  if (size_ < 2 * sizeof(uint32_t) || separated_values_) {
     ret_iter->Invalidate(Status::Corruption("bad block contents"));
     return ret_iter;
   }
@@ -10,6 +10,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -168,6 +169,9 @@ class Block {
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
 
+  // Whether the values are stored apart from the keys. See BlockBuilder.
+  bool separated_values() const { return separated_values_; }
+
   // raw_ucmp is a raw (i.e., not wrapped by `UserComparatorWrapper`) user key
   // comparator.
   //
@@ -240,6 +244,7 @@ class Block {
   size_t size_;              // contents_.data.size()
   uint32_t restart_offset_;  // Offset in data_ of restart array
   uint32_t num_restarts_;
+  bool separated_values_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   DataBlockHashIndex data_block_hash_index_;
 };
@@ -497,34 +502,36 @@ class DataBlockIter final : public BlockIter<Slice> {
   DataBlockIter(const Comparator* raw_ucmp, const char* data, uint32_t restarts,
                 uint32_t num_restarts, SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
-                DataBlockHashIndex* data_block_hash_index)
+                DataBlockHashIndex* data_block_hash_index,
+                bool separated_values = false)
       : DataBlockIter() {
     Initialize(raw_ucmp, data, restarts, num_restarts, global_seqno,
-               read_amp_bitmap, block_contents_pinned, data_block_hash_index);
+               read_amp_bitmap, block_contents_pinned, data_block_hash_index,
+               separated_values);
   }
   void Initialize(const Comparator* raw_ucmp, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
-                  DataBlockHashIndex* data_block_hash_index) {
+                  DataBlockHashIndex* data_block_hash_index,
+                  bool separated_values = false) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned);
     raw_key_.SetIsUserKey(false);
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    separated_values_ = separated_values;
+    // The values end where the first entry starts
+    values_end_ =
+        separated_values ? std::min(GetRestartPoint(0), restarts_) : 0;
   }
 
   Slice value() const override {
     assert(Valid());
-    if (read_amp_bitmap_ && current_ < restarts_ &&
-        current_ != last_bitmap_offset_) {
-      read_amp_bitmap_->Mark(current_ /* current entry offset */,
-                             NextEntryOffset() - 1);
-      last_bitmap_offset_ = current_;
-    }
-    return value_;
+    MarkReadAmpBitmap();
+    return separated_values_ ? separated_value_ : value_;
   }
 
   inline bool SeekForGet(const Slice& target) {
@@ -561,6 +568,12 @@ class DataBlockIter final : public BlockIter<Slice> {
   BlockReadAmpBitmap* read_amp_bitmap_;
   // last `current_` value we report to read-amp bitmp
   mutable uint32_t last_bitmap_offset_;
+  // Whether the values are stored apart from the keys. value_ then holds the
+  // slot locating the value of the current entry, and separated_value_ the
+  // value itself.
+  bool separated_values_ = false;
+  uint32_t values_end_ = 0;
+  Slice separated_value_;
   struct CachedPrevEntry {
     explicit CachedPrevEntry(uint32_t _offset, const char* _key_ptr,
                              size_t _key_offset, size_t _key_size, Slice _value)
@@ -578,7 +591,8 @@ class DataBlockIter final : public BlockIter<Slice> {
     size_t key_offset;
     // size of key
     size_t key_size;
-    // value slice pointing to data in block
+    // value slice pointing to data in block (the value slot if values are
+    // separated)
     Slice value;
   };
   std::string prev_entries_keys_buff_;
@@ -588,6 +602,10 @@ class DataBlockIter final : public BlockIter<Slice> {
   DataBlockHashIndex* data_block_hash_index_;
 
   bool SeekForGetImpl(const Slice& target);
+  // Decodes the value slot in value_ into separated_value_. Returns false if
+  // the slot is malformed.
+  bool DecodeSeparatedValue();
+  void MarkReadAmpBitmap() const;
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -42,11 +42,13 @@
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
 #include "table/block_based/block_like_traits.h"
+#include "table/block_based/data_block_lookup_index.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/format.h"
+#include "table/hot_key_ranges.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
 #include "util/coding.h"
@@ -59,6 +61,7 @@ namespace ROCKSDB_NAMESPACE {
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kDataBlockLookupIndexBlock;
 
 
 // Without anonymous namespace here, we fail the warning -Wmissing-prototypes
@@ -289,6 +292,9 @@ struct BlockBasedTableBuilder::Rep {
 
   size_t data_begin_offset = 0;
 
+  // Size of the meta blocks, metaindex block and footer, known once finished
+  uint64_t tail_size = 0;
+
   TableProperties props;
 
   // States of the builder.
@@ -322,8 +328,16 @@ struct BlockBasedTableBuilder::Rep {
       compression_dict_buffer_cache_res_mgr;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  std::unique_ptr<DataBlockLookupIndexBuilder> data_block_lookup_index_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
+  // Key ranges whose data blocks are inserted into the block cache, for
+  // PrepopulateBlockCache::kFlushAndHotCompaction. nullptr otherwise.
+  const HotKeyRanges* hot_key_ranges;
+  // Only maintained when hot_key_ranges is set
+  std::string first_key_in_data_block;
+  // Whether the data block being written covers a hot key range
+  bool warm_data_block = false;
 
   BlockHandle pending_handle;  // Handle to add to index block
 
@@ -335,6 +349,14 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<ParallelCompressionRep> pc_rep;
 
   uint64_t get_offset() { return offset.load(std::memory_order_relaxed); }
+
+  // Whether the data block with the given first and last internal keys
+  // overlaps a hot key range
+  bool IsHotDataBlock(const Slice& first_ikey, const Slice& last_ikey) const {
+    return hot_key_ranges != nullptr &&
+           hot_key_ranges->Overlaps(ExtractUserKey(first_ikey),
+                                    ExtractUserKey(last_ikey));
+  }
   void set_offset(uint64_t o) { offset.store(o, std::memory_order_relaxed); }
 
   bool IsParallelCompressionEnabled() const {
@@ -416,7 +438,8 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   table_options.separate_values_in_data_blocks),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(tbo.moptions.prefix_extractor.get()),
         compression_type(tbo.compression_type),
@@ -436,6 +459,14 @@ struct BlockBasedTableBuilder::Rep {
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
                                             !table_opt.block_align),
         reason(tbo.reason),
+        hot_key_ranges(
+            table_opt.prepopulate_block_cache ==
+                        BlockBasedTableOptions::PrepopulateBlockCache::
+                            kFlushAndHotCompaction &&
+                    tbo.reason == TableFileCreationReason::kCompaction &&
+                    table_opt.block_cache != nullptr
+                ? tbo.hot_key_ranges
+                : nullptr),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
                 table_options, data_block)),
@@ -519,6 +550,9 @@ struct BlockBasedTableBuilder::Rep {
     if (ucmp->timestamp_size() > 0) {
       table_properties_collectors.emplace_back(
           new TimestampTablePropertiesCollector(ucmp));
+    } else if (table_options.data_block_lookup_index &&
+               !ucmp->CanKeysWithDifferentByteContentsBeEqual()) {
+      data_block_lookup_index_builder.reset(new DataBlockLookupIndexBuilder());
     }
     if (table_options.verify_compression) {
       for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
@@ -923,6 +957,9 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       assert(!r->data_block.empty());
       r->first_key_in_next_block = &key;
       Flush();
+      if (r->data_block_lookup_index_builder != nullptr) {
+        r->data_block_lookup_index_builder->StartNewBlock();
+      }
       if (r->state == Rep::State::kBuffered) {
         bool exceeds_buffer_limit =
             (r->buffer_limit != 0 && r->data_begin_offset > r->buffer_limit);
@@ -977,6 +1014,13 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       }
     }
 
+    if (r->data_block_lookup_index_builder != nullptr) {
+      r->data_block_lookup_index_builder->Add(ExtractUserKey(key));
+    }
+
+    if (r->hot_key_ranges != nullptr && r->data_block.empty()) {
+      r->first_key_in_data_block.assign(key.data(), key.size());
+    }
     r->data_block.AddWithLastKey(key, value, r->last_key);
     r->last_key.assign(key.data(), key.size());
     if (r->state == Rep::State::kBuffered) {
@@ -1030,6 +1074,8 @@ void BlockBasedTableBuilder::Flush() {
                                              r->get_offset());
     r->pc_rep->EmitBlock(block_rep);
   } else {
+    r->warm_data_block =
+        r->IsHotDataBlock(r->first_key_in_data_block, r->last_key);
     WriteBlock(&r->data_block, &r->pending_handle, BlockType::kData);
   }
 }
@@ -1076,6 +1122,9 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     }
     r->props.data_size = r->get_offset();
     ++r->props.num_data_blocks;
+    if (r->data_block_lookup_index_builder != nullptr) {
+      r->data_block_lookup_index_builder->AddBlockHandle(*handle);
+    }
   }
 }
 
@@ -1259,6 +1308,11 @@ void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
         case BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly:
           warm_cache = (r->reason == TableFileCreationReason::kFlush);
           break;
+        case BlockBasedTableOptions::PrepopulateBlockCache::
+            kFlushAndHotCompaction:
+          warm_cache = (r->reason == TableFileCreationReason::kFlush) ||
+                       (block_type == BlockType::kData && r->warm_data_block);
+          break;
         case BlockBasedTableOptions::PrepopulateBlockCache::kDisable:
           warm_cache = false;
           break;
@@ -1347,6 +1401,10 @@ void BlockBasedTableBuilder::BGWorkWriteRawBlock() {
       r->index_builder->OnKeyAdded(key);
     }
 
+    if (block_rep->keys->Size() > 0) {
+      r->warm_data_block = r->IsHotDataBlock((*block_rep->keys)[0],
+                                             block_rep->keys->Back());
+    }
     r->pc_rep->file_size_estimator.SetCurrBlockRawSize(block_rep->data->size());
     WriteRawBlock(block_rep->compressed_contents, block_rep->compression_type,
                   &r->pending_handle, BlockType::kData, &block_rep->contents);
@@ -1359,6 +1417,9 @@ void BlockBasedTableBuilder::BGWorkWriteRawBlock() {
     }
     r->props.data_size = r->get_offset();
     ++r->props.num_data_blocks;
+    if (r->data_block_lookup_index_builder != nullptr) {
+      r->data_block_lookup_index_builder->AddBlockHandle(r->pending_handle);
+    }
 
     if (block_rep->first_key_in_next_block == nullptr) {
       r->index_builder->AddIndexEntry(&(block_rep->keys->Back()), nullptr,
@@ -1780,6 +1841,23 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteDataBlockLookupIndexBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  Rep* r = rep_;
+  std::string contents;
+  if (ok() && r->data_block_lookup_index_builder != nullptr &&
+      r->data_block_lookup_index_builder->Finish(&contents)) {
+    BlockHandle lookup_index_block_handle;
+    WriteRawBlock(contents, kNoCompression, &lookup_index_block_handle,
+                  BlockType::kDataBlockLookupIndex);
+    if (ok()) {
+      meta_index_builder->Add(kDataBlockLookupIndexBlock,
+                              lookup_index_block_handle);
+    }
+  }
+  r->data_block_lookup_index_builder.reset();
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   Rep* r = rep_;
@@ -1853,7 +1931,11 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
   // final data block flushed, now we can generate dictionary from the samples.
   // OK if compression_dict_samples is empty, we'll just get empty dictionary.
   std::string dict;
-  if (r->compression_opts.zstd_max_train_bytes > 0) {
+  if (r->compression_type == kFSSTCompression) {
+    // The FSST dictionary is a symbol table, which is always trained, and
+    // never a ZSTD dictionary even if zstd_max_train_bytes is set.
+    dict = fsst::TrainSymbolTable(compression_dict_samples);
+  } else if (r->compression_opts.zstd_max_train_bytes > 0) {
     dict = ZSTD_TrainDictionary(compression_dict_samples,
                                 compression_dict_sample_lens,
                                 r->compression_opts.max_dict_bytes);
@@ -1916,6 +1998,9 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
                                                r->get_offset());
       r->pc_rep->EmitBlock(block_rep);
     } else {
+      if (r->hot_key_ranges != nullptr) {
+        r->first_key_in_data_block = iter->key().ToString();
+      }
       for (; iter->Valid(); iter->Next()) {
         Slice key = iter->key();
         if (r->filter_builder != nullptr) {
@@ -1925,6 +2010,11 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
         }
         r->index_builder->OnKeyAdded(key);
       }
+      if (r->hot_key_ranges != nullptr) {
+        iter->SeekToLast();
+        r->warm_data_block =
+            r->IsHotDataBlock(r->first_key_in_data_block, iter->key());
+      }
       WriteBlock(Slice(data_block), &r->pending_handle, BlockType::kData);
       if (ok() && i + 1 < r->data_block_buffers.size()) {
         assert(next_block_iter != nullptr);
@@ -1976,20 +2066,23 @@ Status BlockBasedTableBuilder::Finish() {
     }
   }
 
+  const uint64_t tail_start_offset = r->get_offset();
   // Write meta blocks, metaindex block and footer in the following order.
   //    1. [meta block: filter]
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    5. [meta block: data block lookup index]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteDataBlockLookupIndexBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -1998,6 +2091,7 @@ Status BlockBasedTableBuilder::Finish() {
   }
   if (ok()) {
     WriteFooter(metaindex_block_handle, index_block_handle);
+    r->tail_size = r->get_offset() - tail_start_offset;
   }
   r->state = Rep::State::kClosed;
   r->SetStatus(r->CopyIOStatus());
@@ -2036,6 +2130,10 @@ uint64_t BlockBasedTableBuilder::EstimatedFileSize() const {
   }
 }
 
+uint64_t BlockBasedTableBuilder::GetTailSize() const {
+  return rep_->tail_size;
+}
+
 bool BlockBasedTableBuilder::NeedCompact() const {
   for (const auto& collector : rep_->table_properties_collectors) {
     if (collector->NeedCompact()) {
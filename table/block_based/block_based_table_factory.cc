@@ -223,7 +223,10 @@ static std::unordered_map<std::string,
     block_base_table_prepopulate_block_cache_string_map = {
         {"kDisable", BlockBasedTableOptions::PrepopulateBlockCache::kDisable},
         {"kFlushOnly",
-         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly}};
+         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly},
+        {"kFlushAndHotCompaction",
+         BlockBasedTableOptions::PrepopulateBlockCache::
+             kFlushAndHotCompaction}};
 
 #endif  // ROCKSDB_LITE
 
@@ -274,6 +277,15 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"data_block_lookup_index",
+         {offsetof(struct BlockBasedTableOptions, data_block_lookup_index),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"separate_values_in_data_blocks",
+         {offsetof(struct BlockBasedTableOptions,
+                   separate_values_in_data_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal,
@@ -470,6 +482,13 @@ void BlockBasedTableFactory::InitializeOptions() {
       table_options_.block_size_deviation > 100) {
     table_options_.block_size_deviation = 0;
   }
+  if (table_options_.data_block_lookup_index &&
+      table_options_.block_cache != nullptr &&
+      lookup_index_cache_res_mgr_ == nullptr) {
+    lookup_index_cache_res_mgr_ = std::make_shared<
+        ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>(
+        table_options_.block_cache);
+  }
   if (table_options_.block_restart_interval < 1) {
     table_options_.block_restart_interval = 1;
   }
@@ -620,7 +639,8 @@ Status BlockBasedTableFactory::NewTableReader(
       table_reader_options.block_cache_tracer,
       table_reader_options.max_file_size_for_l0_meta_pin,
       table_reader_options.cur_db_session_id,
-      table_reader_options.cur_file_num);
+      table_reader_options.cur_file_num, lookup_index_cache_res_mgr_,
+      table_reader_options.tail_size);
 }
 
 TableBuilder* BlockBasedTableFactory::NewTableBuilder(
@@ -735,6 +755,12 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
            table_options_.data_block_hash_table_util_ratio);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_lookup_index: %d\n",
+           table_options_.data_block_lookup_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  separate_values_in_data_blocks: %d\n",
+           table_options_.separate_values_in_data_blocks);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  hash_index_allow_collision: %d\n",
            table_options_.hash_index_allow_collision);
   ret.append(buffer);
@@ -975,6 +1001,8 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kDataBlockLookupIndexBlock =
+    "rocksdb.data_block_lookup_index";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
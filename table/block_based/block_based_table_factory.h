@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 
+#include "cache/cache_reservation_manager.h"
 #include "port/port.h"
 #include "rocksdb/flush_block_policy.h"
 #include "rocksdb/table.h"
@@ -90,10 +91,16 @@ class BlockBasedTableFactory : public TableFactory {
  private:
   BlockBasedTableOptions table_options_;
   mutable TailPrefetchStats tail_prefetch_stats_;
+  // Charges the data block lookup indexes of all table readers created by
+  // this factory to the block cache
+  std::shared_ptr<
+      ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>
+      lookup_index_cache_res_mgr_;
 };
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kDataBlockLookupIndexBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 }  // namespace ROCKSDB_NAMESPACE
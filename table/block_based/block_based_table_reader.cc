@@ -75,6 +75,7 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kDataBlockLookupIndexBlock;
 
 BlockBasedTable::~BlockBasedTable() {
   delete rep_;
@@ -558,7 +559,11 @@ Status BlockBasedTable::Open(
     TailPrefetchStats* tail_prefetch_stats,
     BlockCacheTracer* const block_cache_tracer,
     size_t max_file_size_for_l0_meta_pin, const std::string& cur_db_session_id,
-    uint64_t cur_file_num) {
+    uint64_t cur_file_num,
+    const std::shared_ptr<
+        ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>&
+        lookup_index_cache_res_mgr,
+    uint64_t tail_size) {
   table_reader->reset();
 
   Status s;
@@ -581,7 +586,7 @@ Status BlockBasedTable::Open(
   if (!ioptions.allow_mmap_reads) {
     s = PrefetchTail(ro, file.get(), file_size, force_direct_prefetch,
                      tail_prefetch_stats, prefetch_all, preload_all,
-                     &prefetch_buffer);
+                     tail_size, &prefetch_buffer);
     // Return error in prefetch path to users.
     if (!s.ok()) {
       return s;
@@ -598,9 +603,10 @@ Status BlockBasedTable::Open(
   //    2. [metaindex block]
   //    3. [meta block: properties]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: compression dictionary]
-  //    6. [meta block: index]
-  //    7. [meta block: filter]
+  //    5. [meta block: data block lookup index]
+  //    6. [meta block: compression dictionary]
+  //    7. [meta block: index]
+  //    8. [meta block: filter]
   IOOptions opts;
   s = file->PrepareIOOptions(ro, opts);
   if (s.ok()) {
@@ -654,6 +660,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  // The metaindex block is never compressed, so it tells whether the file
+  // system really serves mmap reads from its own memory or just copies into
+  // our buffer.
+  const bool file_reads_zero_copy =
+      ioptions.allow_mmap_reads && !metaindex->own_bytes();
 
   // Populates table_properties and some fields that depend on it,
   // such as index_type.
@@ -662,6 +673,8 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  rep->zero_copy_data_blocks =
+      file_reads_zero_copy && !rep->blocks_maybe_compressed;
   if (!PrefixExtractorChangedHelper(rep->table_properties.get(),
                                     prefix_extractor.get())) {
     // Establish fast path for unchanged prefix_extractor
@@ -701,6 +714,12 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  if (table_options.data_block_lookup_index &&
+      internal_comparator.user_comparator()->timestamp_size() == 0) {
+    new_table->ReadDataBlockLookupIndex(ro, prefetch_buffer.get(),
+                                        metaindex_iter.get(),
+                                        lookup_index_cache_res_mgr);
+  }
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
       prefetch_all, table_options, level, file_size,
@@ -724,10 +743,14 @@ Status BlockBasedTable::Open(
 Status BlockBasedTable::PrefetchTail(
     const ReadOptions& ro, RandomAccessFileReader* file, uint64_t file_size,
     bool force_direct_prefetch, TailPrefetchStats* tail_prefetch_stats,
-    const bool prefetch_all, const bool preload_all,
+    const bool prefetch_all, const bool preload_all, uint64_t tail_size,
     std::unique_ptr<FilePrefetchBuffer>* prefetch_buffer) {
   size_t tail_prefetch_size = 0;
-  if (tail_prefetch_stats != nullptr) {
+  const bool read_whole_tail =
+      tail_size > 0 && tail_size <= file_size && (prefetch_all || preload_all);
+  if (read_whole_tail) {
+    tail_prefetch_size = static_cast<size_t>(tail_size);
+  } else if (tail_prefetch_stats != nullptr) {
     // Multiple threads may get a 0 (no history) when running in parallel,
     // but it will get cleared after the first of them finishes.
     tail_prefetch_size = tail_prefetch_stats->GetSuggestedPrefetchSize();
@@ -753,8 +776,8 @@ Status BlockBasedTable::PrefetchTail(
   TEST_SYNC_POINT_CALLBACK("BlockBasedTable::Open::TailPrefetchLen",
                            &tail_prefetch_size);
 
-  // Try file system prefetch
-  if (!file->use_direct_io() && !force_direct_prefetch) {
+  // Try file system prefetch, unless the whole tail is read anyway
+  if (!file->use_direct_io() && !force_direct_prefetch && !read_whole_tail) {
     if (!file->Prefetch(prefetch_off, prefetch_len).IsNotSupported()) {
       prefetch_buffer->reset(new FilePrefetchBuffer(
           0 /* readahead_size */, 0 /* max_readahead_size */,
@@ -890,6 +913,45 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+void BlockBasedTable::ReadDataBlockLookupIndex(
+    const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
+    InternalIterator* meta_iter,
+    const std::shared_ptr<
+        ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>&
+        cache_res_mgr) {
+  BlockHandle handle;
+  Status s =
+      FindOptionalMetaBlock(meta_iter, kDataBlockLookupIndexBlock, &handle);
+  if (!s.ok() || handle.IsNull()) {
+    // Written by an older version or without the option
+    s.PermitUncheckedError();
+    return;
+  }
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, ro, handle, &contents,
+      rep_->ioptions, false /* decompress */, false /* maybe_compressed */,
+      BlockType::kDataBlockLookupIndex, UncompressionDict::GetEmptyDict(),
+      rep_->persistent_cache_options, GetMemoryAllocator(rep_->table_options));
+  s = block_fetcher.ReadBlockContents();
+  if (s.ok()) {
+    s = rep_->data_block_lookup_index.Initialize(contents.data);
+  }
+  if (s.ok() && cache_res_mgr != nullptr) {
+    s = cache_res_mgr->MakeCacheReservation(
+        contents.ApproximateMemoryUsage(),
+        &rep_->data_block_lookup_index_cache_res_handle);
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Not using data block lookup index of %s: %s",
+                   rep_->file->file_name().c_str(), s.ToString().c_str());
+    return;
+  }
+  rep_->data_block_lookup_index_contents = std::move(contents);
+  rep_->has_data_block_lookup_index = true;
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1905,7 +1967,10 @@ Status BlockBasedTable::RetrieveBlock(
   assert(block_entry->IsEmpty());
 
   Status s;
-  if (use_cache) {
+  // Zero-copy data blocks are never inserted into the block cache, so do not
+  // bother looking them up.
+  if (use_cache &&
+      !(block_type == BlockType::kData && rep_->zero_copy_data_blocks)) {
     s = MaybeReadBlockAndLoadToCache(
         prefetch_buffer, ro, handle, uncompression_dict, wait_for_cache,
         for_compaction, block_entry, block_type, get_context, lookup_context,
@@ -2317,9 +2382,13 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
       FullFilterKeyMayMatch(read_options, filter, key, no_io, prefix_extractor,
                             get_context, &lookup_context);
   TEST_SYNC_POINT("BlockBasedTable::Get:AfterFilterMatch");
+  bool matched = false;  // if such user key matched a key in SST
   if (!may_match) {
     RecordTick(rep_->ioptions.stats, BLOOM_FILTER_USEFUL);
     PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
+  } else if (GetWithDataBlockLookupIndex(read_options, key, filter,
+                                         get_context, &matched, &s)) {
+    // Done without searching the index block
   } else {
     IndexBlockIter iiter_on_stack;
     // if prefix_extractor found in block differs from options, disable
@@ -2338,7 +2407,6 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
 
     size_t ts_sz =
         rep_->internal_comparator.user_comparator()->timestamp_size();
-    bool matched = false;  // if such user key matched a key in SST
     bool done = false;
     for (iiter->Seek(key); iiter->Valid() && !done; iiter->Next()) {
       IndexValue v = iiter->value();
@@ -2462,19 +2530,104 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
         break;
       }
     }
-    if (matched && filter != nullptr && !filter->IsBlockBased()) {
-      RecordTick(rep_->ioptions.stats, BLOOM_FILTER_FULL_TRUE_POSITIVE);
-      PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1,
-                                rep_->level);
-    }
     if (s.ok() && !iiter->status().IsNotFound()) {
       s = iiter->status();
     }
   }
+  if (matched && filter != nullptr && !filter->IsBlockBased()) {
+    RecordTick(rep_->ioptions.stats, BLOOM_FILTER_FULL_TRUE_POSITIVE);
+    PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1, rep_->level);
+  }
 
   return s;
 }
 
+bool BlockBasedTable::GetWithDataBlockLookupIndex(
+    const ReadOptions& read_options, const Slice& key,
+    FilterBlockReader* filter, GetContext* get_context, bool* matched,
+    Status* s) const {
+  // Block-based filters and block cache tracing need the index block
+  if (!rep_->has_data_block_lookup_index ||
+      (filter != nullptr && filter->IsBlockBased()) ||
+      (block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled())) {
+    return false;
+  }
+  const DataBlockLookupIndex& lookup_index = rep_->data_block_lookup_index;
+  uint32_t block = 0;
+  if (!lookup_index.Lookup(ExtractUserKey(key), &block)) {
+    // Not in the index, e.g. because the key spans several data blocks
+    return false;
+  }
+  bool continued = false;
+  BlockHandle handle = lookup_index.GetBlockHandle(block, &continued);
+  if (continued) {
+    // Entries of the key, if it really is in this block, might have started
+    // in an earlier block
+    return false;
+  }
+
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  const uint32_t first_block = block;
+  bool done = false;
+  for (;;) {
+    BlockCacheLookupContext lookup_data_block_context{
+        TableReaderCaller::kUserGet, get_context->get_tracing_get_id(),
+        /*get_from_user_specified_snapshot=*/read_options.snapshot !=
+            nullptr};
+    DataBlockIter biter;
+    NewDataBlockIterator<DataBlockIter>(
+        read_options, handle, &biter, BlockType::kData, get_context,
+        &lookup_data_block_context,
+        /*s=*/Status(), /*prefetch_buffer*/ nullptr);
+    if (no_io && biter.status().IsIncomplete()) {
+      // couldn't get block from block_cache
+      get_context->MarkKeyMayExist();
+      *s = biter.status();
+      return true;
+    }
+    if (!biter.status().ok()) {
+      *s = biter.status();
+      return true;
+    }
+    if (!biter.SeekForGet(key)) {
+      // If this is the wrong block, the key can still be in another one
+      return block != first_block;
+    }
+    for (; biter.Valid(); biter.Next()) {
+      ParsedInternalKey parsed_key;
+      Status pik_status = ParseInternalKey(biter.key(), &parsed_key,
+                                           false /* log_err_key */);
+      if (!pik_status.ok()) {
+        *s = pik_status;
+      }
+      if (!get_context->SaveValue(parsed_key, biter.value(), matched,
+                                  biter.IsValuePinned() ? &biter : nullptr)) {
+        done = true;
+        break;
+      }
+    }
+    if (!biter.status().ok()) {
+      *s = biter.status();
+    }
+    if (!s->ok()) {
+      return true;
+    }
+    if (!*matched) {
+      // A false positive of the lookup index, so nothing was saved yet
+      assert(block == first_block);
+      return false;
+    }
+    // Versions of the key might continue in the next block
+    if (done || ++block >= lookup_index.num_blocks()) {
+      return true;
+    }
+    handle = lookup_index.GetBlockHandle(block, &continued);
+    if (!continued) {
+      return true;
+    }
+  }
+}
+
 using MultiGetRange = MultiGetContext::Range;
 void BlockBasedTable::MultiGet(const ReadOptions& read_options,
                                const MultiGetRange* mget_range,
@@ -2783,9 +2936,18 @@ void BlockBasedTable::MultiGet(const ReadOptions& read_options,
             s = pik_status;
           }
           if (biter->IsValuePinned()) {
-            if (reusing_block) {
+            if (reusing_block && biter->cache_handle() == nullptr) {
+              // A zero-copy block, pinned by holding a reference on the file
+              assert(rep_->zero_copy_data_blocks);
+              if (!rep_->immortal_table) {
+                dummy.RegisterCleanup(
+                    &ReleaseFileReaderRef,
+                    new std::shared_ptr<RandomAccessFileReader>(rep_->file),
+                    nullptr);
+              }
+              value_pinner = &dummy;
+            } else if (reusing_block) {
               Cache* block_cache = rep_->table_options.block_cache.get();
-              assert(biter->cache_handle() != nullptr);
               block_cache->Ref(biter->cache_handle());
               dummy.RegisterCleanup(&ReleaseCachedEntry, block_cache,
                                     biter->cache_handle());
@@ -3032,6 +3194,10 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kDataBlockLookupIndexBlock) {
+    return BlockType::kDataBlockLookupIndex;
+  }
+
   assert(false);
   return BlockType::kInvalid;
 }
@@ -3282,6 +3448,110 @@ uint64_t BlockBasedTable::ApproximateSize(const Slice& start, const Slice& end,
                                static_cast<double>(rep_->file_size));
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              std::vector<Anchor>* anchors) {
+  assert(anchors != nullptr);
+  // Enough to balance the subcompactions of a compaction with a few input
+  // files; the cost is one pass over the index, which compaction reads
+  // anyway.
+  constexpr size_t kMaxNumAnchors = 128;
+
+  BlockCacheLookupContext context(TableReaderCaller::kCompaction);
+  IndexBlockIter iiter_on_stack;
+  ReadOptions ro = read_options;
+  ro.total_order_seek = true;
+  auto index_iter =
+      NewIndexIterator(ro, /*disable_prefix_seek=*/true,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  size_t num_blocks = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    ++num_blocks;
+  }
+  if (!index_iter->status().ok()) {
+    return index_iter->status();
+  }
+  const size_t blocks_per_anchor =
+      (num_blocks + kMaxNumAnchors - 1) / kMaxNumAnchors;
+
+  uint64_t prev_end_offset = 0;
+  uint64_t range_size = 0;
+  size_t blocks_in_range = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const BlockHandle& handle = index_iter->value().handle;
+    const uint64_t end_offset =
+        handle.offset() + BlockBasedTable::BlockSizeWithTrailer(handle);
+    range_size += end_offset - prev_end_offset;
+    prev_end_offset = end_offset;
+    if (++blocks_in_range == blocks_per_anchor) {
+      anchors->emplace_back(index_iter->user_key(), range_size);
+      range_size = 0;
+      blocks_in_range = 0;
+    }
+  }
+  if (!index_iter->status().ok()) {
+    return index_iter->status();
+  }
+  if (blocks_in_range > 0) {
+    // The trailing blocks, anchored at the separator of the last one
+    index_iter->SeekToLast();
+    if (index_iter->Valid()) {
+      anchors->emplace_back(index_iter->user_key(), range_size);
+    }
+    return index_iter->status();
+  }
+  return Status::OK();
+}
+
+Status BlockBasedTable::GetCachedKeyRanges(const ReadOptions& read_options,
+                                           std::vector<KeyRange>* ranges) {
+  assert(ranges != nullptr);
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr) {
+    return Status::OK();
+  }
+
+  BlockCacheLookupContext context(TableReaderCaller::kCompaction);
+  IndexBlockIter iiter_on_stack;
+  ReadOptions ro = read_options;
+  ro.total_order_seek = true;
+  auto index_iter =
+      NewIndexIterator(ro, /*disable_prefix_seek=*/true,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  std::string prev_separator;
+  bool extends_range = false;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const CacheKey key =
+        GetCacheKey(rep_->base_cache_key, index_iter->value().handle);
+    const Slice separator = index_iter->user_key();
+    // Probe rather than look up, so that the blocks of the input files do
+    // not look recently used and outlive the ones of the outputs
+    if (block_cache->Probe(key.AsSlice())) {
+      if (extends_range) {
+        ranges->back().largest.assign(separator.data(), separator.size());
+      } else {
+        ranges->emplace_back(prev_separator, separator);
+        extends_range = true;
+      }
+    } else {
+      extends_range = false;
+    }
+    prev_separator.assign(separator.data(), separator.size());
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_FilterBlockInCache() const {
   assert(rep_ != nullptr);
   return rep_->filter_type != Rep::FilterType::kNoFilter &&
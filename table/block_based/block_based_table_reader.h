@@ -20,6 +20,7 @@
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
+#include "table/block_based/data_block_lookup_index.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
@@ -106,7 +107,11 @@ class BlockBasedTable : public TableReader {
       TailPrefetchStats* tail_prefetch_stats = nullptr,
       BlockCacheTracer* const block_cache_tracer = nullptr,
       size_t max_file_size_for_l0_meta_pin = 0,
-      const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0);
+      const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0,
+      const std::shared_ptr<
+          ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>&
+          lookup_index_cache_res_mgr = nullptr,
+      uint64_t tail_size = 0);
 
   bool PrefixMayMatch(const Slice& internal_key,
                       const ReadOptions& read_options,
@@ -162,6 +167,18 @@ class BlockBasedTable : public TableReader {
   uint64_t ApproximateSize(const Slice& start, const Slice& end,
                            TableReaderCaller caller) override;
 
+  // Samples the index keys, so that each anchor covers about the same number
+  // of data blocks.
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               std::vector<Anchor>* anchors) override;
+
+  // Probes the block cache for each data block in the index, without
+  // counting as a use of the cached blocks (see Cache::Probe()). A cached
+  // block covers the keys after the separator of the previous block, which
+  // is taken as the start of its range.
+  Status GetCachedKeyRanges(const ReadOptions& read_options,
+                            std::vector<KeyRange>* ranges) override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -440,6 +457,14 @@ class BlockBasedTable : public TableReader {
                            BlockCacheLookupContext* lookup_context,
                            std::unique_ptr<IndexReader>* index_reader);
 
+  // Serves Get() from the data block pointed to by the data block lookup
+  // index. Returns false, with nothing saved to get_context, if the index
+  // cannot answer and the index block has to be searched instead.
+  bool GetWithDataBlockLookupIndex(const ReadOptions& read_options,
+                                   const Slice& key, FilterBlockReader* filter,
+                                   GetContext* get_context, bool* matched,
+                                   Status* s) const;
+
   bool FullFilterKeyMayMatch(const ReadOptions& read_options,
                              FilterBlockReader* filter, const Slice& user_key,
                              const bool no_io,
@@ -455,10 +480,12 @@ class BlockBasedTable : public TableReader {
 
   // If force_direct_prefetch is true, always prefetching to RocksDB
   //    buffer, rather than calling RandomAccessFile::Prefetch().
+  // If tail_size is known (non-zero) and the index and filter are going to
+  //    be read, the whole tail is read into RocksDB buffer at once.
   static Status PrefetchTail(
       const ReadOptions& ro, RandomAccessFileReader* file, uint64_t file_size,
       bool force_direct_prefetch, TailPrefetchStats* tail_prefetch_stats,
-      const bool prefetch_all, const bool preload_all,
+      const bool prefetch_all, const bool preload_all, uint64_t tail_size,
       std::unique_ptr<FilePrefetchBuffer>* prefetch_buffer);
   Status ReadMetaIndexBlock(const ReadOptions& ro,
                             FilePrefetchBuffer* prefetch_buffer,
@@ -473,6 +500,14 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  // Loads the data block lookup index, if the file has one and it can be
+  // charged to the block cache. Failures only leave the index unused.
+  void ReadDataBlockLookupIndex(
+      const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
+      InternalIterator* meta_iter,
+      const std::shared_ptr<
+          ConcurrentCacheReservationManager<CacheEntryRole::kIndexBlock>>&
+          cache_res_mgr);
   Status PrefetchIndexAndFilterBlocks(
       const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
       InternalIterator* meta_iter, BlockBasedTable* new_table,
@@ -563,7 +598,9 @@ struct BlockBasedTable::Rep {
   const FilterPolicy* const filter_policy;
   const InternalKeyComparator& internal_comparator;
   Status status;
-  std::unique_ptr<RandomAccessFileReader> file;
+  // Shared so that blocks served directly from memory owned by the file
+  // (mmap reads) can keep it alive after the table reader is gone.
+  std::shared_ptr<RandomAccessFileReader> file;
   OffsetableCacheKey base_cache_key;
   PersistentCacheOptions persistent_cache_options;
 
@@ -599,6 +636,14 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<const FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Only initialized if has_data_block_lookup_index
+  BlockContents data_block_lookup_index_contents;
+  DataBlockLookupIndex data_block_lookup_index;
+  bool has_data_block_lookup_index = false;
+  std::unique_ptr<ConcurrentCacheReservationManager<
+      CacheEntryRole::kIndexBlock>::Handle>
+      data_block_lookup_index_cache_res_handle;
+
   // If global_seqno is used, all Keys in this file will have the same
   // seqno with value `global_seqno`.
   //
@@ -623,6 +668,12 @@ struct BlockBasedTable::Rep {
   // still work, just not as quickly.
   bool blocks_definitely_zstd_compressed = false;
 
+  // If true, data blocks are read directly from memory owned by `file`, i.e.
+  // mmap reads of a file with no compressed blocks. Such blocks bypass the
+  // block cache, and iterators over them hold a reference on `file` so that
+  // pinned values (e.g. PinnableSlice) stay valid without a copy.
+  bool zero_copy_data_blocks = false;
+
   // These describe how index is encoded.
   bool index_has_first_key = false;
   bool index_key_includes_seq = true;
@@ -70,14 +70,25 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
   // 1. block cache handle is set to be released in cleanup function, or
   // 2. it's pointing to immortal source. If own_bytes is true then we are
   //    not reading data from the original source, whether immortal or not.
-  //    Otherwise, the block is pinned iff the source is immortal.
+  //    Otherwise, the block is pinned iff the source is immortal, or
+  // 3. it's a zero-copy data block, in which case the iterator holds a
+  //    reference on the file that owns the memory.
+  const bool zero_copy = !block.IsCached() &&
+                         !block.GetValue()->own_bytes() &&
+                         rep_->zero_copy_data_blocks;
   const bool block_contents_pinned =
       block.IsCached() ||
-      (!block.GetValue()->own_bytes() && rep_->immortal_table);
+      (!block.GetValue()->own_bytes() && rep_->immortal_table) || zero_copy;
   iter = InitBlockIterator<TBlockIter>(rep_, block.GetValue(), block_type, iter,
                                        block_contents_pinned);
 
-  if (!block.IsCached()) {
+  if (zero_copy) {
+    if (!rep_->immortal_table) {
+      iter->RegisterCleanup(
+          &ReleaseFileReaderRef,
+          new std::shared_ptr<RandomAccessFileReader>(rep_->file), nullptr);
+    }
+  } else if (!block.IsCached()) {
     if (!ro.fill_cache) {
       Cache* const block_cache = rep_->table_options.block_cache.get();
       if (block_cache) {
@@ -128,14 +139,25 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   // 1. block cache handle is set to be released in cleanup function, or
   // 2. it's pointing to immortal source. If own_bytes is true then we are
   //    not reading data from the original source, whether immortal or not.
-  //    Otherwise, the block is pinned iff the source is immortal.
+  //    Otherwise, the block is pinned iff the source is immortal, or
+  // 3. it's a zero-copy data block, in which case the iterator holds a
+  //    reference on the file that owns the memory.
+  const bool zero_copy = !block.IsCached() &&
+                         !block.GetValue()->own_bytes() &&
+                         rep_->zero_copy_data_blocks;
   const bool block_contents_pinned =
       block.IsCached() ||
-      (!block.GetValue()->own_bytes() && rep_->immortal_table);
+      (!block.GetValue()->own_bytes() && rep_->immortal_table) || zero_copy;
   iter = InitBlockIterator<TBlockIter>(rep_, block.GetValue(), BlockType::kData,
                                        iter, block_contents_pinned);
 
-  if (!block.IsCached()) {
+  if (zero_copy) {
+    if (!rep_->immortal_table) {
+      iter->RegisterCleanup(
+          &ReleaseFileReaderRef,
+          new std::shared_ptr<RandomAccessFileReader>(rep_->file), nullptr);
+    }
+  } else if (!block.IsCached()) {
     if (!ro.fill_cache) {
       Cache* const block_cache = rep_->table_options.block_cache.get();
       if (block_cache) {
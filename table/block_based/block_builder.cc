@@ -30,6 +30,16 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// With separate_values, all values are stored back to back at the start of
+// the block, followed by the entries, so that scanning the keys does not
+// touch the values:
+//     values: char[]
+//     entries, restarts, ... as above, except that the value of each entry
+//         is replaced by a slot locating its value:
+//         value_offset: varint32 (offset of the value within the block)
+//         value_size: varint32
+// The separated values are flagged in the num_restarts footer.
 
 #include "table/block_based/block_builder.h"
 
@@ -46,10 +56,11 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool separate_values)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      separate_values_(separate_values),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -64,11 +75,13 @@ BlockBuilder::BlockBuilder(
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
+  assert(!separate_values_ || !use_value_delta_encoding_);
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
 }
 
 void BlockBuilder::Reset() {
   buffer_.clear();
+  values_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
@@ -112,14 +125,27 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
   if (!use_value_delta_encoding_ || (counter_ >= block_restart_interval_)) {
     estimate += VarintLength(value.size());  // varint for value length.
   }
+  if (separate_values_) {
+    estimate += VarintLength(values_.size());  // varint for value offset.
+  }
 
   return estimate;
 }
 
 Slice BlockBuilder::Finish() {
+  // Restart points are recorded relative to the entries, which follow the
+  // values when they are separated
+  uint32_t restart_shift = 0;
+  if (separate_values_) {
+    restart_shift = static_cast<uint32_t>(values_.size());
+    values_.append(buffer_);
+    buffer_.swap(values_);
+    values_.clear();
+  }
+
   // Append restart array
   for (size_t i = 0; i < restarts_.size(); i++) {
-    PutFixed32(&buffer_, restarts_[i]);
+    PutFixed32(&buffer_, restarts_[i] + restart_shift);
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
@@ -132,7 +158,8 @@ Slice BlockBuilder::Finish() {
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer =
+      PackIndexTypeAndNumRestarts(index_type, num_restarts, separate_values_);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -202,6 +229,19 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // Add "<shared><non_shared>" to buffer_
     PutVarint32Varint32(&buffer_, static_cast<uint32_t>(shared),
                         static_cast<uint32_t>(non_shared));
+  } else if (separate_values_) {
+    // Add "<shared><non_shared><slot_size><key_delta><value_offset>
+    // <value_size>" to buffer_ and the value itself to values_
+    const uint32_t value_offset = static_cast<uint32_t>(values_.size());
+    const uint32_t value_size = static_cast<uint32_t>(value.size());
+    PutVarint32Varint32Varint32(
+        &buffer_, static_cast<uint32_t>(shared),
+        static_cast<uint32_t>(non_shared),
+        static_cast<uint32_t>(VarintLength(value_offset) +
+                              VarintLength(value_size)));
+    buffer_.append(key.data() + shared, non_shared);
+    PutVarint32Varint32(&buffer_, value_offset, value_size);
+    values_.append(value.data(), value.size());
   } else {
     // Add "<shared><non_shared><value_size>" to buffer_
     PutVarint32Varint32Varint32(&buffer_, static_cast<uint32_t>(shared),
@@ -209,15 +249,17 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
                                 static_cast<uint32_t>(value.size()));
   }
 
-  // Add string delta to buffer_ followed by value
-  buffer_.append(key.data() + shared, non_shared);
-  // Use value delta encoding only when the key has shared bytes. This would
-  // simplify the decoding, where it can figure which decoding to use simply by
-  // looking at the shared bytes size.
-  if (shared != 0 && use_value_delta_encoding_) {
-    buffer_.append(delta_value->data(), delta_value->size());
-  } else {
-    buffer_.append(value.data(), value.size());
+  if (!separate_values_) {
+    // Add string delta to buffer_ followed by value
+    buffer_.append(key.data() + shared, non_shared);
+    // Use value delta encoding only when the key has shared bytes. This would
+    // simplify the decoding, where it can figure which decoding to use simply
+    // by looking at the shared bytes size.
+    if (shared != 0 && use_value_delta_encoding_) {
+      buffer_.append(delta_value->data(), delta_value->size());
+    } else {
+      buffer_.append(value.data(), value.size());
+    }
   }
 
   if (data_block_hash_index_builder_.Valid()) {
@@ -227,6 +269,9 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
 
   counter_++;
   estimate_ += buffer_.size() - buffer_size;
+  if (separate_values_) {
+    estimate_ += value.size();
+  }
 }
 
 }  // namespace ROCKSDB_NAMESPACE
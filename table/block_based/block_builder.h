@@ -27,7 +27,8 @@ class BlockBuilder {
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool separate_values = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -85,8 +86,11 @@ class BlockBuilder {
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  // Store the values apart from the keys, ahead of all entries
+  const bool separate_values_;
 
   std::string buffer_;              // Destination buffer
+  std::string values_;              // Separated values, until Finish()
   std::vector<uint32_t> restarts_;  // Restart points
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
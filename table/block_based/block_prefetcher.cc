@@ -15,6 +15,16 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
                                        const BlockHandle& handle,
                                        size_t readahead_size,
                                        bool is_for_compaction) {
+  // FilePrefetchBuffer is disabled in mmap mode, so ask the file system to
+  // fault in the requested range instead.
+  if (rep->ioptions.allow_mmap_reads &&
+      (is_for_compaction || readahead_size > 0)) {
+    MmapReadaheadIfNeeded(
+        rep, handle,
+        is_for_compaction ? compaction_readahead_size_ : readahead_size);
+    return;
+  }
+
   if (is_for_compaction) {
     rep->CreateFilePrefetchBufferIfNotExists(compaction_readahead_size_,
                                              compaction_readahead_size_,
@@ -97,4 +107,17 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
   // max_auto_readahead_size.
   readahead_size_ = std::min(max_auto_readahead_size, readahead_size_ * 2);
 }
+
+void BlockPrefetcher::MmapReadaheadIfNeeded(const BlockBasedTable::Rep* rep,
+                                            const BlockHandle& handle,
+                                            size_t readahead_size) {
+  size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
+  uint64_t offset = handle.offset();
+  if (readahead_size == 0 || offset + len <= readahead_limit_) {
+    return;
+  }
+  // Errors are ignored; the data is still read on demand.
+  rep->file->Prefetch(offset, len + readahead_size).PermitUncheckedError();
+  readahead_limit_ = offset + len + readahead_size;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -19,6 +19,10 @@ class BlockPrefetcher {
                         bool is_for_compaction);
   FilePrefetchBuffer* prefetch_buffer() { return prefetch_buffer_.get(); }
 
+  // Readahead for mmap mode, where blocks are read directly from the mapping.
+  void MmapReadaheadIfNeeded(const BlockBasedTable::Rep* rep,
+                             const BlockHandle& handle, size_t readahead_size);
+
   void UpdateReadPattern(const uint64_t& offset, const size_t& len) {
     prev_offset_ = offset;
     prev_len_ = len;
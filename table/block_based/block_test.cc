@@ -127,6 +127,102 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+TEST_F(BlockTest, SeparatedValues) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  const int num_records = 150;
+  GenerateRandomKVs(&keys, &values, 0, num_records, 1 /* step */,
+                    0 /* padding_size */, 2 /* keys_share_prefix */);
+  for (size_t i = 0; i < values.size(); i += 3) {
+    // Mix in empty and bigger values
+    values[i] = i % 2 ? "" : rnd.RandomString(300);
+  }
+
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    BlockBuilder builder(16, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */, index_type,
+                         0.75 /* data_block_hash_table_util_ratio */,
+                         true /* separate_values */);
+    size_t value_bytes = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      builder.Add(keys[i], values[i]);
+      value_bytes += values[i].size();
+    }
+    const size_t estimate = builder.CurrentSizeEstimate();
+    Slice rawblock = builder.Finish();
+    ASSERT_EQ(estimate, rawblock.size());
+
+    BlockContents contents;
+    contents.data = rawblock;
+    Block reader(std::move(contents));
+    ASSERT_TRUE(reader.separated_values());
+    ASSERT_EQ(index_type, reader.IndexType());
+
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    size_t count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++count) {
+      ASSERT_EQ(keys[count], iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+      // The values are all stored ahead of the keys
+      ASSERT_LE(iter->value().data() + iter->value().size(),
+                rawblock.data() + value_bytes);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(keys.size(), count);
+
+    // Backward, through the cached previous entries
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      --count;
+      ASSERT_EQ(keys[count], iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(0U, count);
+
+    for (int i = 0; i < 1000; ++i) {
+      size_t index = rnd.Uniform(static_cast<int>(keys.size()));
+      iter->Seek(keys[index]);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[index], iter->value().ToString());
+      ASSERT_TRUE(iter->SeekForGet(keys[index]));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[index], iter->value().ToString());
+    }
+
+    // Separated values are not expected in other kinds of blocks
+    std::unique_ptr<MetaBlockIter> meta_iter(reader.NewMetaIterator());
+    ASSERT_TRUE(meta_iter->status().IsCorruption());
+  }
+}
+
+TEST_F(BlockTest, SeparatedValuesCorruption) {
+  BlockBuilder builder(16, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       true /* separate_values */);
+  std::string value(100, 'v');
+  builder.Add(GenerateInternalKey(1, 0, 0, nullptr), value);
+  std::string rawblock = builder.Finish().ToString();
+  // Point the value slot, right after the 10 byte user key and the 8 byte
+  // footer of the only entry, past the values
+  const size_t slot = value.size() + 3 + 18;
+  ASSERT_EQ(0, rawblock[slot]);
+  rawblock[slot] = 1;
+
+  BlockContents contents;
+  contents.data = rawblock;
+  Block reader(std::move(contents));
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  iter->SeekToFirst();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsCorruption());
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
@@ -15,15 +15,15 @@ namespace ROCKSDB_NAMESPACE {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x3FFFFFFF
+const uint32_t kMaxNumRestarts = kDataBlockSeparatedValuesFlag - 1u;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x3FFFFFFF
+const uint32_t kNumRestartsMask = kDataBlockSeparatedValuesFlag - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts) {
+    uint32_t num_restarts, bool separated_values) {
   if (num_restarts > kMaxNumRestarts) {
     assert(0);  // mute travis "unused" warning
   }
@@ -34,6 +34,9 @@ uint32_t PackIndexTypeAndNumRestarts(
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
+  if (separated_values) {
+    block_footer |= kDataBlockSeparatedValuesFlag;
+  }
 
   return block_footer;
 }
@@ -41,7 +44,7 @@ uint32_t PackIndexTypeAndNumRestarts(
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts) {
+    uint32_t* num_restarts, bool* separated_values) {
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -54,6 +57,10 @@ void UnPackIndexTypeAndNumRestarts(
     *num_restarts = block_footer & kNumRestartsMask;
     assert(*num_restarts <= kMaxNumRestarts);
   }
+
+  if (separated_values) {
+    *separated_values = (block_footer & kDataBlockSeparatedValuesFlag) != 0;
+  }
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -13,13 +13,18 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// Set in the footer of data blocks that keep their values apart from the keys
+// (see BlockBasedTableOptions::separate_values_in_data_blocks). No block can
+// hold 2^30 restart points, so the bit is unambiguous for blocks of any size.
+const uint32_t kDataBlockSeparatedValuesFlag = 1u << 30;
+
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool separated_values = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* separated_values = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
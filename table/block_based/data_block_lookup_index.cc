@@ -0,0 +1,211 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/data_block_lookup_index.h"
+
+#include <algorithm>
+
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint32_t kSlotsPerBucket = 4;
+constexpr size_t kHandleSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t kFooterSize = 2 * sizeof(uint32_t) + 1;
+constexpr uint32_t kContinuedFlag = uint32_t{1} << 31;
+// Leave at least this many bits for the fingerprint
+constexpr int kMaxBlockBits = 24;
+constexpr double kLoadFactor = 0.85;
+constexpr int kMaxKicks = 500;
+constexpr int kMaxAttempts = 5;
+
+inline uint32_t Bucket1(uint64_t hash, uint32_t num_buckets) {
+  return FastRange32(Lower32of64(hash), num_buckets);
+}
+
+inline uint32_t Bucket2(uint64_t hash, uint32_t num_buckets) {
+  return FastRange32(Upper32of64(hash), num_buckets);
+}
+
+// Non-zero, so that an empty slot never matches
+inline uint32_t Fingerprint(uint64_t hash, int block_bits) {
+  uint32_t fp = static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15U) >>
+                                      (64 - (32 - block_bits)));
+  return fp == 0 ? 1 : fp;
+}
+
+inline uint64_t KeyHash(const Slice& user_key) {
+  return GetSliceHash64(user_key);
+}
+}  // namespace
+
+void DataBlockLookupIndexBuilder::Add(const Slice& user_key) {
+  if (!entries_.empty() && user_key == Slice(last_user_key_)) {
+    if (entries_.back().block != num_blocks_) {
+      // A lookup could not tell which of the blocks to start from
+      entries_.back().block = kSpanningKey;
+      if (continued_blocks_.empty() ||
+          continued_blocks_.back() != num_blocks_) {
+        continued_blocks_.push_back(num_blocks_);
+      }
+    }
+    return;
+  }
+  last_user_key_.assign(user_key.data(), user_key.size());
+  entries_.push_back({KeyHash(user_key), num_blocks_});
+}
+
+void DataBlockLookupIndexBuilder::AddBlockHandle(const BlockHandle& handle) {
+  PutFixed64(&handles_, handle.offset());
+  PutFixed32(&handles_, static_cast<uint32_t>(handle.size()));
+}
+
+bool DataBlockLookupIndexBuilder::Finish(std::string* buffer) {
+  const uint32_t num_blocks =
+      static_cast<uint32_t>(handles_.size() / kHandleSize);
+  if (num_blocks == 0 || num_blocks > (uint32_t{1} << kMaxBlockBits)) {
+    return false;
+  }
+  for (uint32_t block : continued_blocks_) {
+    if (block >= num_blocks) {
+      return false;
+    }
+    char* size = &handles_[block * kHandleSize + sizeof(uint64_t)];
+    EncodeFixed32(size, DecodeFixed32(size) | kContinuedFlag);
+  }
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [](const Entry& e) {
+                                  return e.block == kSpanningKey;
+                                }),
+                 entries_.end());
+  if (entries_.empty()) {
+    return false;
+  }
+  int block_bits = 1;
+  while ((uint32_t{1} << block_bits) < num_blocks) {
+    ++block_bits;
+  }
+
+  // Build with entry indexes (+1, so that 0 means empty), which lets
+  // evicted entries find their alternate bucket from the full hash.
+  uint32_t num_buckets = static_cast<uint32_t>(
+      entries_.size() / (kSlotsPerBucket * kLoadFactor) + 1);
+  std::vector<uint32_t> slots;
+  Random rnd(301);
+  bool built = false;
+  for (int attempt = 0; attempt < kMaxAttempts && !built; ++attempt) {
+    if (attempt > 0) {
+      num_buckets += num_buckets / 8 + 1;
+    }
+    slots.assign(size_t{num_buckets} * kSlotsPerBucket, 0);
+    built = true;
+    for (uint32_t i = 0; i < entries_.size() && built; ++i) {
+      uint32_t item = i + 1;
+      uint32_t bucket = Bucket1(entries_[i].hash, num_buckets);
+      for (int kick = 0; kick <= kMaxKicks; ++kick) {
+        const uint64_t hash = entries_[item - 1].hash;
+        const uint32_t alt = bucket == Bucket1(hash, num_buckets)
+                                 ? Bucket2(hash, num_buckets)
+                                 : Bucket1(hash, num_buckets);
+        uint32_t* free_slot = nullptr;
+        for (uint32_t b : {bucket, alt}) {
+          uint32_t* s = &slots[size_t{b} * kSlotsPerBucket];
+          for (uint32_t j = 0; j < kSlotsPerBucket && !free_slot; ++j) {
+            if (s[j] == 0) {
+              free_slot = &s[j];
+            }
+          }
+          if (free_slot) {
+            break;
+          }
+        }
+        if (free_slot) {
+          *free_slot = item;
+          item = 0;
+          break;
+        }
+        // Evict a random entry of the alternate bucket and move it on to its
+        // own alternate bucket
+        uint32_t& victim = slots[size_t{alt} * kSlotsPerBucket +
+                                 rnd.Uniform(kSlotsPerBucket)];
+        std::swap(item, victim);
+        bucket = alt;
+      }
+      built = item == 0;
+    }
+  }
+  if (!built) {
+    return false;
+  }
+
+  buffer->append(handles_);
+  for (uint32_t item : slots) {
+    uint32_t v = 0;
+    if (item != 0) {
+      const Entry& e = entries_[item - 1];
+      v = (Fingerprint(e.hash, block_bits) << block_bits) | e.block;
+    }
+    PutFixed32(buffer, v);
+  }
+  PutFixed32(buffer, num_blocks);
+  PutFixed32(buffer, num_buckets);
+  buffer->push_back(static_cast<char>(block_bits));
+  return true;
+}
+
+Status DataBlockLookupIndex::Initialize(const Slice& data) {
+  if (data.size() < kFooterSize) {
+    return Status::Corruption("Data block lookup index too small");
+  }
+  const char* footer = data.data() + data.size() - kFooterSize;
+  num_blocks_ = DecodeFixed32(footer);
+  num_buckets_ = DecodeFixed32(footer + sizeof(uint32_t));
+  block_bits_ = static_cast<uint8_t>(footer[2 * sizeof(uint32_t)]);
+  if (block_bits_ < 1 || block_bits_ > kMaxBlockBits || num_buckets_ == 0 ||
+      num_blocks_ > (uint32_t{1} << block_bits_) ||
+      data.size() != num_blocks_ * kHandleSize +
+                         size_t{num_buckets_} * kSlotsPerBucket *
+                             sizeof(uint32_t) +
+                         kFooterSize) {
+    return Status::Corruption("Malformed data block lookup index");
+  }
+  handles_ = data.data();
+  slots_ = handles_ + num_blocks_ * kHandleSize;
+  return Status::OK();
+}
+
+bool DataBlockLookupIndex::Lookup(const Slice& user_key,
+                                  uint32_t* block) const {
+  const uint64_t hash = KeyHash(user_key);
+  const uint32_t fp = Fingerprint(hash, block_bits_);
+  const uint32_t block_mask = (uint32_t{1} << block_bits_) - 1;
+  for (uint32_t b :
+       {Bucket1(hash, num_buckets_), Bucket2(hash, num_buckets_)}) {
+    const char* s = slots_ + size_t{b} * kSlotsPerBucket * sizeof(uint32_t);
+    for (uint32_t j = 0; j < kSlotsPerBucket; ++j) {
+      uint32_t v = DecodeFixed32(s + j * sizeof(uint32_t));
+      if ((v >> block_bits_) == fp && (v & block_mask) < num_blocks_) {
+        *block = v & block_mask;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+BlockHandle DataBlockLookupIndex::GetBlockHandle(uint32_t block,
+                                                 bool* continued) const {
+  assert(block < num_blocks_);
+  const char* p = handles_ + block * kHandleSize;
+  uint32_t size = DecodeFixed32(p + sizeof(uint64_t));
+  *continued = (size & kContinuedFlag) != 0;
+  return BlockHandle(DecodeFixed64(p), size & ~kContinuedFlag);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
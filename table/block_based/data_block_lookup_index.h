@@ -0,0 +1,98 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+// A per-file index from whole user keys to the data block holding them. It
+// lets BlockBasedTable::Get() go straight to the right data block instead of
+// binary searching the index block. It is built when
+// BlockBasedTableOptions::data_block_lookup_index is set and stored in the
+// "rocksdb.data_block_lookup_index" meta block.
+//
+// The index is a bucketized cuckoo hash table in which every key has two
+// candidate buckets of four slots. A slot packs a fingerprint of the key
+// with a data block number, so a lookup may return the wrong block with a
+// probability of about 8 / 2^(32 - block_bits); the caller has to verify the
+// result and fall back to the index block if the key is not there. User keys
+// whose entries span several data blocks are left out of the index.
+//
+// Format:
+//   block handles : num_blocks x (fixed64 offset, fixed32 size). The MSB of
+//                   the size is set if the block starts with the same user
+//                   key as the previous block ends with.
+//   slots         : num_buckets x kSlotsPerBucket x fixed32, 0 if empty,
+//                   otherwise fingerprint << block_bits | block number
+//   num_blocks    : fixed32
+//   num_buckets   : fixed32
+//   block_bits    : 1 byte
+class DataBlockLookupIndexBuilder {
+ public:
+  // Adds a user key of the current data block. Keys must be added in order.
+  void Add(const Slice& user_key);
+
+  // Starts a new data block for subsequent Add() calls.
+  void StartNewBlock() { ++num_blocks_; }
+
+  // Records the handle of the next data block written to the file. Blocks
+  // must be written in the order they were built.
+  void AddBlockHandle(const BlockHandle& handle);
+
+  // Appends the serialized index to *buffer. Returns false, leaving *buffer
+  // alone, if no index should be written for the file.
+  bool Finish(std::string* buffer);
+
+  size_t ApproximateMemoryUsage() const {
+    return entries_.capacity() * sizeof(Entry) + handles_.capacity();
+  }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    uint32_t block;
+  };
+  // Marks a key that spans several data blocks
+  static constexpr uint32_t kSpanningKey = UINT32_MAX;
+
+  std::vector<Entry> entries_;
+  std::string last_user_key_;
+  // Blocks that start with the same user key as the previous block ends with
+  std::vector<uint32_t> continued_blocks_;
+  std::string handles_;
+  uint32_t num_blocks_ = 0;
+};
+
+// Reader side of the data block lookup index. Does not own the serialized
+// index, which must outlive this object.
+class DataBlockLookupIndex {
+ public:
+  Status Initialize(const Slice& data);
+
+  // Returns false if `user_key` is definitely not in the index. Otherwise
+  // sets *block to the number of the data block that probably holds it.
+  bool Lookup(const Slice& user_key, uint32_t* block) const;
+
+  // REQUIRES: block < num_blocks()
+  BlockHandle GetBlockHandle(uint32_t block, bool* continued) const;
+
+  uint32_t num_blocks() const { return num_blocks_; }
+
+ private:
+  const char* handles_ = nullptr;
+  const char* slots_ = nullptr;
+  uint32_t num_blocks_ = 0;
+  uint32_t num_buckets_ = 0;
+  int block_bits_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,168 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/data_block_lookup_index.h"
+
+#include <string>
+
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::string Key(int i) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "key%08d", i);
+  return buf;
+}
+
+BlockHandle Handle(uint32_t block) {
+  return BlockHandle(uint64_t{block} * 5000, 4000 + block);
+}
+}  // namespace
+
+TEST(DataBlockLookupIndexTest, Basic) {
+  constexpr int kNumKeys = 100000;
+  constexpr int kKeysPerBlock = 37;
+  DataBlockLookupIndexBuilder builder;
+  uint32_t num_blocks = 0;
+  for (int i = 0; i < kNumKeys; ++i) {
+    if (i > 0 && i % kKeysPerBlock == 0) {
+      builder.StartNewBlock();
+      builder.AddBlockHandle(Handle(num_blocks++));
+    }
+    builder.Add(Key(i));
+  }
+  builder.AddBlockHandle(Handle(num_blocks++));
+
+  std::string data;
+  ASSERT_TRUE(builder.Finish(&data));
+  DataBlockLookupIndex index;
+  ASSERT_OK(index.Initialize(data));
+  ASSERT_EQ(num_blocks, index.num_blocks());
+  // A little over 4 bytes per key
+  ASSERT_LT(data.size(), size_t{kNumKeys} * 6);
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    uint32_t block = 0;
+    ASSERT_TRUE(index.Lookup(Key(i), &block));
+    ASSERT_EQ(static_cast<uint32_t>(i / kKeysPerBlock), block);
+  }
+  for (uint32_t b = 0; b < num_blocks; ++b) {
+    bool continued = true;
+    BlockHandle handle = index.GetBlockHandle(b, &continued);
+    ASSERT_FALSE(continued);
+    ASSERT_EQ(Handle(b).offset(), handle.offset());
+    ASSERT_EQ(Handle(b).size(), handle.size());
+  }
+
+  int false_positives = 0;
+  for (int i = kNumKeys; i < 2 * kNumKeys; ++i) {
+    uint32_t block = 0;
+    if (index.Lookup(Key(i), &block)) {
+      ASSERT_LT(block, num_blocks);
+      ++false_positives;
+    }
+  }
+  // Expected about 8 / 2^(32 - 12) per lookup
+  ASSERT_LT(false_positives, 10);
+}
+
+TEST(DataBlockLookupIndexTest, SpanningKeys) {
+  DataBlockLookupIndexBuilder builder;
+  // Block 0: a b c   Block 1: c c d   Block 2: e   Block 3: e f
+  builder.Add("a");
+  builder.Add("b");
+  builder.Add("c");
+  builder.StartNewBlock();
+  builder.AddBlockHandle(Handle(0));
+  builder.Add("c");
+  builder.Add("c");
+  builder.Add("d");
+  builder.StartNewBlock();
+  builder.AddBlockHandle(Handle(1));
+  builder.Add("e");
+  builder.StartNewBlock();
+  builder.AddBlockHandle(Handle(2));
+  builder.Add("e");
+  builder.Add("f");
+  builder.AddBlockHandle(Handle(3));
+
+  std::string data;
+  ASSERT_TRUE(builder.Finish(&data));
+  DataBlockLookupIndex index;
+  ASSERT_OK(index.Initialize(data));
+  ASSERT_EQ(4U, index.num_blocks());
+
+  uint32_t block = 0;
+  ASSERT_TRUE(index.Lookup("a", &block));
+  ASSERT_EQ(0U, block);
+  ASSERT_TRUE(index.Lookup("d", &block));
+  ASSERT_EQ(1U, block);
+  ASSERT_TRUE(index.Lookup("f", &block));
+  ASSERT_EQ(3U, block);
+  // Keys spanning blocks are left out (modulo false positives, which are
+  // negligible for so few keys)
+  ASSERT_FALSE(index.Lookup("c", &block));
+  ASSERT_FALSE(index.Lookup("e", &block));
+
+  bool continued = false;
+  index.GetBlockHandle(0, &continued);
+  ASSERT_FALSE(continued);
+  index.GetBlockHandle(1, &continued);
+  ASSERT_TRUE(continued);
+  index.GetBlockHandle(2, &continued);
+  ASSERT_FALSE(continued);
+  BlockHandle handle = index.GetBlockHandle(3, &continued);
+  ASSERT_TRUE(continued);
+  ASSERT_EQ(Handle(3).size(), handle.size());
+}
+
+TEST(DataBlockLookupIndexTest, NoIndex) {
+  std::string data;
+  {
+    // No blocks
+    DataBlockLookupIndexBuilder builder;
+    ASSERT_FALSE(builder.Finish(&data));
+  }
+  {
+    // Only one key, spanning both blocks
+    DataBlockLookupIndexBuilder builder;
+    builder.Add("a");
+    builder.StartNewBlock();
+    builder.AddBlockHandle(Handle(0));
+    builder.Add("a");
+    builder.AddBlockHandle(Handle(1));
+    ASSERT_FALSE(builder.Finish(&data));
+  }
+  ASSERT_TRUE(data.empty());
+}
+
+TEST(DataBlockLookupIndexTest, Corruption) {
+  DataBlockLookupIndexBuilder builder;
+  for (int i = 0; i < 100; ++i) {
+    builder.Add(Key(i));
+  }
+  builder.AddBlockHandle(Handle(0));
+  std::string data;
+  ASSERT_TRUE(builder.Finish(&data));
+
+  DataBlockLookupIndex index;
+  ASSERT_OK(index.Initialize(data));
+  for (size_t len = 0; len < data.size(); ++len) {
+    ASSERT_TRUE(index.Initialize(Slice(data.data(), len)).IsCorruption());
+  }
+  std::string bad_block_bits = data;
+  bad_block_bits.back() = 30;
+  ASSERT_TRUE(index.Initialize(bad_block_bits).IsCorruption());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/reader_common.h"
 
+#include "file/random_access_file_reader.h"
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/table.h"
 #include "table/format.h"
@@ -22,6 +23,10 @@ void ForceReleaseCachedEntry(void* arg, void* h) {
   cache->Release(handle, true /* force_erase */);
 }
 
+void ReleaseFileReaderRef(void* arg, void* /*h*/) {
+  delete reinterpret_cast<std::shared_ptr<RandomAccessFileReader>*>(arg);
+}
+
 // WART: this is specific to block-based table
 Status VerifyBlockChecksum(ChecksumType type, const char* data,
                            size_t block_size, const std::string& file_name,
@@ -15,6 +15,10 @@ namespace ROCKSDB_NAMESPACE {
 // Release the cached entry and decrement its ref count.
 extern void ForceReleaseCachedEntry(void* arg, void* h);
 
+// Delete a heap-allocated std::shared_ptr<RandomAccessFileReader>, dropping
+// the reference it holds on the file.
+extern void ReleaseFileReaderRef(void* arg, void* h);
+
 inline MemoryAllocator* GetMemoryAllocator(
     const BlockBasedTableOptions& table_options) {
   return table_options.block_cache.get()
@@ -0,0 +1,59 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/hot_key_ranges.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ROCKSDB_NAMESPACE {
+
+void HotKeyRanges::Add(const Slice& smallest, const Slice& largest) {
+  assert(ucmp_->Compare(smallest, largest) <= 0);
+  ranges_.push_back({smallest.ToString(), largest.ToString()});
+#ifndef NDEBUG
+  finished_ = false;
+#endif  // NDEBUG
+}
+
+void HotKeyRanges::Finish() {
+  std::sort(ranges_.begin(), ranges_.end(),
+            [this](const Range& a, const Range& b) {
+              return ucmp_->Compare(a.smallest, b.smallest) < 0;
+            });
+
+  // Merges overlapping ranges, so that the ranges are sorted by both their
+  // smallest and their largest keys
+  size_t merged = 0;
+  for (size_t i = 1; i < ranges_.size(); ++i) {
+    Range& last = ranges_[merged];
+    if (ucmp_->Compare(ranges_[i].smallest, last.largest) <= 0) {
+      if (ucmp_->Compare(ranges_[i].largest, last.largest) > 0) {
+        last.largest = std::move(ranges_[i].largest);
+      }
+    } else if (++merged != i) {
+      ranges_[merged] = std::move(ranges_[i]);
+    }
+  }
+  if (!ranges_.empty()) {
+    ranges_.resize(merged + 1);
+  }
+#ifndef NDEBUG
+  finished_ = true;
+#endif  // NDEBUG
+}
+
+bool HotKeyRanges::Overlaps(const Slice& smallest,
+                            const Slice& largest) const {
+  assert(finished_);
+  // The first range that does not end before `smallest`
+  auto it = std::lower_bound(ranges_.begin(), ranges_.end(), smallest,
+                             [this](const Range& range, const Slice& key) {
+                               return ucmp_->Compare(range.largest, key) < 0;
+                             });
+  return it != ranges_.end() && ucmp_->Compare(it->smallest, largest) <= 0;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,53 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A set of ranges of user keys that are read often, e.g. because the input
+// data blocks of a compaction that cover them were found in the block cache.
+// Used to decide which blocks to insert into the block cache while writing
+// the outputs of the compaction. Not thread-safe while being built; const
+// methods can be called concurrently once Finish() has been called.
+class HotKeyRanges {
+ public:
+  explicit HotKeyRanges(const Comparator* ucmp) : ucmp_(ucmp) {}
+
+  // Adds the user keys from `smallest` to `largest`, both included.
+  void Add(const Slice& smallest, const Slice& largest);
+
+  // Sorts and merges the ranges added so far.
+  void Finish();
+
+  bool empty() const { return ranges_.empty(); }
+
+  size_t size() const { return ranges_.size(); }
+
+  // Whether any of the user keys from `smallest` to `largest` is in one of
+  // the ranges.
+  // REQUIRES: Finish() has been called since the last Add()
+  bool Overlaps(const Slice& smallest, const Slice& largest) const;
+
+ private:
+  struct Range {
+    std::string smallest;
+    std::string largest;
+  };
+
+  const Comparator* ucmp_;
+  std::vector<Range> ranges_;
+#ifndef NDEBUG
+  bool finished_ = true;
+#endif  // NDEBUG
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -25,6 +25,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class HotKeyRanges;
 class Slice;
 class Status;
 
@@ -39,13 +40,14 @@ struct TableReaderOptions {
       bool _force_direct_prefetch = false, int _level = -1,
       BlockCacheTracer* const _block_cache_tracer = nullptr,
       size_t _max_file_size_for_l0_meta_pin = 0,
-      const std::string& _cur_db_session_id = "", uint64_t _cur_file_num = 0)
+      const std::string& _cur_db_session_id = "", uint64_t _cur_file_num = 0,
+      uint64_t _tail_size = 0)
       : TableReaderOptions(
             _ioptions, _prefix_extractor, _env_options, _internal_comparator,
             _skip_filters, _immortal, _force_direct_prefetch, _level,
             0 /* _largest_seqno */, _block_cache_tracer,
-            _max_file_size_for_l0_meta_pin, _cur_db_session_id, _cur_file_num) {
-  }
+            _max_file_size_for_l0_meta_pin, _cur_db_session_id, _cur_file_num,
+            _tail_size) {}
 
   // @param skip_filters Disables loading/accessing the filter block
   TableReaderOptions(
@@ -57,7 +59,8 @@ struct TableReaderOptions {
       SequenceNumber _largest_seqno,
       BlockCacheTracer* const _block_cache_tracer,
       size_t _max_file_size_for_l0_meta_pin,
-      const std::string& _cur_db_session_id, uint64_t _cur_file_num)
+      const std::string& _cur_db_session_id, uint64_t _cur_file_num,
+      uint64_t _tail_size = 0)
       : ioptions(_ioptions),
         prefix_extractor(_prefix_extractor),
         env_options(_env_options),
@@ -70,7 +73,8 @@ struct TableReaderOptions {
         block_cache_tracer(_block_cache_tracer),
         max_file_size_for_l0_meta_pin(_max_file_size_for_l0_meta_pin),
         cur_db_session_id(_cur_db_session_id),
-        cur_file_num(_cur_file_num) {}
+        cur_file_num(_cur_file_num),
+        tail_size(_tail_size) {}
 
   const ImmutableOptions& ioptions;
   const std::shared_ptr<const SliceTransform>& prefix_extractor;
@@ -97,6 +101,10 @@ struct TableReaderOptions {
   std::string cur_db_session_id;
 
   uint64_t cur_file_num;
+
+  // Size of the end of the file following the data blocks, as recorded in
+  // the MANIFEST (can be zero when unknown)
+  uint64_t tail_size;
 };
 
 struct TableBuilderOptions {
@@ -157,6 +165,10 @@ struct TableBuilderOptions {
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
   const uint64_t cur_file_num;
+  // Set by compactions when the table options ask for warming the block cache
+  // with the data blocks covering these key ranges. Not owned, and must
+  // outlive the builder.
+  const HotKeyRanges* hot_key_ranges = nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -210,6 +222,11 @@ class TableBuilder {
   // is enabled.
   virtual uint64_t EstimatedFileSize() const { return FileSize(); }
 
+  // Size of the end of the file that follows the data blocks, which table
+  // readers read when opening the file. 0 if unknown.
+  // REQUIRES: Finish() has been called and returned OK.
+  virtual uint64_t GetTailSize() const { return 0; }
+
   // If the user defined table properties collector suggest the file to
   // be further compacted.
   virtual bool NeedCompact() const { return false; }
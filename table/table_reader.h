@@ -9,6 +9,9 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include <vector>
+
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/slice_transform.h"
 #include "table/get_context.h"
@@ -82,6 +85,40 @@ class TableReader {
   virtual uint64_t ApproximateSize(const Slice& start, const Slice& end,
                                    TableReaderCaller caller) = 0;
 
+  // A user key sampled from the table, with the approximate size of the data
+  // between the previous anchor (or the start of the table) and it.
+  struct Anchor {
+    Anchor(const Slice& _user_key, uint64_t _range_size)
+        : user_key(_user_key.ToString()), range_size(_range_size) {}
+    std::string user_key;
+    uint64_t range_size;
+  };
+
+  // Appends to `*anchors` a bounded number of user keys that split the table
+  // into ranges of roughly equal size, in key order. The last anchor is at or
+  // after the largest key of the table. Used to plan subcompactions.
+  virtual Status ApproximateKeyAnchors(const ReadOptions& /*read_options*/,
+                                       std::vector<Anchor>* /*anchors*/) {
+    return Status::NotSupported("ApproximateKeyAnchors() not supported.");
+  }
+
+  // A range of user keys covered by consecutive data blocks. An empty
+  // `smallest` stands for the start of the table.
+  struct KeyRange {
+    KeyRange(const Slice& _smallest, const Slice& _largest)
+        : smallest(_smallest.ToString()), largest(_largest.ToString()) {}
+    std::string smallest;
+    std::string largest;
+  };
+
+  // Appends to `*ranges` the ranges of user keys covered by the data blocks
+  // that are currently in the block cache, in key order. Used to find the
+  // hot key ranges of compaction inputs.
+  virtual Status GetCachedKeyRanges(const ReadOptions& /*read_options*/,
+                                    std::vector<KeyRange>* /*ranges*/) {
+    return Status::NotSupported("GetCachedKeyRanges() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -3939,6 +3939,49 @@ TEST_F(GeneralTableTest, ApproximateOffsetOfPlain) {
   c.ResetTableReader();
 }
 
+TEST_F(GeneralTableTest, ApproximateKeyAnchors) {
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key_ */);
+  char buf[16];
+  for (int i = 0; i < 2000; i++) {
+    snprintf(buf, sizeof(buf), "k%05d", i);
+    c.Add(buf, rnd.RandomString(i % 2 == 0 ? 100 : 1000));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  Options options;
+  options.db_host_id = "";
+  test::PlainInternalKeyComparator internal_comparator(options.comparator);
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  const ImmutableOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  c.Finish(options, ioptions, moptions, table_options, internal_comparator,
+           &keys, &kvmap);
+
+  std::vector<TableReader::Anchor> anchors;
+  ASSERT_OK(c.GetTableReader()->ApproximateKeyAnchors(ReadOptions(),
+                                                      &anchors));
+  // About 1100 data blocks, sampled down to at most 128 anchors
+  ASSERT_GT(anchors.size(), 64U);
+  ASSERT_LE(anchors.size(), 128U);
+  uint64_t total_size = 0;
+  for (size_t i = 0; i < anchors.size(); i++) {
+    if (i > 0) {
+      ASSERT_LT(anchors[i - 1].user_key, anchors[i].user_key);
+    }
+    // Each anchor covers the same number of blocks, except the last one
+    if (i + 1 < anchors.size()) {
+      ASSERT_TRUE(Between(anchors[i].range_size, 8000, 20000));
+    }
+    total_size += anchors[i].range_size;
+  }
+  ASSERT_GE(anchors.back().user_key, "k01999");
+  ASSERT_TRUE(Between(total_size, 1000000, 1300000));
+  c.ResetTableReader();
+}
+
 static void DoCompressionTest(CompressionType comp) {
   Random rnd(301);
   TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key_ */);
@@ -0,0 +1,79 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <signal.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "rocksdb/utilities/local_compaction_service.h"
+#include "util/gflags_compat.h"
+
+// Serves the compaction jobs of DBs configured with a LocalCompactionService
+// listening on the same socket, until SIGTERM or SIGINT.
+
+DEFINE_string(socket_path, "", "The Unix domain socket to listen on.");
+DEFINE_int32(max_jobs, 1, "Maximum number of jobs to run at a time.");
+DEFINE_bool(fork_jobs, true,
+            "Run each job in a process of its own instead of on a thread.");
+DEFINE_string(cgroup_path, "",
+              "A cgroup v2 directory to move the job processes to.");
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+using GFLAGS_NAMESPACE::SetUsageMessage;
+
+static ROCKSDB_NAMESPACE::LocalCompactionWorker* worker = nullptr;
+
+static void HandleSignal(int /*sig*/) { worker->Shutdown(); }
+
+int main(int argc, char** argv) {
+  SetUsageMessage(std::string("\nUSAGE:\n") + std::string(argv[0]) +
+                  " --socket_path=<path> [OPTIONS]...");
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  ROCKSDB_NAMESPACE::LocalCompactionWorkerOptions options;
+  options.socket_path = FLAGS_socket_path;
+  options.max_jobs = FLAGS_max_jobs;
+  options.fork_jobs = FLAGS_fork_jobs;
+  options.cgroup_path = FLAGS_cgroup_path;
+
+  std::unique_ptr<ROCKSDB_NAMESPACE::LocalCompactionWorker> owned_worker;
+  ROCKSDB_NAMESPACE::Status s =
+      ROCKSDB_NAMESPACE::LocalCompactionWorker::Create(options, &owned_worker);
+  if (!s.ok()) {
+    fprintf(stderr, "%s\n", s.ToString().c_str());
+    return 1;
+  }
+  worker = owned_worker.get();
+  signal(SIGTERM, HandleSignal);
+  signal(SIGINT, HandleSignal);
+
+  s = worker->Run();
+  if (!s.ok()) {
+    fprintf(stderr, "%s\n", s.ToString().c_str());
+    return 1;
+  }
+  return 0;
+}
+
+#endif  // GFLAGS
+
+#else  // ROCKSDB_LITE
+#include <stdio.h>
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr, "Not supported in lite mode.\n");
+  return 1;
+}
+#endif  // ROCKSDB_LITE
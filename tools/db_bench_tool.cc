@@ -519,6 +519,14 @@ DEFINE_int32(compaction_pri,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_pri,
              "priority of files to compaction: by size or by data age");
 
+DEFINE_string(sst_partitioner_factory, "",
+              "The SstPartitionerFactory to use, e.g. "
+              "\"id=SstPartitionerNextLevelBoundaryFactory;"
+              "min_file_size=16777216\" to cut compaction outputs at the file "
+              "boundaries of the next level. The W-Amp column of the "
+              "compaction stats, printed by the stats benchmark, shows the "
+              "effect per level.");
+
 DEFINE_int32(universal_size_ratio, 0,
              "Percentage flexibility while comparing file size"
              " (for universal compaction only).");
@@ -636,8 +644,9 @@ DEFINE_bool(block_align,
             "Align data blocks on page size");
 
 DEFINE_int64(prepopulate_block_cache, 0,
-             "Pre-populate hot/warm blocks in block cache. 0 to disable and 1 "
-             "to insert during flush");
+             "Pre-populate hot/warm blocks in block cache. 0 to disable, 1 "
+             "to insert during flush, and 2 to also insert the data blocks "
+             "of hot key ranges during compaction");
 
 DEFINE_bool(use_data_block_hash_index, false,
             "if use kDataBlockBinaryAndHash "
@@ -649,6 +658,16 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_lookup_index,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().data_block_lookup_index,
+            "If true, build a whole-key data block lookup index per file so "
+            "that point lookups can skip the index block search");
+
+DEFINE_bool(separate_values_in_data_blocks,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .separate_values_in_data_blocks,
+            "If true, store values apart from the keys in data blocks");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -670,6 +689,20 @@ DEFINE_bool(new_table_reader_for_compaction_inputs, true,
 
 DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
+DEFINE_int32(max_compaction_input_threads,
+             ROCKSDB_NAMESPACE::Options().max_compaction_input_threads,
+             "Maximum number of threads a compaction uses to read its input "
+             "files ahead of merging them");
+
+DEFINE_int32(max_wal_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().max_wal_recovery_threads,
+             "Number of threads replaying the WALs when opening the DB");
+
+DEFINE_int32(max_manifest_space_amp_pct,
+             ROCKSDB_NAMESPACE::Options().max_manifest_space_amp_pct,
+             "Roll the MANIFEST over once its edits exceed this percentage of "
+             "the size of the snapshot at its start");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
@@ -764,6 +797,9 @@ DEFINE_bool(disable_wal, false, "If true, do not write WAL for write.");
 DEFINE_bool(manual_wal_flush, false,
             "If true, buffer WAL until buffer is full or a manual FlushWAL().");
 
+DEFINE_string(wal_compression, "none",
+              "Algorithm to use for WAL compression. none to disable.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -853,6 +889,16 @@ DEFINE_bool(force_consistency_checks,
             "Runs consistency checks on the LSM every time a change is "
             "applied.");
 
+DEFINE_uint32(max_flush_partitions,
+              ROCKSDB_NAMESPACE::Options().max_flush_partitions,
+              "Maximum number of L0 files, covering disjoint key ranges, that "
+              "a flush writes concurrently.");
+
+DEFINE_bool(flush_to_deepest_level,
+            ROCKSDB_NAMESPACE::Options().flush_to_deepest_level,
+            "Add flush outputs to the deepest level they do not overlap "
+            "instead of L0.");
+
 DEFINE_bool(check_flush_compaction_key_order,
             ROCKSDB_NAMESPACE::Options().check_flush_compaction_key_order,
             "During flush or compaction, check whether keys inserted to "
@@ -1026,6 +1072,13 @@ DEFINE_uint64(blob_compaction_readahead_size,
                   .blob_compaction_readahead_size,
               "[Integrated BlobDB] Compaction readahead for blob files.");
 
+DEFINE_uint64(blob_garbage_collection_batch_size,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_batch_size,
+              "[Integrated BlobDB] The number of bytes of blobs read at once "
+              "by garbage collection during compaction; 0 reads them one at a "
+              "time.");
+
 #ifndef ROCKSDB_LITE
 
 // Secondary DB instance Options
@@ -1077,6 +1130,10 @@ DEFINE_bool(adaptive_readahead, false,
             "carry forward internal auto readahead size from one file to next "
             "file at each level during iteration");
 
+DEFINE_bool(keys_only, false,
+            "Set ReadOptions::keys_only for readseq and readreverse, which "
+            "then do not read the values through the DB iterator");
+
 static enum ROCKSDB_NAMESPACE::CompressionType StringToCompressionType(
     const char* ctype) {
   assert(ctype);
@@ -1097,6 +1154,8 @@ static enum ROCKSDB_NAMESPACE::CompressionType StringToCompressionType(
     return ROCKSDB_NAMESPACE::kXpressCompression;
   else if (!strcasecmp(ctype, "zstd"))
     return ROCKSDB_NAMESPACE::kZSTD;
+  else if (!strcasecmp(ctype, "fsst"))
+    return ROCKSDB_NAMESPACE::kFSSTCompression;
 
   fprintf(stdout, "Cannot parse compression type '%s'\n", ctype);
   return ROCKSDB_NAMESPACE::kSnappyCompression;  // default value
@@ -1229,6 +1288,10 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
               "Limited bytes allowed to DB when soft_rate_limit or "
               "level0_slowdown_writes_trigger triggers");
 
+DEFINE_bool(smooth_write_stalls,
+            ROCKSDB_NAMESPACE::Options().smooth_write_stalls,
+            "Delay writes at a rate following the write stall pressure");
+
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
@@ -1400,6 +1463,13 @@ DEFINE_bool(use_direct_io_for_flush_and_compaction,
             ROCKSDB_NAMESPACE::Options().use_direct_io_for_flush_and_compaction,
             "Use O_DIRECT for background flush and compaction writes");
 
+DEFINE_bool(use_direct_io_for_wal,
+            ROCKSDB_NAMESPACE::Options().use_direct_io_for_wal,
+            "Use O_DIRECT for WAL writes");
+
+DEFINE_bool(wal_zero_fill, ROCKSDB_NAMESPACE::Options().wal_zero_fill,
+            "Fill new WAL files with zeros up to their preallocation size");
+
 DEFINE_bool(advise_random_on_open,
             ROCKSDB_NAMESPACE::Options().advise_random_on_open,
             "Advise random access on table file open");
@@ -1426,6 +1496,11 @@ DEFINE_uint64(wal_bytes_per_sync,
               " being written, in the background. Issue one request for every"
               " wal_bytes_per_sync written. 0 turns it off.");
 
+DEFINE_uint64(max_unsynced_wal_bytes,
+              ROCKSDB_NAMESPACE::Options().max_unsynced_wal_bytes,
+              "Sync the WAL in the background once this many bytes were"
+              " written to it without a sync. 0 turns it off.");
+
 DEFINE_bool(use_single_deletes, true,
             "Use single deletes (used in RandomReplaceKeys only).");
 
@@ -4073,7 +4148,11 @@ class Benchmark {
     options.use_direct_reads = FLAGS_use_direct_reads;
     options.use_direct_io_for_flush_and_compaction =
         FLAGS_use_direct_io_for_flush_and_compaction;
+    options.use_direct_io_for_wal = FLAGS_use_direct_io_for_wal;
+    options.wal_zero_fill = FLAGS_wal_zero_fill;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
+    options.wal_compression =
+        StringToCompressionType(FLAGS_wal_compression.c_str());
 #ifndef ROCKSDB_LITE
     options.ttl = FLAGS_fifo_compaction_ttl;
     options.compaction_options_fifo = CompactionOptionsFIFO(
@@ -4108,6 +4187,9 @@ class Benchmark {
     options.new_table_reader_for_compaction_inputs =
         FLAGS_new_table_reader_for_compaction_inputs;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.max_compaction_input_threads = FLAGS_max_compaction_input_threads;
+    options.max_wal_recovery_threads = FLAGS_max_wal_recovery_threads;
+    options.max_manifest_space_amp_pct = FLAGS_max_manifest_space_amp_pct;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4269,6 +4351,10 @@ class Benchmark {
           prepopulate_block_cache =
               BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly;
           break;
+        case 2:
+          prepopulate_block_cache = BlockBasedTableOptions::
+              PrepopulateBlockCache::kFlushAndHotCompaction;
+          break;
         default:
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
@@ -4282,6 +4368,10 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_lookup_index =
+          FLAGS_data_block_lookup_index;
+      block_based_options.separate_values_in_data_blocks =
+          FLAGS_separate_values_in_data_blocks;
       if (FLAGS_read_cache_path != "") {
 #ifndef ROCKSDB_LITE
         Status rc_status;
@@ -4367,6 +4457,7 @@ class Benchmark {
     options.hard_pending_compaction_bytes_limit =
         FLAGS_hard_pending_compaction_bytes_limit;
     options.delayed_write_rate = FLAGS_delayed_write_rate;
+    options.smooth_write_stalls = FLAGS_smooth_write_stalls;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
     options.experimental_mempurge_threshold =
@@ -4389,6 +4480,8 @@ class Benchmark {
     options.force_consistency_checks = FLAGS_force_consistency_checks;
     options.check_flush_compaction_key_order =
         FLAGS_check_flush_compaction_key_order;
+    options.max_flush_partitions = FLAGS_max_flush_partitions;
+    options.flush_to_deepest_level = FLAGS_flush_to_deepest_level;
     options.periodic_compaction_seconds = FLAGS_periodic_compaction_seconds;
     options.ttl = FLAGS_ttl_seconds;
     // fill storage options
@@ -4397,6 +4490,7 @@ class Benchmark {
     options.use_adaptive_mutex = FLAGS_use_adaptive_mutex;
     options.bytes_per_sync = FLAGS_bytes_per_sync;
     options.wal_bytes_per_sync = FLAGS_wal_bytes_per_sync;
+    options.max_unsynced_wal_bytes = FLAGS_max_unsynced_wal_bytes;
 
     // merge operator options
     if (!FLAGS_merge_operator.empty()) {
@@ -4411,6 +4505,17 @@ class Benchmark {
     options.max_successive_merges = FLAGS_max_successive_merges;
     options.report_bg_io_stats = FLAGS_report_bg_io_stats;
 
+    if (!FLAGS_sst_partitioner_factory.empty()) {
+      s = SstPartitionerFactory::CreateFromString(
+          config_options, FLAGS_sst_partitioner_factory,
+          &options.sst_partitioner_factory);
+      if (!s.ok()) {
+        fprintf(stderr, "invalid sst partitioner factory[%s]: %s\n",
+                FLAGS_sst_partitioner_factory.c_str(), s.ToString().c_str());
+        exit(1);
+      }
+    }
+
     // set universal style compaction configurations, if applicable
     if (FLAGS_universal_size_ratio != 0) {
       options.compaction_options_universal.size_ratio =
@@ -4465,6 +4570,8 @@ class Benchmark {
         FLAGS_blob_garbage_collection_force_threshold;
     options.blob_compaction_readahead_size =
         FLAGS_blob_compaction_readahead_size;
+    options.blob_garbage_collection_batch_size =
+        FLAGS_blob_garbage_collection_batch_size;
 
 #ifndef ROCKSDB_LITE
     if (FLAGS_readonly && FLAGS_transaction_db) {
@@ -5609,6 +5716,7 @@ class Benchmark {
     }
 
     options.adaptive_readahead = FLAGS_adaptive_readahead;
+    options.keys_only = FLAGS_keys_only;
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
     int64_t bytes = 0;
@@ -5705,6 +5813,7 @@ class Benchmark {
   void ReadReverse(ThreadState* thread, DB* db) {
     ReadOptions options(FLAGS_verify_checksum, true);
     options.adaptive_readahead = FLAGS_adaptive_readahead;
+    options.keys_only = FLAGS_keys_only;
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
     int64_t bytes = 0;
@@ -638,6 +638,8 @@ void LDBCommand::OverrideBaseCFOptions(ColumnFamilyOptions* cf_opts) {
       cf_opts->compression = kXpressCompression;
     } else if (comp == "zstd") {
       cf_opts->compression = kZSTD;
+    } else if (comp == "fsst") {
+      cf_opts->compression = kFSSTCompression;
     } else {
       // Unknown compression.
       exec_state_ =
@@ -25,7 +25,8 @@ static const std::vector<std::pair<CompressionType, const char*>>
         {CompressionType::kLZ4Compression, "kLZ4Compression"},
         {CompressionType::kLZ4HCCompression, "kLZ4HCCompression"},
         {CompressionType::kXpressCompression, "kXpressCompression"},
-        {CompressionType::kZSTD, "kZSTD"}};
+        {CompressionType::kZSTD, "kZSTD"},
+        {CompressionType::kFSSTCompression, "kFSSTCompression"}};
 
 namespace {
 
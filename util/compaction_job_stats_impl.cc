@@ -12,6 +12,7 @@ namespace ROCKSDB_NAMESPACE {
 void CompactionJobStats::Reset() {
   elapsed_micros = 0;
   cpu_micros = 0;
+  subcompaction_elapsed_micros.clear();
 
   num_input_records = 0;
   num_blobs_read = 0;
@@ -55,6 +56,10 @@ void CompactionJobStats::Reset() {
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
   elapsed_micros += stats.elapsed_micros;
   cpu_micros += stats.cpu_micros;
+  subcompaction_elapsed_micros.insert(
+      subcompaction_elapsed_micros.end(),
+      stats.subcompaction_elapsed_micros.begin(),
+      stats.subcompaction_elapsed_micros.end());
 
   num_input_records += stats.num_input_records;
   num_blobs_read += stats.num_blobs_read;
@@ -0,0 +1,167 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+class ZSTDStreamingCompress final : public StreamingCompress {
+ public:
+  ZSTDStreamingCompress(const CompressionOptions& opts, size_t max_output_len)
+      : StreamingCompress(opts, max_output_len) {
+#ifdef ZSTD_STREAMING
+    cctx_ = ZSTD_createCCtx();
+    // The same level as for blocks (see ZSTD_Compress())
+    const int level =
+        opts_.level == CompressionOptions::kDefaultCompressionLevel
+            ? 3
+            : opts_.level;
+    ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level);
+    // Records are self-delimited by the log format
+    ZSTD_CCtx_setParameter(cctx_, ZSTD_c_checksumFlag, 0);
+#endif
+  }
+
+  ~ZSTDStreamingCompress() override {
+#ifdef ZSTD_STREAMING
+    ZSTD_freeCCtx(cctx_);
+#endif
+  }
+
+  int Compress(const char* input, size_t input_size, char* output,
+               size_t* output_pos) override {
+    assert(output != nullptr && output_pos != nullptr);
+    *output_pos = 0;
+#ifdef ZSTD_STREAMING
+    if (!in_progress_) {
+      input_buffer_ = {input, input_size, /*pos=*/0};
+    }
+    assert(input_buffer_.src == input && input_buffer_.size == input_size);
+    ZSTD_outBuffer output_buffer = {output, max_output_len_, /*pos=*/0};
+    const size_t remaining = ZSTD_compressStream2(cctx_, &output_buffer,
+                                                  &input_buffer_, ZSTD_e_flush);
+    if (ZSTD_isError(remaining)) {
+      Reset();
+      return -1;
+    }
+    *output_pos = output_buffer.pos;
+    in_progress_ = remaining > 0;
+    return static_cast<int>(std::min<size_t>(remaining, 1));
+#else
+    (void)input;
+    (void)input_size;
+    return -1;
+#endif
+  }
+
+  void Reset() override {
+#ifdef ZSTD_STREAMING
+    ZSTD_CCtx_reset(cctx_, ZSTD_reset_session_only);
+    input_buffer_ = {nullptr, 0, 0};
+    in_progress_ = false;
+#endif
+  }
+
+ private:
+#ifdef ZSTD_STREAMING
+  ZSTD_CCtx* cctx_;
+  ZSTD_inBuffer input_buffer_ = {nullptr, 0, 0};
+  // Whether the output of the current input is not fully flushed yet
+  bool in_progress_ = false;
+#endif
+};
+
+class ZSTDStreamingUncompress final : public StreamingUncompress {
+ public:
+  explicit ZSTDStreamingUncompress(size_t max_output_len)
+      : StreamingUncompress(max_output_len) {
+#ifdef ZSTD_STREAMING
+    dctx_ = ZSTD_createDCtx();
+#endif
+  }
+
+  ~ZSTDStreamingUncompress() override {
+#ifdef ZSTD_STREAMING
+    ZSTD_freeDCtx(dctx_);
+#endif
+  }
+
+  int Uncompress(const char* input, size_t input_size, char* output,
+                 size_t* output_pos) override {
+    assert(output != nullptr && output_pos != nullptr);
+    *output_pos = 0;
+#ifdef ZSTD_STREAMING
+    if (!in_progress_) {
+      input_buffer_ = {input, input_size, /*pos=*/0};
+    }
+    assert(input_buffer_.src == input && input_buffer_.size == input_size);
+    ZSTD_outBuffer output_buffer = {output, max_output_len_, /*pos=*/0};
+    const size_t ret =
+        ZSTD_decompressStream(dctx_, &output_buffer, &input_buffer_);
+    if (ZSTD_isError(ret)) {
+      Reset();
+      return -1;
+    }
+    *output_pos = output_buffer.pos;
+    // A full output buffer may leave output buffered in the context
+    in_progress_ = input_buffer_.pos < input_buffer_.size ||
+                   output_buffer.pos == max_output_len_;
+    return in_progress_ ? 1 : 0;
+#else
+    (void)input;
+    (void)input_size;
+    return -1;
+#endif
+  }
+
+  void Reset() override {
+#ifdef ZSTD_STREAMING
+    ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only);
+    input_buffer_ = {nullptr, 0, 0};
+    in_progress_ = false;
+#endif
+  }
+
+ private:
+#ifdef ZSTD_STREAMING
+  ZSTD_DCtx* dctx_;
+  ZSTD_inBuffer input_buffer_ = {nullptr, 0, 0};
+  // Whether the current input is not fully uncompressed yet
+  bool in_progress_ = false;
+#endif
+};
+
+}  // namespace
+
+StreamingCompress* StreamingCompress::Create(CompressionType compression_type,
+                                             const CompressionOptions& opts,
+                                             size_t max_output_len) {
+  switch (compression_type) {
+    case kZSTD:
+      if (!ZSTD_Streaming_Supported()) {
+        return nullptr;
+      }
+      return new ZSTDStreamingCompress(opts, max_output_len);
+    default:
+      return nullptr;
+  }
+}
+
+StreamingUncompress* StreamingUncompress::Create(
+    CompressionType compression_type, size_t max_output_len) {
+  switch (compression_type) {
+    case kZSTD:
+      if (!ZSTD_Streaming_Supported()) {
+        return nullptr;
+      }
+      return new ZSTDStreamingUncompress(max_output_len);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
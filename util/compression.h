@@ -26,6 +26,7 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/compression_context_cache.h"
+#include "util/fsst.h"
 #include "util/string_util.h"
 
 #ifdef SNAPPY
@@ -50,6 +51,11 @@
 #if ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
 #include <zdict.h>
 #endif  // ZSTD_VERSION_NUMBER >= 10103
+// ZSTD_compressStream2() and the advanced parameter API are stable since
+// v1.4.0
+#if ZSTD_VERSION_NUMBER >= 10400  // v1.4.0+
+#define ZSTD_STREAMING
+#endif  // ZSTD_VERSION_NUMBER >= 10400
 namespace ROCKSDB_NAMESPACE {
 // Need this for the context allocation override
 // On windows we need to do this explicitly
@@ -514,6 +520,19 @@ inline bool ZSTDNotFinal_Supported() {
 #endif
 }
 
+inline bool ZSTD_Streaming_Supported() {
+#if defined(ZSTD) && defined(ZSTD_STREAMING)
+  return true;
+#else
+  return false;
+#endif
+}
+
+inline bool FSST_Supported() {
+  // Implemented in-tree, so always available.
+  return true;
+}
+
 inline bool CompressionTypeSupported(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -534,12 +553,28 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
       return ZSTDNotFinal_Supported();
     case kZSTD:
       return ZSTD_Supported();
+    case kFSSTCompression:
+      return FSST_Supported();
     default:
       assert(false);
       return false;
   }
 }
 
+// Whether `compression_type` can compress a stream of records with
+// StreamingCompress, as the WAL does
+inline bool StreamingCompressionTypeSupported(
+    CompressionType compression_type) {
+  switch (compression_type) {
+    case kNoCompression:
+      return true;
+    case kZSTD:
+      return ZSTD_Streaming_Supported();
+    default:
+      return false;
+  }
+}
+
 inline bool DictCompressionTypeSupported(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -571,6 +606,8 @@ inline bool DictCompressionTypeSupported(CompressionType compression_type) {
 #else
       return false;
 #endif
+    case kFSSTCompression:
+      return FSST_Supported();
     default:
       assert(false);
       return false;
@@ -597,6 +634,8 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
       return "ZSTD";
     case kZSTDNotFinalCompression:
       return "ZSTDNotFinal";
+    case kFSSTCompression:
+      return "FSST";
     case kDisableCompressionOption:
       return "DisableOption";
     default:
@@ -1459,6 +1498,39 @@ inline std::string ZSTD_TrainDictionary(const std::string& samples,
 #endif  // ZSTD_VERSION_NUMBER >= 10103
 }
 
+// The decompressed size is always included in the block header in varint32
+// format, independent of compress_format_version, since the format postdates
+// version 1.
+// @param compression_dict Symbol table trained by fsst::TrainSymbolTable().
+inline bool FSST_Compress(const CompressionInfo& info, const char* input,
+                          size_t length, ::std::string* output) {
+  if (length > std::numeric_limits<uint32_t>::max()) {
+    // Can't compress more than 4GB
+    return false;
+  }
+  compression::PutDecompressedSizeInfo(output, static_cast<uint32_t>(length));
+  return fsst::Compress(input, length, info.dict().GetRawDict(), output);
+}
+
+inline CacheAllocationPtr FSST_Uncompress(const UncompressionInfo& info,
+                                          const char* input_data,
+                                          size_t input_length,
+                                          size_t* uncompressed_size,
+                                          MemoryAllocator* allocator = nullptr) {
+  uint32_t output_len = 0;
+  if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
+                                            &output_len)) {
+    return nullptr;
+  }
+  auto output = AllocateBlock(output_len, allocator);
+  if (!fsst::Decompress(input_data, input_length, info.dict().GetRawDict(),
+                        output.get(), output_len)) {
+    return nullptr;
+  }
+  *uncompressed_size = output_len;
+  return output;
+}
+
 inline bool CompressData(const Slice& raw,
                          const CompressionInfo& compression_info,
                          uint32_t compress_format_version,
@@ -1496,6 +1568,10 @@ inline bool CompressData(const Slice& raw,
       ret = ZSTD_Compress(compression_info, raw.data(), raw.size(),
                           compressed_output);
       break;
+    case kFSSTCompression:
+      ret = FSST_Compress(compression_info, raw.data(), raw.size(),
+                          compressed_output);
+      break;
     default:
       // Do not recognize this compression type
       break;
@@ -1532,9 +1608,105 @@ inline CacheAllocationPtr UncompressData(
     case kZSTDNotFinalCompression:
       return ZSTD_Uncompress(uncompression_info, data, n, uncompressed_size,
                              allocator);
+    case kFSSTCompression:
+      return FSST_Uncompress(uncompression_info, data, n, uncompressed_size,
+                             allocator);
     default:
       return CacheAllocationPtr();
   }
 }
 
+// The payload of the record setting the compression type of the records
+// following it in a log file
+class CompressionTypeRecord {
+ public:
+  explicit CompressionTypeRecord(CompressionType compression_type)
+      : compression_type_(compression_type) {}
+
+  CompressionType GetCompressionType() const { return compression_type_; }
+
+  void EncodeTo(std::string* dst) const {
+    assert(dst != nullptr);
+    PutFixed32(dst, compression_type_);
+  }
+
+  Status DecodeFrom(Slice* src) {
+    uint32_t val;
+    if (!GetFixed32(src, &val)) {
+      return Status::Corruption("Error decoding WAL compression type");
+    }
+    const CompressionType compression_type =
+        static_cast<CompressionType>(val);
+    if (!StreamingCompressionTypeSupported(compression_type)) {
+      return Status::NotSupported("WAL compression type not supported: " +
+                                  CompressionTypeToString(compression_type));
+    }
+    compression_type_ = compression_type;
+    return Status::OK();
+  }
+
+ private:
+  CompressionType compression_type_;
+};
+
+// Compresses a stream of records. The history of the stream is kept across
+// records, so that each record is compressed against the ones before it,
+// and each record is flushed, so that it can be uncompressed as soon as it
+// is read, given the records before it.
+class StreamingCompress {
+ public:
+  virtual ~StreamingCompress() = default;
+
+  // Compresses `input` into `output`, up to the `max_output_len` given at
+  // creation at a time, and sets `*output_pos` to the size of the output.
+  // Returns a positive value if more output is pending, in which case it
+  // must be called again with the same input, 0 once the input is fully
+  // compressed and flushed, and a negative value on error.
+  virtual int Compress(const char* input, size_t input_size, char* output,
+                       size_t* output_pos) = 0;
+
+  // Discards the history of the stream
+  virtual void Reset() = 0;
+
+  // Returns nullptr if `compression_type` does not support streaming (see
+  // StreamingCompressionTypeSupported())
+  static StreamingCompress* Create(CompressionType compression_type,
+                                   const CompressionOptions& opts,
+                                   size_t max_output_len);
+
+ protected:
+  StreamingCompress(const CompressionOptions& opts, size_t max_output_len)
+      : opts_(opts), max_output_len_(max_output_len) {}
+
+  const CompressionOptions opts_;
+  const size_t max_output_len_;
+};
+
+// Uncompresses a stream written by StreamingCompress, a record at a time
+class StreamingUncompress {
+ public:
+  virtual ~StreamingUncompress() = default;
+
+  // Uncompresses `input` into `output`, up to the `max_output_len` given at
+  // creation at a time, and sets `*output_pos` to the size of the output.
+  // Returns a positive value if more output is pending, in which case it
+  // must be called again with the same input, 0 once the input is fully
+  // uncompressed, and a negative value on error.
+  virtual int Uncompress(const char* input, size_t input_size, char* output,
+                         size_t* output_pos) = 0;
+
+  // Discards the history of the stream
+  virtual void Reset() = 0;
+
+  // Returns nullptr if `compression_type` does not support streaming
+  static StreamingUncompress* Create(CompressionType compression_type,
+                                     size_t max_output_len);
+
+ protected:
+  explicit StreamingUncompress(size_t max_output_len)
+      : max_output_len_(max_output_len) {}
+
+  const size_t max_output_len_;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -8,7 +8,12 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "util/concurrent_task_limiter_impl.h"
+
+#include <algorithm>
+
 #include "rocksdb/concurrent_task_limiter.h"
+#include "rocksdb/system_clock.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -54,14 +59,138 @@ std::unique_ptr<TaskLimiterToken> ConcurrentTaskLimiterImpl::GetToken(
   return nullptr;
 }
 
+void ConcurrentTaskLimiterImpl::ReleaseToken(TaskLimiterToken* /*token*/) {
+  --outstanding_tasks_;
+  assert(outstanding_tasks_ >= 0);
+}
+
+CostAwareConcurrentTaskLimiterImpl::CostAwareConcurrentTaskLimiterImpl(
+    const std::string& name, int32_t max_outstanding_task,
+    std::shared_ptr<RateLimiter> rate_limiter, uint64_t max_inflight_seconds,
+    SystemClock* clock)
+    : ConcurrentTaskLimiterImpl(name, max_outstanding_task),
+      rate_limiter_(std::move(rate_limiter)),
+      max_inflight_seconds_(max_inflight_seconds),
+      clock_(clock) {
+  assert(clock_ != nullptr);
+}
+
+double CostAwareConcurrentTaskLimiterImpl::GetPriority(
+    const TaskCostEstimate& estimate) const {
+  uint64_t io_bytes_per_sec = kDefaultIOBytesPerSecond;
+  if (rate_limiter_ != nullptr) {
+    io_bytes_per_sec = static_cast<uint64_t>(
+        std::max<int64_t>(rate_limiter_->GetBytesPerSecond(), 1));
+  }
+  // I/O and CPU overlap, so the task takes about as long as the larger of
+  // the two. The floor keeps tiny tasks from getting an infinite priority.
+  const double seconds = std::max(
+      {static_cast<double>(estimate.io_bytes) / io_bytes_per_sec,
+       static_cast<double>(estimate.cpu_micros) / 1000000, 0.001});
+  return (estimate.read_amp_reduction + estimate.space_amp_reduction) /
+         seconds;
+}
+
+void CostAwareConcurrentTaskLimiterImpl::EnqueueLocked(const void* requester,
+                                                       double priority,
+                                                       uint64_t now_micros) {
+  mutex_.AssertHeld();
+  for (auto it = waiters_.begin(); it != waiters_.end();) {
+    if (it->second.last_request_micros + kWaiterExpirationMicros <
+        now_micros) {
+      it = waiters_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  Waiter& waiter = waiters_[requester];
+  waiter.priority = priority;
+  waiter.last_request_micros = now_micros;
+}
+
+void CostAwareConcurrentTaskLimiterImpl::Enqueue(
+    const void* requester, const TaskCostEstimate& estimate) {
+  const double priority = GetPriority(estimate);
+  const uint64_t now_micros = clock_->NowMicros();
+  MutexLock l(&mutex_);
+  EnqueueLocked(requester, priority, now_micros);
+}
+
+std::unique_ptr<TaskLimiterToken> CostAwareConcurrentTaskLimiterImpl::GetToken(
+    bool force, const void* requester, const TaskCostEstimate& estimate) {
+  const double priority = GetPriority(estimate);
+  const uint64_t now_micros = clock_->NowMicros();
+  MutexLock l(&mutex_);
+  if (!force) {
+    EnqueueLocked(requester, priority, now_micros);
+
+    // The free slots go to the waiters with the highest priorities
+    const int32_t limit =
+        max_outstanding_tasks_.load(std::memory_order_relaxed);
+    if (limit >= 0) {
+      int32_t ahead = 0;
+      for (const auto& waiter : waiters_) {
+        if (waiter.first != requester && waiter.second.priority > priority) {
+          ++ahead;
+        }
+      }
+      if (outstanding_tasks_.load(std::memory_order_relaxed) + ahead >=
+          limit) {
+        return nullptr;
+      }
+    }
+
+    // Bound the bytes of the running tasks to what the rate limiter lets
+    // through in max_inflight_seconds_, so that they do not all crawl at a
+    // fraction of the rate. A task reducing read amplification waiting for
+    // the budget asks the rate limiter to speed up.
+    if (rate_limiter_ != nullptr && inflight_bytes_ > 0) {
+      const uint64_t budget =
+          static_cast<uint64_t>(
+              std::max<int64_t>(rate_limiter_->GetBytesPerSecond(), 0)) *
+          max_inflight_seconds_;
+      if (inflight_bytes_ + estimate.io_bytes > budget) {
+        if (estimate.read_amp_reduction > 0) {
+          rate_limiter_->PaceUp(false /* critical */);
+        }
+        return nullptr;
+      }
+    }
+    waiters_.erase(requester);
+  }
+  ++outstanding_tasks_;
+  inflight_bytes_ += estimate.io_bytes;
+  return std::unique_ptr<TaskLimiterToken>(
+      new TaskLimiterToken(this, estimate.io_bytes));
+}
+
+void CostAwareConcurrentTaskLimiterImpl::ReleaseToken(TaskLimiterToken* token) {
+  {
+    MutexLock l(&mutex_);
+    assert(inflight_bytes_ >= token->io_bytes());
+    inflight_bytes_ -= token->io_bytes();
+  }
+  ConcurrentTaskLimiterImpl::ReleaseToken(token);
+}
+
+uint64_t CostAwareConcurrentTaskLimiterImpl::TEST_GetInflightBytes() const {
+  MutexLock l(&mutex_);
+  return inflight_bytes_;
+}
+
 ConcurrentTaskLimiter* NewConcurrentTaskLimiter(
     const std::string& name, int32_t limit) {
   return new ConcurrentTaskLimiterImpl(name, limit);
 }
 
-TaskLimiterToken::~TaskLimiterToken() {
-  --limiter_->outstanding_tasks_;
-  assert(limiter_->outstanding_tasks_ >= 0);
+ConcurrentTaskLimiter* NewCostAwareConcurrentTaskLimiter(
+    const std::string& name, int32_t limit,
+    std::shared_ptr<RateLimiter> rate_limiter, uint64_t max_inflight_seconds) {
+  return new CostAwareConcurrentTaskLimiterImpl(
+      name, limit, std::move(rate_limiter), max_inflight_seconds,
+      SystemClock::Default().get());
 }
 
+TaskLimiterToken::~TaskLimiterToken() { limiter_->ReleaseToken(this); }
+
 }  // namespace ROCKSDB_NAMESPACE
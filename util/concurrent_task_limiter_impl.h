@@ -10,14 +10,33 @@
 #pragma once
 #include <atomic>
 #include <memory>
+#include <unordered_map>
 
-#include "rocksdb/env.h"
+#include "port/port.h"
 #include "rocksdb/concurrent_task_limiter.h"
+#include "rocksdb/env.h"
+#include "rocksdb/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class SystemClock;
 class TaskLimiterToken;
 
+// The estimated cost and benefit of a task, a compaction, used by cost-aware
+// limiters to decide which of the waiting tasks gets a free slot.
+struct TaskCostEstimate {
+  // Bytes read and written by the task
+  uint64_t io_bytes = 0;
+  // CPU time of the task
+  uint64_t cpu_micros = 0;
+  // Expected reduction of the read amplification, in sorted runs a read
+  // has to go through
+  double read_amp_reduction = 0;
+  // Expected reduction of the space amplification, as a fraction of the live
+  // data size
+  double space_amp_reduction = 0;
+};
+
 class ConcurrentTaskLimiterImpl : public ConcurrentTaskLimiter {
  public:
   explicit ConcurrentTaskLimiterImpl(const std::string& name,
@@ -42,22 +61,105 @@ class ConcurrentTaskLimiterImpl : public ConcurrentTaskLimiter {
   // Returns nullptr if it got throttled.
   virtual std::unique_ptr<TaskLimiterToken> GetToken(bool force);
 
- private:
+  // Request token for adding a new task on behalf of `requester`, e.g. a
+  // column family, with the given estimate. Limiters that are not cost-aware
+  // ignore the requester and the estimate.
+  virtual std::unique_ptr<TaskLimiterToken> GetToken(
+      bool force, const void* /*requester*/,
+      const TaskCostEstimate& /*estimate*/) {
+    return GetToken(force);
+  }
+
+  // Records that `requester` waits for a token for a task with the given
+  // estimate, without requesting one.
+  virtual void Enqueue(const void* /*requester*/,
+                       const TaskCostEstimate& /*estimate*/) {}
+
+  // Whether the limiter takes task estimates into account. If not, there is
+  // no need to compute them.
+  virtual bool IsCostAware() const { return false; }
+
+ protected:
   friend class TaskLimiterToken;
 
+  // Called when `token` is destroyed
+  virtual void ReleaseToken(TaskLimiterToken* token);
+
   std::string name_;
   std::atomic<int32_t> max_outstanding_tasks_;
   std::atomic<int32_t> outstanding_tasks_;
 };
 
+// A limiter that grants free task slots to the waiting tasks with the highest
+// expected benefit per unit of cost, across all the column families and DB
+// instances sharing it. See NewCostAwareConcurrentTaskLimiter().
+class CostAwareConcurrentTaskLimiterImpl : public ConcurrentTaskLimiterImpl {
+ public:
+  CostAwareConcurrentTaskLimiterImpl(const std::string& name,
+                                     int32_t max_outstanding_task,
+                                     std::shared_ptr<RateLimiter> rate_limiter,
+                                     uint64_t max_inflight_seconds,
+                                     SystemClock* clock);
+
+  using ConcurrentTaskLimiterImpl::GetToken;
+  std::unique_ptr<TaskLimiterToken> GetToken(
+      bool force, const void* requester,
+      const TaskCostEstimate& estimate) override;
+
+  void Enqueue(const void* requester,
+               const TaskCostEstimate& estimate) override;
+
+  bool IsCostAware() const override { return true; }
+
+  // The benefit of a task with the given estimate per second of the time it
+  // is expected to take
+  double GetPriority(const TaskCostEstimate& estimate) const;
+
+  uint64_t TEST_GetInflightBytes() const;
+
+ protected:
+  void ReleaseToken(TaskLimiterToken* token) override;
+
+ private:
+  struct Waiter {
+    double priority;
+    // When the requester last asked for a token
+    uint64_t last_request_micros;
+  };
+
+  // Nominal I/O rate used to weigh I/O against CPU time without a rate
+  // limiter
+  static constexpr uint64_t kDefaultIOBytesPerSecond = 64 << 20;
+  // Throttled compactions are retried every 10 milliseconds, so a requester
+  // that has not asked for much longer has given up or found other work.
+  static constexpr uint64_t kWaiterExpirationMicros = 100 * 1000;
+
+  void EnqueueLocked(const void* requester, double priority,
+                     uint64_t now_micros);
+
+  const std::shared_ptr<RateLimiter> rate_limiter_;
+  const uint64_t max_inflight_seconds_;
+  SystemClock* const clock_;
+
+  mutable port::Mutex mutex_;
+  std::unordered_map<const void*, Waiter> waiters_;
+  // I/O bytes estimated for the tasks holding a token
+  uint64_t inflight_bytes_ = 0;
+};
+
 class TaskLimiterToken {
  public:
-  explicit TaskLimiterToken(ConcurrentTaskLimiterImpl* limiter)
-      : limiter_(limiter) {}
+  explicit TaskLimiterToken(ConcurrentTaskLimiterImpl* limiter,
+                            uint64_t io_bytes = 0)
+      : limiter_(limiter), io_bytes_(io_bytes) {}
   ~TaskLimiterToken();
 
+  // The estimated I/O bytes of the task holding the token
+  uint64_t io_bytes() const { return io_bytes_; }
+
  private:
   ConcurrentTaskLimiterImpl* limiter_;
+  const uint64_t io_bytes_;
 
   // no copying allowed
   TaskLimiterToken(const TaskLimiterToken&) = delete;
@@ -0,0 +1,132 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/concurrent_task_limiter_impl.h"
+
+#include <memory>
+
+#include "port/stack_trace.h"
+#include "rocksdb/rate_limiter.h"
+#include "test_util/mock_time_env.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class CostAwareConcurrentTaskLimiterTest : public testing::Test {
+ public:
+  CostAwareConcurrentTaskLimiterTest()
+      : clock_(std::make_shared<MockSystemClock>(SystemClock::Default())) {}
+
+  std::unique_ptr<CostAwareConcurrentTaskLimiterImpl> NewLimiter(
+      int32_t limit, std::shared_ptr<RateLimiter> rate_limiter = nullptr) {
+    return std::unique_ptr<CostAwareConcurrentTaskLimiterImpl>(
+        new CostAwareConcurrentTaskLimiterImpl(
+            "limiter", limit, std::move(rate_limiter),
+            /*max_inflight_seconds=*/10, clock_.get()));
+  }
+
+  static TaskCostEstimate Estimate(uint64_t io_bytes,
+                                   double read_amp_reduction) {
+    TaskCostEstimate estimate;
+    estimate.io_bytes = io_bytes;
+    estimate.read_amp_reduction = read_amp_reduction;
+    return estimate;
+  }
+
+  std::shared_ptr<MockSystemClock> clock_;
+  // Stand-ins for the column families requesting tokens
+  const int cf_a_ = 0;
+  const int cf_b_ = 0;
+  const int cf_c_ = 0;
+};
+
+TEST_F(CostAwareConcurrentTaskLimiterTest, Priority) {
+  auto limiter = NewLimiter(1);
+  // Merging 4 sorted runs of 1MB is worth more per byte than merging 8 sorted
+  // runs of 64MB
+  ASSERT_GT(limiter->GetPriority(Estimate(1 << 20, 4)),
+            limiter->GetPriority(Estimate(64 << 20, 8)));
+  // CPU time counts when it is larger than the I/O time
+  TaskCostEstimate cpu_bound = Estimate(1 << 20, 4);
+  cpu_bound.cpu_micros = 10 * 1000 * 1000;
+  ASSERT_GT(limiter->GetPriority(Estimate(1 << 20, 4)),
+            limiter->GetPriority(cpu_bound));
+  // So does the space reclaimed
+  TaskCostEstimate reclaiming = Estimate(1 << 20, 4);
+  reclaiming.space_amp_reduction = 0.5;
+  ASSERT_LT(limiter->GetPriority(Estimate(1 << 20, 4)),
+            limiter->GetPriority(reclaiming));
+}
+
+TEST_F(CostAwareConcurrentTaskLimiterTest, HighestPriorityFirst) {
+  auto limiter = NewLimiter(1);
+  const TaskCostEstimate low = Estimate(64 << 20, 1);
+  const TaskCostEstimate high = Estimate(1 << 20, 4);
+
+  limiter->Enqueue(&cf_b_, high);
+  // The slot is kept for the waiter with the higher priority
+  ASSERT_EQ(nullptr, limiter->GetToken(false, &cf_a_, low));
+  auto token_b = limiter->GetToken(false, &cf_b_, high);
+  ASSERT_NE(nullptr, token_b);
+  ASSERT_EQ(1, limiter->GetOutstandingTask());
+  ASSERT_EQ(uint64_t{1} << 20, limiter->TEST_GetInflightBytes());
+  // No slot left
+  ASSERT_EQ(nullptr, limiter->GetToken(false, &cf_a_, low));
+  // Forcing bypasses the limit
+  ASSERT_NE(nullptr, limiter->GetToken(true, &cf_c_, low));
+
+  token_b.reset();
+  ASSERT_EQ(0, limiter->GetOutstandingTask());
+  ASSERT_EQ(0U, limiter->TEST_GetInflightBytes());
+  auto token_a = limiter->GetToken(false, &cf_a_, low);
+  ASSERT_NE(nullptr, token_a);
+  ASSERT_EQ(uint64_t{64} << 20, limiter->TEST_GetInflightBytes());
+}
+
+TEST_F(CostAwareConcurrentTaskLimiterTest, WaitersExpire) {
+  auto limiter = NewLimiter(1);
+  const TaskCostEstimate low = Estimate(64 << 20, 1);
+  const TaskCostEstimate high = Estimate(1 << 20, 4);
+
+  limiter->Enqueue(&cf_b_, high);
+  ASSERT_EQ(nullptr, limiter->GetToken(false, &cf_a_, low));
+  // A waiter that stops asking no longer holds back the others
+  clock_->MockSleepForSeconds(1);
+  ASSERT_NE(nullptr, limiter->GetToken(false, &cf_a_, low));
+}
+
+TEST_F(CostAwareConcurrentTaskLimiterTest, Unlimited) {
+  auto limiter = NewLimiter(-1);
+  limiter->Enqueue(&cf_b_, Estimate(1 << 20, 4));
+  ASSERT_NE(nullptr, limiter->GetToken(false, &cf_a_, Estimate(64 << 20, 1)));
+}
+
+TEST_F(CostAwareConcurrentTaskLimiterTest, InflightBytesBudget) {
+  // 1MB/s for 10 seconds
+  std::shared_ptr<RateLimiter> rate_limiter(NewGenericRateLimiter(1 << 20));
+  auto limiter = NewLimiter(-1, rate_limiter);
+
+  // The first task always runs, even over the budget
+  auto token_a = limiter->GetToken(false, &cf_a_, Estimate(20 << 20, 1));
+  ASSERT_NE(nullptr, token_a);
+  ASSERT_EQ(nullptr, limiter->GetToken(false, &cf_b_, Estimate(1 << 20, 1)));
+  token_a.reset();
+
+  token_a = limiter->GetToken(false, &cf_a_, Estimate(6 << 20, 1));
+  ASSERT_NE(nullptr, token_a);
+  auto token_b = limiter->GetToken(false, &cf_b_, Estimate(4 << 20, 1));
+  ASSERT_NE(nullptr, token_b);
+  ASSERT_EQ(nullptr, limiter->GetToken(false, &cf_c_, Estimate(1 << 20, 1)));
+  token_b.reset();
+  ASSERT_NE(nullptr, limiter->GetToken(false, &cf_c_, Estimate(1 << 20, 1)));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,479 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/fsst.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace fsst {
+
+namespace {
+
+// Number of rounds used to grow the symbol table. Each round can at most
+// double the length of the longest symbol, so 4 rounds are enough to reach
+// kMaxSymbolLength; the last round re-scores the final candidates.
+constexpr int kGenerations = 5;
+// Upper bound on the bytes used to learn the symbol table. Larger inputs are
+// sampled in evenly spaced chunks.
+constexpr size_t kMaxSampleBytes = 4 << 10;
+constexpr size_t kSampleChunk = 256;
+// Same for TrainSymbolTable(), whose cost is amortized over a whole file.
+constexpr size_t kMaxTrainBytes = 16 << 10;
+// Tokens >= kPseudoBase are single bytes not covered by any symbol.
+constexpr uint32_t kPseudoBase = 256;
+constexpr uint32_t kNumTokens = kPseudoBase + 256;
+
+// Symbols are kept as up to 8 bytes packed into an integer in memory order,
+// so matching a symbol against the input is a load, a mask and a compare.
+struct Symbol {
+  uint64_t val;
+  uint32_t len;
+};
+
+inline uint64_t LenMask(size_t len) {
+  assert(len >= 1 && len <= kMaxSymbolLength);
+  if (len == kMaxSymbolLength) {
+    return ~uint64_t{0};
+  }
+  return port::kLittleEndian ? (uint64_t{1} << (8 * len)) - 1
+                             : ~((~uint64_t{0}) >> (8 * len));
+}
+
+inline uint64_t LoadPrefix(const char* p, size_t avail) {
+  uint64_t v = 0;
+  memcpy(&v, p, std::min(avail, kMaxSymbolLength));
+  return v;
+}
+
+inline uint8_t FirstByte(const Symbol& s) {
+  uint8_t b;
+  memcpy(&b, &s.val, 1);
+  return b;
+}
+
+// Appends the first `len` bytes of b to a (of length a_len), truncating the
+// result to kMaxSymbolLength bytes.
+inline Symbol Concat(const Symbol& a, const Symbol& b) {
+  Symbol r;
+  r.len = std::min(a.len + b.len, static_cast<uint32_t>(kMaxSymbolLength));
+  char buf[2 * kMaxSymbolLength];
+  memcpy(buf, &a.val, kMaxSymbolLength);
+  memcpy(buf + a.len, &b.val, kMaxSymbolLength);
+  memcpy(&r.val, buf, kMaxSymbolLength);
+  r.val &= LenMask(r.len);
+  return r;
+}
+
+class SymbolTable {
+ public:
+  SymbolTable() { Clear(); }
+
+  void Clear() {
+    num_symbols_ = 0;
+    std::fill(begin_.begin(), begin_.end(), 0);
+  }
+
+  size_t size() const { return num_symbols_; }
+  const Symbol& symbol(size_t code) const { return symbols_[code]; }
+
+  // Replaces the contents of the table. Codes are assigned so that symbols
+  // with the same first byte are contiguous and ordered longest first, which
+  // turns longest-match lookup into a short linear scan.
+  void Assign(std::vector<Symbol>* symbols) {
+    assert(symbols->size() <= kMaxSymbols);
+    std::sort(symbols->begin(), symbols->end(),
+              [](const Symbol& x, const Symbol& y) {
+                uint8_t fx = FirstByte(x), fy = FirstByte(y);
+                if (fx != fy) {
+                  return fx < fy;
+                }
+                return x.len != y.len ? x.len > y.len : x.val < y.val;
+              });
+    num_symbols_ = symbols->size();
+    std::copy(symbols->begin(), symbols->end(), symbols_.begin());
+    BuildIndex();
+  }
+
+  // Loads a table serialized by EncodeTo() from the front of *input and
+  // advances it. Returns false if the table is malformed.
+  bool DecodeFrom(Slice* input) {
+    Clear();
+    if (input->empty()) {
+      return false;
+    }
+    size_t n = static_cast<uint8_t>((*input)[0]);
+    input->remove_prefix(1);
+    if (input->size() < n) {
+      return false;
+    }
+    const char* lens = input->data();
+    input->remove_prefix(n);
+    for (size_t code = 0; code < n; ++code) {
+      uint32_t len = static_cast<uint8_t>(lens[code]);
+      if (len == 0 || len > kMaxSymbolLength || input->size() < len) {
+        return false;
+      }
+      Symbol& s = symbols_[code];
+      s.val = 0;
+      memcpy(&s.val, input->data(), len);
+      s.len = len;
+      input->remove_prefix(len);
+      // Lookup relies on the order established by Assign().
+      if (code > 0 && FirstByte(symbols_[code - 1]) > FirstByte(s)) {
+        return false;
+      }
+      if (code > 0 && FirstByte(symbols_[code - 1]) == FirstByte(s) &&
+          symbols_[code - 1].len < s.len) {
+        return false;
+      }
+    }
+    num_symbols_ = n;
+    BuildIndex();
+    return true;
+  }
+
+  // Returns the code of the longest symbol that is a prefix of
+  // [p, p + avail), or -1 if there is none. `avail` must be positive.
+  int FindLongestMatch(const char* p, size_t avail) const {
+    uint8_t first = static_cast<uint8_t>(*p);
+    uint32_t code = begin_[first];
+    uint32_t limit = begin_[first + 1];
+    if (code == limit) {
+      return -1;
+    }
+    uint64_t word = LoadPrefix(p, avail);
+    for (; code < limit; ++code) {
+      const Symbol& s = symbols_[code];
+      if (s.len <= avail && (word & LenMask(s.len)) == s.val) {
+        return static_cast<int>(code);
+      }
+    }
+    return -1;
+  }
+
+  void EncodeTo(std::string* output) const {
+    output->push_back(static_cast<char>(num_symbols_));
+    for (size_t code = 0; code < num_symbols_; ++code) {
+      output->push_back(static_cast<char>(symbols_[code].len));
+    }
+    for (size_t code = 0; code < num_symbols_; ++code) {
+      output->append(reinterpret_cast<const char*>(&symbols_[code].val),
+                     symbols_[code].len);
+    }
+  }
+
+ private:
+  void BuildIndex() {
+    std::fill(begin_.begin(), begin_.end(), 0);
+    for (size_t code = 0; code < num_symbols_; ++code) {
+      ++begin_[FirstByte(symbols_[code]) + 1];
+    }
+    for (size_t b = 1; b < begin_.size(); ++b) {
+      begin_[b] += begin_[b - 1];
+    }
+  }
+
+  size_t num_symbols_;
+  std::array<Symbol, kMaxSymbols> symbols_;
+  // Codes of symbols starting with byte b are [begin_[b], begin_[b + 1]).
+  std::array<uint32_t, 257> begin_;
+};
+
+// A minimal open-addressing counter keyed by non-zero 64-bit keys, used to
+// avoid per-key allocation while learning the symbol table.
+class FlatCounter {
+ public:
+  explicit FlatCounter(size_t capacity_pow2)
+      : mask_(capacity_pow2 - 1), slots_(capacity_pow2) {}
+
+  void Clear() {
+    for (size_t i : used_) {
+      slots_[i] = Slot();
+    }
+    used_.clear();
+  }
+
+  // Returns the slot index for `key`, inserting it if needed.
+  size_t Find(uint64_t key) {
+    assert(key != 0);
+    size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 40) & mask_;
+    while (slots_[i].key != 0 && slots_[i].key != key) {
+      i = (i + 1) & mask_;
+    }
+    if (slots_[i].key == 0) {
+      assert(used_.size() < mask_);
+      slots_[i].key = key;
+      used_.push_back(i);
+    }
+    return i;
+  }
+
+  uint64_t& value(size_t slot) { return slots_[slot].value; }
+  const std::vector<size_t>& used() const { return used_; }
+  uint64_t key(size_t slot) const { return slots_[slot].key; }
+
+ private:
+  struct Slot {
+    uint64_t key = 0;
+    uint64_t value = 0;
+  };
+  size_t mask_;
+  std::vector<Slot> slots_;
+  std::vector<size_t> used_;
+};
+
+std::string BuildSample(const char* input, size_t length, size_t max_bytes) {
+  if (length <= max_bytes) {
+    return std::string(input, length);
+  }
+  std::string sample;
+  sample.reserve(max_bytes);
+  size_t num_chunks = max_bytes / kSampleChunk;
+  size_t stride = length / num_chunks;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    sample.append(input + i * stride, kSampleChunk);
+  }
+  return sample;
+}
+
+// Learns a symbol table from `sample`, following the iterative scheme from
+// the FSST paper: encode the sample with the current table, count how often
+// every symbol and every pair of adjacent symbols occurs, and keep the
+// kMaxSymbols candidates that cover the most bytes.
+void BuildSymbolTable(const std::string& sample, SymbolTable* table) {
+  const char* begin = sample.data();
+  const size_t size = sample.size();
+  // Every position yields at most one token and one pair, and candidates are
+  // tokens plus pairs, so twice the sample size (rounded up to a power of
+  // two) keeps both tables at most half full.
+  size_t capacity = 1024;
+  while (capacity < 2 * (size + kNumTokens)) {
+    capacity <<= 1;
+  }
+  FlatCounter pair_counts(capacity);
+  FlatCounter gains(capacity);
+  std::array<uint32_t, kNumTokens> single_counts;
+  std::array<Symbol, kNumTokens> tokens;
+  std::vector<Symbol> candidates;
+  std::vector<std::pair<uint64_t, size_t>> ranked;
+
+  for (int gen = 0; gen < kGenerations; ++gen) {
+    size_t num_symbols = table->size();
+    for (uint32_t t = 0; t < kNumTokens; ++t) {
+      if (t < num_symbols) {
+        tokens[t] = table->symbol(t);
+      } else if (t >= kPseudoBase) {
+        char c = static_cast<char>(t - kPseudoBase);
+        tokens[t].val = 0;
+        memcpy(&tokens[t].val, &c, 1);
+        tokens[t].len = 1;
+      }
+    }
+
+    single_counts.fill(0);
+    pair_counts.Clear();
+    uint32_t prev = kNumTokens;
+    for (size_t pos = 0; pos < size;) {
+      int code = table->FindLongestMatch(begin + pos, size - pos);
+      uint32_t token;
+      if (code >= 0) {
+        token = static_cast<uint32_t>(code);
+        pos += tokens[token].len;
+      } else {
+        token = kPseudoBase + static_cast<uint8_t>(begin[pos]);
+        ++pos;
+      }
+      ++single_counts[token];
+      if (prev != kNumTokens && tokens[prev].len < kMaxSymbolLength) {
+        ++pair_counts.value(pair_counts.Find((uint64_t{prev} << 16) | token |
+                                             (uint64_t{1} << 40)));
+      }
+      prev = token;
+    }
+
+    // Gains are keyed by symbol so that a pair which concatenates to an
+    // existing symbol adds to the same candidate.
+    gains.Clear();
+    candidates.clear();
+    auto add_candidate = [&](const Symbol& s, uint64_t count) {
+      uint64_t key = s.val ^ (uint64_t{s.len} << 59) ^ 0x5555555555555555ULL;
+      if (key == 0) {
+        key = 1;
+      }
+      size_t slot = gains.Find(key);
+      // value() holds 1 + index into candidates; the gain is stored next to
+      // the symbol in `ranked`.
+      if (gains.value(slot) == 0) {
+        candidates.push_back(s);
+        ranked.emplace_back(0, candidates.size() - 1);
+        gains.value(slot) = candidates.size();
+      }
+      ranked[gains.value(slot) - 1].first += count * s.len;
+    };
+    ranked.clear();
+    for (uint32_t t = 0; t < kNumTokens; ++t) {
+      if (single_counts[t] != 0) {
+        add_candidate(tokens[t], single_counts[t]);
+      }
+    }
+    if (gen + 1 < kGenerations) {
+      for (size_t slot : pair_counts.used()) {
+        uint64_t key = pair_counts.key(slot);
+        uint32_t first = static_cast<uint32_t>((key >> 16) & 0xffff);
+        uint32_t second = static_cast<uint32_t>(key & 0xffff);
+        add_candidate(Concat(tokens[first], tokens[second]),
+                      pair_counts.value(slot));
+      }
+    }
+
+    size_t keep = std::min(ranked.size(), kMaxSymbols);
+    auto by_gain = [&](const std::pair<uint64_t, size_t>& a,
+                       const std::pair<uint64_t, size_t>& b) {
+      if (a.first != b.first) {
+        return a.first > b.first;
+      }
+      const Symbol& sa = candidates[a.second];
+      const Symbol& sb = candidates[b.second];
+      return sa.len != sb.len ? sa.len > sb.len : sa.val < sb.val;
+    };
+    if (keep < ranked.size()) {
+      std::nth_element(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                       by_gain);
+    }
+    std::vector<Symbol> selected;
+    selected.reserve(keep);
+    for (size_t i = 0; i < keep; ++i) {
+      selected.push_back(candidates[ranked[i].second]);
+    }
+    table->Assign(&selected);
+  }
+}
+
+}  // namespace
+
+bool Compress(const char* input, size_t length, const Slice& symbol_table,
+              std::string* output) {
+  SymbolTable table;
+  if (symbol_table.empty()) {
+    if (length > 0) {
+      BuildSymbolTable(BuildSample(input, length, kMaxSampleBytes), &table);
+    }
+    table.EncodeTo(output);
+  } else {
+    Slice encoded = symbol_table;
+    if (!table.DecodeFrom(&encoded) || !encoded.empty()) {
+      return false;
+    }
+  }
+
+  size_t header_size = output->size();
+  // Worst case is every byte escaped.
+  output->resize(header_size + 2 * length);
+  char* out = &(*output)[header_size];
+  char* const out_begin = out;
+  for (size_t pos = 0; pos < length;) {
+    int code = table.FindLongestMatch(input + pos, length - pos);
+    if (code >= 0) {
+      *out++ = static_cast<char>(code);
+      pos += table.symbol(code).len;
+    } else {
+      *out++ = static_cast<char>(kEscapeCode);
+      *out++ = input[pos++];
+    }
+  }
+  output->resize(header_size + static_cast<size_t>(out - out_begin));
+  return true;
+}
+
+std::string TrainSymbolTable(const std::string& samples) {
+  SymbolTable table;
+  if (!samples.empty()) {
+    BuildSymbolTable(
+        BuildSample(samples.data(), samples.size(), kMaxTrainBytes), &table);
+  }
+  std::string result;
+  table.EncodeTo(&result);
+  return result;
+}
+
+bool Decompress(const char* input, size_t length, const Slice& symbol_table,
+                char* output, size_t output_len) {
+  Slice codes(input, length);
+  SymbolTable table;
+  bool ok;
+  if (symbol_table.empty()) {
+    ok = table.DecodeFrom(&codes);
+  } else {
+    Slice encoded = symbol_table;
+    ok = table.DecodeFrom(&encoded) && encoded.empty();
+  }
+  if (!ok) {
+    return false;
+  }
+
+  // A zero length marks unused codes. Symbols are zero-padded to 8 bytes so
+  // every code can be emitted with one fixed-size store.
+  uint8_t lens[256] = {};
+  uint64_t symbols[256] = {};
+  for (size_t code = 0; code < table.size(); ++code) {
+    lens[code] = static_cast<uint8_t>(table.symbol(code).len);
+    symbols[code] = table.symbol(code).val;
+  }
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(codes.data());
+  const uint8_t* const in_end = in + codes.size();
+
+  char* out = output;
+  char* const out_end = output + output_len;
+  // Fast path: while there is room for a full-width store, each code is
+  // decoded without data-dependent branches. An escape is treated as a
+  // one-byte symbol whose value is the following input byte, selected with a
+  // conditional move rather than a branch, so mixed streams of symbols and
+  // escapes do not cause mispredictions.
+  lens[kEscapeCode] = 1;
+  while (in_end - in >= 2 &&
+         out_end - out >= static_cast<ptrdiff_t>(kMaxSymbolLength)) {
+    uint8_t code = in[0];
+    bool escape = code == kEscapeCode;
+    uint64_t literal = 0;
+    memcpy(&literal, in + 1, 1);
+    uint64_t value = escape ? literal : symbols[code];
+    size_t len = lens[code];
+    if (len == 0) {
+      return false;
+    }
+    memcpy(out, &value, kMaxSymbolLength);
+    out += len;
+    in += 1 + static_cast<size_t>(escape);
+  }
+  // Slow path: one code at a time, with full bounds checks.
+  while (in < in_end) {
+    uint8_t code = *in++;
+    if (code == kEscapeCode) {
+      if (in == in_end || out == out_end) {
+        return false;
+      }
+      *out++ = static_cast<char>(*in++);
+    } else {
+      size_t len = lens[code];
+      if (len == 0 || static_cast<size_t>(out_end - out) < len) {
+        return false;
+      }
+      memcpy(out, &symbols[code], len);
+      out += len;
+    }
+  }
+  return out == out_end;
+}
+
+}  // namespace fsst
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,65 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A lightweight, in-tree block codec in the spirit of FSST ("Fast Static
+// Symbol Table", Boncz et al., VLDB 2020). Data is encoded against a table
+// of up to 255 symbols of 1-8 bytes as a stream of one-byte codes, where code
+// 255 escapes a literal byte.
+//
+// Decoding is a table lookup followed by an unconditional 8-byte store per
+// code, which keeps the inner loop free of data-dependent branches. It is
+// intended for hot levels where decompression CPU matters more than the last
+// few percent of compression ratio.
+//
+// A symbol table can either be stored at the front of every block, or be
+// trained once per file with TrainSymbolTable() and passed in through the
+// compression dictionary, in which case blocks only hold codes. The latter
+// avoids both the per-block table overhead and the per-block training cost
+// and is recommended whenever CompressionOptions::max_dict_bytes can be set.
+//
+// Encoded symbol table:
+//   num_symbols      : 1 byte  (0-255)
+//   symbol_lengths   : num_symbols bytes, each in [1, 8]
+//   symbol_bytes     : sum(symbol_lengths) bytes
+// Encoded block:
+//   symbol table     : only present if no external table is used
+//   codes            : remaining bytes
+namespace fsst {
+
+constexpr size_t kMaxSymbols = 255;
+constexpr size_t kMaxSymbolLength = 8;
+constexpr uint8_t kEscapeCode = 255;
+
+// Learns a symbol table from `samples` and returns it in serialized form,
+// suitable for use as a compression dictionary.
+std::string TrainSymbolTable(const std::string& samples);
+
+// Appends the encoding of input[0, length) to *output. If `symbol_table` is
+// empty, a table is learned from the input and stored in front of the codes.
+// Returns false only if `symbol_table` is malformed; the caller is
+// responsible for deciding whether the result is small enough to be worth
+// keeping.
+bool Compress(const char* input, size_t length, const Slice& symbol_table,
+              std::string* output);
+
+// Decodes input[0, length) into output, which must hold exactly output_len
+// bytes. `symbol_table` must be the one passed to Compress(). Returns false
+// if the input is malformed or does not decode to exactly output_len bytes.
+bool Decompress(const char* input, size_t length, const Slice& symbol_table,
+                char* output, size_t output_len);
+
+}  // namespace fsst
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,177 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/fsst.h"
+
+#include <string>
+
+#include "port/stack_trace.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/compression.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class FSSTTest : public testing::Test {
+ protected:
+  static std::string RoundTrip(const std::string& input,
+                               const Slice& table = Slice()) {
+    std::string compressed;
+    EXPECT_TRUE(
+        fsst::Compress(input.data(), input.size(), table, &compressed));
+    std::string output(input.size(), '\0');
+    EXPECT_TRUE(fsst::Decompress(compressed.data(), compressed.size(), table,
+                                 &output[0], output.size()));
+    return output;
+  }
+
+  static std::string Compress(const std::string& input,
+                              const Slice& table = Slice()) {
+    std::string compressed;
+    EXPECT_TRUE(
+        fsst::Compress(input.data(), input.size(), table, &compressed));
+    return compressed;
+  }
+};
+
+TEST_F(FSSTTest, Empty) {
+  ASSERT_EQ("", RoundTrip(""));
+  std::string compressed = Compress("");
+  ASSERT_EQ(1U, compressed.size());
+}
+
+TEST_F(FSSTTest, Small) {
+  for (const std::string& s : {std::string("a"), std::string("ab"),
+                               std::string("abcdefghij"),
+                               std::string(3, '\xff')}) {
+    ASSERT_EQ(s, RoundTrip(s));
+  }
+}
+
+TEST_F(FSSTTest, CompressesRepetitiveData) {
+  std::string input;
+  for (int i = 0; i < 200; ++i) {
+    input.append("user_key_prefix_");
+    input.append(std::to_string(i));
+    input.append("{\"name\":\"value\",\"count\":");
+    input.append(std::to_string(i * 7));
+    input.append("}");
+  }
+  ASSERT_EQ(input, RoundTrip(input));
+  ASSERT_LT(Compress(input).size(), input.size() / 2);
+}
+
+TEST_F(FSSTTest, RandomData) {
+  Random rnd(301);
+  for (size_t len : {1, 7, 31, 100, 4096, 20000, 100000}) {
+    std::string input = rnd.RandomBinaryString(static_cast<int>(len));
+    ASSERT_EQ(input, RoundTrip(input));
+    std::string text;
+    test::CompressibleString(&rnd, 0.3, static_cast<int>(len), &text);
+    ASSERT_EQ(text, RoundTrip(text));
+  }
+}
+
+TEST_F(FSSTTest, DetectsCorruption) {
+  std::string input(1000, 'x');
+  input.append("abcabcabcabc");
+  std::string compressed = Compress(input);
+  std::string output(input.size(), '\0');
+
+  // Wrong expected size
+  ASSERT_FALSE(fsst::Decompress(compressed.data(), compressed.size(), Slice(),
+                                &output[0], output.size() - 1));
+  std::string bigger(input.size() + 1, '\0');
+  ASSERT_FALSE(fsst::Decompress(compressed.data(), compressed.size(), Slice(),
+                                &bigger[0], bigger.size()));
+  // Truncated input
+  for (size_t len = 0; len < compressed.size(); ++len) {
+    ASSERT_FALSE(
+        fsst::Decompress(compressed.data(), len, Slice(), &output[0],
+                         output.size()));
+  }
+  // Dangling escape
+  std::string escaped = Compress("");
+  escaped.push_back(static_cast<char>(fsst::kEscapeCode));
+  char c;
+  ASSERT_FALSE(fsst::Decompress(escaped.data(), escaped.size(), Slice(), &c, 1));
+  // Unused code
+  std::string unused = Compress("");
+  unused.push_back('\x01');
+  ASSERT_FALSE(fsst::Decompress(unused.data(), unused.size(), Slice(), &c, 1));
+}
+
+TEST_F(FSSTTest, TrainedSymbolTable) {
+  Random rnd(17);
+  std::string samples;
+  for (int i = 0; i < 500; ++i) {
+    samples.append("timestamp=" + std::to_string(1600000000 + i * 37) +
+                   ";host=server" + std::to_string(i % 16) + ";");
+  }
+  std::string table = fsst::TrainSymbolTable(samples);
+  ASSERT_FALSE(table.empty());
+  ASSERT_EQ("", RoundTrip("", table));
+  ASSERT_EQ(samples, RoundTrip(samples, table));
+  // Blocks no longer carry the table, so they compress better than with a
+  // per-block table.
+  std::string block = samples.substr(0, 4096);
+  ASSERT_EQ(block, RoundTrip(block, table));
+  ASSERT_LT(Compress(block, table).size(), Compress(block).size());
+  // Data not seen during training still round-trips via escapes.
+  std::string unseen = rnd.RandomBinaryString(1000);
+  ASSERT_EQ(unseen, RoundTrip(unseen, table));
+
+  // Empty samples yield an empty but valid table.
+  std::string empty_table = fsst::TrainSymbolTable("");
+  ASSERT_EQ(1U, empty_table.size());
+  ASSERT_EQ(block, RoundTrip(block, empty_table));
+
+  // Malformed tables are rejected.
+  std::string compressed;
+  std::string bad_table(1, '\x05');
+  ASSERT_FALSE(
+      fsst::Compress(block.data(), block.size(), bad_table, &compressed));
+  std::string output(block.size(), '\0');
+  ASSERT_FALSE(fsst::Decompress(compressed.data(), compressed.size(),
+                                bad_table, &output[0], output.size()));
+}
+
+TEST_F(FSSTTest, CompressDataRoundTrip) {
+  ASSERT_TRUE(CompressionTypeSupported(kFSSTCompression));
+  ASSERT_TRUE(DictCompressionTypeSupported(kFSSTCompression));
+  ASSERT_EQ("FSST", CompressionTypeToString(kFSSTCompression));
+
+  Random rnd(42);
+  std::string raw;
+  test::CompressibleString(&rnd, 0.5, 16 << 10, &raw);
+
+  CompressionOptions opts;
+  CompressionContext ctx(kFSSTCompression);
+  CompressionInfo info(opts, ctx, CompressionDict::GetEmptyDict(),
+                       kFSSTCompression, 0 /* sample_for_compression */);
+  std::string compressed;
+  ASSERT_TRUE(CompressData(raw, info, 2 /* compress_format_version */,
+                           &compressed));
+  ASSERT_LT(compressed.size(), raw.size());
+
+  UncompressionContext uctx(kFSSTCompression);
+  UncompressionInfo uinfo(uctx, UncompressionDict::GetEmptyDict(),
+                          kFSSTCompression);
+  size_t uncompressed_size = 0;
+  CacheAllocationPtr uncompressed =
+      UncompressData(uinfo, compressed.data(), compressed.size(),
+                     &uncompressed_size, 2 /* compress_format_version */);
+  ASSERT_NE(nullptr, uncompressed);
+  ASSERT_EQ(Slice(raw), Slice(uncompressed.get(), uncompressed_size));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,64 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/run_in_thread_pool.h"
+
+#include <memory>
+
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Shared by the caller of RunInThreadPool() and its jobs, which may start
+// after it returned
+struct RunInThreadPoolState {
+  explicit RunInThreadPoolState(const std::function<void()>* _work)
+      : work(_work), cv(&mu) {}
+
+  // Only valid until closed
+  const std::function<void()>* work;
+  port::Mutex mu;
+  port::CondVar cv;
+  bool closed = false;
+  int running = 0;
+};
+
+void RunInThreadPoolJob(void* arg) {
+  std::unique_ptr<std::shared_ptr<RunInThreadPoolState>> state_ref(
+      static_cast<std::shared_ptr<RunInThreadPoolState>*>(arg));
+  RunInThreadPoolState* state = state_ref->get();
+  {
+    MutexLock l(&state->mu);
+    if (state->closed) {
+      return;
+    }
+    state->running++;
+  }
+  (*state->work)();
+  MutexLock l(&state->mu);
+  if (--state->running == 0) {
+    state->cv.SignalAll();
+  }
+}
+}  // namespace
+
+void RunInThreadPool(Env* env, Env::Priority pri, size_t num_threads,
+                     const std::function<void()>& work) {
+  auto state = std::make_shared<RunInThreadPoolState>(&work);
+  for (size_t i = 1; i < num_threads; i++) {
+    env->Schedule(&RunInThreadPoolJob,
+                  new std::shared_ptr<RunInThreadPoolState>(state), pri);
+  }
+  work();
+  MutexLock l(&state->mu);
+  state->closed = true;
+  while (state->running > 0) {
+    state->cv.Wait();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
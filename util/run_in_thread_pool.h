@@ -0,0 +1,23 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <functional>
+
+#include "rocksdb/env.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Calls `work` on up to `num_threads` threads at once: the calling thread and
+// `num_threads - 1` jobs scheduled in the `pri` thread pool of `env`. Returns
+// once all the calls returned. `work` must return when there is nothing left
+// to do, e.g. by taking its items from a shared counter, since the calling
+// thread alone may do all of it when the thread pool is busy: jobs starting
+// after the call of the calling thread returned do not call `work`.
+void RunInThreadPool(Env* env, Env::Priority pri, size_t num_threads,
+                     const std::function<void()>& work);
+
+}  // namespace ROCKSDB_NAMESPACE
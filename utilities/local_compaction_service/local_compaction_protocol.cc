@@ -0,0 +1,238 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#if !defined(ROCKSDB_LITE) && !defined(OS_WIN)
+
+#include "utilities/local_compaction_service/local_compaction_protocol.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "util/coding.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace local_compaction {
+
+namespace {
+// Bumped on incompatible changes of the messages
+constexpr uint32_t kProtocolVersion = 1;
+// Guards against reading garbage as a huge message size
+constexpr uint32_t kMaxMessageSize = 1u << 30;
+
+Status IOErrorFromErrno(const std::string& context, int err) {
+  return Status::IOError(context, strerror(err));
+}
+
+Status MakeAddress(const std::string& path, struct sockaddr_un* addr) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+    return Status::InvalidArgument("Invalid socket path", path);
+  }
+  memcpy(addr->sun_path, path.data(), path.size());
+  return Status::OK();
+}
+}  // namespace
+
+void JobRequest::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kProtocolVersion);
+  PutLengthPrefixedSlice(dst, db_path);
+  PutLengthPrefixedSlice(dst, output_directory);
+  PutLengthPrefixedSlice(dst, input);
+}
+
+Status JobRequest::DecodeFrom(const Slice& src) {
+  Slice input_slice = src;
+  uint32_t version = 0;
+  Slice db_path_slice;
+  Slice output_directory_slice;
+  Slice job_input_slice;
+  if (!GetVarint32(&input_slice, &version)) {
+    return Status::Corruption("Bad compaction job request");
+  }
+  if (version != kProtocolVersion) {
+    return Status::NotSupported("Unknown compaction job request version",
+                                ToString(version));
+  }
+  if (!GetLengthPrefixedSlice(&input_slice, &db_path_slice) ||
+      !GetLengthPrefixedSlice(&input_slice, &output_directory_slice) ||
+      !GetLengthPrefixedSlice(&input_slice, &job_input_slice)) {
+    return Status::Corruption("Bad compaction job request");
+  }
+  db_path = db_path_slice.ToString();
+  output_directory = output_directory_slice.ToString();
+  input = job_input_slice.ToString();
+  return Status::OK();
+}
+
+void JobResponse::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, ok ? 1 : 0);
+  PutLengthPrefixedSlice(dst, result);
+  PutLengthPrefixedSlice(dst, error);
+}
+
+Status JobResponse::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  uint32_t ok_value = 0;
+  Slice result_slice;
+  Slice error_slice;
+  if (!GetVarint32(&input, &ok_value) ||
+      !GetLengthPrefixedSlice(&input, &result_slice) ||
+      !GetLengthPrefixedSlice(&input, &error_slice)) {
+    return Status::Corruption("Bad compaction job response");
+  }
+  ok = ok_value != 0;
+  result = result_slice.ToString();
+  error = error_slice.ToString();
+  return Status::OK();
+}
+
+Status Connect(const std::string& path, int* fd) {
+  struct sockaddr_un addr;
+  Status s = MakeAddress(path, &addr);
+  if (!s.ok()) {
+    return s;
+  }
+  int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sock < 0) {
+    return IOErrorFromErrno("socket()", errno);
+  }
+  int ret;
+  do {
+    ret = connect(sock, reinterpret_cast<struct sockaddr*>(&addr),
+                  sizeof(addr));
+  } while (ret != 0 && errno == EINTR);
+  if (ret != 0) {
+    int err = errno;
+    close(sock);
+    return IOErrorFromErrno("While connecting to " + path, err);
+  }
+  *fd = sock;
+  return Status::OK();
+}
+
+Status Listen(const std::string& path, int* fd) {
+  struct sockaddr_un addr;
+  Status s = MakeAddress(path, &addr);
+  if (!s.ok()) {
+    return s;
+  }
+  int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sock < 0) {
+    return IOErrorFromErrno("socket()", errno);
+  }
+  unlink(path.c_str());
+  if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) !=
+          0 ||
+      listen(sock, SOMAXCONN) != 0) {
+    int err = errno;
+    close(sock);
+    return IOErrorFromErrno("While listening on " + path, err);
+  }
+  *fd = sock;
+  return Status::OK();
+}
+
+Status SendMessage(int fd, const Slice& payload) {
+  if (payload.size() > kMaxMessageSize) {
+    return Status::InvalidArgument("Compaction job message too large");
+  }
+  std::string buf;
+  PutFixed32(&buf, static_cast<uint32_t>(payload.size()));
+  buf.append(payload.data(), payload.size());
+  size_t sent = 0;
+  while (sent < buf.size()) {
+    // MSG_NOSIGNAL: a closed peer must not kill the process with SIGPIPE
+    ssize_t ret =
+        send(fd, buf.data() + sent, buf.size() - sent, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOErrorFromErrno("While sending compaction job message", errno);
+    }
+    sent += static_cast<size_t>(ret);
+  }
+  return Status::OK();
+}
+
+namespace {
+Status ReceiveFully(int fd, char* buf, size_t n) {
+  size_t received = 0;
+  while (received < n) {
+    ssize_t ret = recv(fd, buf + received, n - received, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOErrorFromErrno("While receiving compaction job message",
+                              errno);
+    }
+    if (ret == 0) {
+      return Status::Incomplete("Connection closed");
+    }
+    received += static_cast<size_t>(ret);
+  }
+  return Status::OK();
+}
+}  // namespace
+
+Status ReceiveMessage(int fd, std::string* payload) {
+  char size_buf[sizeof(uint32_t)];
+  Status s = ReceiveFully(fd, size_buf, sizeof(size_buf));
+  if (!s.ok()) {
+    return s;
+  }
+  uint32_t size = DecodeFixed32(size_buf);
+  if (size > kMaxMessageSize) {
+    return Status::Corruption("Compaction job message too large");
+  }
+  payload->resize(size);
+  return ReceiveFully(fd, &(*payload)[0], size);
+}
+
+Status ReceiveMessageNonBlocking(int fd, std::string* buffer,
+                                 std::string* payload, bool* done) {
+  *done = false;
+  char chunk[4096];
+  while (true) {
+    if (buffer->size() >= sizeof(uint32_t)) {
+      uint32_t size = DecodeFixed32(buffer->data());
+      if (size > kMaxMessageSize) {
+        return Status::Corruption("Compaction job message too large");
+      }
+      if (buffer->size() >= sizeof(uint32_t) + size) {
+        payload->assign(*buffer, sizeof(uint32_t), size);
+        buffer->clear();
+        *done = true;
+        return Status::OK();
+      }
+    }
+    ssize_t ret = recv(fd, chunk, sizeof(chunk), 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return Status::OK();
+      }
+      return IOErrorFromErrno("While receiving compaction job message",
+                              errno);
+    }
+    if (ret == 0) {
+      return Status::Incomplete("Connection closed");
+    }
+    buffer->append(chunk, static_cast<size_t>(ret));
+  }
+}
+
+}  // namespace local_compaction
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // !ROCKSDB_LITE && !OS_WIN
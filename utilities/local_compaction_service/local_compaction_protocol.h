@@ -0,0 +1,69 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#if !defined(ROCKSDB_LITE) && !defined(OS_WIN)
+
+#include <string>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace local_compaction {
+
+// The protocol between LocalCompactionService and LocalCompactionWorker. The
+// DB process opens one connection per job and sends a JobRequest. The worker
+// answers with a JobResponse once the job is done. The DB process closing
+// the connection before that cancels the job.
+//
+// Each message is a fixed32 payload size followed by the payload.
+
+struct JobRequest {
+  // Directory of the DB to compact
+  std::string db_path;
+  // Directory for the output files, created by the worker
+  std::string output_directory;
+  // The input of DB::OpenAndCompact()
+  std::string input;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+struct JobResponse {
+  bool ok = false;
+  // The output of DB::OpenAndCompact(), possibly empty on failure
+  std::string result;
+  // Why the job failed
+  std::string error;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// Connects to the socket at `path`.
+Status Connect(const std::string& path, int* fd);
+
+// Creates a socket listening at `path`, replacing any file there.
+Status Listen(const std::string& path, int* fd);
+
+Status SendMessage(int fd, const Slice& payload);
+
+// Returns Incomplete if the peer closed the connection before sending a
+// whole message.
+Status ReceiveMessage(int fd, std::string* payload);
+
+// Reads what is available on the non-blocking `fd` without waiting, adding
+// it to `buffer`, which accumulates a message across calls. Once `buffer`
+// holds a whole message, moves its payload to `payload` and sets `*done`.
+// Returns Incomplete if the peer closed the connection before sending a
+// whole message.
+Status ReceiveMessageNonBlocking(int fd, std::string* buffer,
+                                 std::string* payload, bool* done);
+
+}  // namespace local_compaction
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // !ROCKSDB_LITE && !OS_WIN
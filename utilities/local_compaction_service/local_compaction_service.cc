@@ -0,0 +1,257 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#ifndef OS_WIN
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "db/compaction/compaction_job.h"
+#include "file/filename.h"
+#include "util/string_util.h"
+#include "utilities/local_compaction_service/local_compaction_protocol.h"
+#endif  // !OS_WIN
+
+namespace ROCKSDB_NAMESPACE {
+
+#ifndef OS_WIN
+namespace {
+
+class LocalCompactionServiceImpl : public LocalCompactionService {
+ public:
+  explicit LocalCompactionServiceImpl(
+      const LocalCompactionServiceOptions& options)
+      : options_(options) {}
+
+  ~LocalCompactionServiceImpl() override {
+    // The DB waits for its compactions before it goes away, so there should
+    // be no job left
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& job : jobs_) {
+      close(job.second.fd);
+    }
+    CleanUpOutputDirectories();
+  }
+
+  CompactionServiceJobStatus StartV2(const CompactionServiceJobInfo& info,
+                                     const std::string& input) override {
+    local_compaction::JobRequest request;
+    request.db_path = info.db_name;
+    request.output_directory = info.db_name + "/local_compaction_" +
+                               info.db_session_id + "_" +
+                               ROCKSDB_NAMESPACE::ToString(info.job_id);
+    request.input = input;
+    std::string payload;
+    request.EncodeTo(&payload);
+
+    int fd = -1;
+    Status s = local_compaction::Connect(options_.socket_path, &fd);
+    if (!s.ok()) {
+      s.PermitUncheckedError();
+      return StartFailedStatus();
+    }
+    {
+      // Registered before sending, so the job can be cancelled as soon as
+      // the worker may run it
+      std::lock_guard<std::mutex> lock(mutex_);
+      CleanUpOutputDirectories();
+      Job& job = jobs_[JobKey(info)];
+      job.fd = fd;
+      job.output_directory = request.output_directory;
+    }
+    s = local_compaction::SendMessage(fd, payload);
+    if (!s.ok()) {
+      s.PermitUncheckedError();
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = jobs_.find(JobKey(info));
+      assert(it != jobs_.end());
+      // Otherwise WaitForCompleteV2() reports the cancellation
+      if (!it->second.cancelled) {
+        jobs_.erase(it);
+        close(fd);
+        return StartFailedStatus();
+      }
+    }
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  CompactionServiceJobStatus WaitForCompleteV2(
+      const CompactionServiceJobInfo& info,
+      std::string* compaction_service_result) override {
+    int fd;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = jobs_.find(JobKey(info));
+      if (it == jobs_.end()) {
+        return CompactionServiceJobStatus::kFailure;
+      }
+      fd = it->second.fd;
+    }
+
+    std::string payload;
+    Status s = local_compaction::ReceiveMessage(fd, &payload);
+    local_compaction::JobResponse response;
+    if (s.ok()) {
+      s = response.DecodeFrom(payload);
+    }
+
+    Job job;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = jobs_.find(JobKey(info));
+      assert(it != jobs_.end());
+      job = std::move(it->second);
+      jobs_.erase(it);
+    }
+    close(job.fd);
+
+    CompactionServiceJobStatus status;
+    if (job.cancelled) {
+      // Fails the compaction the way a paused manual compaction does, which
+      // is not a background error. Any response that raced with the
+      // cancellation is dropped.
+      s.PermitUncheckedError();
+      CompactionServiceResult result;
+      result.status =
+          Status::Incomplete(Status::SubCode::kManualCompactionPaused);
+      result.output_level = 0;
+      result.Write(compaction_service_result).PermitUncheckedError();
+      status = CompactionServiceJobStatus::kFailure;
+    } else if (!s.ok()) {
+      // The worker went away
+      s.PermitUncheckedError();
+      status = options_.fallback_to_local
+                   ? CompactionServiceJobStatus::kUseLocal
+                   : CompactionServiceJobStatus::kFailure;
+    } else {
+      *compaction_service_result = std::move(response.result);
+      status = response.ok ? CompactionServiceJobStatus::kSuccess
+                           : CompactionServiceJobStatus::kFailure;
+    }
+
+    if (status == CompactionServiceJobStatus::kSuccess) {
+      // The DB moves the output files out after this returns
+      std::lock_guard<std::mutex> lock(mutex_);
+      finished_output_directories_.push_back(
+          std::move(job.output_directory));
+    } else {
+      DestroyOutputDirectory(job.output_directory);
+    }
+    return status;
+  }
+
+  void CancelAllJobs() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& job : jobs_) {
+      if (!job.second.cancelled) {
+        job.second.cancelled = true;
+        // Makes the worker see the connection closed and kill the job, and
+        // wakes up WaitForCompleteV2()
+        shutdown(job.second.fd, SHUT_RDWR);
+      }
+    }
+  }
+
+  size_t GetNumRunningJobs() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+  }
+
+ private:
+  struct Job {
+    int fd = -1;
+    std::string output_directory;
+    bool cancelled = false;
+  };
+
+  CompactionServiceJobStatus StartFailedStatus() const {
+    return options_.fallback_to_local ? CompactionServiceJobStatus::kUseLocal
+                                      : CompactionServiceJobStatus::kFailure;
+  }
+
+  static std::pair<std::string, uint64_t> JobKey(
+      const CompactionServiceJobInfo& info) {
+    return std::make_pair(info.db_session_id, info.job_id);
+  }
+
+  // Removes the output directories of jobs whose files have been installed,
+  // along with what else the worker left there, such as info logs.
+  // REQUIRES: mutex_ held
+  void CleanUpOutputDirectories() {
+    std::vector<std::string> remaining;
+    for (auto& dir : finished_output_directories_) {
+      std::vector<std::string> children;
+      bool installed = options_.env->GetChildren(dir, &children).ok();
+      for (const auto& child : children) {
+        uint64_t number;
+        FileType type;
+        if (ParseFileName(child, &number, &type) &&
+            (type == kTableFile || type == kBlobFile)) {
+          // Not moved out by the DB yet
+          installed = false;
+          break;
+        }
+      }
+      if (installed) {
+        DestroyOutputDirectory(dir);
+      } else {
+        remaining.push_back(std::move(dir));
+      }
+    }
+    finished_output_directories_.swap(remaining);
+  }
+
+  void DestroyOutputDirectory(const std::string& dir) {
+    std::vector<std::string> children;
+    if (options_.env->GetChildren(dir, &children).ok()) {
+      for (const auto& child : children) {
+        options_.env->DeleteFile(dir + "/" + child).PermitUncheckedError();
+      }
+    }
+    options_.env->DeleteDir(dir).PermitUncheckedError();
+  }
+
+  const LocalCompactionServiceOptions options_;
+  std::mutex mutex_;
+  std::map<std::pair<std::string, uint64_t>, Job> jobs_;
+  std::vector<std::string> finished_output_directories_;
+};
+
+}  // namespace
+
+Status NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options,
+    std::shared_ptr<LocalCompactionService>* service) {
+  if (options.socket_path.empty()) {
+    return Status::InvalidArgument("socket_path is required");
+  }
+  if (options.env == nullptr) {
+    return Status::InvalidArgument("env is required");
+  }
+  service->reset(new LocalCompactionServiceImpl(options));
+  return Status::OK();
+}
+
+#else  // OS_WIN
+
+Status NewLocalCompactionService(
+    const LocalCompactionServiceOptions& /*options*/,
+    std::shared_ptr<LocalCompactionService>* /*service*/) {
+  return Status::NotSupported(
+      "LocalCompactionService is not supported on Windows");
+}
+
+#endif  // !OS_WIN
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // !ROCKSDB_LITE
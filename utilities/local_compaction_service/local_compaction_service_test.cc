@@ -0,0 +1,245 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#if !defined(ROCKSDB_LITE) && !defined(OS_WIN)
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#include "db/db_test_util.h"
+#include "port/port.h"
+#include "port/stack_trace.h"
+#include "utilities/local_compaction_service/local_compaction_protocol.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class LocalCompactionServiceTest : public DBTestBase {
+ public:
+  LocalCompactionServiceTest()
+      : DBTestBase("local_compaction_service_test", /*env_do_fsync=*/true),
+        socket_path_(test::PerThreadDBPath(env_, "lcs_worker.sock")) {}
+
+  ~LocalCompactionServiceTest() override { StopWorker(); }
+
+ protected:
+  // Jobs run on threads of the worker, as the test process cannot fork
+  void StartWorker(int max_jobs) {
+    LocalCompactionWorkerOptions worker_options;
+    worker_options.socket_path = socket_path_;
+    worker_options.max_jobs = max_jobs;
+    worker_options.fork_jobs = false;
+    worker_statistics_ = CreateDBStatistics();
+    worker_options.options_override.statistics = worker_statistics_;
+    ASSERT_OK(LocalCompactionWorker::Create(worker_options, &worker_));
+    worker_thread_ = port::Thread([this] { ASSERT_OK(worker_->Run()); });
+    // Run() listens on the socket right away
+    while (!env_->FileExists(socket_path_).ok()) {
+      env_->SleepForMicroseconds(1000);
+    }
+  }
+
+  void StopWorker() {
+    if (worker_) {
+      worker_->Shutdown();
+      worker_thread_.join();
+      worker_.reset();
+    }
+  }
+
+  void ReopenWithLocalCompactionService(Options* options) {
+    LocalCompactionServiceOptions service_options;
+    service_options.socket_path = socket_path_;
+    ASSERT_OK(NewLocalCompactionService(service_options, &service_));
+    options->compaction_service = service_;
+    options->statistics = CreateDBStatistics();
+    DestroyAndReopen(*options);
+  }
+
+  void GenerateTestData() {
+    // Generate 20 files @ L2
+    for (int i = 0; i < 20; i++) {
+      for (int j = 0; j < 10; j++) {
+        int key_id = i * 10 + j;
+        ASSERT_OK(Put(Key(key_id), "value" + ToString(key_id)));
+      }
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(2);
+
+    // Generate 10 files @ L1 overlap with all 20 files @ L2
+    for (int i = 0; i < 10; i++) {
+      for (int j = 0; j < 10; j++) {
+        int key_id = i * 20 + j * 2;
+        ASSERT_OK(Put(Key(key_id), "value_new" + ToString(key_id)));
+      }
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(1);
+    ASSERT_EQ(FilesPerLevel(), "0,10,20");
+  }
+
+  void VerifyTestData() {
+    for (int i = 0; i < 200; i++) {
+      auto result = Get(Key(i));
+      if (i % 2) {
+        ASSERT_EQ(result, "value" + ToString(i));
+      } else {
+        ASSERT_EQ(result, "value_new" + ToString(i));
+      }
+    }
+  }
+
+  void AssertNoJobOutputDirectories() {
+    std::vector<std::string> children;
+    ASSERT_OK(env_->GetChildren(dbname_, &children));
+    for (const auto& child : children) {
+      ASSERT_EQ(child.find("local_compaction_"), std::string::npos) << child;
+    }
+  }
+
+  const std::string socket_path_;
+  std::shared_ptr<LocalCompactionService> service_;
+  std::shared_ptr<Statistics> worker_statistics_;
+  std::unique_ptr<LocalCompactionWorker> worker_;
+  port::Thread worker_thread_;
+};
+
+TEST_F(LocalCompactionServiceTest, BasicCompactions) {
+  StartWorker(/*max_jobs=*/2);
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 4;
+  options.target_file_size_base = 1 << 10;  // 1KB
+  ReopenWithLocalCompactionService(&options);
+
+  GenerateTestData();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyTestData();
+  ASSERT_EQ(FilesPerLevel().substr(0, 4), "0,0,");
+
+  // The compactions ran on the worker
+  ASSERT_GT(worker_statistics_->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            worker_statistics_->getTickerCount(COMPACT_WRITE_BYTES));
+  ASSERT_EQ(service_->GetNumRunningJobs(), 0U);
+
+  // The service cleans up the output directories at the latest when it goes
+  // away
+  Close();
+  options.compaction_service.reset();
+  last_options_.compaction_service.reset();
+  service_.reset();
+  AssertNoJobOutputDirectories();
+  Reopen(options);
+  VerifyTestData();
+}
+
+TEST_F(LocalCompactionServiceTest, FallbackToLocal) {
+  // No worker is listening
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  ReopenWithLocalCompactionService(&options);
+
+  GenerateTestData();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyTestData();
+  ASSERT_GT(options.statistics->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            0);
+}
+
+TEST_F(LocalCompactionServiceTest, CancelAllJobs) {
+  StartWorker(/*max_jobs=*/1);
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  ReopenWithLocalCompactionService(&options);
+
+  GenerateTestData();
+
+  // Cancel from inside the job on the worker
+  std::atomic<int> num_cancels{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Inprogress", [&](void* /*arg*/) {
+        ASSERT_EQ(service_->GetNumRunningJobs(), 1U);
+        // Counted first, as CompactRange() may return as soon as the job is
+        // cancelled
+        num_cancels++;
+        service_->CancelAllJobs();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Status s = db_->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+  ASSERT_TRUE(s.IsManualCompactionPaused()) << s.ToString();
+  ASSERT_EQ(num_cancels, 1);
+  ASSERT_EQ(FilesPerLevel(), "0,10,20");
+  // Not a background error
+  ASSERT_OK(Put(Key(0), "value_new0"));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Later jobs are not affected
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyTestData();
+  ASSERT_EQ(FilesPerLevel().substr(0, 4), "0,0,");
+}
+
+TEST_F(LocalCompactionServiceTest, IdleClientDoesNotStallJobs) {
+  StartWorker(/*max_jobs=*/1);
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  ReopenWithLocalCompactionService(&options);
+  GenerateTestData();
+
+  // A client sending the start of a request and then nothing
+  int idle_fd = -1;
+  ASSERT_OK(local_compaction::Connect(socket_path_, &idle_fd));
+  ASSERT_EQ(2, write(idle_fd, "\x10\x00", 2));
+
+  // The worker takes the next job without waiting for the idle client to
+  // time out (after 10 seconds)
+  const uint64_t start_micros = env_->NowMicros();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_LT(env_->NowMicros() - start_micros, 5000000U);
+  VerifyTestData();
+  ASSERT_GT(worker_statistics_->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  close(idle_fd);
+}
+
+TEST_F(LocalCompactionServiceTest, WorkerOptionsValidation) {
+  std::unique_ptr<LocalCompactionWorker> worker;
+  LocalCompactionWorkerOptions worker_options;
+  Status s = LocalCompactionWorker::Create(worker_options, &worker);
+  ASSERT_TRUE(s.IsInvalidArgument());
+  worker_options.socket_path = socket_path_;
+  worker_options.max_jobs = 0;
+  s = LocalCompactionWorker::Create(worker_options, &worker);
+  ASSERT_TRUE(s.IsInvalidArgument());
+
+  std::shared_ptr<LocalCompactionService> service;
+  s = NewLocalCompactionService(LocalCompactionServiceOptions(), &service);
+  ASSERT_TRUE(s.IsInvalidArgument());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  RegisterCustomObjects(argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else
+#include <stdio.h>
+
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr,
+          "SKIPPED as LocalCompactionService is not supported in "
+          "ROCKSDB_LITE or on Windows\n");
+  return 0;
+}
+#endif  // !ROCKSDB_LITE && !OS_WIN
@@ -0,0 +1,432 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#ifndef OS_WIN
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "db/compaction/compaction_job.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/system_clock.h"
+#include "util/string_util.h"
+#include "utilities/local_compaction_service/local_compaction_protocol.h"
+#endif  // !OS_WIN
+
+namespace ROCKSDB_NAMESPACE {
+
+#ifndef OS_WIN
+namespace {
+
+class LocalCompactionWorkerImpl : public LocalCompactionWorker {
+ public:
+  explicit LocalCompactionWorkerImpl(
+      const LocalCompactionWorkerOptions& options)
+      : options_(options) {}
+
+  Status Run() override;
+
+  void Shutdown() override { shutdown_.store(true, std::memory_order_relaxed); }
+
+ private:
+  // How often Run() checks for Shutdown() while idle
+  static constexpr int kPollIntervalMs = 100;
+  // How long a new connection may take to send its request
+  static constexpr int kRequestTimeoutSecs = 10;
+
+  struct Job {
+    int fd = -1;
+    // The request bytes received so far, until the whole request is
+    // received, and when the connection was accepted
+    std::string request_buffer;
+    uint64_t accept_time_micros = 0;
+    local_compaction::JobRequest request;
+    bool cancelled = false;
+    // The job process, with fork_jobs
+    pid_t pid = -1;
+    // The job thread, without fork_jobs
+    std::unique_ptr<port::Thread> thread;
+    std::atomic<bool> finished{false};
+  };
+
+  // Accepts a connection, whose request is read by ReceiveRequest()
+  void AcceptJob(int listen_fd, std::vector<std::unique_ptr<Job>>* receiving);
+  // Reads the request bytes available without waiting. Returns true once
+  // the whole request is received, with `*s` telling whether it is valid.
+  bool ReceiveRequest(Job* job, Status* s);
+  // `fds_to_close` are closed in a forked job process.
+  Status StartJob(Job* job, const std::vector<int>& fds_to_close);
+  void CancelJob(Job* job);
+  // Closes the connections of the finished jobs and removes them from
+  // `running`. With `wait`, waits for all of them to finish.
+  void ReapJobs(std::vector<std::unique_ptr<Job>>* running, bool wait);
+  // Runs a job in the current process
+  local_compaction::JobResponse RunJob(
+      const local_compaction::JobRequest& request);
+  void RespondToJob(Job* job);
+  Status JoinCgroup(pid_t pid);
+
+  const LocalCompactionWorkerOptions options_;
+  std::atomic<bool> shutdown_{false};
+};
+
+constexpr int LocalCompactionWorkerImpl::kPollIntervalMs;
+constexpr int LocalCompactionWorkerImpl::kRequestTimeoutSecs;
+
+Status LocalCompactionWorkerImpl::Run() {
+  if (!options_.fork_jobs && !options_.cgroup_path.empty()) {
+    Status s = JoinCgroup(getpid());
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  int listen_fd = -1;
+  Status s = local_compaction::Listen(options_.socket_path, &listen_fd);
+  if (!s.ok()) {
+    return s;
+  }
+
+  const size_t max_jobs = static_cast<size_t>(std::max(options_.max_jobs, 1));
+  SystemClock* clock = SystemClock::Default().get();
+  // Connections whose request is not fully received yet
+  std::vector<std::unique_ptr<Job>> receiving;
+  std::deque<std::unique_ptr<Job>> pending;
+  std::vector<std::unique_ptr<Job>> running;
+  std::vector<struct pollfd> poll_fds;
+  std::vector<Job*> polled_jobs;
+  while (!shutdown_.load(std::memory_order_relaxed)) {
+    ReapJobs(&running, /*wait=*/false);
+
+    while (running.size() < max_jobs && !pending.empty()) {
+      std::unique_ptr<Job> job = std::move(pending.front());
+      pending.pop_front();
+      std::vector<int> fds_to_close = {listen_fd};
+      for (const auto& other : receiving) {
+        fds_to_close.push_back(other->fd);
+      }
+      for (const auto& other : pending) {
+        fds_to_close.push_back(other->fd);
+      }
+      for (const auto& other : running) {
+        fds_to_close.push_back(other->fd);
+      }
+      Status start_status = StartJob(job.get(), fds_to_close);
+      if (start_status.ok()) {
+        running.push_back(std::move(job));
+      } else {
+        // Closing the connection fails the job
+        start_status.PermitUncheckedError();
+        close(job->fd);
+      }
+    }
+
+    // Wait for new jobs, for their requests, and for connections of jobs
+    // closed by the DB, which cancels the jobs. The DB sends nothing after
+    // the request.
+    poll_fds.clear();
+    polled_jobs.clear();
+    poll_fds.push_back({listen_fd, POLLIN, 0});
+    for (const auto& job : receiving) {
+      poll_fds.push_back({job->fd, POLLIN, 0});
+    }
+    for (const auto& job : pending) {
+      poll_fds.push_back({job->fd, POLLIN, 0});
+      polled_jobs.push_back(job.get());
+    }
+    for (const auto& job : running) {
+      if (!job->cancelled) {
+        poll_fds.push_back({job->fd, POLLIN, 0});
+        polled_jobs.push_back(job.get());
+      }
+    }
+    int ret = poll(poll_fds.data(), static_cast<nfds_t>(poll_fds.size()),
+                   kPollIntervalMs);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      s = Status::IOError("poll()", strerror(errno));
+      break;
+    }
+    const size_t num_receiving = receiving.size();
+    for (size_t i = 1 + num_receiving; i < poll_fds.size(); i++) {
+      if (poll_fds[i].revents != 0) {
+        CancelJob(polled_jobs[i - 1 - num_receiving]);
+      }
+    }
+    const uint64_t now_micros = clock->NowMicros();
+    size_t num_kept = 0;
+    for (size_t i = 0; i < num_receiving; i++) {
+      std::unique_ptr<Job>& job = receiving[i];
+      Status request_status;
+      bool received = false;
+      if (poll_fds[1 + i].revents != 0) {
+        received = ReceiveRequest(job.get(), &request_status);
+      }
+      if (received && request_status.ok()) {
+        pending.push_back(std::move(job));
+      } else if (received || now_micros - job->accept_time_micros >=
+                                 kRequestTimeoutSecs * 1000000ull) {
+        // An invalid, aborted or too slow request
+        request_status.PermitUncheckedError();
+        close(job->fd);
+      } else {
+        receiving[num_kept++] = std::move(job);
+      }
+    }
+    receiving.resize(num_kept);
+    for (auto it = pending.begin(); it != pending.end();) {
+      if ((*it)->cancelled) {
+        close((*it)->fd);
+        it = pending.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (poll_fds[0].revents & POLLIN) {
+      AcceptJob(listen_fd, &receiving);
+    }
+  }
+
+  for (const auto& job : running) {
+    CancelJob(job.get());
+  }
+  ReapJobs(&running, /*wait=*/true);
+  for (const auto& job : receiving) {
+    close(job->fd);
+  }
+  for (const auto& job : pending) {
+    close(job->fd);
+  }
+  close(listen_fd);
+  unlink(options_.socket_path.c_str());
+  return s;
+}
+
+void LocalCompactionWorkerImpl::AcceptJob(
+    int listen_fd, std::vector<std::unique_ptr<Job>>* receiving) {
+  int fd;
+  do {
+    // Non-blocking, so that a slow client cannot stall the other jobs
+    fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    return;
+  }
+  std::unique_ptr<Job> job(new Job);
+  job->fd = fd;
+  job->accept_time_micros = SystemClock::Default()->NowMicros();
+  receiving->push_back(std::move(job));
+}
+
+bool LocalCompactionWorkerImpl::ReceiveRequest(Job* job, Status* s) {
+  std::string payload;
+  bool done = false;
+  *s = local_compaction::ReceiveMessageNonBlocking(
+      job->fd, &job->request_buffer, &payload, &done);
+  if (!s->ok()) {
+    return true;
+  }
+  if (!done) {
+    return false;
+  }
+  *s = job->request.DecodeFrom(payload);
+  if (s->ok()) {
+    // The response is sent with blocking writes by the job
+    int flags = fcntl(job->fd, F_GETFL);
+    if (flags < 0 || fcntl(job->fd, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+      *s = Status::IOError("fcntl()", strerror(errno));
+    }
+  }
+  return true;
+}
+
+Status LocalCompactionWorkerImpl::StartJob(
+    Job* job, const std::vector<int>& fds_to_close) {
+  if (!options_.fork_jobs) {
+    job->thread.reset(new port::Thread([this, job] {
+      RespondToJob(job);
+      job->finished.store(true, std::memory_order_release);
+    }));
+    return Status::OK();
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    return Status::IOError("fork()", strerror(errno));
+  }
+  if (pid == 0) {
+    // In the job process
+    for (int fd : fds_to_close) {
+      close(fd);
+    }
+    if (!options_.cgroup_path.empty()) {
+      Status s = JoinCgroup(getpid());
+      if (!s.ok()) {
+        local_compaction::JobResponse response;
+        response.error = s.ToString();
+        std::string payload;
+        response.EncodeTo(&payload);
+        local_compaction::SendMessage(job->fd, payload)
+            .PermitUncheckedError();
+        _exit(1);
+      }
+    }
+    RespondToJob(job);
+    _exit(0);
+  }
+  job->pid = pid;
+  return Status::OK();
+}
+
+void LocalCompactionWorkerImpl::CancelJob(Job* job) {
+  if (job->cancelled) {
+    return;
+  }
+  job->cancelled = true;
+  if (job->pid > 0) {
+    // Reaped by ReapJobs()
+    kill(job->pid, SIGKILL);
+  }
+  // A job thread cannot be stopped; its response is discarded
+}
+
+void LocalCompactionWorkerImpl::ReapJobs(
+    std::vector<std::unique_ptr<Job>>* running, bool wait) {
+  for (auto it = running->begin(); it != running->end();) {
+    Job* job = it->get();
+    bool finished;
+    if (job->pid > 0) {
+      pid_t ret;
+      do {
+        ret = waitpid(job->pid, nullptr, wait ? 0 : WNOHANG);
+      } while (ret < 0 && errno == EINTR);
+      finished = ret != 0;
+    } else {
+      finished = wait || job->finished.load(std::memory_order_acquire);
+      if (finished) {
+        job->thread->join();
+      }
+    }
+    if (finished) {
+      close(job->fd);
+      it = running->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+local_compaction::JobResponse LocalCompactionWorkerImpl::RunJob(
+    const local_compaction::JobRequest& request) {
+  local_compaction::JobResponse response;
+  CompactionServiceInput input;
+  Status s = CompactionServiceInput::Read(request.input, &input);
+  if (s.ok()) {
+    CompactionServiceOptionsOverride override_options =
+        options_.options_override;
+    const ColumnFamilyOptions& cf_options = input.column_family.options;
+    if (cf_options.comparator != nullptr) {
+      override_options.comparator = cf_options.comparator;
+    }
+    if (cf_options.merge_operator != nullptr) {
+      override_options.merge_operator = cf_options.merge_operator;
+    }
+    if (cf_options.compaction_filter != nullptr) {
+      override_options.compaction_filter = cf_options.compaction_filter;
+    }
+    if (cf_options.compaction_filter_factory != nullptr) {
+      override_options.compaction_filter_factory =
+          cf_options.compaction_filter_factory;
+    }
+    if (cf_options.prefix_extractor != nullptr) {
+      override_options.prefix_extractor = cf_options.prefix_extractor;
+    }
+    if (cf_options.table_factory != nullptr) {
+      override_options.table_factory = cf_options.table_factory;
+    }
+    if (cf_options.sst_partitioner_factory != nullptr) {
+      override_options.sst_partitioner_factory =
+          cf_options.sst_partitioner_factory;
+    }
+    s = DB::OpenAndCompact(request.db_path, request.output_directory,
+                           request.input, &response.result, override_options);
+  }
+  response.ok = s.ok();
+  if (!s.ok()) {
+    response.error = s.ToString();
+  }
+  return response;
+}
+
+void LocalCompactionWorkerImpl::RespondToJob(Job* job) {
+  local_compaction::JobResponse response = RunJob(job->request);
+  std::string payload;
+  response.EncodeTo(&payload);
+  // Fails if the job was cancelled meanwhile
+  local_compaction::SendMessage(job->fd, payload).PermitUncheckedError();
+}
+
+Status LocalCompactionWorkerImpl::JoinCgroup(pid_t pid) {
+  const std::string path = options_.cgroup_path + "/cgroup.procs";
+  int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return Status::IOError("While opening " + path, strerror(errno));
+  }
+  const std::string pid_str = ToString(pid);
+  ssize_t ret = write(fd, pid_str.data(), pid_str.size());
+  int err = errno;
+  close(fd);
+  if (ret != static_cast<ssize_t>(pid_str.size())) {
+    return Status::IOError("While writing " + path, strerror(err));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+Status LocalCompactionWorker::Create(
+    const LocalCompactionWorkerOptions& options,
+    std::unique_ptr<LocalCompactionWorker>* worker) {
+  if (options.socket_path.empty()) {
+    return Status::InvalidArgument("socket_path is required");
+  }
+  if (options.max_jobs < 1) {
+    return Status::InvalidArgument("max_jobs must be positive");
+  }
+  worker->reset(new LocalCompactionWorkerImpl(options));
+  return Status::OK();
+}
+
+#else  // OS_WIN
+
+Status LocalCompactionWorker::Create(
+    const LocalCompactionWorkerOptions& /*options*/,
+    std::unique_ptr<LocalCompactionWorker>* /*worker*/) {
+  return Status::NotSupported(
+      "LocalCompactionWorker is not supported on Windows");
+}
+
+#endif  // !OS_WIN
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // !ROCKSDB_LITE
@@ -210,6 +210,11 @@ class SimCacheImpl : public SimCache {
     return cache_->Lookup(key, stats);
   }
 
+  // Not a use of the entry, so not simulated nor logged
+  bool Probe(const Slice& key) override {
+    return cache_ != nullptr && cache_->Probe(key);
+  }
+
   bool Ref(Handle* handle) override { return cache_->Ref(handle); }
 
   using Cache::Release;